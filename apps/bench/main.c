@@ -1,4 +1,6 @@
 #include "lattice/lattice.h"
+#include "lattice/recorder.h"
+#include "lattice/unchecked.h"
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -33,7 +35,13 @@ typedef enum bench_scene_e {
 
 enum {
     BENCH_SWEEP_WORKER_COUNT_DEFAULT = 4,
-    BENCH_SWEEP_WORKER_COUNT_MAX = 16
+    BENCH_SWEEP_WORKER_COUNT_MAX = 16,
+    BENCH_SCHEDULE_COMPILE_COMPONENTS = 64,
+    BENCH_SCHEDULE_COMPILE_TERMS = 4,
+    BENCH_SCHEDULE_COMPILE_REPEATS = 5,
+    BENCH_TRANSITION_TOP_MAX = 32,
+    BENCH_TRANSITION_NAME_BYTES = 96,
+    BENCH_TRANSITION_COMPONENT_MAX = 4
 };
 
 typedef struct bench_options_s {
@@ -47,6 +55,10 @@ typedef struct bench_options_s {
     double churn_initial_ratio;
     uint32_t worker_count;
     uint32_t workers[BENCH_SWEEP_WORKER_COUNT_MAX];
+    uint32_t schedule_compile_count;
+    uint32_t schedule_compile_entries[BENCH_SWEEP_WORKER_COUNT_MAX];
+    uint32_t transition_top;
+    const char* record_path;
 } bench_options_t;
 
 typedef struct bench_scheduler_case_s {
@@ -62,6 +74,32 @@ typedef struct bench_scheduler_case_s {
     lt_query_schedule_stats_t schedule_stats;
 } bench_scheduler_case_t;
 
+typedef struct bench_schedule_compile_case_s {
+    uint32_t entry_count;
+    double compile_ms;
+    lt_query_schedule_stats_t schedule_stats;
+} bench_schedule_compile_case_t;
+
+typedef struct bench_transition_row_s {
+    char src[BENCH_TRANSITION_NAME_BYTES];
+    char dst[BENCH_TRANSITION_NAME_BYTES];
+    uint64_t move_count;
+    uint64_t bytes_moved;
+} bench_transition_row_t;
+
+typedef struct bench_component_transition_row_s {
+    char name[BENCH_TRANSITION_NAME_BYTES];
+    lt_component_transition_stats_t stats;
+} bench_component_transition_row_t;
+
+typedef struct bench_transition_report_s {
+    uint32_t transition_count;
+    uint32_t row_count;
+    bench_transition_row_t rows[BENCH_TRANSITION_TOP_MAX];
+    uint32_t component_count;
+    bench_component_transition_row_t components[BENCH_TRANSITION_COMPONENT_MAX];
+} bench_transition_report_t;
+
 typedef struct bench_results_s {
     double spawn_ms;
     double simulate_ms;
@@ -70,6 +108,11 @@ typedef struct bench_results_s {
     double checksum;
     uint32_t scheduler_case_count;
     bench_scheduler_case_t scheduler_cases[BENCH_SWEEP_WORKER_COUNT_MAX];
+    uint64_t random_access_lookups;
+    double random_access_checked_ms;
+    double random_access_unchecked_ms;
+    double random_access_speedup;
+    bench_transition_report_t transitions;
 } bench_results_t;
 
 typedef struct bench_motion_ctx_s {
@@ -106,7 +149,8 @@ static void bench_print_usage(const char* program)
         stderr,
         "Usage: %s [--entities N] [--frames N] [--seed N] [--defer 0|1] "
         "[--format text|csv|json] [--scene steady|churn] [--churn-rate 0..1] "
-        "[--churn-initial-ratio 0..1] [--workers N[,N...]]\n",
+        "[--churn-initial-ratio 0..1] [--workers N[,N...]] [--schedule-compile N[,N...]] "
+        "[--transitions N] [--record PATH]\n",
         program);
 }
 
@@ -201,12 +245,12 @@ static int bench_parse_scene(const char* arg, bench_scene_t* out_scene)
     return 1;
 }
 
-static int bench_parse_workers(const char* arg, uint32_t* out_workers, uint32_t* out_count)
+static int bench_parse_u32_list(const char* arg, uint32_t* out_values, uint32_t* out_count)
 {
     const char* cursor;
     uint32_t count;
 
-    if (arg == NULL || out_workers == NULL || out_count == NULL || arg[0] == '\0') {
+    if (arg == NULL || out_values == NULL || out_count == NULL || arg[0] == '\0') {
         return 1;
     }
 
@@ -215,7 +259,7 @@ static int bench_parse_workers(const char* arg, uint32_t* out_workers, uint32_t*
     while (*cursor != '\0') {
         char* end_ptr;
         unsigned long parsed;
-        uint32_t parsed_worker;
+        uint32_t parsed_value;
         uint32_t j;
 
         parsed = strtoul(cursor, &end_ptr, 10);
@@ -226,13 +270,13 @@ static int bench_parse_workers(const char* arg, uint32_t* out_workers, uint32_t*
             return 1;
         }
 
-        parsed_worker = (uint32_t)parsed;
+        parsed_value = (uint32_t)parsed;
         for (j = 0u; j < count; ++j) {
-            if (out_workers[j] == parsed_worker) {
+            if (out_values[j] == parsed_value) {
                 return 1;
             }
         }
-        out_workers[count] = parsed_worker;
+        out_values[count] = parsed_value;
         count += 1u;
 
         if (*end_ptr == '\0') {
@@ -321,7 +365,7 @@ static int bench_parse_options(int argc, char** argv, bench_options_t* out_opts)
             i += 1;
         } else if (strcmp(argv[i], "--workers") == 0) {
             if (i + 1 >= argc
-                || bench_parse_workers(
+                || bench_parse_u32_list(
                     argv[i + 1],
                     out_opts->workers,
                     &out_opts->worker_count)
@@ -329,6 +373,28 @@ static int bench_parse_options(int argc, char** argv, bench_options_t* out_opts)
                 return 1;
             }
             i += 1;
+        } else if (strcmp(argv[i], "--schedule-compile") == 0) {
+            if (i + 1 >= argc
+                || bench_parse_u32_list(
+                    argv[i + 1],
+                    out_opts->schedule_compile_entries,
+                    &out_opts->schedule_compile_count)
+                    != 0) {
+                return 1;
+            }
+            i += 1;
+        } else if (strcmp(argv[i], "--transitions") == 0) {
+            if (i + 1 >= argc || bench_parse_u32(argv[i + 1], &out_opts->transition_top) != 0
+                || out_opts->transition_top > BENCH_TRANSITION_TOP_MAX) {
+                return 1;
+            }
+            i += 1;
+        } else if (strcmp(argv[i], "--record") == 0) {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0') {
+                return 1;
+            }
+            out_opts->record_path = argv[i + 1];
+            i += 1;
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             return 1;
         } else {
@@ -539,10 +605,134 @@ static lt_status_t bench_compute_checksum(
     return LT_STATUS_OK;
 }
 
+static void bench_format_component_set(
+    const lt_world_t* world,
+    const lt_component_id_t* ids,
+    uint32_t count,
+    char* out_text)
+{
+    size_t used;
+    uint32_t i;
+
+    used = 0u;
+    out_text[0] = '\0';
+    if (count == 0u) {
+        (void)snprintf(out_text, BENCH_TRANSITION_NAME_BYTES, "-");
+        return;
+    }
+
+    for (i = 0u; i < count && used < BENCH_TRANSITION_NAME_BYTES; ++i) {
+        const char* name;
+        int written;
+
+        name = NULL;
+        if (lt_component_get_name(world, ids[i], &name) != LT_STATUS_OK || name == NULL) {
+            name = "?";
+        }
+        written = snprintf(
+            out_text + used,
+            BENCH_TRANSITION_NAME_BYTES - used,
+            "%s%s",
+            i > 0u ? "+" : "",
+            name);
+        if (written < 0) {
+            break;
+        }
+        used += (size_t)written;
+    }
+}
+
+static int bench_compare_transitions(const void* lhs, const void* rhs)
+{
+    const lt_transition_stats_t* a;
+    const lt_transition_stats_t* b;
+
+    a = (const lt_transition_stats_t*)lhs;
+    b = (const lt_transition_stats_t*)rhs;
+    if (a->move_count != b->move_count) {
+        return a->move_count > b->move_count ? -1 : 1;
+    }
+    if (a->bytes_moved != b->bytes_moved) {
+        return a->bytes_moved > b->bytes_moved ? -1 : 1;
+    }
+    return 0;
+}
+
+static lt_status_t bench_capture_transitions(
+    const lt_world_t* world,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count,
+    uint32_t top_count,
+    bench_transition_report_t* out_report)
+{
+    lt_transition_stats_t* transitions;
+    uint32_t copied;
+    uint32_t i;
+    lt_status_t status;
+
+    memset(out_report, 0, sizeof(*out_report));
+    status = lt_world_get_transition_count(world, &out_report->transition_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    transitions = NULL;
+    copied = 0u;
+    if (out_report->transition_count > 0u) {
+        transitions = (lt_transition_stats_t*)malloc(
+            sizeof(*transitions) * (size_t)out_report->transition_count);
+        if (transitions == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        status = lt_world_copy_transitions(world, transitions, out_report->transition_count, &copied);
+        if (status != LT_STATUS_OK) {
+            free(transitions);
+            return status;
+        }
+        qsort(transitions, (size_t)copied, sizeof(*transitions), bench_compare_transitions);
+    }
+
+    for (i = 0u; i < copied && i < top_count; ++i) {
+        bench_transition_row_t* row;
+
+        row = &out_report->rows[i];
+        bench_format_component_set(
+            world,
+            transitions[i].src_component_ids,
+            transitions[i].src_component_count,
+            row->src);
+        bench_format_component_set(
+            world,
+            transitions[i].dst_component_ids,
+            transitions[i].dst_component_count,
+            row->dst);
+        row->move_count = transitions[i].move_count;
+        row->bytes_moved = transitions[i].bytes_moved;
+        out_report->row_count += 1u;
+    }
+    free(transitions);
+
+    for (i = 0u; i < component_count && i < BENCH_TRANSITION_COMPONENT_MAX; ++i) {
+        bench_component_transition_row_t* row;
+
+        row = &out_report->components[out_report->component_count];
+        bench_format_component_set(world, &component_ids[i], 1u, row->name);
+        status = lt_component_get_transition_stats(world, component_ids[i], &row->stats);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+        out_report->component_count += 1u;
+    }
+
+    return LT_STATUS_OK;
+}
+
 static int bench_run_scheduler_case(
     const bench_options_t* opts,
     uint32_t workers,
-    bench_scheduler_case_t* out_case)
+    bench_scheduler_case_t* out_case,
+    bench_transition_report_t* out_transitions,
+    const char* record_path)
 {
     lt_world_t* world;
     lt_component_desc_t desc;
@@ -560,6 +750,7 @@ static int bench_run_scheduler_case(
     lt_query_t* damp_query;
     lt_query_t* churn_query;
     lt_schedule_t* schedule;
+    lt_recorder_t* recorder;
     lt_query_schedule_entry_t entries[4];
     bench_motion_ctx_t motion_ctx;
     bench_health_ctx_t health_ctx;
@@ -602,6 +793,7 @@ static int bench_run_scheduler_case(
     damp_query = NULL;
     churn_query = NULL;
     schedule = NULL;
+    recorder = NULL;
     tracked_entities = NULL;
     has_churn = NULL;
     toggle_count_per_frame = 0u;
@@ -609,6 +801,12 @@ static int bench_run_scheduler_case(
     schedule_entry_count = 0u;
 
     BENCH_CASE_REQUIRE_STATUS(lt_world_create(NULL, &world));
+    if (out_transitions != NULL) {
+        BENCH_CASE_REQUIRE_STATUS(lt_world_set_transition_tracking(world, 1u));
+    }
+    if (record_path != NULL) {
+        BENCH_CASE_REQUIRE_STATUS(lt_recorder_create(world, record_path, &recorder));
+    }
 
     memset(&desc, 0, sizeof(desc));
     desc.name = "Position";
@@ -813,8 +1011,14 @@ static int bench_run_scheduler_case(
                 BENCH_CASE_REQUIRE_STATUS(lt_world_flush(world));
             }
         }
+        if (recorder != NULL) {
+            BENCH_CASE_REQUIRE_STATUS(lt_recorder_mark_frame(recorder));
+        }
     }
     sim_end_ns = bench_now_ns();
+    if (recorder != NULL) {
+        BENCH_CASE_REQUIRE_STATUS(lt_recorder_flush(recorder));
+    }
 
     BENCH_CASE_REQUIRE_STATUS(bench_compute_checksum(
         world,
@@ -824,6 +1028,20 @@ static int bench_run_scheduler_case(
         &out_case->checksum,
         &out_case->touched_entities));
     BENCH_CASE_REQUIRE_STATUS(lt_world_get_stats(world, &out_case->stats));
+    if (out_transitions != NULL) {
+        lt_component_id_t tracked_ids[BENCH_TRANSITION_COMPONENT_MAX];
+
+        tracked_ids[0] = position_id;
+        tracked_ids[1] = velocity_id;
+        tracked_ids[2] = health_id;
+        tracked_ids[3] = churn_id;
+        BENCH_CASE_REQUIRE_STATUS(bench_capture_transitions(
+            world,
+            tracked_ids,
+            opts->scene == BENCH_SCENE_CHURN ? 4u : 3u,
+            opts->transition_top,
+            out_transitions));
+    }
 
     out_case->structural_ops = structural_ops;
     out_case->touched_entities = (uint64_t)out_case->stats.live_entities * (uint64_t)opts->frame_count
@@ -837,6 +1055,7 @@ static int bench_run_scheduler_case(
                                               ? 0.0
                                               : ((double)out_case->touched_entities / sim_seconds);
 
+    lt_recorder_destroy(recorder);
     lt_schedule_destroy(schedule);
     lt_query_destroy(churn_query);
     lt_query_destroy(damp_query);
@@ -849,6 +1068,7 @@ static int bench_run_scheduler_case(
     return 0;
 
 cleanup:
+    lt_recorder_destroy(recorder);
     lt_schedule_destroy(schedule);
     lt_query_destroy(churn_query);
     lt_query_destroy(damp_query);
@@ -861,6 +1081,313 @@ cleanup:
     return 1;
 }
 
+static int bench_run_random_access(const bench_options_t* opts, bench_results_t* results)
+{
+    lt_world_t* world;
+    lt_component_desc_t desc;
+    lt_component_id_t position_id;
+    lt_component_id_t health_id;
+    lt_entity_t* entities;
+    uint32_t* order;
+    uint32_t random_state;
+    uint32_t lookup_count;
+    uint64_t start_ns;
+    uint64_t checked_ns;
+    uint64_t unchecked_ns;
+    double checked_sum;
+    double unchecked_sum;
+    uint32_t i;
+    lt_status_t status;
+
+#define BENCH_RA_REQUIRE_STATUS(call_expr)                                                     \
+    do {                                                                                        \
+        status = (call_expr);                                                                   \
+        if (status != LT_STATUS_OK) {                                                          \
+            fprintf(stderr, "Error: %s failed with %s\\n", #call_expr, lt_status_string(status)); \
+            goto cleanup;                                                                       \
+        }                                                                                       \
+    } while (0)
+
+    if (opts == NULL || results == NULL) {
+        return 1;
+    }
+
+    world = NULL;
+    entities = NULL;
+    order = NULL;
+    lookup_count = opts->entity_count;
+    if (lookup_count == 0u) {
+        return 0;
+    }
+
+    BENCH_RA_REQUIRE_STATUS(lt_world_create(NULL, &world));
+
+    memset(&desc, 0, sizeof(desc));
+    desc.name = "Position";
+    desc.size = (uint32_t)sizeof(bench_vec3_t);
+    desc.align = (uint32_t)_Alignof(bench_vec3_t);
+    BENCH_RA_REQUIRE_STATUS(lt_register_component(world, &desc, &position_id));
+
+    desc.name = "Health";
+    desc.size = (uint32_t)sizeof(bench_health_t);
+    desc.align = (uint32_t)_Alignof(bench_health_t);
+    BENCH_RA_REQUIRE_STATUS(lt_register_component(world, &desc, &health_id));
+
+    entities = (lt_entity_t*)malloc(sizeof(*entities) * (size_t)opts->entity_count);
+    order = (uint32_t*)malloc(sizeof(*order) * (size_t)lookup_count);
+    if (entities == NULL || order == NULL) {
+        fprintf(stderr, "Error: failed to allocate random access buffers\n");
+        goto cleanup;
+    }
+
+    random_state = opts->seed;
+    BENCH_RA_REQUIRE_STATUS(lt_world_reserve_entities(world, opts->entity_count));
+    for (i = 0u; i < opts->entity_count; ++i) {
+        bench_vec3_t position;
+        bench_health_t health;
+
+        BENCH_RA_REQUIRE_STATUS(lt_entity_create(world, &entities[i]));
+        position.x = bench_rand_range(&random_state, -100.0f, 100.0f);
+        position.y = bench_rand_range(&random_state, -100.0f, 100.0f);
+        position.z = bench_rand_range(&random_state, -100.0f, 100.0f);
+        BENCH_RA_REQUIRE_STATUS(lt_add_component(world, entities[i], position_id, &position));
+        if ((i & 1u) == 0u) {
+            health.value = bench_rand_range(&random_state, 50.0f, 150.0f);
+            BENCH_RA_REQUIRE_STATUS(lt_add_component(world, entities[i], health_id, &health));
+        }
+    }
+
+    for (i = 0u; i < lookup_count; ++i) {
+        order[i] = bench_rand_u32(&random_state) % opts->entity_count;
+    }
+
+    checked_sum = 0.0;
+    start_ns = bench_now_ns();
+    for (i = 0u; i < lookup_count; ++i) {
+        void* ptr;
+
+        BENCH_RA_REQUIRE_STATUS(lt_get_component(world, entities[order[i]], position_id, &ptr));
+        checked_sum += (double)((const bench_vec3_t*)ptr)->x;
+    }
+    checked_ns = bench_now_ns() - start_ns;
+
+    unchecked_sum = 0.0;
+    start_ns = bench_now_ns();
+    for (i = 0u; i < lookup_count; ++i) {
+        const bench_vec3_t* position;
+
+        position = (const bench_vec3_t*)lt_get_component_unchecked(world, entities[order[i]], position_id);
+        unchecked_sum += (double)position->x;
+    }
+    unchecked_ns = bench_now_ns() - start_ns;
+
+    if (checked_sum != unchecked_sum) {
+        fprintf(stderr, "Error: unchecked random access diverged from checked access\n");
+        goto cleanup;
+    }
+
+    results->random_access_lookups = (uint64_t)lookup_count;
+    results->random_access_checked_ms = (double)checked_ns / 1000000.0;
+    results->random_access_unchecked_ms = (double)unchecked_ns / 1000000.0;
+    results->random_access_speedup = unchecked_ns == 0u ? 0.0 : (double)checked_ns / (double)unchecked_ns;
+
+    lt_world_destroy(world);
+    free(order);
+    free(entities);
+#undef BENCH_RA_REQUIRE_STATUS
+    return 0;
+
+cleanup:
+    lt_world_destroy(world);
+    free(order);
+    free(entities);
+#undef BENCH_RA_REQUIRE_STATUS
+    return 1;
+}
+
+static void bench_noop_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    (void)view;
+    (void)worker_index;
+    (void)user_data;
+}
+
+static int bench_run_schedule_compile(
+    const bench_options_t* opts,
+    uint32_t entry_count,
+    bench_schedule_compile_case_t* out_case)
+{
+    lt_world_t* world;
+    lt_component_desc_t desc;
+    lt_component_id_t component_ids[BENCH_SCHEDULE_COMPILE_COMPONENTS];
+    lt_query_term_t* terms;
+    lt_query_t** queries;
+    lt_query_schedule_entry_t* entries;
+    lt_query_desc_t query_desc;
+    lt_schedule_t* schedule;
+    lt_query_schedule_stats_t stats;
+    char name[32];
+    uint32_t random_state;
+    uint64_t start_ns;
+    uint64_t total_ns;
+    uint32_t i;
+    uint32_t j;
+    lt_status_t status;
+
+#define BENCH_SC_REQUIRE_STATUS(call_expr)                                                     \
+    do {                                                                                        \
+        status = (call_expr);                                                                   \
+        if (status != LT_STATUS_OK) {                                                          \
+            fprintf(stderr, "Error: %s failed with %s\\n", #call_expr, lt_status_string(status)); \
+            goto cleanup;                                                                       \
+        }                                                                                       \
+    } while (0)
+
+    if (opts == NULL || out_case == NULL || entry_count == 0u) {
+        return 1;
+    }
+
+    memset(out_case, 0, sizeof(*out_case));
+    world = NULL;
+    queries = (lt_query_t**)calloc((size_t)entry_count, sizeof(*queries));
+    terms = (lt_query_term_t*)malloc(sizeof(*terms) * (size_t)entry_count * BENCH_SCHEDULE_COMPILE_TERMS);
+    entries = (lt_query_schedule_entry_t*)calloc((size_t)entry_count, sizeof(*entries));
+    if (queries == NULL || terms == NULL || entries == NULL) {
+        fprintf(stderr, "Error: failed to allocate schedule compile buffers\n");
+        goto cleanup;
+    }
+
+    BENCH_SC_REQUIRE_STATUS(lt_world_create(NULL, &world));
+    memset(&desc, 0, sizeof(desc));
+    desc.size = (uint32_t)sizeof(float);
+    desc.align = (uint32_t)_Alignof(float);
+    for (i = 0u; i < BENCH_SCHEDULE_COMPILE_COMPONENTS; ++i) {
+        snprintf(name, sizeof(name), "Component%" PRIu32, i);
+        desc.name = name;
+        BENCH_SC_REQUIRE_STATUS(lt_register_component(world, &desc, &component_ids[i]));
+    }
+
+    random_state = opts->seed;
+    for (i = 0u; i < entry_count; ++i) {
+        lt_query_term_t* entry_terms;
+        uint32_t first;
+        uint32_t stride;
+
+        entry_terms = &terms[(size_t)i * BENCH_SCHEDULE_COMPILE_TERMS];
+        first = bench_rand_u32(&random_state) % BENCH_SCHEDULE_COMPILE_COMPONENTS;
+        stride = 1u + bench_rand_u32(&random_state) % (BENCH_SCHEDULE_COMPILE_COMPONENTS / BENCH_SCHEDULE_COMPILE_TERMS);
+        for (j = 0u; j < BENCH_SCHEDULE_COMPILE_TERMS; ++j) {
+            entry_terms[j].component_id = component_ids[(first + j * stride) % BENCH_SCHEDULE_COMPILE_COMPONENTS];
+            entry_terms[j].access = (bench_rand_u32(&random_state) % 4u) == 0u ? LT_ACCESS_WRITE : LT_ACCESS_READ;
+        }
+
+        memset(&query_desc, 0, sizeof(query_desc));
+        query_desc.with_terms = entry_terms;
+        query_desc.with_count = BENCH_SCHEDULE_COMPILE_TERMS;
+        BENCH_SC_REQUIRE_STATUS(lt_query_create(world, &query_desc, &queries[i]));
+
+        entries[i].query = queries[i];
+        entries[i].callback = bench_noop_chunk;
+    }
+
+    total_ns = 0u;
+    for (i = 0u; i < BENCH_SCHEDULE_COMPILE_REPEATS; ++i) {
+        start_ns = bench_now_ns();
+        BENCH_SC_REQUIRE_STATUS(lt_schedule_create(entries, entry_count, &schedule));
+        total_ns += bench_now_ns() - start_ns;
+        BENCH_SC_REQUIRE_STATUS(lt_schedule_execute(schedule, 1u, &stats));
+        lt_schedule_destroy(schedule);
+    }
+
+    out_case->entry_count = entry_count;
+    out_case->compile_ms = (double)total_ns / 1000000.0 / (double)BENCH_SCHEDULE_COMPILE_REPEATS;
+    out_case->schedule_stats = stats;
+
+    for (i = 0u; i < entry_count; ++i) {
+        lt_query_destroy(queries[i]);
+    }
+    lt_world_destroy(world);
+    free(entries);
+    free(terms);
+    free(queries);
+#undef BENCH_SC_REQUIRE_STATUS
+    return 0;
+
+cleanup:
+    if (queries != NULL) {
+        for (i = 0u; i < entry_count; ++i) {
+            lt_query_destroy(queries[i]);
+        }
+    }
+    lt_world_destroy(world);
+    free(entries);
+    free(terms);
+    free(queries);
+#undef BENCH_SC_REQUIRE_STATUS
+    return 1;
+}
+
+static void bench_print_schedule_compile(
+    const bench_options_t* opts,
+    const bench_schedule_compile_case_t* cases,
+    uint32_t case_count)
+{
+    uint32_t i;
+
+    switch (opts->output_format) {
+        case BENCH_OUTPUT_CSV:
+            printf("entries,components,terms_per_entry,compile_ms,batch_count,edge_count,max_batch_size\n");
+            for (i = 0u; i < case_count; ++i) {
+                printf(
+                    "%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.3f,%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n",
+                    cases[i].entry_count,
+                    (uint32_t)BENCH_SCHEDULE_COMPILE_COMPONENTS,
+                    (uint32_t)BENCH_SCHEDULE_COMPILE_TERMS,
+                    cases[i].compile_ms,
+                    cases[i].schedule_stats.batch_count,
+                    cases[i].schedule_stats.edge_count,
+                    cases[i].schedule_stats.max_batch_size);
+            }
+            break;
+        case BENCH_OUTPUT_JSON:
+            printf("{\n");
+            printf("  \"seed\": %" PRIu32 ",\n", opts->seed);
+            printf("  \"components\": %" PRIu32 ",\n", (uint32_t)BENCH_SCHEDULE_COMPILE_COMPONENTS);
+            printf("  \"terms_per_entry\": %" PRIu32 ",\n", (uint32_t)BENCH_SCHEDULE_COMPILE_TERMS);
+            printf("  \"schedule_compile\": [\n");
+            for (i = 0u; i < case_count; ++i) {
+                printf("    {\n");
+                printf("      \"entries\": %" PRIu32 ",\n", cases[i].entry_count);
+                printf("      \"compile_ms\": %.3f,\n", cases[i].compile_ms);
+                printf("      \"batch_count\": %" PRIu32 ",\n", cases[i].schedule_stats.batch_count);
+                printf("      \"edge_count\": %" PRIu32 ",\n", cases[i].schedule_stats.edge_count);
+                printf("      \"max_batch_size\": %" PRIu32 "\n", cases[i].schedule_stats.max_batch_size);
+                printf("    }%s\n", (i + 1u) < case_count ? "," : "");
+            }
+            printf("  ]\n");
+            printf("}\n");
+            break;
+        case BENCH_OUTPUT_TEXT:
+        default:
+            printf("seed=%" PRIu32 "\n", opts->seed);
+            printf("schedule_compile_components=%" PRIu32 "\n", (uint32_t)BENCH_SCHEDULE_COMPILE_COMPONENTS);
+            printf("schedule_compile_terms_per_entry=%" PRIu32 "\n", (uint32_t)BENCH_SCHEDULE_COMPILE_TERMS);
+            printf("schedule_compile_count=%" PRIu32 "\n", case_count);
+            for (i = 0u; i < case_count; ++i) {
+                printf(
+                    "schedule_compile_entries=%" PRIu32 " schedule_compile_ms=%.3f"
+                    " schedule_compile_batches=%" PRIu32 " schedule_compile_edges=%" PRIu32
+                    " schedule_compile_max_batch_size=%" PRIu32 "\n",
+                    cases[i].entry_count,
+                    cases[i].compile_ms,
+                    cases[i].schedule_stats.batch_count,
+                    cases[i].schedule_stats.edge_count,
+                    cases[i].schedule_stats.max_batch_size);
+            }
+            break;
+    }
+}
+
 static const char* bench_scene_name(bench_scene_t scene)
 {
     switch (scene) {
@@ -899,6 +1426,39 @@ static void bench_print_results_text(
         stats->chunk_count,
         stats->pending_commands,
         stats->structural_moves);
+    printf(
+        "random_access_lookups=%" PRIu64 " random_access_checked_ms=%.3f"
+        " random_access_unchecked_ms=%.3f random_access_speedup=%.3f\n",
+        results->random_access_lookups,
+        results->random_access_checked_ms,
+        results->random_access_unchecked_ms,
+        results->random_access_speedup);
+
+    if (opts->transition_top > 0u) {
+        const bench_transition_report_t* report;
+
+        report = &results->transitions;
+        printf("transition_count=%" PRIu32 "\n", report->transition_count);
+        for (i = 0u; i < report->row_count; ++i) {
+            printf(
+                "transition_rank=%" PRIu32 " transition_src=%s transition_dst=%s"
+                " transition_moves=%" PRIu64 " transition_bytes=%" PRIu64 "\n",
+                i + 1u,
+                report->rows[i].src,
+                report->rows[i].dst,
+                report->rows[i].move_count,
+                report->rows[i].bytes_moved);
+        }
+        for (i = 0u; i < report->component_count; ++i) {
+            printf(
+                "component_transition_name=%s component_transition_adds=%" PRIu64
+                " component_transition_removes=%" PRIu64 " component_transition_bytes=%" PRIu64 "\n",
+                report->components[i].name,
+                report->components[i].stats.add_count,
+                report->components[i].stats.remove_count,
+                report->components[i].stats.bytes_moved);
+        }
+    }
 
     printf("scheduler_sweep_count=%" PRIu32 "\n", results->scheduler_case_count);
     for (i = 0u; i < results->scheduler_case_count; ++i) {
@@ -934,7 +1494,8 @@ static void bench_print_results_csv(const bench_options_t* opts, const bench_res
         "touched_entities,simulate_entities_per_sec,checksum,stats_live,stats_archetypes,"
         "stats_chunks,stats_pending,stats_structural_moves,schedule_batch_count,"
         "schedule_edge_count,schedule_max_batch_size,scheduler_structural_ops,scene,"
-        "churn_rate,churn_initial_ratio\n");
+        "churn_rate,churn_initial_ratio,random_access_lookups,random_access_checked_ms,"
+        "random_access_unchecked_ms\n");
 
     for (i = 0u; i < results->scheduler_case_count; ++i) {
         const bench_scheduler_case_t* c;
@@ -943,7 +1504,8 @@ static void bench_print_results_csv(const bench_options_t* opts, const bench_res
         printf(
             "%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ","
             "%.3f,%.3f,%.3f,%" PRIu64 ",%.3f,%.6f,%" PRIu32 ",%" PRIu32 ",%" PRIu32
-            ",%" PRIu32 ",%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu64 ",%s,%.6f,%.6f\n",
+            ",%" PRIu32 ",%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu64 ",%s,%.6f,%.6f"
+            ",%" PRIu64 ",%.3f,%.3f\n",
             opts->entity_count,
             opts->frame_count,
             opts->seed,
@@ -966,7 +1528,10 @@ static void bench_print_results_csv(const bench_options_t* opts, const bench_res
             c->structural_ops,
             bench_scene_name(opts->scene),
             opts->churn_rate,
-            opts->churn_initial_ratio);
+            opts->churn_initial_ratio,
+            results->random_access_lookups,
+            results->random_access_checked_ms,
+            results->random_access_unchecked_ms);
     }
 }
 
@@ -995,6 +1560,39 @@ static void bench_print_results_json(
     printf("  \"stats_chunks\": %" PRIu32 ",\n", stats->chunk_count);
     printf("  \"stats_pending\": %" PRIu32 ",\n", stats->pending_commands);
     printf("  \"stats_structural_moves\": %" PRIu64 ",\n", stats->structural_moves);
+    printf("  \"random_access_lookups\": %" PRIu64 ",\n", results->random_access_lookups);
+    printf("  \"random_access_checked_ms\": %.3f,\n", results->random_access_checked_ms);
+    printf("  \"random_access_unchecked_ms\": %.3f,\n", results->random_access_unchecked_ms);
+    printf("  \"random_access_speedup\": %.3f,\n", results->random_access_speedup);
+    if (opts->transition_top > 0u) {
+        const bench_transition_report_t* report;
+
+        report = &results->transitions;
+        printf("  \"transition_count\": %" PRIu32 ",\n", report->transition_count);
+        printf("  \"transitions\": [\n");
+        for (i = 0u; i < report->row_count; ++i) {
+            printf(
+                "    {\"src\": \"%s\", \"dst\": \"%s\", \"moves\": %" PRIu64 ", \"bytes\": %" PRIu64 "}%s\n",
+                report->rows[i].src,
+                report->rows[i].dst,
+                report->rows[i].move_count,
+                report->rows[i].bytes_moved,
+                (i + 1u) < report->row_count ? "," : "");
+        }
+        printf("  ],\n");
+        printf("  \"component_transitions\": [\n");
+        for (i = 0u; i < report->component_count; ++i) {
+            printf(
+                "    {\"name\": \"%s\", \"adds\": %" PRIu64 ", \"removes\": %" PRIu64 ", \"bytes\": %" PRIu64
+                "}%s\n",
+                report->components[i].name,
+                report->components[i].stats.add_count,
+                report->components[i].stats.remove_count,
+                report->components[i].stats.bytes_moved,
+                (i + 1u) < report->component_count ? "," : "");
+        }
+        printf("  ],\n");
+    }
     printf("  \"scheduler_sweep\": [\n");
 
     for (i = 0u; i < results->scheduler_case_count; ++i) {
@@ -1059,11 +1657,39 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (opts.schedule_compile_count > 0u) {
+        bench_schedule_compile_case_t compile_cases[BENCH_SWEEP_WORKER_COUNT_MAX];
+
+        for (i = 0u; i < opts.schedule_compile_count; ++i) {
+            if (bench_run_schedule_compile(&opts, opts.schedule_compile_entries[i], &compile_cases[i]) != 0) {
+                return 1;
+            }
+        }
+        bench_print_schedule_compile(&opts, compile_cases, opts.schedule_compile_count);
+        return 0;
+    }
+
     memset(&results, 0, sizeof(results));
     results.scheduler_case_count = opts.worker_count;
 
     for (i = 0u; i < opts.worker_count; ++i) {
-        if (bench_run_scheduler_case(&opts, opts.workers[i], &results.scheduler_cases[i]) != 0) {
+        if (bench_run_scheduler_case(&opts, opts.workers[i], &results.scheduler_cases[i], NULL, NULL) != 0) {
+            return 1;
+        }
+    }
+
+    if (opts.transition_top > 0u) {
+        bench_scheduler_case_t tracked_case;
+
+        if (bench_run_scheduler_case(&opts, opts.workers[0], &tracked_case, &results.transitions, NULL) != 0) {
+            return 1;
+        }
+    }
+
+    if (opts.record_path != NULL) {
+        bench_scheduler_case_t recorded_case;
+
+        if (bench_run_scheduler_case(&opts, opts.workers[0], &recorded_case, NULL, opts.record_path) != 0) {
             return 1;
         }
     }
@@ -1085,6 +1711,10 @@ int main(int argc, char** argv)
     results.checksum = results.scheduler_cases[0].checksum;
     baseline_stats = results.scheduler_cases[0].stats;
 
+    if (bench_run_random_access(&opts, &results) != 0) {
+        return 1;
+    }
+
     bench_print_results(&opts, &results, &baseline_stats);
     return 0;
 }
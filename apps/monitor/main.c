@@ -0,0 +1,200 @@
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "lattice/shm_export.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct monitor_options_s {
+    const char* name;
+    uint32_t interval_ms;
+    uint32_t count;
+    uint8_t once;
+} monitor_options_t;
+
+static void monitor_print_usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--once] [--interval-ms N] [--count N] /segment-name\n", program);
+}
+
+static int monitor_parse_u32(const char* arg, uint32_t* out_value)
+{
+    char* end_ptr;
+    unsigned long parsed;
+
+    if (arg == NULL || out_value == NULL || arg[0] == '\0') {
+        return 1;
+    }
+
+    parsed = strtoul(arg, &end_ptr, 10);
+    if (end_ptr == arg || *end_ptr != '\0' || parsed > 0xFFFFFFFFul) {
+        return 1;
+    }
+
+    *out_value = (uint32_t)parsed;
+    return 0;
+}
+
+static int monitor_parse_options(int argc, char** argv, monitor_options_t* out_opts)
+{
+    int i;
+
+    memset(out_opts, 0, sizeof(*out_opts));
+    out_opts->interval_ms = 1000u;
+
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--once") == 0) {
+            out_opts->once = 1u;
+        } else if (strcmp(argv[i], "--interval-ms") == 0) {
+            if (i + 1 >= argc || monitor_parse_u32(argv[i + 1], &out_opts->interval_ms) != 0) {
+                return 1;
+            }
+            i += 1;
+        } else if (strcmp(argv[i], "--count") == 0) {
+            if (i + 1 >= argc || monitor_parse_u32(argv[i + 1], &out_opts->count) != 0) {
+                return 1;
+            }
+            i += 1;
+        } else if (argv[i][0] == '/' && out_opts->name == NULL) {
+            out_opts->name = argv[i];
+        } else {
+            return 1;
+        }
+    }
+
+    return out_opts->name == NULL ? 1 : 0;
+}
+
+static void monitor_sleep_ms(uint32_t ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ms / 1000u);
+    ts.tv_nsec = (long)(ms % 1000u) * 1000000l;
+    (void)nanosleep(&ts, NULL);
+}
+
+static void monitor_print_sample(const lt_shm_header_t* header, const lt_shm_entry_t* entries, uint32_t entry_count)
+{
+    uint32_t i;
+
+    printf(
+        "frame=%" PRIu64 " live=%" PRIu64 " slots=%" PRIu64 "/%" PRIu64 " archetypes=%" PRIu64
+        " chunks=%" PRIu64 " chunk_bytes=%" PRIu64 " pending=%" PRIu64 " moves=%" PRIu64 "\n",
+        header->frame,
+        header->world.live_entities,
+        header->world.allocated_entity_slots,
+        header->world.entity_capacity,
+        header->world.archetype_count,
+        header->world.chunk_count,
+        header->world.chunk_bytes,
+        header->world.pending_commands,
+        header->world.structural_moves);
+    for (i = 0u; i < entry_count; ++i) {
+        const lt_shm_entry_t* entry;
+        uint64_t avg_ns;
+
+        entry = &entries[i];
+        avg_ns = entry->run_count > 0u ? entry->total_ns / entry->run_count : 0u;
+        printf(
+            "  [%" PRIu32 ":%" PRIu32 "] %-24s last_us=%.3f avg_us=%.3f max_us=%.3f runs=%" PRIu64 "\n",
+            entry->schedule_index,
+            entry->position,
+            entry->name[0] != '\0' ? entry->name : "-",
+            (double)entry->last_ns / 1000.0,
+            (double)avg_ns / 1000.0,
+            (double)entry->max_ns / 1000.0,
+            entry->run_count);
+    }
+    if (header->dropped_entries > 0u) {
+        printf("  (%" PRIu32 " entries dropped)\n", header->dropped_entries);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    monitor_options_t opts;
+    struct stat info;
+    lt_shm_header_t header;
+    lt_shm_entry_t* entries;
+    const void* segment;
+    uint64_t last_frame;
+    uint32_t max_entries;
+    uint32_t samples;
+    int exit_code;
+    int fd;
+
+    if (monitor_parse_options(argc, argv, &opts) != 0) {
+        monitor_print_usage(argv[0]);
+        return 1;
+    }
+
+    fd = shm_open(opts.name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: cannot open shared-memory segment %s\n", opts.name);
+        return 1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(lt_shm_header_t)) {
+        fprintf(stderr, "Error: segment %s is not a lattice metrics page\n", opts.name);
+        (void)close(fd);
+        return 1;
+    }
+    segment = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (segment == MAP_FAILED) {
+        fprintf(stderr, "Error: cannot map segment %s\n", opts.name);
+        return 1;
+    }
+
+    max_entries = (uint32_t)(((size_t)info.st_size - sizeof(lt_shm_header_t)) / sizeof(lt_shm_entry_t));
+    entries = NULL;
+    if (max_entries > 0u) {
+        entries = (lt_shm_entry_t*)malloc(sizeof(*entries) * (size_t)max_entries);
+        if (entries == NULL) {
+            fprintf(stderr, "Error: failed to allocate entry buffer\n");
+            (void)munmap((void*)segment, (size_t)info.st_size);
+            return 1;
+        }
+    }
+
+    last_frame = 0u;
+    samples = 0u;
+    exit_code = 0;
+    for (;;) {
+        uint32_t entry_count;
+        lt_status_t status;
+
+        status = lt_shm_read(segment, (size_t)info.st_size, &header, entries, max_entries, &entry_count);
+        if (status == LT_STATUS_INVALID_ARGUMENT) {
+            fprintf(stderr, "Error: segment %s has an incompatible layout\n", opts.name);
+            exit_code = 1;
+            break;
+        }
+        if (status == LT_STATUS_OK && (header.frame != last_frame || opts.once != 0u)) {
+            monitor_print_sample(&header, entries, entry_count);
+            last_frame = header.frame;
+            samples += 1u;
+        }
+        if (opts.once != 0u || (opts.count > 0u && samples >= opts.count)) {
+            break;
+        }
+        monitor_sleep_ms(opts.interval_ms);
+    }
+
+    free(entries);
+    (void)munmap((void*)segment, (size_t)info.st_size);
+    if ((opts.once != 0u || opts.count > 0u) && samples == 0u) {
+        exit_code = 1;
+    }
+    return exit_code;
+}
@@ -0,0 +1,508 @@
+#include "lattice/lattice.h"
+#include "lattice/recorder.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct replay_options_s {
+    const char* path;
+    uint32_t repeat;
+} replay_options_t;
+
+typedef struct replay_op_stats_s {
+    uint64_t count;
+    uint64_t total_ns;
+} replay_op_stats_t;
+
+typedef struct replay_run_s {
+    replay_op_stats_t ops[LT_RECORD_OP_FRAME + 1];
+    uint64_t total_ns;
+    uint64_t frame_count;
+    uint64_t frame_min_ns;
+    uint64_t frame_max_ns;
+    uint64_t frame_total_ns;
+    uint64_t failed_ops;
+} replay_run_t;
+
+typedef struct replay_state_s {
+    lt_world_t* world;
+    lt_entity_t* entities;
+    uint32_t entity_capacity;
+    lt_component_id_t* components;
+    uint32_t component_capacity;
+    uint32_t* sizes;
+    uint32_t size_capacity;
+    lt_query_t** queries;
+    uint32_t query_capacity;
+    uint64_t sink;
+} replay_state_t;
+
+static const char* const replay_op_names[LT_RECORD_OP_FRAME + 1] = {
+    "",
+    "register",
+    "create",
+    "destroy",
+    "add",
+    "remove",
+    "set",
+    "get",
+    "query_define",
+    "query_run",
+    "frame"
+};
+
+static uint64_t replay_now_ns(void)
+{
+    struct timespec ts;
+
+    if (timespec_get(&ts, TIME_UTC) != TIME_UTC) {
+        return 0u;
+    }
+
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+static void replay_print_usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--repeat N] capture.ltrc\n", program);
+}
+
+static int replay_parse_options(int argc, char** argv, replay_options_t* out_opts)
+{
+    int i;
+
+    memset(out_opts, 0, sizeof(*out_opts));
+    out_opts->repeat = 1u;
+
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--repeat") == 0) {
+            char* end_ptr;
+            unsigned long parsed;
+
+            if (i + 1 >= argc) {
+                return 1;
+            }
+            parsed = strtoul(argv[i + 1], &end_ptr, 10);
+            if (end_ptr == argv[i + 1] || *end_ptr != '\0' || parsed == 0ul || parsed > 0xFFFFFFFFul) {
+                return 1;
+            }
+            out_opts->repeat = (uint32_t)parsed;
+            i += 1;
+        } else if (argv[i][0] != '-' && out_opts->path == NULL) {
+            out_opts->path = argv[i];
+        } else {
+            return 1;
+        }
+    }
+
+    return out_opts->path == NULL ? 1 : 0;
+}
+
+static uint8_t* replay_load_file(const char* path, size_t* out_size)
+{
+    FILE* file;
+    uint8_t* data;
+    long length;
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    if (fseek(file, 0, SEEK_END) != 0 || (length = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        (void)fclose(file);
+        return NULL;
+    }
+
+    data = (uint8_t*)malloc(length > 0 ? (size_t)length : 1u);
+    if (data == NULL || fread(data, 1u, (size_t)length, file) != (size_t)length) {
+        free(data);
+        (void)fclose(file);
+        return NULL;
+    }
+    (void)fclose(file);
+    *out_size = (size_t)length;
+    return data;
+}
+
+static int replay_reserve(void** items, uint32_t* capacity, uint32_t index, size_t item_size)
+{
+    uint32_t grown_capacity;
+    void* grown;
+
+    if (index < *capacity) {
+        return 0;
+    }
+    grown_capacity = *capacity == 0u ? 64u : *capacity;
+    while (grown_capacity <= index) {
+        if (grown_capacity > UINT32_MAX / 2u) {
+            return 1;
+        }
+        grown_capacity *= 2u;
+    }
+    grown = realloc(*items, item_size * (size_t)grown_capacity);
+    if (grown == NULL) {
+        return 1;
+    }
+    memset((uint8_t*)grown + item_size * (size_t)*capacity, 0, item_size * (size_t)(grown_capacity - *capacity));
+    *items = grown;
+    *capacity = grown_capacity;
+    return 0;
+}
+
+static lt_entity_t replay_entity(const replay_state_t* state, uint32_t index)
+{
+    return index < state->entity_capacity ? state->entities[index] : LT_ENTITY_NULL;
+}
+
+static lt_component_id_t replay_component(const replay_state_t* state, lt_component_id_t component_id)
+{
+    return component_id < state->component_capacity ? state->components[component_id] : LT_COMPONENT_INVALID;
+}
+
+static lt_status_t replay_register(replay_state_t* state, const lt_record_t* record)
+{
+    lt_component_desc_t desc;
+    lt_component_id_t id;
+    char name[256];
+    uint32_t length;
+    lt_status_t status;
+
+    length = record->name_bytes < sizeof(name) - 1u ? record->name_bytes : (uint32_t)sizeof(name) - 1u;
+    memcpy(name, record->name, length);
+    name[length] = '\0';
+
+    memset(&desc, 0, sizeof(desc));
+    desc.name = name;
+    desc.size = record->size;
+    desc.align = record->align;
+    status = lt_register_component(state->world, &desc, &id);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+    if (replay_reserve(
+            (void**)&state->components,
+            &state->component_capacity,
+            record->component_id,
+            sizeof(*state->components))
+            != 0
+        || replay_reserve((void**)&state->sizes, &state->size_capacity, id, sizeof(*state->sizes)) != 0) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    state->components[record->component_id] = id;
+    state->sizes[id] = record->size;
+    return LT_STATUS_OK;
+}
+
+static lt_status_t replay_define_query(replay_state_t* state, const lt_record_t* record)
+{
+    lt_query_term_t terms[LT_RECORD_MAX_QUERY_TERMS];
+    lt_component_id_t without[LT_RECORD_MAX_QUERY_TERMS];
+    lt_query_desc_t desc;
+    uint32_t i;
+
+    for (i = 0u; i < record->term_count; ++i) {
+        terms[i].component_id = replay_component(state, record->terms[i].component_id);
+        terms[i].access = record->terms[i].access;
+    }
+    for (i = 0u; i < record->without_count; ++i) {
+        without[i] = replay_component(state, record->without[i]);
+    }
+    if (replay_reserve((void**)&state->queries, &state->query_capacity, record->query_id, sizeof(*state->queries))
+        != 0) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    lt_query_destroy(state->queries[record->query_id]);
+    state->queries[record->query_id] = NULL;
+
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = terms;
+    desc.with_count = record->term_count;
+    desc.without = without;
+    desc.without_count = record->without_count;
+    return lt_query_create(state->world, &desc, &state->queries[record->query_id]);
+}
+
+static lt_status_t replay_run_query(replay_state_t* state, uint32_t query_id)
+{
+    lt_query_t* query;
+    lt_query_term_t terms[LT_RECORD_MAX_QUERY_TERMS];
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    uint32_t term_count;
+    uint8_t has_value;
+    lt_status_t status;
+
+    query = query_id < state->query_capacity ? state->queries[query_id] : NULL;
+    if (query == NULL) {
+        return LT_STATUS_NOT_FOUND;
+    }
+    status = lt_query_copy_terms(query, terms, LT_RECORD_MAX_QUERY_TERMS, &term_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_query_iter_begin(query, &iter);
+    while (status == LT_STATUS_OK) {
+        uint32_t c;
+
+        status = lt_query_iter_next(&iter, &view, &has_value);
+        if (status != LT_STATUS_OK || has_value == 0u) {
+            break;
+        }
+        for (c = 0u; c < view.column_count && c < term_count; ++c) {
+            uint8_t* column;
+            size_t bytes;
+            size_t k;
+
+            column = (uint8_t*)view.columns[c];
+            if (column == NULL || terms[c].component_id >= state->size_capacity) {
+                continue;
+            }
+            bytes = (size_t)state->sizes[terms[c].component_id] * (size_t)view.count;
+            if (terms[c].access == LT_ACCESS_WRITE) {
+                for (k = 0u; k < bytes; ++k) {
+                    column[k] = (uint8_t)(column[k] + 1u);
+                }
+            } else {
+                for (k = 0u; k < bytes; ++k) {
+                    state->sink += column[k];
+                }
+            }
+        }
+    }
+    (void)lt_query_iter_end(&iter);
+    return status;
+}
+
+static lt_status_t replay_apply(replay_state_t* state, const lt_record_t* record)
+{
+    lt_entity_t entity;
+    void* ptr;
+    lt_status_t status;
+
+    switch (record->op) {
+        case LT_RECORD_OP_REGISTER:
+            return replay_register(state, record);
+        case LT_RECORD_OP_CREATE:
+            if (replay_reserve(
+                    (void**)&state->entities,
+                    &state->entity_capacity,
+                    record->entity_index,
+                    sizeof(*state->entities))
+                != 0) {
+                return LT_STATUS_ALLOCATION_FAILED;
+            }
+            return lt_entity_create(state->world, &state->entities[record->entity_index]);
+        case LT_RECORD_OP_DESTROY:
+            status = lt_entity_destroy(state->world, replay_entity(state, record->entity_index));
+            if (status == LT_STATUS_OK) {
+                state->entities[record->entity_index] = LT_ENTITY_NULL;
+            }
+            return status;
+        case LT_RECORD_OP_ADD:
+            return lt_add_component(
+                state->world,
+                replay_entity(state, record->entity_index),
+                replay_component(state, record->component_id),
+                record->payload);
+        case LT_RECORD_OP_REMOVE:
+            return lt_remove_component(
+                state->world,
+                replay_entity(state, record->entity_index),
+                replay_component(state, record->component_id));
+        case LT_RECORD_OP_SET:
+            return lt_set_component(
+                state->world,
+                replay_entity(state, record->entity_index),
+                replay_component(state, record->component_id),
+                record->payload);
+        case LT_RECORD_OP_GET:
+            entity = replay_entity(state, record->entity_index);
+            status = lt_get_component(state->world, entity, replay_component(state, record->component_id), &ptr);
+            if (status == LT_STATUS_OK && ptr != NULL) {
+                state->sink += *(const uint8_t*)ptr;
+            }
+            return status;
+        case LT_RECORD_OP_QUERY_DEFINE:
+            return replay_define_query(state, record);
+        case LT_RECORD_OP_QUERY_RUN:
+            return replay_run_query(state, record->query_id);
+        case LT_RECORD_OP_FRAME:
+        default:
+            return LT_STATUS_OK;
+    }
+}
+
+static void replay_state_release(replay_state_t* state)
+{
+    uint32_t i;
+
+    for (i = 0u; i < state->query_capacity; ++i) {
+        lt_query_destroy(state->queries[i]);
+    }
+    lt_world_destroy(state->world);
+    free(state->queries);
+    free(state->sizes);
+    free(state->components);
+    free(state->entities);
+}
+
+static int replay_run(const uint8_t* data, size_t size, size_t offset, replay_run_t* out_run, uint64_t* out_sink)
+{
+    replay_state_t state;
+    lt_record_t record;
+    uint64_t run_start_ns;
+    uint64_t frame_start_ns;
+    lt_status_t status;
+
+    memset(&state, 0, sizeof(state));
+    memset(out_run, 0, sizeof(*out_run));
+    out_run->frame_min_ns = UINT64_MAX;
+    if (lt_world_create(NULL, &state.world) != LT_STATUS_OK) {
+        fprintf(stderr, "Error: failed to create replay world\n");
+        return 1;
+    }
+
+    run_start_ns = replay_now_ns();
+    frame_start_ns = run_start_ns;
+    for (;;) {
+        uint64_t op_start_ns;
+        uint64_t op_end_ns;
+
+        status = lt_record_decode(data, size, &offset, &record);
+        if (status == LT_STATUS_NOT_FOUND) {
+            break;
+        }
+        if (status != LT_STATUS_OK) {
+            fprintf(stderr, "Error: corrupt record at byte %zu\n", offset);
+            replay_state_release(&state);
+            return 1;
+        }
+
+        op_start_ns = replay_now_ns();
+        if (replay_apply(&state, &record) != LT_STATUS_OK) {
+            out_run->failed_ops += 1u;
+        }
+        op_end_ns = replay_now_ns();
+        out_run->ops[record.op].count += 1u;
+        out_run->ops[record.op].total_ns += op_end_ns - op_start_ns;
+
+        if (record.op == LT_RECORD_OP_FRAME) {
+            uint64_t frame_ns;
+
+            frame_ns = op_end_ns - frame_start_ns;
+            frame_start_ns = op_end_ns;
+            out_run->frame_count += 1u;
+            out_run->frame_total_ns += frame_ns;
+            if (frame_ns < out_run->frame_min_ns) {
+                out_run->frame_min_ns = frame_ns;
+            }
+            if (frame_ns > out_run->frame_max_ns) {
+                out_run->frame_max_ns = frame_ns;
+            }
+        }
+    }
+    out_run->total_ns = replay_now_ns() - run_start_ns;
+    if (out_run->frame_count == 0u) {
+        out_run->frame_min_ns = 0u;
+    }
+
+    *out_sink += state.sink;
+    replay_state_release(&state);
+    return 0;
+}
+
+static void replay_print_run(const replay_options_t* opts, const replay_run_t* best, uint64_t records)
+{
+    uint32_t op;
+
+    printf("replay_file=%s\n", opts->path);
+    printf("replay_records=%" PRIu64 "\n", records);
+    printf("replay_runs=%" PRIu32 "\n", opts->repeat);
+    printf("replay_best_total_ms=%.3f\n", (double)best->total_ns / 1000000.0);
+    printf("replay_failed_ops=%" PRIu64 "\n", best->failed_ops);
+    for (op = (uint32_t)LT_RECORD_OP_REGISTER; op < (uint32_t)LT_RECORD_OP_FRAME; ++op) {
+        const replay_op_stats_t* stats;
+
+        stats = &best->ops[op];
+        if (stats->count == 0u) {
+            continue;
+        }
+        printf(
+            "replay_op=%s replay_count=%" PRIu64 " replay_total_ms=%.3f replay_avg_ns=%.1f\n",
+            replay_op_names[op],
+            stats->count,
+            (double)stats->total_ns / 1000000.0,
+            (double)stats->total_ns / (double)stats->count);
+    }
+    printf(
+        "replay_frames=%" PRIu64 " replay_frame_min_ms=%.3f replay_frame_avg_ms=%.3f replay_frame_max_ms=%.3f\n",
+        best->frame_count,
+        (double)best->frame_min_ns / 1000000.0,
+        best->frame_count > 0u ? (double)best->frame_total_ns / (double)best->frame_count / 1000000.0 : 0.0,
+        (double)best->frame_max_ns / 1000000.0);
+}
+
+int main(int argc, char** argv)
+{
+    replay_options_t opts;
+    replay_run_t best;
+    replay_run_t run;
+    lt_record_t record;
+    uint8_t* data;
+    size_t size;
+    size_t offset;
+    size_t cursor;
+    uint64_t records;
+    uint64_t sink;
+    uint32_t i;
+    lt_status_t status;
+
+    if (replay_parse_options(argc, argv, &opts) != 0) {
+        replay_print_usage(argv[0]);
+        return 1;
+    }
+
+    size = 0u;
+    data = replay_load_file(opts.path, &size);
+    if (data == NULL) {
+        fprintf(stderr, "Error: cannot read capture %s\n", opts.path);
+        return 1;
+    }
+    if (lt_record_read_header(data, size, &offset) != LT_STATUS_OK) {
+        fprintf(stderr, "Error: %s is not a lattice capture\n", opts.path);
+        free(data);
+        return 1;
+    }
+
+    records = 0u;
+    cursor = offset;
+    while ((status = lt_record_decode(data, size, &cursor, &record)) == LT_STATUS_OK) {
+        records += 1u;
+    }
+    if (status != LT_STATUS_NOT_FOUND) {
+        fprintf(stderr, "Error: corrupt record at byte %zu\n", cursor);
+        free(data);
+        return 1;
+    }
+
+    sink = 0u;
+    memset(&best, 0, sizeof(best));
+    for (i = 0u; i < opts.repeat; ++i) {
+        if (replay_run(data, size, offset, &run, &sink) != 0) {
+            free(data);
+            return 1;
+        }
+        if (i == 0u || run.total_ns < best.total_ns) {
+            best = run;
+        }
+    }
+
+    replay_print_run(&opts, &best, records);
+    printf("replay_checksum=%" PRIu64 "\n", sink);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef LATTICE_RECORDER_H
+#define LATTICE_RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lattice/types.h"
+#include "lattice/world.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LT_RECORD_MAGIC 0x4352544Cu
+#define LT_RECORD_VERSION 1u
+
+enum {
+    LT_RECORD_MAX_QUERY_TERMS = 32u
+};
+
+typedef enum lt_record_op_e {
+    LT_RECORD_OP_REGISTER = 1,
+    LT_RECORD_OP_CREATE = 2,
+    LT_RECORD_OP_DESTROY = 3,
+    LT_RECORD_OP_ADD = 4,
+    LT_RECORD_OP_REMOVE = 5,
+    LT_RECORD_OP_SET = 6,
+    LT_RECORD_OP_GET = 7,
+    LT_RECORD_OP_QUERY_DEFINE = 8,
+    LT_RECORD_OP_QUERY_RUN = 9,
+    LT_RECORD_OP_FRAME = 10
+} lt_record_op_t;
+
+typedef struct lt_record_header_s {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_bytes;
+    uint32_t max_query_terms;
+} lt_record_header_t;
+
+typedef struct lt_record_s {
+    lt_record_op_t op;
+    uint32_t entity_index;
+    lt_component_id_t component_id;
+    uint32_t query_id;
+    uint32_t size;
+    uint32_t align;
+    const char* name;
+    uint32_t name_bytes;
+    const void* payload;
+    uint32_t payload_size;
+    uint32_t term_count;
+    uint32_t without_count;
+    lt_query_term_t terms[LT_RECORD_MAX_QUERY_TERMS];
+    lt_component_id_t without[LT_RECORD_MAX_QUERY_TERMS];
+} lt_record_t;
+
+typedef struct lt_recorder_s lt_recorder_t;
+
+lt_status_t lt_recorder_create(lt_world_t* world, const char* path, lt_recorder_t** out_recorder);
+void lt_recorder_destroy(lt_recorder_t* recorder);
+lt_status_t lt_recorder_mark_frame(lt_recorder_t* recorder);
+lt_status_t lt_recorder_flush(lt_recorder_t* recorder);
+lt_status_t lt_recorder_get_record_count(const lt_recorder_t* recorder, uint64_t* out_count);
+
+lt_status_t lt_record_read_header(const void* data, size_t size, size_t* out_offset);
+lt_status_t lt_record_decode(const void* data, size_t size, size_t* inout_offset, lt_record_t* out_record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef LATTICE_SHM_EXPORT_H
+#define LATTICE_SHM_EXPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lattice/types.h"
+#include "lattice/world.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LT_SHM_MAGIC 0x4D53544Cu
+#define LT_SHM_VERSION 2u
+
+enum {
+    LT_SHM_NAME_BYTES = 48u,
+    LT_SHM_READ_RETRIES = 64u
+};
+
+typedef struct lt_shm_world_s {
+    uint64_t live_entities;
+    uint64_t entity_capacity;
+    uint64_t allocated_entity_slots;
+    uint64_t free_entity_slots;
+    uint64_t registered_components;
+    uint64_t archetype_count;
+    uint64_t chunk_count;
+    uint64_t chunk_bytes;
+    uint64_t pending_commands;
+    uint64_t structural_moves;
+} lt_shm_world_t;
+
+typedef struct lt_shm_entry_s {
+    char name[LT_SHM_NAME_BYTES];
+    uint32_t schedule_index;
+    uint32_t position;
+    uint64_t last_ns;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t run_count;
+} lt_shm_entry_t;
+
+typedef struct lt_shm_header_s {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_bytes;
+    uint32_t entry_bytes;
+    uint32_t entry_capacity;
+    uint32_t entry_count;
+    uint32_t dropped_entries;
+    uint32_t sequence;
+    uint64_t owner_pid;
+    uint64_t frame;
+    uint64_t publish_ns;
+    lt_shm_world_t world;
+} lt_shm_header_t;
+
+typedef struct lt_shm_export_s lt_shm_export_t;
+
+lt_status_t lt_shm_export_create(const char* name, uint32_t entry_capacity, lt_shm_export_t** out_exporter);
+void lt_shm_export_destroy(lt_shm_export_t* exporter);
+lt_status_t lt_shm_export_publish(
+    lt_shm_export_t* exporter,
+    const lt_world_t* world,
+    const lt_schedule_t* const* schedules,
+    uint32_t schedule_count);
+
+static inline size_t lt_shm_segment_bytes(uint32_t entry_capacity)
+{
+    return sizeof(lt_shm_header_t) + sizeof(lt_shm_entry_t) * (size_t)entry_capacity;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+static inline void lt_shm_copy_words(void* dst, const void* src, size_t bytes)
+{
+    const uint32_t* from;
+    uint32_t* to;
+    size_t i;
+
+    from = (const uint32_t*)src;
+    to = (uint32_t*)dst;
+    for (i = 0u; i < bytes / sizeof(uint32_t); ++i) {
+        to[i] = __atomic_load_n(&from[i], __ATOMIC_ACQUIRE);
+    }
+}
+
+static inline lt_status_t lt_shm_read(
+    const void* segment,
+    size_t segment_bytes,
+    lt_shm_header_t* out_header,
+    lt_shm_entry_t* out_entries,
+    uint32_t max_entries,
+    uint32_t* out_count)
+{
+    const lt_shm_header_t* header;
+    const lt_shm_entry_t* entries;
+    uint32_t attempt;
+
+    if (segment == NULL || out_header == NULL || out_count == NULL || (max_entries > 0u && out_entries == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    *out_count = 0u;
+    if (segment_bytes < sizeof(lt_shm_header_t)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    header = (const lt_shm_header_t*)segment;
+    entries = (const lt_shm_entry_t*)(const void*)((const uint8_t*)segment + sizeof(lt_shm_header_t));
+    if (header->magic != LT_SHM_MAGIC
+        || header->version != LT_SHM_VERSION
+        || header->header_bytes != sizeof(lt_shm_header_t)
+        || header->entry_bytes != sizeof(lt_shm_entry_t)
+        || segment_bytes < lt_shm_segment_bytes(header->entry_capacity)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (attempt = 0u; attempt < LT_SHM_READ_RETRIES; ++attempt) {
+        uint32_t before;
+        uint32_t after;
+        uint32_t count;
+
+        before = __atomic_load_n(&header->sequence, __ATOMIC_ACQUIRE);
+        if ((before & 1u) != 0u) {
+            continue;
+        }
+        lt_shm_copy_words(out_header, header, sizeof(*out_header));
+        count = out_header->entry_count;
+        if (count > out_header->entry_capacity) {
+            count = out_header->entry_capacity;
+        }
+        if (count > max_entries) {
+            count = max_entries;
+        }
+        if (count > 0u) {
+            lt_shm_copy_words(out_entries, entries, sizeof(*out_entries) * (size_t)count);
+        }
+        after = __atomic_load_n(&header->sequence, __ATOMIC_RELAXED);
+        if (before == after) {
+            out_header->sequence = before;
+            *out_count = count;
+            return LT_STATUS_OK;
+        }
+    }
+
+    return LT_STATUS_CONFLICT;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef LATTICE_UNCHECKED_H
+#define LATTICE_UNCHECKED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lattice/types.h"
+#include "lattice/world.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lt_unchecked_chunk_s {
+    struct lt_unchecked_chunk_s* next;
+    uint32_t count;
+    uint32_t capacity;
+    lt_entity_t* entities;
+    uint8_t** columns;
+    uint64_t version;
+} lt_unchecked_chunk_t;
+
+typedef struct lt_unchecked_archetype_s {
+    lt_component_id_t* component_ids;
+    uint32_t component_count;
+} lt_unchecked_archetype_t;
+
+typedef struct lt_unchecked_slot_s {
+    uint32_t generation;
+    uint32_t next_free;
+    uint8_t alive;
+    lt_unchecked_archetype_t* archetype;
+    lt_unchecked_chunk_t* chunk;
+    uint32_t row;
+} lt_unchecked_slot_t;
+
+typedef struct lt_unchecked_component_s {
+    char* name;
+    uint32_t size;
+    uint32_t align;
+    uint32_t flags;
+    lt_component_ctor_fn ctor;
+    lt_component_dtor_fn dtor;
+    lt_component_move_fn move;
+    void* user;
+    lt_component_key_fn key;
+} lt_unchecked_component_t;
+
+typedef struct lt_unchecked_world_s {
+    lt_unchecked_slot_t* entities;
+    uint32_t entity_capacity;
+    uint32_t entity_count;
+    uint32_t live_entity_count;
+    uint32_t free_entity_count;
+    uint32_t free_entity_head;
+    lt_unchecked_component_t* components;
+    uint32_t component_capacity;
+    uint32_t component_count;
+} lt_unchecked_world_t;
+
+static inline const lt_unchecked_slot_t* lt_unchecked_slot(const lt_world_t* world, lt_entity_t entity)
+{
+    return &((const lt_unchecked_world_t*)(const void*)world)->entities[(uint32_t)(entity & 0xFFFFFFFFu)];
+}
+
+static inline uint8_t lt_is_alive_unchecked(const lt_world_t* world, lt_entity_t entity)
+{
+    const lt_unchecked_world_t* w;
+    const lt_unchecked_slot_t* slot;
+    uint32_t index;
+
+    w = (const lt_unchecked_world_t*)(const void*)world;
+    index = (uint32_t)(entity & 0xFFFFFFFFu);
+    if (index >= w->entity_count) {
+        return 0u;
+    }
+    slot = &w->entities[index];
+    return (uint8_t)(slot->alive != 0u && slot->generation == (uint32_t)(entity >> 32u));
+}
+
+static inline uint32_t lt_unchecked_component_index(
+    const lt_unchecked_archetype_t* archetype,
+    lt_component_id_t component_id)
+{
+    uint32_t i;
+
+    for (i = 0u; i < archetype->component_count; ++i) {
+        if (archetype->component_ids[i] == component_id) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static inline uint8_t lt_has_component_unchecked(
+    const lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id)
+{
+    return (uint8_t)(lt_unchecked_component_index(lt_unchecked_slot(world, entity)->archetype, component_id)
+                     != UINT32_MAX);
+}
+
+static inline void* lt_get_component_unchecked(
+    const lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id)
+{
+    const lt_unchecked_world_t* w;
+    const lt_unchecked_slot_t* slot;
+    uint32_t component_index;
+    uint32_t size;
+
+    w = (const lt_unchecked_world_t*)(const void*)world;
+    slot = lt_unchecked_slot(world, entity);
+    component_index = lt_unchecked_component_index(slot->archetype, component_id);
+    if (component_index == UINT32_MAX) {
+        return NULL;
+    }
+    size = w->components[component_id].size;
+    if (size == 0u) {
+        return NULL;
+    }
+    return (void*)(slot->chunk->columns[component_index] + (size_t)size * (size_t)slot->row);
+}
+
+static inline void* lt_component_ref_ptr_unchecked(const lt_world_t* world, const lt_component_ref_t* ref)
+{
+    const lt_unchecked_slot_t* slot;
+
+    slot = lt_unchecked_slot(world, ref->entity);
+    if ((const void*)slot->chunk != ref->chunk || slot->row != ref->row || slot->chunk->version != ref->version
+        || slot->generation != (uint32_t)(ref->entity >> 32u) || slot->alive == 0u) {
+        return NULL;
+    }
+    return ref->ptr;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,6 +13,9 @@ extern "C" {
 typedef struct lt_world_s lt_world_t;
 typedef struct lt_query_s lt_query_t;
 typedef struct lt_schedule_s lt_schedule_t;
+typedef struct lt_task_graph_s lt_task_graph_t;
+typedef struct lt_epoch_s lt_epoch_t;
+typedef uint32_t lt_task_id_t;
 
 typedef void* (*lt_alloc_fn)(void* user, size_t size, size_t align);
 typedef void (*lt_free_fn)(void* user, void* ptr, size_t size, size_t align);
@@ -32,6 +35,8 @@ enum {
 typedef void (*lt_component_ctor_fn)(void* dst, uint32_t count, void* user);
 typedef void (*lt_component_dtor_fn)(void* dst, uint32_t count, void* user);
 typedef void (*lt_component_move_fn)(void* dst, const void* src, uint32_t count, void* user);
+typedef double (*lt_component_key_fn)(const void* value, void* user);
+typedef int (*lt_component_compare_fn)(const void* lhs, const void* rhs, void* user);
 
 typedef struct lt_component_desc_s {
     const char* name;
@@ -42,6 +47,7 @@ typedef struct lt_component_desc_s {
     lt_component_dtor_fn dtor;
     lt_component_move_fn move;
     void* user;
+    lt_component_key_fn key;
 } lt_component_desc_t;
 
 typedef struct lt_world_config_s {
@@ -49,6 +55,7 @@ typedef struct lt_world_config_s {
     uint32_t initial_entity_capacity;
     uint32_t initial_component_capacity;
     uint32_t target_chunk_bytes;
+    uint32_t empty_archetype_reclaim_flushes;
 } lt_world_config_t;
 
 typedef struct lt_world_stats_s {
@@ -62,8 +69,41 @@ typedef struct lt_world_stats_s {
     uint32_t pending_commands;
     uint32_t defer_depth;
     uint64_t structural_moves;
+    uint64_t chunk_bytes;
 } lt_world_stats_t;
 
+typedef struct lt_transition_stats_s {
+    const lt_component_id_t* src_component_ids;
+    const lt_component_id_t* dst_component_ids;
+    uint32_t src_component_count;
+    uint32_t dst_component_count;
+    uint64_t move_count;
+    uint64_t bytes_moved;
+} lt_transition_stats_t;
+
+typedef struct lt_component_transition_stats_s {
+    uint64_t add_count;
+    uint64_t remove_count;
+    uint64_t bytes_moved;
+} lt_component_transition_stats_t;
+
+typedef struct lt_component_access_stats_s {
+    uint64_t read_rows;
+    uint64_t write_rows;
+    uint64_t random_lookups;
+    uint64_t moved_bytes;
+} lt_component_access_stats_t;
+
+typedef struct lt_component_ref_s {
+    lt_entity_t entity;
+    const void* chunk;
+    uint64_t version;
+    void* ptr;
+    lt_component_id_t component_id;
+    uint32_t row;
+    uint32_t column;
+} lt_component_ref_t;
+
 typedef enum lt_trace_event_kind_e {
     LT_TRACE_EVENT_DEFER_BEGIN = 1,
     LT_TRACE_EVENT_DEFER_END = 2,
@@ -77,7 +117,11 @@ typedef enum lt_trace_event_kind_e {
     LT_TRACE_EVENT_COMPONENT_REMOVE = 10,
     LT_TRACE_EVENT_QUERY_ITER_BEGIN = 11,
     LT_TRACE_EVENT_QUERY_ITER_CHUNK = 12,
-    LT_TRACE_EVENT_QUERY_ITER_END = 13
+    LT_TRACE_EVENT_QUERY_ITER_END = 13,
+    LT_TRACE_EVENT_QUERY_DISPATCH = 14,
+    LT_TRACE_EVENT_COMPONENT_SET = 15,
+    LT_TRACE_EVENT_COMPONENT_GET = 16,
+    LT_TRACE_EVENT_COMPONENT_REGISTER = 17
 } lt_trace_event_kind_t;
 
 typedef struct lt_trace_event_s {
@@ -89,6 +133,9 @@ typedef struct lt_trace_event_s {
     uint32_t live_entities;
     uint32_t pending_commands;
     uint32_t defer_depth;
+    const lt_query_t* query;
+    const void* payload;
+    uint32_t payload_size;
 } lt_trace_event_t;
 
 typedef void (*lt_trace_hook_fn)(const lt_trace_event_t* event, void* user_data);
@@ -103,11 +150,27 @@ typedef struct lt_query_term_s {
     lt_access_t access;
 } lt_query_term_t;
 
+typedef struct lt_query_range_s {
+    lt_component_id_t component_id;
+    double min;
+    double max;
+} lt_query_range_t;
+
+typedef uint64_t (*lt_query_group_fn)(
+    const lt_component_id_t* component_ids,
+    uint32_t component_count,
+    void* user_data);
+
 typedef struct lt_query_desc_s {
     const lt_query_term_t* with_terms;
     uint32_t with_count;
     const lt_component_id_t* without;
     uint32_t without_count;
+    const lt_query_range_t* ranges;
+    uint32_t range_count;
+    lt_query_group_fn group_by;
+    void* group_by_user_data;
+    uint8_t auto_defer;
 } lt_query_desc_t;
 
 typedef struct lt_chunk_view_s {
@@ -115,6 +178,10 @@ typedef struct lt_chunk_view_s {
     const lt_entity_t* entities;
     void** columns;
     uint32_t column_count;
+    uint64_t group_id;
+    uint8_t group_begin;
+    const uint32_t* rows;
+    uint32_t row_count;
 } lt_chunk_view_t;
 
 typedef void (*lt_query_parallel_chunk_fn)(
@@ -122,25 +189,88 @@ typedef void (*lt_query_parallel_chunk_fn)(
     uint32_t worker_index,
     void* user_data);
 
+typedef void (*lt_task_fn)(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data);
+
+typedef uint32_t lt_event_channel_id_t;
+
+typedef struct lt_event_channel_desc_s {
+    uint32_t event_size;
+    uint32_t align;
+    uint32_t worker_count;
+    uint32_t initial_capacity;
+} lt_event_channel_desc_t;
+
+typedef struct lt_event_access_s {
+    lt_event_channel_id_t channel;
+    lt_access_t access;
+} lt_event_access_t;
+
+typedef struct lt_epoch_info_s {
+    uint64_t id;
+    uint32_t live_entity_count;
+    uint32_t chunk_count;
+    uint32_t shared_chunk_count;
+} lt_epoch_info_t;
+
+typedef void (*lt_epoch_chunk_fn)(const lt_chunk_view_t* view, void* user_data);
+
 typedef struct lt_query_schedule_entry_s {
     lt_query_t* query;
     lt_query_parallel_chunk_fn callback;
     void* user_data;
 } lt_query_schedule_entry_t;
 
+#define LT_SCHEDULE_ENTRY_DECL_VERSION 1u
+
+typedef struct lt_schedule_entry_decl_s {
+    uint32_t version;
+    const char* name;
+    const lt_event_access_t* events;
+    uint32_t event_count;
+    const lt_query_term_t* random_access;
+    uint32_t random_access_count;
+} lt_schedule_entry_decl_t;
+
+typedef enum lt_access_violation_kind_e {
+    LT_ACCESS_VIOLATION_UNDECLARED_READ = 1,
+    LT_ACCESS_VIOLATION_UNDECLARED_WRITE = 2,
+    LT_ACCESS_VIOLATION_READ_COLUMN_WRITE = 3
+} lt_access_violation_kind_t;
+
+typedef struct lt_access_violation_s {
+    lt_access_violation_kind_t kind;
+    const char* system_name;
+    const char* component_name;
+    lt_component_id_t component_id;
+    lt_entity_t entity;
+    uint32_t worker_index;
+} lt_access_violation_t;
+
+typedef void (*lt_access_violation_fn)(const lt_access_violation_t* violation, void* user_data);
+
 typedef struct lt_query_schedule_stats_s {
     uint32_t batch_count;
     uint32_t edge_count;
     uint32_t max_batch_size;
 } lt_query_schedule_stats_t;
 
+typedef struct lt_schedule_entry_timing_s {
+    uint64_t last_ns;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t run_count;
+} lt_schedule_entry_timing_t;
+
 typedef struct lt_query_iter_s {
     lt_query_t* query;
     uint32_t archetype_index;
     void* chunk_cursor;
     void** columns;
     uint32_t column_capacity;
+    uint64_t group_id;
+    uint8_t group_started;
     uint8_t finished;
+    uint8_t deferring;
 } lt_query_iter_t;
 
 lt_status_t lt_world_create(const lt_world_config_t* cfg, lt_world_t** out_world);
@@ -152,6 +282,8 @@ lt_status_t lt_world_begin_defer(lt_world_t* world);
 lt_status_t lt_world_end_defer(lt_world_t* world);
 lt_status_t lt_world_flush(lt_world_t* world);
 lt_status_t lt_world_set_trace_hook(lt_world_t* world, lt_trace_hook_fn hook, void* user_data);
+lt_status_t lt_world_set_access_checks(lt_world_t* world, uint8_t enabled);
+lt_status_t lt_world_set_access_violation_hook(lt_world_t* world, lt_access_violation_fn hook, void* user_data);
 
 lt_status_t lt_entity_create(lt_world_t* world, lt_entity_t* out_entity);
 lt_status_t lt_entity_destroy(lt_world_t* world, lt_entity_t entity);
@@ -168,6 +300,38 @@ lt_status_t lt_remove_component(
     lt_entity_t entity,
     lt_component_id_t component_id);
 
+lt_status_t lt_add_components(
+    lt_world_t* world,
+    lt_entity_t entity,
+    const lt_component_id_t* component_ids,
+    const void* const* initial_values,
+    uint32_t component_count);
+
+lt_status_t lt_remove_components(
+    lt_world_t* world,
+    lt_entity_t entity,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count);
+
+lt_status_t lt_set_component(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void* value);
+
+lt_status_t lt_add_component_batch(
+    lt_world_t* world,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    lt_component_id_t component_id,
+    const void* initial_values);
+
+lt_status_t lt_remove_component_batch(
+    lt_world_t* world,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    lt_component_id_t component_id);
+
 lt_status_t lt_has_component(
     const lt_world_t* world,
     lt_entity_t entity,
@@ -180,6 +344,13 @@ lt_status_t lt_get_component(
     lt_component_id_t component_id,
     void** out_ptr);
 
+lt_status_t lt_component_ref_init(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    lt_component_ref_t* out_ref);
+lt_status_t lt_component_ref_get(lt_world_t* world, lt_component_ref_t* ref, void** out_ptr);
+
 lt_status_t lt_register_component(
     lt_world_t* world,
     const lt_component_desc_t* desc,
@@ -216,25 +387,125 @@ lt_status_t lt_world_copy_entity_components(
     uint32_t* out_count);
 
 lt_status_t lt_world_get_stats(const lt_world_t* world, lt_world_stats_t* out_stats);
+lt_status_t lt_world_set_transition_tracking(lt_world_t* world, uint8_t enabled);
+lt_status_t lt_world_reset_transition_stats(lt_world_t* world);
+lt_status_t lt_world_get_transition_count(const lt_world_t* world, uint32_t* out_count);
+lt_status_t lt_world_copy_transitions(
+    const lt_world_t* world,
+    lt_transition_stats_t* out_transitions,
+    uint32_t max_transitions,
+    uint32_t* out_count);
+lt_status_t lt_component_get_transition_stats(
+    const lt_world_t* world,
+    lt_component_id_t component_id,
+    lt_component_transition_stats_t* out_stats);
+lt_status_t lt_world_set_access_counting(lt_world_t* world, uint8_t enabled);
+lt_status_t lt_world_reset_access_stats(lt_world_t* world);
+lt_status_t lt_component_get_access_stats(
+    const lt_world_t* world,
+    lt_component_id_t component_id,
+    lt_component_access_stats_t* out_stats);
+
+lt_status_t lt_event_channel_create(
+    lt_world_t* world,
+    const lt_event_channel_desc_t* desc,
+    lt_event_channel_id_t* out_id);
+lt_status_t lt_event_write(
+    lt_world_t* world,
+    lt_event_channel_id_t channel,
+    uint32_t worker_index,
+    const void* event);
+lt_status_t lt_event_read(
+    const lt_world_t* world,
+    lt_event_channel_id_t channel,
+    const void** out_events,
+    uint32_t* out_count);
+lt_status_t lt_world_swap_events(lt_world_t* world);
+
+lt_status_t lt_world_publish_epoch(lt_world_t* world, uint64_t* out_epoch_id);
+lt_status_t lt_epoch_pin(lt_world_t* world, const lt_epoch_t** out_epoch);
+lt_status_t lt_epoch_release(lt_world_t* world, const lt_epoch_t* epoch);
+lt_status_t lt_epoch_get_info(const lt_epoch_t* epoch, lt_epoch_info_t* out_info);
+lt_status_t lt_epoch_get_component(
+    const lt_epoch_t* epoch,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void** out_ptr);
+lt_status_t lt_epoch_for_each_chunk(
+    const lt_epoch_t* epoch,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count,
+    lt_epoch_chunk_fn callback,
+    void* user_data);
 
 lt_status_t lt_query_create(lt_world_t* world, const lt_query_desc_t* desc, lt_query_t** out_query);
 void lt_query_destroy(lt_query_t* query);
 lt_status_t lt_query_refresh(lt_query_t* query);
+lt_status_t lt_query_copy_terms(
+    const lt_query_t* query,
+    lt_query_term_t* out_terms,
+    uint32_t max_terms,
+    uint32_t* out_count);
+lt_status_t lt_query_copy_without(
+    const lt_query_t* query,
+    lt_component_id_t* out_component_ids,
+    uint32_t max_component_ids,
+    uint32_t* out_count);
+lt_status_t lt_query_count(
+    lt_query_t* query,
+    uint32_t* out_entity_count,
+    uint32_t* out_chunk_count);
+lt_status_t lt_query_sort(
+    lt_query_t* query,
+    lt_component_id_t component_id,
+    lt_component_key_fn key,
+    lt_component_compare_fn compare,
+    void* user);
+lt_status_t lt_query_add_tag(lt_query_t* query, lt_component_id_t tag_id);
+lt_status_t lt_query_remove_tag(lt_query_t* query, lt_component_id_t tag_id);
 lt_status_t lt_query_iter_begin(lt_query_t* query, lt_query_iter_t* out_iter);
 lt_status_t lt_query_iter_next(
     lt_query_iter_t* iter,
     lt_chunk_view_t* out_view,
     uint8_t* out_has_value);
+lt_status_t lt_query_iter_end(lt_query_iter_t* iter);
 lt_status_t lt_query_for_each_chunk_parallel(
     lt_query_t* query,
     uint32_t worker_count,
     lt_query_parallel_chunk_fn callback,
     void* user_data);
+lt_status_t lt_query_for_each_subset_chunk(
+    lt_query_t* query,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    uint32_t worker_count,
+    lt_query_parallel_chunk_fn callback,
+    void* user_data);
 lt_status_t lt_schedule_create(
     const lt_query_schedule_entry_t* entries,
     uint32_t entry_count,
     lt_schedule_t** out_schedule);
+lt_status_t lt_schedule_create_with_decls(
+    const lt_query_schedule_entry_t* entries,
+    const lt_schedule_entry_decl_t* decls,
+    uint32_t entry_count,
+    lt_schedule_t** out_schedule);
 void lt_schedule_destroy(lt_schedule_t* schedule);
+lt_status_t lt_schedule_insert_entry(
+    lt_schedule_t* schedule,
+    uint32_t position,
+    const lt_query_schedule_entry_t* entry,
+    const lt_schedule_entry_decl_t* decl);
+lt_status_t lt_schedule_remove_entry(lt_schedule_t* schedule, uint32_t position);
+lt_status_t lt_schedule_set_entry_enabled(lt_schedule_t* schedule, uint32_t position, uint8_t enabled);
+lt_status_t lt_schedule_get_stats(const lt_schedule_t* schedule, lt_query_schedule_stats_t* out_stats);
+lt_status_t lt_schedule_set_profiling(lt_schedule_t* schedule, uint8_t enabled);
+lt_status_t lt_schedule_get_entry_count(const lt_schedule_t* schedule, uint32_t* out_count);
+lt_status_t lt_schedule_get_entry_name(const lt_schedule_t* schedule, uint32_t position, const char** out_name);
+lt_status_t lt_schedule_get_entry_timing(
+    const lt_schedule_t* schedule,
+    uint32_t position,
+    lt_schedule_entry_timing_t* out_timing);
 lt_status_t lt_schedule_execute(
     lt_schedule_t* schedule,
     uint32_t worker_count,
@@ -244,6 +515,46 @@ lt_status_t lt_query_schedule_execute(
     uint32_t entry_count,
     uint32_t worker_count,
     lt_query_schedule_stats_t* out_stats);
+lt_status_t lt_query_schedule_execute_with_decls(
+    const lt_query_schedule_entry_t* entries,
+    const lt_schedule_entry_decl_t* decls,
+    uint32_t entry_count,
+    uint32_t worker_count,
+    lt_query_schedule_stats_t* out_stats);
+
+lt_status_t lt_task_graph_create(lt_task_graph_t** out_graph);
+void lt_task_graph_destroy(lt_task_graph_t* graph);
+lt_status_t lt_task_graph_add_task(
+    lt_task_graph_t* graph,
+    lt_task_fn fn,
+    void* user_data,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id);
+lt_status_t lt_task_graph_add_parallel_for(
+    lt_task_graph_t* graph,
+    lt_task_fn fn,
+    void* user_data,
+    uint32_t count,
+    uint32_t grain,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id);
+lt_status_t lt_task_graph_add_query(
+    lt_task_graph_t* graph,
+    lt_query_t* query,
+    lt_query_parallel_chunk_fn callback,
+    void* user_data,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id);
+lt_status_t lt_task_graph_add_schedule(
+    lt_task_graph_t* graph,
+    lt_schedule_t* schedule,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id);
+lt_status_t lt_task_graph_execute(lt_task_graph_t* graph, uint32_t worker_count);
 
 #ifdef __cplusplus
 }
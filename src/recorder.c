@@ -0,0 +1,628 @@
+#include "lattice/recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+#include <pthread.h>
+#endif
+
+enum {
+    LT_RECORDER_BUFFER_BYTES = 64u * 1024u
+};
+
+typedef struct lt_recorder_query_s {
+    const lt_query_t* query;
+    uint64_t shape_hash;
+    uint32_t id;
+} lt_recorder_query_t;
+
+struct lt_recorder_s {
+    lt_world_t* world;
+    FILE* file;
+    uint8_t* buffer;
+    size_t buffer_used;
+    lt_recorder_query_t* queries;
+    uint32_t query_count;
+    uint32_t query_capacity;
+    uint32_t next_query_id;
+    uint64_t record_count;
+    lt_status_t error;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    pthread_mutex_t mutex;
+#endif
+};
+
+static void lt_recorder_lock(lt_recorder_t* recorder)
+{
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    (void)pthread_mutex_lock(&recorder->mutex);
+#else
+    (void)recorder;
+#endif
+}
+
+static void lt_recorder_unlock(lt_recorder_t* recorder)
+{
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    (void)pthread_mutex_unlock(&recorder->mutex);
+#else
+    (void)recorder;
+#endif
+}
+
+static void lt_recorder_drain(lt_recorder_t* recorder)
+{
+    if (recorder->buffer_used == 0u) {
+        return;
+    }
+    if (recorder->error == LT_STATUS_OK
+        && fwrite(recorder->buffer, 1u, recorder->buffer_used, recorder->file) != recorder->buffer_used) {
+        recorder->error = LT_STATUS_CAPACITY_REACHED;
+    }
+    recorder->buffer_used = 0u;
+}
+
+static void lt_recorder_write(lt_recorder_t* recorder, const void* bytes, size_t size)
+{
+    if (size > LT_RECORDER_BUFFER_BYTES - recorder->buffer_used) {
+        lt_recorder_drain(recorder);
+    }
+    if (size > LT_RECORDER_BUFFER_BYTES) {
+        if (recorder->error == LT_STATUS_OK && fwrite(bytes, 1u, size, recorder->file) != size) {
+            recorder->error = LT_STATUS_CAPACITY_REACHED;
+        }
+        return;
+    }
+    memcpy(recorder->buffer + recorder->buffer_used, bytes, size);
+    recorder->buffer_used += size;
+}
+
+static void lt_recorder_begin(lt_recorder_t* recorder, lt_record_op_t op)
+{
+    uint8_t code;
+
+    code = (uint8_t)op;
+    lt_recorder_write(recorder, &code, 1u);
+    recorder->record_count += 1u;
+}
+
+static void lt_recorder_write_u32(lt_recorder_t* recorder, uint32_t value)
+{
+    lt_recorder_write(recorder, &value, sizeof(value));
+}
+
+static void lt_recorder_emit_register(lt_recorder_t* recorder, lt_component_id_t component_id)
+{
+    const char* name;
+    uint32_t size;
+    uint32_t align;
+    uint32_t flags;
+    uint32_t name_bytes;
+
+    name = NULL;
+    size = 0u;
+    align = 0u;
+    if (lt_component_get_layout(recorder->world, component_id, &size, &align, &flags) != LT_STATUS_OK) {
+        return;
+    }
+    (void)lt_component_get_name(recorder->world, component_id, &name);
+    name_bytes = name != NULL ? (uint32_t)strlen(name) : 0u;
+
+    lt_recorder_begin(recorder, LT_RECORD_OP_REGISTER);
+    lt_recorder_write_u32(recorder, component_id);
+    lt_recorder_write_u32(recorder, size);
+    lt_recorder_write_u32(recorder, align);
+    lt_recorder_write_u32(recorder, name_bytes);
+    lt_recorder_write(recorder, name, name_bytes);
+}
+
+static void lt_recorder_emit_entity(lt_recorder_t* recorder, lt_record_op_t op, lt_entity_t entity)
+{
+    lt_recorder_begin(recorder, op);
+    lt_recorder_write_u32(recorder, (uint32_t)(entity & 0xFFFFFFFFu));
+}
+
+static void lt_recorder_emit_component(
+    lt_recorder_t* recorder,
+    lt_record_op_t op,
+    lt_entity_t entity,
+    lt_component_id_t component_id)
+{
+    lt_recorder_begin(recorder, op);
+    lt_recorder_write_u32(recorder, (uint32_t)(entity & 0xFFFFFFFFu));
+    lt_recorder_write_u32(recorder, component_id);
+}
+
+static void lt_recorder_emit_value(
+    lt_recorder_t* recorder,
+    lt_record_op_t op,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void* payload,
+    uint32_t payload_size)
+{
+    lt_recorder_emit_component(recorder, op, entity, component_id);
+    lt_recorder_write_u32(recorder, payload != NULL ? payload_size : 0u);
+    if (payload != NULL) {
+        lt_recorder_write(recorder, payload, payload_size);
+    }
+}
+
+static uint64_t lt_recorder_hash_bytes(uint64_t hash, const void* bytes, size_t size)
+{
+    const uint8_t* cursor;
+    size_t i;
+
+    cursor = (const uint8_t*)bytes;
+    for (i = 0u; i < size; ++i) {
+        hash ^= cursor[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void lt_recorder_emit_query_run(lt_recorder_t* recorder, const lt_query_t* query)
+{
+    lt_query_term_t terms[LT_RECORD_MAX_QUERY_TERMS];
+    lt_component_id_t without[LT_RECORD_MAX_QUERY_TERMS];
+    lt_recorder_query_t* entry;
+    uint32_t term_count;
+    uint32_t without_count;
+    uint64_t shape_hash;
+    uint32_t i;
+
+    if (lt_query_copy_terms(query, terms, LT_RECORD_MAX_QUERY_TERMS, &term_count) != LT_STATUS_OK
+        || lt_query_copy_without(query, without, LT_RECORD_MAX_QUERY_TERMS, &without_count) != LT_STATUS_OK) {
+        return;
+    }
+    shape_hash = lt_recorder_hash_bytes(14695981039346656037ull, terms, sizeof(*terms) * (size_t)term_count);
+    shape_hash = lt_recorder_hash_bytes(shape_hash, without, sizeof(*without) * (size_t)without_count);
+
+    entry = NULL;
+    for (i = 0u; i < recorder->query_count; ++i) {
+        if (recorder->queries[i].query == query) {
+            entry = &recorder->queries[i];
+            break;
+        }
+    }
+
+    if (entry == NULL) {
+        if (recorder->query_count == recorder->query_capacity) {
+            lt_recorder_query_t* grown;
+            uint32_t capacity;
+
+            capacity = recorder->query_capacity == 0u ? 16u : recorder->query_capacity * 2u;
+            grown = (lt_recorder_query_t*)realloc(recorder->queries, sizeof(*grown) * (size_t)capacity);
+            if (grown == NULL) {
+                recorder->error = LT_STATUS_ALLOCATION_FAILED;
+                return;
+            }
+            recorder->queries = grown;
+            recorder->query_capacity = capacity;
+        }
+        entry = &recorder->queries[recorder->query_count];
+        recorder->query_count += 1u;
+        entry->query = query;
+        entry->shape_hash = shape_hash + 1u;
+    }
+
+    if (entry->shape_hash != shape_hash) {
+        recorder->next_query_id += 1u;
+        entry->shape_hash = shape_hash;
+        entry->id = recorder->next_query_id;
+
+        lt_recorder_begin(recorder, LT_RECORD_OP_QUERY_DEFINE);
+        lt_recorder_write_u32(recorder, entry->id);
+        lt_recorder_write_u32(recorder, term_count);
+        for (i = 0u; i < term_count; ++i) {
+            lt_recorder_write_u32(recorder, terms[i].component_id);
+            lt_recorder_write_u32(recorder, (uint32_t)terms[i].access);
+        }
+        lt_recorder_write_u32(recorder, without_count);
+        for (i = 0u; i < without_count; ++i) {
+            lt_recorder_write_u32(recorder, without[i]);
+        }
+    }
+
+    lt_recorder_begin(recorder, LT_RECORD_OP_QUERY_RUN);
+    lt_recorder_write_u32(recorder, entry->id);
+}
+
+static void lt_recorder_on_event(const lt_trace_event_t* event, void* user_data)
+{
+    lt_recorder_t* recorder;
+
+    recorder = (lt_recorder_t*)user_data;
+    if (event->status != LT_STATUS_OK) {
+        return;
+    }
+
+    lt_recorder_lock(recorder);
+    switch (event->kind) {
+        case LT_TRACE_EVENT_COMPONENT_REGISTER:
+            lt_recorder_emit_register(recorder, event->component_id);
+            break;
+        case LT_TRACE_EVENT_ENTITY_CREATE:
+            lt_recorder_emit_entity(recorder, LT_RECORD_OP_CREATE, event->entity);
+            break;
+        case LT_TRACE_EVENT_ENTITY_DESTROY:
+            lt_recorder_emit_entity(recorder, LT_RECORD_OP_DESTROY, event->entity);
+            break;
+        case LT_TRACE_EVENT_COMPONENT_ADD:
+            lt_recorder_emit_value(
+                recorder,
+                LT_RECORD_OP_ADD,
+                event->entity,
+                event->component_id,
+                event->payload,
+                event->payload_size);
+            break;
+        case LT_TRACE_EVENT_COMPONENT_REMOVE:
+            lt_recorder_emit_component(recorder, LT_RECORD_OP_REMOVE, event->entity, event->component_id);
+            break;
+        case LT_TRACE_EVENT_COMPONENT_SET:
+            lt_recorder_emit_value(
+                recorder,
+                LT_RECORD_OP_SET,
+                event->entity,
+                event->component_id,
+                event->payload,
+                event->payload_size);
+            break;
+        case LT_TRACE_EVENT_COMPONENT_GET:
+            lt_recorder_emit_component(recorder, LT_RECORD_OP_GET, event->entity, event->component_id);
+            break;
+        case LT_TRACE_EVENT_QUERY_ITER_BEGIN:
+        case LT_TRACE_EVENT_QUERY_DISPATCH:
+            if (event->query != NULL) {
+                lt_recorder_emit_query_run(recorder, event->query);
+            }
+            break;
+        default:
+            break;
+    }
+    lt_recorder_unlock(recorder);
+}
+
+static lt_status_t lt_recorder_snapshot(lt_recorder_t* recorder)
+{
+    lt_world_t* world;
+    lt_component_id_t* component_ids;
+    lt_world_stats_t stats;
+    lt_query_desc_t desc;
+    lt_query_t* query;
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    uint32_t count;
+    uint32_t i;
+    uint8_t has_value;
+    lt_status_t status;
+
+    world = recorder->world;
+    status = lt_world_get_stats(world, &stats);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+    if (stats.pending_commands > 0u || stats.defer_depth > 0u) {
+        return LT_STATUS_CONFLICT;
+    }
+
+    component_ids = NULL;
+    if (stats.registered_components > 0u) {
+        component_ids = (lt_component_id_t*)malloc(sizeof(*component_ids) * (size_t)stats.registered_components);
+        if (component_ids == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+    }
+    status = lt_world_copy_component_ids(world, component_ids, stats.registered_components, &count);
+    if (status != LT_STATUS_OK) {
+        free(component_ids);
+        return status;
+    }
+    for (i = 0u; i < count; ++i) {
+        lt_recorder_emit_register(recorder, component_ids[i]);
+    }
+
+    if (stats.live_entities == 0u) {
+        free(component_ids);
+        return LT_STATUS_OK;
+    }
+
+    memset(&desc, 0, sizeof(desc));
+    status = lt_query_create(world, &desc, &query);
+    if (status != LT_STATUS_OK) {
+        free(component_ids);
+        return status;
+    }
+    status = lt_query_iter_begin(query, &iter);
+    while (status == LT_STATUS_OK) {
+        status = lt_query_iter_next(&iter, &view, &has_value);
+        if (status != LT_STATUS_OK || has_value == 0u) {
+            break;
+        }
+        for (i = 0u; i < view.count; ++i) {
+            uint32_t c;
+
+            lt_recorder_emit_entity(recorder, LT_RECORD_OP_CREATE, view.entities[i]);
+            status = lt_world_copy_entity_components(
+                world,
+                view.entities[i],
+                component_ids,
+                stats.registered_components,
+                &count);
+            if (status != LT_STATUS_OK) {
+                break;
+            }
+            for (c = 0u; c < count; ++c) {
+                void* ptr;
+                uint32_t size;
+                uint32_t align;
+                uint32_t flags;
+
+                ptr = NULL;
+                size = 0u;
+                (void)lt_component_get_layout(world, component_ids[c], &size, &align, &flags);
+                if (size > 0u && lt_get_component(world, view.entities[i], component_ids[c], &ptr) != LT_STATUS_OK) {
+                    ptr = NULL;
+                }
+                lt_recorder_emit_value(recorder, LT_RECORD_OP_ADD, view.entities[i], component_ids[c], ptr, size);
+            }
+        }
+    }
+    (void)lt_query_iter_end(&iter);
+    lt_query_destroy(query);
+    free(component_ids);
+    return status;
+}
+
+lt_status_t lt_recorder_create(lt_world_t* world, const char* path, lt_recorder_t** out_recorder)
+{
+    lt_recorder_t* recorder;
+    lt_record_header_t header;
+    lt_status_t status;
+
+    if (out_recorder == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    *out_recorder = NULL;
+    if (world == NULL || path == NULL || path[0] == '\0') {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    recorder = (lt_recorder_t*)malloc(sizeof(*recorder));
+    if (recorder == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->world = world;
+    recorder->buffer = (uint8_t*)malloc(LT_RECORDER_BUFFER_BYTES);
+    if (recorder->buffer == NULL) {
+        free(recorder);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    recorder->file = fopen(path, "wb");
+    if (recorder->file == NULL) {
+        free(recorder->buffer);
+        free(recorder);
+        return LT_STATUS_NOT_FOUND;
+    }
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    if (pthread_mutex_init(&recorder->mutex, NULL) != 0) {
+        (void)fclose(recorder->file);
+        free(recorder->buffer);
+        free(recorder);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+#endif
+
+    memset(&header, 0, sizeof(header));
+    header.magic = LT_RECORD_MAGIC;
+    header.version = LT_RECORD_VERSION;
+    header.header_bytes = (uint32_t)sizeof(header);
+    header.max_query_terms = LT_RECORD_MAX_QUERY_TERMS;
+    lt_recorder_write(recorder, &header, sizeof(header));
+
+    status = lt_recorder_snapshot(recorder);
+    if (status == LT_STATUS_OK) {
+        status = lt_world_set_trace_hook(world, lt_recorder_on_event, recorder);
+    }
+    if (status != LT_STATUS_OK) {
+        recorder->world = NULL;
+        lt_recorder_destroy(recorder);
+        return status;
+    }
+
+    *out_recorder = recorder;
+    return LT_STATUS_OK;
+}
+
+void lt_recorder_destroy(lt_recorder_t* recorder)
+{
+    if (recorder == NULL) {
+        return;
+    }
+
+    if (recorder->world != NULL) {
+        (void)lt_world_set_trace_hook(recorder->world, NULL, NULL);
+    }
+    lt_recorder_drain(recorder);
+    (void)fclose(recorder->file);
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    (void)pthread_mutex_destroy(&recorder->mutex);
+#endif
+    free(recorder->queries);
+    free(recorder->buffer);
+    free(recorder);
+}
+
+lt_status_t lt_recorder_mark_frame(lt_recorder_t* recorder)
+{
+    lt_status_t status;
+
+    if (recorder == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    lt_recorder_lock(recorder);
+    lt_recorder_begin(recorder, LT_RECORD_OP_FRAME);
+    status = recorder->error;
+    lt_recorder_unlock(recorder);
+    return status;
+}
+
+lt_status_t lt_recorder_flush(lt_recorder_t* recorder)
+{
+    lt_status_t status;
+
+    if (recorder == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    lt_recorder_lock(recorder);
+    lt_recorder_drain(recorder);
+    if (recorder->error == LT_STATUS_OK && fflush(recorder->file) != 0) {
+        recorder->error = LT_STATUS_CAPACITY_REACHED;
+    }
+    status = recorder->error;
+    lt_recorder_unlock(recorder);
+    return status;
+}
+
+lt_status_t lt_recorder_get_record_count(const lt_recorder_t* recorder, uint64_t* out_count)
+{
+    if (recorder == NULL || out_count == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_count = recorder->record_count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_record_read_header(const void* data, size_t size, size_t* out_offset)
+{
+    lt_record_header_t header;
+
+    if (data == NULL || out_offset == NULL || size < sizeof(header)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != LT_RECORD_MAGIC
+        || header.version != LT_RECORD_VERSION
+        || header.header_bytes < sizeof(header)
+        || header.header_bytes > size
+        || header.max_query_terms > LT_RECORD_MAX_QUERY_TERMS) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_offset = header.header_bytes;
+    return LT_STATUS_OK;
+}
+
+static int lt_record_read_u32(const uint8_t* data, size_t size, size_t* offset, uint32_t* out_value)
+{
+    if (size - *offset < sizeof(*out_value)) {
+        return 0;
+    }
+    memcpy(out_value, data + *offset, sizeof(*out_value));
+    *offset += sizeof(*out_value);
+    return 1;
+}
+
+static int lt_record_read_bytes(const uint8_t* data, size_t size, size_t* offset, uint32_t count, const void** out_bytes)
+{
+    if (size - *offset < count) {
+        return 0;
+    }
+    *out_bytes = data + *offset;
+    *offset += count;
+    return 1;
+}
+
+lt_status_t lt_record_decode(const void* data, size_t size, size_t* inout_offset, lt_record_t* out_record)
+{
+    const uint8_t* bytes;
+    const void* name;
+    size_t offset;
+    uint32_t access;
+    uint32_t i;
+    int ok;
+
+    if (data == NULL || inout_offset == NULL || out_record == NULL || *inout_offset > size) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    if (*inout_offset == size) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    bytes = (const uint8_t*)data;
+    offset = *inout_offset;
+    memset(out_record, 0, sizeof(*out_record));
+    out_record->op = (lt_record_op_t)bytes[offset];
+    offset += 1u;
+
+    switch (out_record->op) {
+        case LT_RECORD_OP_REGISTER:
+            name = NULL;
+            ok = lt_record_read_u32(bytes, size, &offset, &out_record->component_id)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->size)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->align)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->name_bytes)
+                && lt_record_read_bytes(bytes, size, &offset, out_record->name_bytes, &name);
+            out_record->name = (const char*)name;
+            break;
+        case LT_RECORD_OP_CREATE:
+        case LT_RECORD_OP_DESTROY:
+            ok = lt_record_read_u32(bytes, size, &offset, &out_record->entity_index);
+            break;
+        case LT_RECORD_OP_ADD:
+        case LT_RECORD_OP_SET:
+            ok = lt_record_read_u32(bytes, size, &offset, &out_record->entity_index)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->component_id)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->payload_size)
+                && lt_record_read_bytes(bytes, size, &offset, out_record->payload_size, &out_record->payload);
+            if (out_record->payload_size == 0u) {
+                out_record->payload = NULL;
+            }
+            break;
+        case LT_RECORD_OP_REMOVE:
+        case LT_RECORD_OP_GET:
+            ok = lt_record_read_u32(bytes, size, &offset, &out_record->entity_index)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->component_id);
+            break;
+        case LT_RECORD_OP_QUERY_DEFINE:
+            ok = lt_record_read_u32(bytes, size, &offset, &out_record->query_id)
+                && lt_record_read_u32(bytes, size, &offset, &out_record->term_count)
+                && out_record->term_count <= LT_RECORD_MAX_QUERY_TERMS;
+            for (i = 0u; ok && i < out_record->term_count; ++i) {
+                ok = lt_record_read_u32(bytes, size, &offset, &out_record->terms[i].component_id)
+                    && lt_record_read_u32(bytes, size, &offset, &access);
+                if (ok) {
+                    out_record->terms[i].access = access == (uint32_t)LT_ACCESS_WRITE ? LT_ACCESS_WRITE : LT_ACCESS_READ;
+                }
+            }
+            ok = ok && lt_record_read_u32(bytes, size, &offset, &out_record->without_count)
+                && out_record->without_count <= LT_RECORD_MAX_QUERY_TERMS;
+            for (i = 0u; ok && i < out_record->without_count; ++i) {
+                ok = lt_record_read_u32(bytes, size, &offset, &out_record->without[i]);
+            }
+            break;
+        case LT_RECORD_OP_QUERY_RUN:
+            ok = lt_record_read_u32(bytes, size, &offset, &out_record->query_id);
+            break;
+        case LT_RECORD_OP_FRAME:
+            ok = 1;
+            break;
+        default:
+            ok = 0;
+            break;
+    }
+
+    if (!ok) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    *inout_offset = offset;
+    return LT_STATUS_OK;
+}
@@ -0,0 +1,324 @@
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "lattice/shm_export.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct lt_shm_export_s {
+    char* name;
+    void* segment;
+    size_t segment_bytes;
+    uint32_t entry_capacity;
+    uint64_t frame;
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+    dev_t device;
+    ino_t inode;
+#endif
+};
+
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+static uint64_t lt_shm_now_ns(void)
+{
+    struct timespec ts;
+
+    if (timespec_get(&ts, TIME_UTC) != TIME_UTC) {
+        return 0u;
+    }
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void lt_shm_copy_name(char* dst, const char* src)
+{
+    size_t length;
+
+    memset(dst, 0, LT_SHM_NAME_BYTES);
+    if (src == NULL) {
+        return;
+    }
+    length = strlen(src);
+    if (length >= LT_SHM_NAME_BYTES) {
+        length = LT_SHM_NAME_BYTES - 1u;
+    }
+    memcpy(dst, src, length);
+}
+
+static void lt_shm_store_words(void* dst, const void* src, size_t bytes)
+{
+    const uint32_t* from;
+    uint32_t* to;
+    size_t i;
+
+    from = (const uint32_t*)src;
+    to = (uint32_t*)dst;
+    for (i = 0u; i < bytes / sizeof(uint32_t); ++i) {
+        __atomic_store_n(&to[i], from[i], __ATOMIC_RELAXED);
+    }
+}
+
+static int lt_shm_is_stale_segment(const char* name)
+{
+    const lt_shm_header_t* header;
+    struct stat info;
+    void* mapping;
+    uint64_t owner;
+    int matches;
+    int fd;
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(lt_shm_header_t)) {
+        (void)close(fd);
+        return 0;
+    }
+    mapping = mmap(NULL, sizeof(lt_shm_header_t), PROT_READ, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (mapping == MAP_FAILED) {
+        return 0;
+    }
+    header = (const lt_shm_header_t*)mapping;
+    matches = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) == LT_SHM_MAGIC
+        && header->version == LT_SHM_VERSION
+        && header->header_bytes == (uint32_t)sizeof(lt_shm_header_t)
+        && header->entry_bytes == (uint32_t)sizeof(lt_shm_entry_t);
+    owner = header->owner_pid;
+    (void)munmap(mapping, sizeof(lt_shm_header_t));
+    if (!matches || owner == 0u || owner != (uint64_t)(pid_t)owner) {
+        return 0;
+    }
+    return kill((pid_t)owner, 0) != 0 && errno == ESRCH;
+}
+
+static int lt_shm_owns_name(const lt_shm_export_t* exporter)
+{
+    struct stat info;
+    int fd;
+
+    fd = shm_open(exporter->name, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    if (fstat(fd, &info) != 0) {
+        (void)close(fd);
+        return 0;
+    }
+    (void)close(fd);
+    return info.st_dev == exporter->device && info.st_ino == exporter->inode;
+}
+#endif
+
+lt_status_t lt_shm_export_create(const char* name, uint32_t entry_capacity, lt_shm_export_t** out_exporter)
+{
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+    lt_shm_export_t* exporter;
+    lt_shm_header_t* header;
+    struct stat info;
+    size_t name_length;
+    int fd;
+
+    if (out_exporter == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    *out_exporter = NULL;
+    if (name == NULL || name[0] != '/' || name[1] == '\0' || strchr(name + 1, '/') != NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    if (sizeof(lt_shm_entry_t) > (SIZE_MAX - sizeof(lt_shm_header_t)) / ((size_t)entry_capacity + 1u)) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    exporter = (lt_shm_export_t*)malloc(sizeof(*exporter));
+    if (exporter == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(exporter, 0, sizeof(*exporter));
+
+    name_length = strlen(name);
+    exporter->name = (char*)malloc(name_length + 1u);
+    if (exporter->name == NULL) {
+        free(exporter);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memcpy(exporter->name, name, name_length + 1u);
+    exporter->entry_capacity = entry_capacity;
+    exporter->segment_bytes = lt_shm_segment_bytes(entry_capacity);
+
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST && lt_shm_is_stale_segment(name)) {
+        (void)shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        int error;
+
+        error = errno;
+        free(exporter->name);
+        free(exporter);
+        return error == EEXIST ? LT_STATUS_ALREADY_EXISTS : LT_STATUS_ALLOCATION_FAILED;
+    }
+    if (ftruncate(fd, (off_t)exporter->segment_bytes) != 0 || fstat(fd, &info) != 0) {
+        (void)close(fd);
+        (void)shm_unlink(name);
+        free(exporter->name);
+        free(exporter);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    exporter->segment = mmap(NULL, exporter->segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (exporter->segment == MAP_FAILED) {
+        (void)shm_unlink(name);
+        free(exporter->name);
+        free(exporter);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    exporter->device = info.st_dev;
+    exporter->inode = info.st_ino;
+
+    memset(exporter->segment, 0, exporter->segment_bytes);
+    header = (lt_shm_header_t*)exporter->segment;
+    header->version = LT_SHM_VERSION;
+    header->header_bytes = (uint32_t)sizeof(lt_shm_header_t);
+    header->entry_bytes = (uint32_t)sizeof(lt_shm_entry_t);
+    header->entry_capacity = entry_capacity;
+    header->owner_pid = (uint64_t)getpid();
+    __atomic_store_n(&header->magic, LT_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    *out_exporter = exporter;
+    return LT_STATUS_OK;
+#else
+    (void)name;
+    (void)entry_capacity;
+    if (out_exporter != NULL) {
+        *out_exporter = NULL;
+    }
+    return LT_STATUS_NOT_IMPLEMENTED;
+#endif
+}
+
+void lt_shm_export_destroy(lt_shm_export_t* exporter)
+{
+    if (exporter == NULL) {
+        return;
+    }
+
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+    (void)munmap(exporter->segment, exporter->segment_bytes);
+    if (lt_shm_owns_name(exporter)) {
+        (void)shm_unlink(exporter->name);
+    }
+#endif
+    free(exporter->name);
+    free(exporter);
+}
+
+lt_status_t lt_shm_export_publish(
+    lt_shm_export_t* exporter,
+    const lt_world_t* world,
+    const lt_schedule_t* const* schedules,
+    uint32_t schedule_count)
+{
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+    lt_shm_header_t* header;
+    lt_shm_header_t next;
+    lt_shm_entry_t* entries;
+    lt_world_stats_t stats;
+    uint32_t entry_count;
+    uint32_t dropped;
+    uint32_t sequence;
+    uint32_t i;
+    lt_status_t status;
+
+    if (exporter == NULL || world == NULL || (schedule_count > 0u && schedules == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = lt_world_get_stats(world, &stats);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    header = (lt_shm_header_t*)exporter->segment;
+    entries = (lt_shm_entry_t*)(void*)((uint8_t*)exporter->segment + sizeof(lt_shm_header_t));
+    sequence = __atomic_load_n(&header->sequence, __ATOMIC_RELAXED);
+    (void)__atomic_exchange_n(&header->sequence, sequence + 1u, __ATOMIC_ACQ_REL);
+
+    entry_count = 0u;
+    dropped = 0u;
+    for (i = 0u; i < schedule_count; ++i) {
+        uint32_t count;
+        uint32_t position;
+
+        if (schedules[i] == NULL || lt_schedule_get_entry_count(schedules[i], &count) != LT_STATUS_OK) {
+            continue;
+        }
+        for (position = 0u; position < count; ++position) {
+            lt_schedule_entry_timing_t timing;
+            const char* name;
+            lt_shm_entry_t entry;
+
+            if (entry_count >= exporter->entry_capacity) {
+                dropped += 1u;
+                continue;
+            }
+            name = NULL;
+            (void)lt_schedule_get_entry_name(schedules[i], position, &name);
+            memset(&timing, 0, sizeof(timing));
+            (void)lt_schedule_get_entry_timing(schedules[i], position, &timing);
+            memset(&entry, 0, sizeof(entry));
+            lt_shm_copy_name(entry.name, name);
+            entry.schedule_index = i;
+            entry.position = position;
+            entry.last_ns = timing.last_ns;
+            entry.total_ns = timing.total_ns;
+            entry.max_ns = timing.max_ns;
+            entry.run_count = timing.run_count;
+            lt_shm_store_words(&entries[entry_count], &entry, sizeof(entry));
+            entry_count += 1u;
+        }
+    }
+
+    exporter->frame += 1u;
+    memset(&next, 0, sizeof(next));
+    next.entry_count = entry_count;
+    next.dropped_entries = dropped;
+    next.frame = exporter->frame;
+    next.publish_ns = lt_shm_now_ns();
+    next.world.live_entities = stats.live_entities;
+    next.world.entity_capacity = stats.entity_capacity;
+    next.world.allocated_entity_slots = stats.allocated_entity_slots;
+    next.world.free_entity_slots = stats.free_entity_slots;
+    next.world.registered_components = stats.registered_components;
+    next.world.archetype_count = stats.archetype_count;
+    next.world.chunk_count = stats.chunk_count;
+    next.world.chunk_bytes = stats.chunk_bytes;
+    next.world.pending_commands = stats.pending_commands;
+    next.world.structural_moves = stats.structural_moves;
+    lt_shm_store_words(&header->entry_count, &next.entry_count,
+                       offsetof(lt_shm_header_t, sequence) - offsetof(lt_shm_header_t, entry_count));
+    lt_shm_store_words(&header->frame, &next.frame, sizeof(next) - offsetof(lt_shm_header_t, frame));
+
+    __atomic_store_n(&header->sequence, sequence + 2u, __ATOMIC_RELEASE);
+    return LT_STATUS_OK;
+#else
+    (void)exporter;
+    (void)world;
+    (void)schedules;
+    (void)schedule_count;
+    return LT_STATUS_NOT_IMPLEMENTED;
+#endif
+}
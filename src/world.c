@@ -1,8 +1,12 @@
 #include "lattice/world.h"
+#include "lattice/unchecked.h"
 
+#include <float.h>
 #include <limits.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
 #include <pthread.h>
@@ -12,15 +16,32 @@
 #error "C11 or newer is required"
 #endif
 
+#if defined(LT_NO_VALIDATION) && LT_NO_VALIDATION
+#define LT_CHECK(cond) 0
+#else
+#define LT_CHECK(cond) (cond)
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LT_THREAD_LOCAL __declspec(thread)
+#else
+#define LT_THREAD_LOCAL _Thread_local
+#endif
+
 enum {
     LT_DEFAULT_CHUNK_BYTES = 16u * 1024u,
-    LT_MAX_ROWS_PER_CHUNK = 4096u
+    LT_MAX_ROWS_PER_CHUNK = 4096u,
+    LT_ACCESS_GUARD_INLINE_COLUMNS = 16u
 };
 
 typedef enum lt_deferred_op_kind_e {
     LT_DEFERRED_OP_ADD_COMPONENT = 1,
     LT_DEFERRED_OP_REMOVE_COMPONENT = 2,
-    LT_DEFERRED_OP_DESTROY_ENTITY = 3
+    LT_DEFERRED_OP_DESTROY_ENTITY = 3,
+    LT_DEFERRED_OP_ADD_COMPONENTS = 4,
+    LT_DEFERRED_OP_REMOVE_COMPONENTS = 5,
+    LT_DEFERRED_OP_SET_COMPONENT = 6
 } lt_deferred_op_kind_t;
 
 typedef struct lt_archetype_s lt_archetype_t;
@@ -44,6 +65,7 @@ typedef struct lt_component_record_s {
     lt_component_dtor_fn dtor;
     lt_component_move_fn move;
     void* user;
+    lt_component_key_fn key;
 } lt_component_record_t;
 
 typedef struct lt_deferred_op_s {
@@ -53,31 +75,137 @@ typedef struct lt_deferred_op_s {
     void* payload;
     uint32_t payload_size;
     uint32_t payload_align;
+    lt_component_id_t* component_ids;
+    void** payloads;
+    uint32_t component_count;
 } lt_deferred_op_t;
 
+typedef struct lt_deferred_set_s {
+    lt_entity_t entity;
+    lt_component_id_t component_id;
+    void* payload;
+    uint32_t payload_size;
+    uint32_t payload_align;
+    uint32_t sequence;
+} lt_deferred_set_t;
+
+typedef struct lt_deferred_set_target_s {
+    lt_chunk_t* chunk;
+    uint32_t row;
+    uint32_t component_index;
+    uint32_t set_index;
+} lt_deferred_set_target_t;
+
+typedef struct lt_batch_row_s {
+    lt_chunk_t* chunk;
+    uint32_t row;
+} lt_batch_row_t;
+
+typedef struct lt_subset_row_s {
+    lt_chunk_t* chunk;
+    uint32_t row;
+    uint32_t match_index;
+} lt_subset_row_t;
+
+typedef struct lt_subset_match_s {
+    const lt_archetype_t* archetype;
+    uint32_t match_index;
+} lt_subset_match_t;
+
+typedef struct lt_chunk_key_range_s {
+    double min;
+    double max;
+    uint8_t dirty;
+} lt_chunk_key_range_t;
+
+typedef struct lt_event_buffer_s {
+    uint8_t* data;
+    uint32_t count;
+    uint32_t capacity;
+} lt_event_buffer_t;
+
+typedef struct lt_event_channel_s {
+    uint32_t event_size;
+    uint32_t align;
+    uint32_t worker_count;
+    lt_event_buffer_t* writers;
+    lt_event_buffer_t front;
+} lt_event_channel_t;
+
+typedef struct lt_epoch_chunk_s {
+    const void* source;
+    uint64_t version;
+    uint32_t refs;
+    uint32_t count;
+    uint32_t component_count;
+    size_t block_size;
+    size_t block_align;
+    lt_entity_t* entities;
+    uint8_t** columns;
+} lt_epoch_chunk_t;
+
+typedef struct lt_epoch_archetype_s {
+    lt_component_id_t* component_ids;
+    uint32_t component_count;
+    uint32_t chunk_begin;
+    uint32_t chunk_end;
+} lt_epoch_archetype_t;
+
+typedef struct lt_epoch_slot_s {
+    uint32_t generation;
+    uint32_t archetype;
+    uint32_t chunk;
+    uint32_t row;
+} lt_epoch_slot_t;
+
+struct lt_epoch_s {
+    uint64_t id;
+    uint32_t pins;
+    lt_epoch_t* next_retired;
+    uint32_t* component_sizes;
+    uint32_t component_count;
+    lt_epoch_archetype_t* archetypes;
+    uint32_t archetype_count;
+    lt_epoch_chunk_t** chunks;
+    uint32_t chunk_count;
+    uint32_t shared_chunk_count;
+    lt_epoch_slot_t* slots;
+    uint32_t slot_count;
+    uint32_t live_entity_count;
+};
+
 struct lt_chunk_s {
     lt_chunk_t* next;
     uint32_t count;
     uint32_t capacity;
     lt_entity_t* entities;
     uint8_t** columns;
+    uint64_t version;
+    lt_chunk_key_range_t* key_ranges;
 };
 
 struct lt_archetype_s {
     lt_component_id_t* component_ids;
     uint32_t component_count;
     uint32_t rows_per_chunk;
+    uint64_t row_bytes;
     lt_chunk_t* chunks;
     lt_chunk_t* chunk_tail;
     uint32_t chunk_count;
+    uint32_t live_chunk_count;
+    uint32_t row_count;
+    uint32_t empty_flush_count;
+    uint8_t has_key_ranges;
+    uint32_t serial;
 };
 
-struct lt_world_s {
-    lt_allocator_t allocator;
-    uint32_t target_chunk_bytes;
-    lt_trace_hook_fn trace_hook;
-    void* trace_user_data;
+typedef struct lt_transition_record_s {
+    uint32_t src_serial;
+    uint32_t dst_serial;
+    lt_transition_stats_t stats;
+} lt_transition_record_t;
 
+struct lt_world_s {
     lt_entity_slot_t* entities;
     uint32_t entity_capacity;
     uint32_t entity_count;
@@ -89,17 +217,59 @@ struct lt_world_s {
     uint32_t component_capacity;
     uint32_t component_count;
 
+    lt_allocator_t allocator;
+    uint32_t target_chunk_bytes;
+    uint32_t empty_archetype_reclaim_flushes;
+    lt_trace_hook_fn trace_hook;
+    void* trace_user_data;
+
     lt_archetype_t** archetypes;
     uint32_t archetype_capacity;
     uint32_t archetype_count;
+    uint32_t archetype_generation;
+    uint32_t archetype_serial;
     uint32_t total_chunk_count;
+    uint64_t total_chunk_bytes;
     lt_archetype_t* root_archetype;
 
     lt_deferred_op_t* deferred_ops;
     uint32_t deferred_count;
     uint32_t deferred_capacity;
+    lt_deferred_set_t* deferred_sets;
+    uint32_t deferred_set_count;
+    uint32_t deferred_set_capacity;
+    uint32_t* deferred_set_slots;
+    uint32_t deferred_set_slot_capacity;
     uint32_t defer_depth;
     uint64_t structural_move_count;
+    uint64_t chunk_version;
+
+    lt_event_channel_t* event_channels;
+    uint32_t event_channel_count;
+    uint32_t event_channel_capacity;
+    uint8_t access_checks;
+    lt_access_violation_fn access_violation_hook;
+    void* access_violation_user_data;
+
+    uint8_t transition_tracking;
+    lt_transition_record_t* transitions;
+    uint32_t transition_count;
+    uint32_t transition_capacity;
+    uint32_t* transition_slots;
+    uint32_t transition_slot_capacity;
+    lt_component_transition_stats_t* component_transitions;
+    uint32_t component_transition_capacity;
+    uint8_t access_counting;
+    lt_component_access_stats_t* access_stats;
+    uint32_t access_stats_capacity;
+
+    lt_epoch_t* epoch_current;
+    lt_epoch_t* epoch_retired;
+    uint64_t epoch_counter;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    pthread_mutex_t epoch_mutex;
+    uint8_t epoch_mutex_ready;
+#endif
 };
 
 struct lt_query_s {
@@ -108,29 +278,113 @@ struct lt_query_s {
     uint32_t with_count;
     lt_component_id_t* without;
     uint32_t without_count;
+    lt_query_range_t* ranges;
+    uint32_t range_count;
+    lt_query_group_fn group_by;
+    void* group_by_user_data;
+    uint8_t auto_defer;
     lt_archetype_t** matches;
+    uint64_t* match_groups;
     uint32_t match_count;
     uint32_t match_capacity;
+    uint32_t scanned_archetype_count;
+    uint32_t archetype_generation;
     void** scratch_columns;
     uint32_t scratch_capacity;
 };
 
+typedef struct lt_schedule_access_s {
+    uint32_t entry;
+    lt_access_t access;
+} lt_schedule_access_t;
+
+typedef struct lt_schedule_access_list_s {
+    lt_schedule_access_t* items;
+    uint32_t count;
+    uint32_t capacity;
+} lt_schedule_access_list_t;
+
+typedef struct lt_schedule_item_s {
+    lt_query_t* query;
+    lt_query_parallel_chunk_fn callback;
+    void* user_data;
+    const char* name;
+    const lt_event_access_t* events;
+    uint32_t event_count;
+    const lt_query_term_t* random_access;
+    uint32_t random_access_count;
+} lt_schedule_item_t;
+
 struct lt_schedule_s {
     lt_world_t* world;
-    lt_query_schedule_entry_t* entries;
+    lt_schedule_item_t* entries;
     uint32_t entry_count;
+    uint32_t entry_capacity;
+    uint8_t* enabled;
+    uint32_t* levels;
+    uint32_t* pred_counts;
     uint32_t* batch_nodes;
     uint32_t* batch_offsets;
     uint32_t batch_count;
     uint32_t edge_count;
     uint32_t max_batch_size;
+    lt_schedule_access_list_t* component_lists;
+    uint32_t component_list_count;
+    lt_schedule_access_list_t* channel_lists;
+    uint32_t channel_list_count;
+    uint32_t* saved_levels;
+    uint32_t* saved_pred_counts;
+    uint32_t* queue;
+    uint8_t* queued;
+    uint32_t* preds;
+    uint32_t pred_capacity;
+    lt_schedule_entry_timing_t* timings;
+    uint8_t profiling;
 };
 
+_Static_assert(offsetof(lt_world_t, entities) == offsetof(lt_unchecked_world_t, entities), "world layout");
+_Static_assert(offsetof(lt_world_t, entity_count) == offsetof(lt_unchecked_world_t, entity_count), "world layout");
+_Static_assert(offsetof(lt_world_t, components) == offsetof(lt_unchecked_world_t, components), "world layout");
+_Static_assert(sizeof(lt_entity_slot_t) == sizeof(lt_unchecked_slot_t), "slot layout");
+_Static_assert(offsetof(lt_entity_slot_t, generation) == offsetof(lt_unchecked_slot_t, generation), "slot layout");
+_Static_assert(offsetof(lt_entity_slot_t, alive) == offsetof(lt_unchecked_slot_t, alive), "slot layout");
+_Static_assert(offsetof(lt_entity_slot_t, archetype) == offsetof(lt_unchecked_slot_t, archetype), "slot layout");
+_Static_assert(offsetof(lt_entity_slot_t, chunk) == offsetof(lt_unchecked_slot_t, chunk), "slot layout");
+_Static_assert(offsetof(lt_entity_slot_t, row) == offsetof(lt_unchecked_slot_t, row), "slot layout");
+_Static_assert(sizeof(lt_component_record_t) == sizeof(lt_unchecked_component_t), "component layout");
+_Static_assert(offsetof(lt_component_record_t, size) == offsetof(lt_unchecked_component_t, size), "component layout");
+_Static_assert(offsetof(lt_archetype_t, component_ids) == offsetof(lt_unchecked_archetype_t, component_ids), "archetype layout");
+_Static_assert(offsetof(lt_archetype_t, component_count) == offsetof(lt_unchecked_archetype_t, component_count), "archetype layout");
+_Static_assert(offsetof(lt_chunk_t, count) == offsetof(lt_unchecked_chunk_t, count), "chunk layout");
+_Static_assert(offsetof(lt_chunk_t, columns) == offsetof(lt_unchecked_chunk_t, columns), "chunk layout");
+_Static_assert(offsetof(lt_chunk_t, version) == offsetof(lt_unchecked_chunk_t, version), "chunk layout");
+
 typedef struct lt_parallel_work_item_s {
     lt_archetype_t* archetype;
     lt_chunk_t* chunk;
+    uint64_t group_id;
+    const uint32_t* rows;
+    uint32_t row_count;
 } lt_parallel_work_item_t;
 
+typedef struct lt_trace_record_s {
+    lt_world_t* world;
+    lt_trace_event_t event;
+    size_t payload_offset;
+} lt_trace_record_t;
+
+typedef struct lt_trace_queue_s {
+    lt_trace_record_t* records;
+    uint32_t count;
+    uint32_t capacity;
+    uint8_t* payload;
+    size_t payload_bytes;
+    size_t payload_capacity;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    pthread_mutex_t mutex;
+#endif
+} lt_trace_queue_t;
+
 typedef struct lt_parallel_worker_ctx_s {
     lt_world_t* world;
     lt_query_t* query;
@@ -141,16 +395,95 @@ typedef struct lt_parallel_worker_ctx_s {
     void* user_data;
     uint32_t worker_index;
     void** columns;
+    lt_trace_queue_t* trace_queue;
     lt_status_t status;
 } lt_parallel_worker_ctx_t;
 
 typedef struct lt_schedule_stage_worker_ctx_s {
-    const lt_query_schedule_entry_t* entry;
+    const lt_schedule_item_t* entry;
+    lt_schedule_entry_timing_t* timing;
+    lt_trace_queue_t* trace_queue;
     lt_status_t status;
 } lt_schedule_stage_worker_ctx_t;
 
+typedef enum lt_task_kind_e {
+    LT_TASK_KIND_RANGE = 1,
+    LT_TASK_KIND_QUERY = 2,
+    LT_TASK_KIND_JOIN = 3
+} lt_task_kind_t;
+
+typedef struct lt_task_node_s {
+    lt_task_kind_t kind;
+    lt_task_fn fn;
+    lt_query_t* query;
+    lt_query_parallel_chunk_fn chunk_fn;
+    void* user_data;
+    const char* name;
+    uint32_t count;
+    uint32_t grain;
+    uint32_t dep_offset;
+    uint32_t dep_count;
+    uint32_t term_offset;
+    uint32_t term_count;
+    uint32_t pending;
+    uint32_t unit_count;
+    uint32_t units_left;
+    lt_parallel_work_item_t* items;
+} lt_task_node_t;
+
+struct lt_task_graph_s {
+    lt_task_node_t* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    lt_task_id_t* deps;
+    uint32_t dep_total;
+    uint32_t dep_capacity;
+    lt_query_term_t* terms;
+    uint32_t term_total;
+    uint32_t term_capacity;
+};
+
+typedef struct lt_task_unit_s {
+    uint32_t node;
+    uint32_t unit;
+} lt_task_unit_t;
+
+typedef struct lt_task_exec_s {
+    lt_task_graph_t* graph;
+    uint32_t* succ_offsets;
+    uint32_t* succ_nodes;
+    uint32_t* complete_stack;
+    lt_task_unit_t* queue;
+    uint32_t queue_head;
+    uint32_t queue_tail;
+    uint32_t queue_capacity;
+    uint32_t nodes_left;
+    lt_status_t status;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    lt_trace_queue_t trace_queue;
+#endif
+} lt_task_exec_t;
+
+typedef struct lt_task_worker_s {
+    lt_task_exec_t* exec;
+    uint32_t worker_index;
+    void** columns;
+} lt_task_worker_t;
+
 void lt_query_destroy(lt_query_t* query);
 
+typedef struct lt_access_scope_s {
+    const lt_schedule_item_t* entry;
+    uint32_t worker_index;
+} lt_access_scope_t;
+
+static LT_THREAD_LOCAL const lt_access_scope_t* lt_access_scope;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+static LT_THREAD_LOCAL lt_trace_queue_t* lt_trace_queue;
+#endif
+
 static int lt_is_power_of_two_u32(uint32_t v)
 {
     return v != 0u && (v & (v - 1u)) == 0u;
@@ -260,13 +593,164 @@ static void lt_free_bytes(lt_allocator_t* allocator, void* ptr, size_t size, siz
     allocator->free(allocator->user, ptr, size, align);
 }
 
-static void lt_trace_emit(
+static uint32_t lt_stat_load_u32(const uint32_t* counter)
+{
+#if defined(_MSC_VER)
+    return (uint32_t)__iso_volatile_load32((const volatile __int32*)counter);
+#else
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#endif
+}
+
+static void lt_stat_store_u32(uint32_t* counter, uint32_t value)
+{
+#if defined(_MSC_VER)
+    __iso_volatile_store32((volatile __int32*)counter, (__int32)value);
+#else
+    __atomic_store_n(counter, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static uint64_t lt_stat_load_u64(const uint64_t* counter)
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_ARM))
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)counter, 0, 0);
+#elif defined(_MSC_VER)
+    return (uint64_t)__iso_volatile_load64((const volatile __int64*)counter);
+#else
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#endif
+}
+
+static void lt_stat_store_u64(uint64_t* counter, uint64_t value)
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_ARM))
+    (void)_InterlockedExchange64((volatile __int64*)counter, (__int64)value);
+#elif defined(_MSC_VER)
+    __iso_volatile_store64((volatile __int64*)counter, (__int64)value);
+#else
+    __atomic_store_n(counter, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static void lt_stat_add_u64(uint64_t* counter, uint64_t value)
+{
+#if defined(_MSC_VER)
+    (void)_InterlockedExchangeAdd64((volatile __int64*)counter, (__int64)value);
+#else
+    (void)__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+#endif
+}
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+static void lt_trace_queue_append(lt_trace_queue_t* queue, lt_world_t* world, const lt_trace_event_t* event)
+{
+    lt_trace_record_t* record;
+
+    if (queue->count == queue->capacity) {
+        lt_trace_record_t* grown;
+        uint32_t capacity;
+
+        capacity = queue->capacity == 0u ? 64u : queue->capacity * 2u;
+        grown = (lt_trace_record_t*)realloc(queue->records, sizeof(*grown) * (size_t)capacity);
+        if (grown == NULL) {
+            return;
+        }
+        queue->records = grown;
+        queue->capacity = capacity;
+    }
+
+    record = &queue->records[queue->count];
+    record->world = world;
+    record->event = *event;
+    record->event.payload = NULL;
+    record->payload_offset = SIZE_MAX;
+    if (event->payload_size > 0u) {
+        if (queue->payload_bytes + event->payload_size > queue->payload_capacity) {
+            uint8_t* grown;
+            size_t capacity;
+
+            capacity = queue->payload_capacity == 0u ? 1024u : queue->payload_capacity;
+            while (capacity < queue->payload_bytes + event->payload_size) {
+                capacity *= 2u;
+            }
+            grown = (uint8_t*)realloc(queue->payload, capacity);
+            if (grown == NULL) {
+                return;
+            }
+            queue->payload = grown;
+            queue->payload_capacity = capacity;
+        }
+        memcpy(queue->payload + queue->payload_bytes, event->payload, event->payload_size);
+        record->payload_offset = queue->payload_bytes;
+        queue->payload_bytes += event->payload_size;
+    }
+    queue->count += 1u;
+}
+
+static void lt_trace_queue_push(lt_trace_queue_t* queue, lt_world_t* world, const lt_trace_event_t* event)
+{
+    (void)pthread_mutex_lock(&queue->mutex);
+    lt_trace_queue_append(queue, world, event);
+    (void)pthread_mutex_unlock(&queue->mutex);
+}
+#endif
+
+static void lt_trace_deliver(lt_world_t* world, const lt_trace_event_t* event)
+{
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    if (lt_trace_queue != NULL) {
+        lt_trace_queue_push(lt_trace_queue, world, event);
+        return;
+    }
+#endif
+    if (world->trace_hook != NULL) {
+        world->trace_hook(event, world->trace_user_data);
+    }
+}
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+static lt_status_t lt_trace_queue_open(lt_trace_queue_t* queue, lt_trace_queue_t** out_previous)
+{
+    memset(queue, 0, sizeof(*queue));
+    if (pthread_mutex_init(&queue->mutex, NULL) != 0) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    *out_previous = lt_trace_queue;
+    lt_trace_queue = queue;
+    return LT_STATUS_OK;
+}
+
+static void lt_trace_queue_close(lt_trace_queue_t* queue, lt_trace_queue_t* previous)
+{
+    uint32_t i;
+
+    lt_trace_queue = previous;
+    for (i = 0u; i < queue->count; ++i) {
+        lt_trace_record_t* record;
+
+        record = &queue->records[i];
+        if (record->payload_offset != SIZE_MAX) {
+            record->event.payload = queue->payload + record->payload_offset;
+        }
+        lt_trace_deliver(record->world, &record->event);
+    }
+    free(queue->records);
+    free(queue->payload);
+    (void)pthread_mutex_destroy(&queue->mutex);
+}
+#endif
+
+static void lt_trace_emit_payload(
     lt_world_t* world,
     lt_trace_event_kind_t kind,
     lt_status_t status,
     lt_entity_t entity,
     lt_component_id_t component_id,
-    uint32_t operation)
+    uint32_t operation,
+    const lt_query_t* query,
+    const void* payload,
+    uint32_t payload_size)
 {
     lt_trace_event_t event;
 
@@ -281,9 +765,23 @@ static void lt_trace_emit(
     event.component_id = component_id;
     event.operation = operation;
     event.live_entities = world->live_entity_count;
-    event.pending_commands = world->deferred_count;
+    event.pending_commands = world->deferred_count + world->deferred_set_count;
     event.defer_depth = world->defer_depth;
-    world->trace_hook(&event, world->trace_user_data);
+    event.query = query;
+    event.payload = payload;
+    event.payload_size = payload != NULL ? payload_size : 0u;
+    lt_trace_deliver(world, &event);
+}
+
+static void lt_trace_emit(
+    lt_world_t* world,
+    lt_trace_event_kind_t kind,
+    lt_status_t status,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    uint32_t operation)
+{
+    lt_trace_emit_payload(world, kind, status, entity, component_id, operation, NULL, NULL, 0u);
 }
 
 static void lt_deferred_op_release(lt_world_t* world, lt_deferred_op_t* op)
@@ -300,16 +798,67 @@ static void lt_deferred_op_release(lt_world_t* world, lt_deferred_op_t* op)
             op->payload_align == 0u ? _Alignof(max_align_t) : (size_t)op->payload_align);
     }
 
+    if (op->payloads != NULL) {
+        uint32_t i;
+
+        for (i = 0u; i < op->component_count; ++i) {
+            const lt_component_record_t* component;
+
+            if (op->payloads[i] == NULL) {
+                continue;
+            }
+            component = &world->components[op->component_ids[i]];
+            lt_free_bytes(&world->allocator, op->payloads[i], component->size, component->align);
+        }
+        lt_free_bytes(
+            &world->allocator,
+            op->payloads,
+            sizeof(*op->payloads) * (size_t)op->component_count,
+            _Alignof(void*));
+    }
+
+    if (op->component_ids != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            op->component_ids,
+            sizeof(*op->component_ids) * (size_t)op->component_count,
+            _Alignof(lt_component_id_t));
+    }
+
     memset(op, 0, sizeof(*op));
 }
 
+static void lt_deferred_sets_clear(lt_world_t* world)
+{
+    uint32_t i;
+
+    for (i = 0u; i < world->deferred_set_count; ++i) {
+        lt_deferred_set_t* set;
+
+        set = &world->deferred_sets[i];
+        lt_free_bytes(&world->allocator, set->payload, (size_t)set->payload_size, (size_t)set->payload_align);
+    }
+
+    if (world->deferred_set_slots != NULL && world->deferred_set_count > 0u) {
+        memset(
+            world->deferred_set_slots,
+            0,
+            sizeof(*world->deferred_set_slots) * (size_t)world->deferred_set_slot_capacity);
+    }
+    lt_stat_store_u32(&world->deferred_set_count, 0u);
+}
+
 static void lt_deferred_clear(lt_world_t* world)
 {
     uint32_t i;
 
+    if (world != NULL) {
+        lt_deferred_sets_clear(world);
+    }
+
     if (world == NULL || world->deferred_ops == NULL || world->deferred_count == 0u) {
         if (world != NULL) {
-            world->deferred_count = 0u;
+            lt_stat_store_u32(&world->deferred_count, 0u);
         }
         return;
     }
@@ -317,7 +866,7 @@ static void lt_deferred_clear(lt_world_t* world)
     for (i = 0u; i < world->deferred_count; ++i) {
         lt_deferred_op_release(world, &world->deferred_ops[i]);
     }
-    world->deferred_count = 0u;
+    lt_stat_store_u32(&world->deferred_count, 0u);
 }
 
 static lt_status_t lt_deferred_grow(lt_world_t* world, uint32_t min_capacity)
@@ -402,7 +951,7 @@ static lt_status_t lt_enqueue_destroy_entity(lt_world_t* world, lt_entity_t enti
     memset(op, 0, sizeof(*op));
     op->kind = LT_DEFERRED_OP_DESTROY_ENTITY;
     op->entity = entity;
-    world->deferred_count += 1u;
+    lt_stat_store_u32(&world->deferred_count, world->deferred_count + 1u);
     lt_trace_emit(
         world,
         LT_TRACE_EVENT_DEFER_ENQUEUE,
@@ -442,7 +991,7 @@ static lt_status_t lt_enqueue_remove_component(
     op->kind = LT_DEFERRED_OP_REMOVE_COMPONENT;
     op->entity = entity;
     op->component_id = component_id;
-    world->deferred_count += 1u;
+    lt_stat_store_u32(&world->deferred_count, world->deferred_count + 1u);
     lt_trace_emit(
         world,
         LT_TRACE_EVENT_DEFER_ENQUEUE,
@@ -504,7 +1053,7 @@ static lt_status_t lt_enqueue_add_component(
         op->payload_align = component->align;
     }
 
-    world->deferred_count += 1u;
+    lt_stat_store_u32(&world->deferred_count, world->deferred_count + 1u);
     lt_trace_emit(
         world,
         LT_TRACE_EVENT_DEFER_ENQUEUE,
@@ -515,44 +1064,323 @@ static lt_status_t lt_enqueue_add_component(
     return LT_STATUS_OK;
 }
 
-static lt_status_t lt_grow_entities(lt_world_t* world, uint32_t min_capacity)
+static lt_status_t lt_enqueue_add_components(
+    lt_world_t* world,
+    lt_deferred_op_kind_t kind,
+    lt_entity_t entity,
+    const lt_component_id_t* component_ids,
+    const void* const* initial_values,
+    uint32_t component_count)
 {
-    uint32_t old_capacity;
-    uint32_t new_capacity;
-    size_t old_size;
-    size_t new_size;
-    lt_entity_slot_t* new_entities;
+    lt_deferred_op_t* op;
+    uint32_t i;
+    lt_status_t status;
 
-    if (world == NULL) {
+    if (world == NULL || entity == LT_ENTITY_NULL || component_ids == NULL || component_count == 0u) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (world->entity_capacity >= min_capacity) {
-        return LT_STATUS_OK;
-    }
-
-    old_capacity = world->entity_capacity;
-    new_capacity = old_capacity == 0u ? 64u : old_capacity;
-    while (new_capacity < min_capacity) {
-        if (new_capacity > UINT32_MAX / 2u) {
-            return LT_STATUS_CAPACITY_REACHED;
-        }
-        new_capacity *= 2u;
+    status = lt_deferred_grow(world, world->deferred_count + 1u);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_DEFER_ENQUEUE,
+            status,
+            entity,
+            component_ids[0],
+            (uint32_t)kind);
+        return status;
     }
 
-    if (sizeof(*new_entities) > SIZE_MAX / new_capacity) {
-        return LT_STATUS_CAPACITY_REACHED;
-    }
+    op = &world->deferred_ops[world->deferred_count];
+    memset(op, 0, sizeof(*op));
+    op->kind = kind;
+    op->entity = entity;
+    op->component_id = component_ids[0];
+    op->component_count = component_count;
 
-    new_size = sizeof(*new_entities) * (size_t)new_capacity;
-    new_entities = (lt_entity_slot_t*)lt_alloc_bytes(
+    op->component_ids = (lt_component_id_t*)lt_alloc_bytes(
         &world->allocator,
-        new_size,
-        _Alignof(lt_entity_slot_t));
-    if (new_entities == NULL) {
-        return LT_STATUS_ALLOCATION_FAILED;
+        sizeof(*op->component_ids) * (size_t)component_count,
+        _Alignof(lt_component_id_t));
+    if (op->component_ids == NULL) {
+        status = LT_STATUS_ALLOCATION_FAILED;
+    } else {
+        memcpy(op->component_ids, component_ids, sizeof(*op->component_ids) * (size_t)component_count);
     }
-    memset(new_entities, 0, new_size);
+
+    if (status == LT_STATUS_OK && kind == LT_DEFERRED_OP_ADD_COMPONENTS && initial_values != NULL) {
+        op->payloads = (void**)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*op->payloads) * (size_t)component_count,
+            _Alignof(void*));
+        if (op->payloads == NULL) {
+            status = LT_STATUS_ALLOCATION_FAILED;
+        } else {
+            memset(op->payloads, 0, sizeof(*op->payloads) * (size_t)component_count);
+        }
+
+        for (i = 0u; i < component_count && status == LT_STATUS_OK; ++i) {
+            const lt_component_record_t* component;
+
+            component = &world->components[component_ids[i]];
+            if (component->size == 0u || initial_values[i] == NULL) {
+                continue;
+            }
+
+            op->payloads[i] = lt_alloc_bytes(&world->allocator, component->size, component->align);
+            if (op->payloads[i] == NULL) {
+                status = LT_STATUS_ALLOCATION_FAILED;
+                break;
+            }
+            memcpy(op->payloads[i], initial_values[i], component->size);
+        }
+    }
+
+    if (status != LT_STATUS_OK) {
+        lt_deferred_op_release(world, op);
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_DEFER_ENQUEUE,
+            status,
+            entity,
+            component_ids[0],
+            (uint32_t)kind);
+        return status;
+    }
+
+    lt_stat_store_u32(&world->deferred_count, world->deferred_count + 1u);
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_DEFER_ENQUEUE,
+        LT_STATUS_OK,
+        entity,
+        component_ids[0],
+        (uint32_t)kind);
+    return LT_STATUS_OK;
+}
+
+static uint32_t lt_deferred_set_hash(lt_entity_t entity, lt_component_id_t component_id)
+{
+    uint64_t h;
+
+    h = (uint64_t)entity ^ ((uint64_t)component_id * 0x9E3779B97F4A7C15ull);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+static uint32_t* lt_deferred_set_find_slot(
+    const lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id)
+{
+    uint32_t mask;
+    uint32_t slot_index;
+
+    mask = world->deferred_set_slot_capacity - 1u;
+    slot_index = lt_deferred_set_hash(entity, component_id) & mask;
+    while (world->deferred_set_slots[slot_index] != 0u) {
+        const lt_deferred_set_t* set;
+
+        set = &world->deferred_sets[world->deferred_set_slots[slot_index] - 1u];
+        if (set->entity == entity && set->component_id == component_id) {
+            break;
+        }
+        slot_index = (slot_index + 1u) & mask;
+    }
+
+    return &world->deferred_set_slots[slot_index];
+}
+
+static lt_status_t lt_deferred_sets_grow(lt_world_t* world, uint32_t min_capacity)
+{
+    lt_deferred_set_t* new_sets;
+    uint32_t* new_slots;
+    uint32_t new_capacity;
+    uint32_t new_slot_capacity;
+    uint32_t i;
+
+    if (world->deferred_set_capacity >= min_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    new_capacity = world->deferred_set_capacity == 0u ? 64u : world->deferred_set_capacity;
+    while (new_capacity < min_capacity) {
+        if (new_capacity > UINT32_MAX / 4u) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        new_capacity *= 2u;
+    }
+    new_slot_capacity = new_capacity * 2u;
+
+    if (sizeof(*new_sets) > SIZE_MAX / (size_t)new_capacity
+        || sizeof(*new_slots) > SIZE_MAX / (size_t)new_slot_capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    new_sets = (lt_deferred_set_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*new_sets) * (size_t)new_capacity,
+        _Alignof(lt_deferred_set_t));
+    if (new_sets == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    new_slots = (uint32_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*new_slots) * (size_t)new_slot_capacity,
+        _Alignof(uint32_t));
+    if (new_slots == NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            new_sets,
+            sizeof(*new_sets) * (size_t)new_capacity,
+            _Alignof(lt_deferred_set_t));
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(new_slots, 0, sizeof(*new_slots) * (size_t)new_slot_capacity);
+
+    if (world->deferred_set_count > 0u) {
+        memcpy(new_sets, world->deferred_sets, sizeof(*new_sets) * (size_t)world->deferred_set_count);
+    }
+
+    if (world->deferred_sets != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->deferred_sets,
+            sizeof(*world->deferred_sets) * (size_t)world->deferred_set_capacity,
+            _Alignof(lt_deferred_set_t));
+    }
+    if (world->deferred_set_slots != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->deferred_set_slots,
+            sizeof(*world->deferred_set_slots) * (size_t)world->deferred_set_slot_capacity,
+            _Alignof(uint32_t));
+    }
+
+    world->deferred_sets = new_sets;
+    world->deferred_set_capacity = new_capacity;
+    world->deferred_set_slots = new_slots;
+    world->deferred_set_slot_capacity = new_slot_capacity;
+    for (i = 0u; i < world->deferred_set_count; ++i) {
+        *lt_deferred_set_find_slot(world, new_sets[i].entity, new_sets[i].component_id) = i + 1u;
+    }
+
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_enqueue_set_component(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void* value)
+{
+    const lt_component_record_t* component;
+    lt_deferred_set_t* set;
+    uint32_t* slot;
+    lt_status_t status;
+
+    component = &world->components[component_id];
+    if (world->deferred_set_count > 0u) {
+        slot = lt_deferred_set_find_slot(world, entity, component_id);
+        if (*slot != 0u && world->deferred_sets[*slot - 1u].sequence == world->deferred_count) {
+            set = &world->deferred_sets[*slot - 1u];
+            memcpy(set->payload, value, component->size);
+            lt_trace_emit(
+                world,
+                LT_TRACE_EVENT_DEFER_ENQUEUE,
+                LT_STATUS_OK,
+                entity,
+                component_id,
+                (uint32_t)LT_DEFERRED_OP_SET_COMPONENT);
+            return LT_STATUS_OK;
+        }
+    }
+
+    status = lt_deferred_sets_grow(world, world->deferred_set_count + 1u);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_DEFER_ENQUEUE,
+            status,
+            entity,
+            component_id,
+            (uint32_t)LT_DEFERRED_OP_SET_COMPONENT);
+        return status;
+    }
+
+    set = &world->deferred_sets[world->deferred_set_count];
+    set->payload = lt_alloc_bytes(&world->allocator, component->size, component->align);
+    if (set->payload == NULL) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_DEFER_ENQUEUE,
+            LT_STATUS_ALLOCATION_FAILED,
+            entity,
+            component_id,
+            (uint32_t)LT_DEFERRED_OP_SET_COMPONENT);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memcpy(set->payload, value, component->size);
+    set->entity = entity;
+    set->component_id = component_id;
+    set->payload_size = component->size;
+    set->payload_align = component->align;
+    set->sequence = world->deferred_count;
+
+    *lt_deferred_set_find_slot(world, entity, component_id) = world->deferred_set_count + 1u;
+    lt_stat_store_u32(&world->deferred_set_count, world->deferred_set_count + 1u);
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_DEFER_ENQUEUE,
+        LT_STATUS_OK,
+        entity,
+        component_id,
+        (uint32_t)LT_DEFERRED_OP_SET_COMPONENT);
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_grow_entities(lt_world_t* world, uint32_t min_capacity)
+{
+    uint32_t old_capacity;
+    uint32_t new_capacity;
+    size_t old_size;
+    size_t new_size;
+    lt_entity_slot_t* new_entities;
+
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->entity_capacity >= min_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    old_capacity = world->entity_capacity;
+    new_capacity = old_capacity == 0u ? 64u : old_capacity;
+    while (new_capacity < min_capacity) {
+        if (new_capacity > UINT32_MAX / 2u) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        new_capacity *= 2u;
+    }
+
+    if (sizeof(*new_entities) > SIZE_MAX / new_capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    new_size = sizeof(*new_entities) * (size_t)new_capacity;
+    new_entities = (lt_entity_slot_t*)lt_alloc_bytes(
+        &world->allocator,
+        new_size,
+        _Alignof(lt_entity_slot_t));
+    if (new_entities == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(new_entities, 0, new_size);
 
     if (world->entities != NULL && old_capacity > 0u) {
         old_size = sizeof(*new_entities) * (size_t)old_capacity;
@@ -565,7 +1393,49 @@ static lt_status_t lt_grow_entities(lt_world_t* world, uint32_t min_capacity)
     }
 
     world->entities = new_entities;
-    world->entity_capacity = new_capacity;
+    lt_stat_store_u32(&world->entity_capacity, new_capacity);
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_grow_access_stats(lt_world_t* world)
+{
+    lt_component_access_stats_t* grown;
+    uint32_t capacity;
+
+    capacity = world->component_capacity + 1u;
+    if (capacity <= world->access_stats_capacity) {
+        return LT_STATUS_OK;
+    }
+    if (sizeof(*grown) > SIZE_MAX / (size_t)capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    grown = (lt_component_access_stats_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*grown) * (size_t)capacity,
+        _Alignof(lt_component_access_stats_t));
+    if (grown == NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->access_stats,
+            sizeof(*world->access_stats) * (size_t)world->access_stats_capacity,
+            _Alignof(lt_component_access_stats_t));
+        world->access_stats = NULL;
+        world->access_stats_capacity = 0u;
+        world->access_counting = 0u;
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(grown, 0, sizeof(*grown) * (size_t)capacity);
+    if (world->access_stats != NULL) {
+        memcpy(grown, world->access_stats, sizeof(*grown) * (size_t)world->access_stats_capacity);
+        lt_free_bytes(
+            &world->allocator,
+            world->access_stats,
+            sizeof(*world->access_stats) * (size_t)world->access_stats_capacity,
+            _Alignof(lt_component_access_stats_t));
+    }
+    world->access_stats = grown;
+    world->access_stats_capacity = capacity;
     return LT_STATUS_OK;
 }
 
@@ -620,6 +1490,9 @@ static lt_status_t lt_grow_components(lt_world_t* world, uint32_t min_capacity)
 
     world->components = new_components;
     world->component_capacity = new_capacity;
+    if (world->access_stats != NULL) {
+        return lt_grow_access_stats(world);
+    }
     return LT_STATUS_OK;
 }
 
@@ -692,7 +1565,7 @@ static lt_status_t lt_component_desc_validate(const lt_component_desc_t* desc)
     }
 
     if ((desc->flags & LT_COMPONENT_FLAG_TAG) != 0u) {
-        if (desc->size != 0u) {
+        if (desc->size != 0u || desc->key != NULL) {
             return LT_STATUS_INVALID_ARGUMENT;
         }
         if (desc->align != 0u && desc->align != 1u) {
@@ -736,33 +1609,30 @@ static lt_status_t lt_component_name_copy(
     return LT_STATUS_OK;
 }
 
-static uint32_t lt_compute_rows_per_chunk(
+static uint64_t lt_compute_row_bytes(
     const lt_world_t* world,
     const lt_component_id_t* component_ids,
     uint32_t component_count)
 {
-    size_t per_row_bytes;
+    uint64_t per_row_bytes;
     uint32_t i;
-    uint32_t rows;
 
     per_row_bytes = sizeof(lt_entity_t);
     for (i = 0u; i < component_count; ++i) {
-        const lt_component_record_t* component;
-        lt_component_id_t component_id;
-
-        component_id = component_ids[i];
-        component = &world->components[component_id];
-        if (component->size > SIZE_MAX - per_row_bytes) {
-            return 1u;
-        }
-        per_row_bytes += component->size;
+        per_row_bytes += world->components[component_ids[i]].size;
     }
+    return per_row_bytes;
+}
+
+static uint32_t lt_compute_rows_per_chunk(const lt_world_t* world, uint64_t per_row_bytes)
+{
+    uint32_t rows;
 
     if (per_row_bytes == 0u) {
         return 1u;
     }
 
-    rows = (uint32_t)((size_t)world->target_chunk_bytes / per_row_bytes);
+    rows = (uint32_t)((uint64_t)world->target_chunk_bytes / per_row_bytes);
     if (rows == 0u) {
         rows = 1u;
     }
@@ -818,6 +1688,7 @@ static lt_status_t lt_archetype_create(
     lt_archetype_t** out_archetype)
 {
     lt_archetype_t* archetype;
+    uint32_t i;
     lt_status_t status;
 
     if (world == NULL || out_archetype == NULL) {
@@ -865,13 +1736,21 @@ static lt_status_t lt_archetype_create(
     }
 
     archetype->component_count = component_count;
-    archetype->rows_per_chunk = lt_compute_rows_per_chunk(world, component_ids, component_count);
+    for (i = 0u; i < component_count; ++i) {
+        if (world->components[component_ids[i]].key != NULL) {
+            archetype->has_key_ranges = 1u;
+        }
+    }
+    archetype->row_bytes = lt_compute_row_bytes(world, component_ids, component_count);
+    archetype->rows_per_chunk = lt_compute_rows_per_chunk(world, archetype->row_bytes);
     if (archetype->rows_per_chunk == 0u) {
         archetype->rows_per_chunk = 1u;
     }
 
+    world->archetype_serial += 1u;
+    archetype->serial = world->archetype_serial;
     world->archetypes[world->archetype_count] = archetype;
-    world->archetype_count += 1u;
+    lt_stat_store_u32(&world->archetype_count, world->archetype_count + 1u);
 
     *out_archetype = archetype;
     return LT_STATUS_OK;
@@ -986,6 +1865,87 @@ static void lt_component_destruct_one(
     component->dtor(dst, 1u, component->user);
 }
 
+static void lt_chunk_key_range_include_row(
+    const lt_world_t* world,
+    const lt_archetype_t* archetype,
+    lt_chunk_t* chunk,
+    uint32_t row)
+{
+    uint32_t i;
+
+    if (chunk->key_ranges == NULL) {
+        return;
+    }
+
+    for (i = 0u; i < archetype->component_count; ++i) {
+        const lt_component_record_t* component;
+        lt_chunk_key_range_t* range;
+        double key;
+
+        component = &world->components[archetype->component_ids[i]];
+        range = &chunk->key_ranges[i];
+        if (component->key == NULL || range->dirty != 0u) {
+            continue;
+        }
+
+        key = component->key(chunk->columns[i] + (size_t)component->size * (size_t)row, component->user);
+        if (key < range->min) {
+            range->min = key;
+        }
+        if (key > range->max) {
+            range->max = key;
+        }
+    }
+}
+
+static void lt_chunk_key_range_mark_dirty(lt_chunk_t* chunk, uint32_t component_index)
+{
+    if (chunk != NULL && chunk->key_ranges != NULL) {
+        chunk->key_ranges[component_index].dirty = 1u;
+    }
+}
+
+static const lt_chunk_key_range_t* lt_chunk_key_range_resolve(
+    const lt_world_t* world,
+    const lt_archetype_t* archetype,
+    lt_chunk_t* chunk,
+    uint32_t component_index)
+{
+    lt_chunk_key_range_t* range;
+
+    range = &chunk->key_ranges[component_index];
+    if (range->dirty != 0u) {
+        const lt_component_record_t* component;
+        uint32_t row;
+
+        component = &world->components[archetype->component_ids[component_index]];
+        range->min = DBL_MAX;
+        range->max = -DBL_MAX;
+        for (row = 0u; row < chunk->count; ++row) {
+            double key;
+
+            key = component->key(
+                chunk->columns[component_index] + (size_t)component->size * (size_t)row,
+                component->user);
+            if (key < range->min) {
+                range->min = key;
+            }
+            if (key > range->max) {
+                range->max = key;
+            }
+        }
+        range->dirty = 0u;
+    }
+
+    return range;
+}
+
+static void lt_chunk_destroy(
+    lt_world_t* world,
+    const lt_archetype_t* archetype,
+    lt_chunk_t* chunk,
+    int destroy_live_rows);
+
 static lt_status_t lt_chunk_create(
     lt_world_t* world,
     lt_archetype_t* archetype,
@@ -1006,6 +1966,8 @@ static lt_status_t lt_chunk_create(
     }
     memset(chunk, 0, sizeof(*chunk));
 
+    world->chunk_version += 1u;
+    chunk->version = world->chunk_version;
     chunk->capacity = archetype->rows_per_chunk;
     if (chunk->capacity == 0u) {
         chunk->capacity = 1u;
@@ -1110,8 +2072,24 @@ static lt_status_t lt_chunk_create(
         }
     }
 
-    *out_chunk = chunk;
-    return LT_STATUS_OK;
+    if (archetype->has_key_ranges != 0u) {
+        chunk->key_ranges = (lt_chunk_key_range_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*chunk->key_ranges) * (size_t)archetype->component_count,
+            _Alignof(lt_chunk_key_range_t));
+        if (chunk->key_ranges == NULL) {
+            lt_chunk_destroy(world, archetype, chunk, 0);
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        for (i = 0u; i < archetype->component_count; ++i) {
+            chunk->key_ranges[i].min = DBL_MAX;
+            chunk->key_ranges[i].max = -DBL_MAX;
+            chunk->key_ranges[i].dirty = 0u;
+        }
+    }
+
+    *out_chunk = chunk;
+    return LT_STATUS_OK;
 }
 
 static void lt_chunk_destroy(
@@ -1177,9 +2155,96 @@ static void lt_chunk_destroy(
             _Alignof(lt_entity_t));
     }
 
+    if (chunk->key_ranges != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            chunk->key_ranges,
+            sizeof(*chunk->key_ranges) * (size_t)archetype->component_count,
+            _Alignof(lt_chunk_key_range_t));
+    }
+
     lt_free_bytes(&world->allocator, chunk, sizeof(*chunk), _Alignof(lt_chunk_t));
 }
 
+static void lt_archetype_destroy(lt_world_t* world, lt_archetype_t* archetype)
+{
+    lt_chunk_t* chunk;
+
+    if (world == NULL || archetype == NULL) {
+        return;
+    }
+
+    chunk = archetype->chunks;
+    while (chunk != NULL) {
+        lt_chunk_t* next;
+        next = chunk->next;
+        lt_chunk_destroy(world, archetype, chunk, 1);
+        chunk = next;
+    }
+
+    if (archetype->component_ids != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            archetype->component_ids,
+            sizeof(*archetype->component_ids) * (size_t)archetype->component_count,
+            _Alignof(lt_component_id_t));
+    }
+
+    lt_free_bytes(&world->allocator, archetype, sizeof(*archetype), _Alignof(lt_archetype_t));
+}
+
+static void lt_archetype_release_chunk_stats(lt_world_t* world, const lt_archetype_t* archetype)
+{
+    const lt_chunk_t* chunk;
+    uint64_t bytes;
+
+    bytes = 0u;
+    for (chunk = archetype->chunks; chunk != NULL; chunk = chunk->next) {
+        bytes += (uint64_t)chunk->capacity * archetype->row_bytes;
+    }
+    lt_stat_store_u32(&world->total_chunk_count, world->total_chunk_count - archetype->chunk_count);
+    lt_stat_store_u64(&world->total_chunk_bytes, world->total_chunk_bytes - bytes);
+}
+
+static void lt_world_reclaim_empty_archetypes(lt_world_t* world)
+{
+    uint32_t read_index;
+    uint32_t write_index;
+
+    if (world == NULL || world->empty_archetype_reclaim_flushes == 0u) {
+        return;
+    }
+
+    write_index = 0u;
+    for (read_index = 0u; read_index < world->archetype_count; ++read_index) {
+        lt_archetype_t* archetype;
+
+        archetype = world->archetypes[read_index];
+        if (archetype != world->root_archetype && archetype->row_count == 0u) {
+            archetype->empty_flush_count += 1u;
+            if (archetype->empty_flush_count >= world->empty_archetype_reclaim_flushes) {
+                lt_archetype_release_chunk_stats(world, archetype);
+                lt_archetype_destroy(world, archetype);
+                continue;
+            }
+        } else {
+            archetype->empty_flush_count = 0u;
+        }
+
+        world->archetypes[write_index] = archetype;
+        write_index += 1u;
+    }
+
+    if (write_index != world->archetype_count) {
+        memset(
+            &world->archetypes[write_index],
+            0,
+            sizeof(*world->archetypes) * (size_t)(world->archetype_count - write_index));
+        lt_stat_store_u32(&world->archetype_count, write_index);
+        world->archetype_generation += 1u;
+    }
+}
+
 static lt_status_t lt_archetype_alloc_row(
     lt_world_t* world,
     lt_archetype_t* archetype,
@@ -1195,9 +2260,13 @@ static lt_status_t lt_archetype_alloc_row(
     chunk = archetype->chunks;
     while (chunk != NULL) {
         if (chunk->count < chunk->capacity) {
+            if (chunk->count == 0u) {
+                archetype->live_chunk_count += 1u;
+            }
             *out_chunk = chunk;
             *out_row = chunk->count;
             chunk->count += 1u;
+            archetype->row_count += 1u;
             return LT_STATUS_OK;
         }
         chunk = chunk->next;
@@ -1218,7 +2287,12 @@ static lt_status_t lt_archetype_alloc_row(
     }
     archetype->chunk_tail = chunk;
     archetype->chunk_count += 1u;
-    world->total_chunk_count += 1u;
+    archetype->live_chunk_count += 1u;
+    archetype->row_count += 1u;
+    lt_stat_store_u32(&world->total_chunk_count, world->total_chunk_count + 1u);
+    lt_stat_store_u64(
+        &world->total_chunk_bytes,
+        world->total_chunk_bytes + (uint64_t)chunk->capacity * archetype->row_bytes);
 
     *out_chunk = chunk;
     *out_row = 0u;
@@ -1226,6 +2300,51 @@ static lt_status_t lt_archetype_alloc_row(
     return LT_STATUS_OK;
 }
 
+static lt_status_t lt_archetype_alloc_rows(
+    lt_world_t* world,
+    lt_archetype_t* archetype,
+    uint32_t max_count,
+    lt_chunk_t** out_chunk,
+    uint32_t* out_first_row,
+    uint32_t* out_count)
+{
+    lt_chunk_t* chunk;
+    uint32_t count;
+    lt_status_t status;
+
+    status = lt_archetype_alloc_row(world, archetype, &chunk, out_first_row);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    count = chunk->capacity - chunk->count;
+    if (count > max_count - 1u) {
+        count = max_count - 1u;
+    }
+    chunk->count += count;
+    archetype->row_count += count;
+
+    *out_chunk = chunk;
+    *out_count = count + 1u;
+    return LT_STATUS_OK;
+}
+
+static int lt_batch_row_compare(const void* lhs, const void* rhs)
+{
+    const lt_batch_row_t* a;
+    const lt_batch_row_t* b;
+
+    a = (const lt_batch_row_t*)lhs;
+    b = (const lt_batch_row_t*)rhs;
+    if (a->chunk != b->chunk) {
+        return (uintptr_t)a->chunk < (uintptr_t)b->chunk ? -1 : 1;
+    }
+    if (a->row != b->row) {
+        return a->row > b->row ? -1 : 1;
+    }
+    return 0;
+}
+
 static void lt_archetype_swap_remove_row(
     lt_world_t* world,
     lt_archetype_t* archetype,
@@ -1243,7 +2362,9 @@ static void lt_archetype_swap_remove_row(
     if (row != last_row) {
         lt_entity_t moved_entity;
 
-        world->structural_move_count += 1u;
+        lt_stat_store_u64(&world->structural_move_count, world->structural_move_count + 1u);
+        world->chunk_version += 1u;
+        chunk->version = world->chunk_version;
         moved_entity = chunk->entities[last_row];
         chunk->entities[row] = moved_entity;
 
@@ -1279,6 +2400,17 @@ static void lt_archetype_swap_remove_row(
     }
 
     chunk->count -= 1u;
+    archetype->row_count -= 1u;
+    if (chunk->count == 0u) {
+        archetype->live_chunk_count -= 1u;
+        if (chunk->key_ranges != NULL) {
+            for (i = 0u; i < archetype->component_count; ++i) {
+                chunk->key_ranges[i].min = DBL_MAX;
+                chunk->key_ranges[i].max = -DBL_MAX;
+                chunk->key_ranges[i].dirty = 0u;
+            }
+        }
+    }
 }
 
 static lt_status_t lt_world_get_live_slot(
@@ -1414,57 +2546,28 @@ static lt_status_t lt_world_component_key_with_remove(
     return LT_STATUS_OK;
 }
 
-static lt_status_t lt_query_validate_desc(const lt_world_t* world, const lt_query_desc_t* desc)
+static lt_status_t lt_component_id_list_validate(
+    const lt_world_t* world,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count)
 {
     uint32_t i;
     uint32_t j;
 
-    if (world == NULL || desc == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
-
-    if ((desc->with_count > 0u && desc->with_terms == NULL)
-        || (desc->without_count > 0u && desc->without == NULL)) {
+    if (component_ids == NULL || component_count == 0u) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    for (i = 0u; i < desc->with_count; ++i) {
-        lt_component_id_t component_id;
-
-        component_id = desc->with_terms[i].component_id;
-        if (component_id == LT_COMPONENT_INVALID || component_id > world->component_count) {
-            return LT_STATUS_NOT_FOUND;
-        }
-
-        if (desc->with_terms[i].access != LT_ACCESS_READ
-            && desc->with_terms[i].access != LT_ACCESS_WRITE) {
+    for (i = 0u; i < component_count; ++i) {
+        if (component_ids[i] == LT_COMPONENT_INVALID) {
             return LT_STATUS_INVALID_ARGUMENT;
         }
-
-        for (j = i + 1u; j < desc->with_count; ++j) {
-            if (desc->with_terms[j].component_id == component_id) {
-                return LT_STATUS_CONFLICT;
-            }
-        }
-    }
-
-    for (i = 0u; i < desc->without_count; ++i) {
-        lt_component_id_t component_id;
-
-        component_id = desc->without[i];
-        if (component_id == LT_COMPONENT_INVALID || component_id > world->component_count) {
+        if (component_ids[i] > world->component_count) {
             return LT_STATUS_NOT_FOUND;
         }
-
-        for (j = i + 1u; j < desc->without_count; ++j) {
-            if (desc->without[j] == component_id) {
-                return LT_STATUS_CONFLICT;
-            }
-        }
-
-        for (j = 0u; j < desc->with_count; ++j) {
-            if (desc->with_terms[j].component_id == component_id) {
-                return LT_STATUS_CONFLICT;
+        for (j = 0u; j < i; ++j) {
+            if (component_ids[j] == component_ids[i]) {
+                return LT_STATUS_INVALID_ARGUMENT;
             }
         }
     }
@@ -1472,2199 +2575,7959 @@ static lt_status_t lt_query_validate_desc(const lt_world_t* world, const lt_quer
     return LT_STATUS_OK;
 }
 
-static lt_status_t lt_query_copy_desc(lt_query_t* query, const lt_query_desc_t* desc)
+static lt_status_t lt_world_component_key_with_set(
+    lt_world_t* world,
+    const lt_archetype_t* archetype,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count,
+    int add,
+    lt_component_id_t** out_ids,
+    uint32_t* out_count)
 {
-    lt_world_t* world;
+    lt_component_id_t* ids;
+    uint32_t count;
+    uint32_t i;
+    uint32_t dst_i;
 
-    if (query == NULL || query->world == NULL || desc == NULL) {
+    if (world == NULL || archetype == NULL || out_ids == NULL || out_count == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    world = query->world;
+    if (add) {
+        if (component_count > UINT32_MAX - archetype->component_count) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        count = archetype->component_count + component_count;
+    } else {
+        count = archetype->component_count - component_count;
+    }
 
-    if (desc->with_count > 0u) {
-        if (sizeof(*query->with_terms) > SIZE_MAX / desc->with_count) {
+    ids = NULL;
+    if (count > 0u) {
+        if (sizeof(*ids) > SIZE_MAX / count) {
             return LT_STATUS_CAPACITY_REACHED;
         }
 
-        query->with_terms = (lt_query_term_t*)lt_alloc_bytes(
+        ids = (lt_component_id_t*)lt_alloc_bytes(
             &world->allocator,
-            sizeof(*query->with_terms) * (size_t)desc->with_count,
-            _Alignof(lt_query_term_t));
-        if (query->with_terms == NULL) {
+            sizeof(*ids) * (size_t)count,
+            _Alignof(lt_component_id_t));
+        if (ids == NULL) {
             return LT_STATUS_ALLOCATION_FAILED;
         }
-        memcpy(
-            query->with_terms,
-            desc->with_terms,
-            sizeof(*query->with_terms) * (size_t)desc->with_count);
-        query->with_count = desc->with_count;
     }
 
-    if (desc->without_count > 0u) {
-        if (sizeof(*query->without) > SIZE_MAX / desc->without_count) {
-            return LT_STATUS_CAPACITY_REACHED;
+    dst_i = 0u;
+    for (i = 0u; i < archetype->component_count; ++i) {
+        uint32_t j;
+        int listed;
+
+        listed = 0;
+        for (j = 0u; j < component_count && !add; ++j) {
+            if (component_ids[j] == archetype->component_ids[i]) {
+                listed = 1;
+            }
+        }
+        if (!listed) {
+            ids[dst_i] = archetype->component_ids[i];
+            dst_i += 1u;
         }
+    }
 
-        query->without = (lt_component_id_t*)lt_alloc_bytes(
-            &world->allocator,
-            sizeof(*query->without) * (size_t)desc->without_count,
-            _Alignof(lt_component_id_t));
-        if (query->without == NULL) {
-            return LT_STATUS_ALLOCATION_FAILED;
+    for (i = 0u; i < component_count && add; ++i) {
+        uint32_t position;
+
+        position = dst_i;
+        while (position > 0u && ids[position - 1u] > component_ids[i]) {
+            ids[position] = ids[position - 1u];
+            position -= 1u;
         }
-        memcpy(
-            query->without,
-            desc->without,
-            sizeof(*query->without) * (size_t)desc->without_count);
-        query->without_count = desc->without_count;
+        ids[position] = component_ids[i];
+        dst_i += 1u;
     }
 
+    *out_ids = ids;
+    *out_count = count;
     return LT_STATUS_OK;
 }
 
-static int lt_query_matches_archetype(const lt_query_t* query, const lt_archetype_t* archetype)
+static uint32_t lt_transition_hash(uint32_t src_serial, uint32_t dst_serial)
+{
+    uint32_t hash;
+
+    hash = src_serial * 0x9E3779B1u;
+    hash ^= dst_serial + 0x7F4A7C15u + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+static lt_status_t lt_transition_slots_rebuild(lt_world_t* world, uint32_t capacity)
 {
+    uint32_t* slots;
     uint32_t i;
 
-    if (query == NULL || archetype == NULL) {
-        return 0;
+    if (sizeof(*slots) > SIZE_MAX / (size_t)capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
-
-    for (i = 0u; i < query->with_count; ++i) {
-        if (!lt_archetype_find_component_index(
-                archetype,
-                query->with_terms[i].component_id,
-                NULL)) {
-            return 0;
-        }
+    slots = (uint32_t*)lt_alloc_bytes(&world->allocator, sizeof(*slots) * (size_t)capacity, _Alignof(uint32_t));
+    if (slots == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
     }
+    memset(slots, 0, sizeof(*slots) * (size_t)capacity);
 
-    for (i = 0u; i < query->without_count; ++i) {
-        if (lt_archetype_find_component_index(archetype, query->without[i], NULL)) {
-            return 0;
+    for (i = 0u; i < world->transition_count; ++i) {
+        const lt_transition_record_t* record;
+        uint32_t slot;
+
+        record = &world->transitions[i];
+        slot = lt_transition_hash(record->src_serial, record->dst_serial) & (capacity - 1u);
+        while (slots[slot] != 0u) {
+            slot = (slot + 1u) & (capacity - 1u);
         }
+        slots[slot] = i + 1u;
     }
 
-    return 1;
+    lt_free_bytes(
+        &world->allocator,
+        world->transition_slots,
+        sizeof(*world->transition_slots) * (size_t)world->transition_slot_capacity,
+        _Alignof(uint32_t));
+    world->transition_slots = slots;
+    world->transition_slot_capacity = capacity;
+    return LT_STATUS_OK;
 }
 
-static lt_status_t lt_query_ensure_match_capacity(lt_query_t* query, uint32_t min_capacity)
+static lt_status_t lt_grow_transitions(lt_world_t* world)
 {
-    lt_world_t* world;
-    lt_archetype_t** new_matches;
-    size_t old_size;
-    size_t new_size;
+    uint32_t new_capacity;
+    lt_transition_record_t* new_transitions;
+    lt_status_t status;
 
-    if (query == NULL || query->world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    if (world->transition_count >= UINT32_MAX / 4u) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
-
-    if (query->match_capacity >= min_capacity) {
+    if ((world->transition_count + 1u) * 2u > world->transition_slot_capacity) {
+        status = lt_transition_slots_rebuild(
+            world,
+            world->transition_slot_capacity == 0u ? 64u : world->transition_slot_capacity * 2u);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+    }
+    if (world->transition_count < world->transition_capacity) {
         return LT_STATUS_OK;
     }
 
-    if (sizeof(*new_matches) > SIZE_MAX / (size_t)min_capacity) {
+    new_capacity = world->transition_capacity == 0u ? 16u : world->transition_capacity * 2u;
+    if (sizeof(*new_transitions) > SIZE_MAX / (size_t)new_capacity) {
         return LT_STATUS_CAPACITY_REACHED;
     }
-
-    world = query->world;
-    new_size = sizeof(*new_matches) * (size_t)min_capacity;
-    new_matches = (lt_archetype_t**)lt_alloc_bytes(
+    new_transitions = (lt_transition_record_t*)lt_alloc_bytes(
         &world->allocator,
-        new_size,
-        _Alignof(lt_archetype_t*));
-    if (new_matches == NULL) {
+        sizeof(*new_transitions) * (size_t)new_capacity,
+        _Alignof(lt_transition_record_t));
+    if (new_transitions == NULL) {
         return LT_STATUS_ALLOCATION_FAILED;
     }
-    memset(new_matches, 0, new_size);
-
-    if (query->matches != NULL && query->match_count > 0u) {
-        old_size = sizeof(*new_matches) * (size_t)query->match_count;
-        memcpy(new_matches, query->matches, old_size);
-    }
+    memset(new_transitions, 0, sizeof(*new_transitions) * (size_t)new_capacity);
 
-    if (query->matches != NULL) {
+    if (world->transitions != NULL) {
+        memcpy(
+            new_transitions,
+            world->transitions,
+            sizeof(*new_transitions) * (size_t)world->transition_count);
         lt_free_bytes(
             &world->allocator,
-            query->matches,
-            sizeof(*query->matches) * (size_t)query->match_capacity,
-            _Alignof(lt_archetype_t*));
+            world->transitions,
+            sizeof(*world->transitions) * (size_t)world->transition_capacity,
+            _Alignof(lt_transition_record_t));
     }
 
-    query->matches = new_matches;
-    query->match_capacity = min_capacity;
+    world->transitions = new_transitions;
+    world->transition_capacity = new_capacity;
     return LT_STATUS_OK;
 }
 
-static lt_status_t lt_query_ensure_scratch_capacity(lt_query_t* query, uint32_t min_capacity)
+static lt_transition_record_t* lt_transition_find_or_add(
+    lt_world_t* world,
+    const lt_archetype_t* src_archetype,
+    const lt_archetype_t* dst_archetype)
 {
-    lt_world_t* world;
-    void** new_columns;
-    size_t new_size;
-
-    if (query == NULL || query->world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
-
-    if (min_capacity == 0u || query->scratch_capacity >= min_capacity) {
-        return LT_STATUS_OK;
-    }
-
-    if (sizeof(*new_columns) > SIZE_MAX / (size_t)min_capacity) {
-        return LT_STATUS_CAPACITY_REACHED;
+    lt_transition_record_t* record;
+    lt_component_id_t* ids;
+    uint32_t id_count;
+    uint32_t slot;
+
+    if (world->transition_slot_capacity > 0u) {
+        slot = lt_transition_hash(src_archetype->serial, dst_archetype->serial)
+               & (world->transition_slot_capacity - 1u);
+        while (world->transition_slots[slot] != 0u) {
+            record = &world->transitions[world->transition_slots[slot] - 1u];
+            if (record->src_serial == src_archetype->serial && record->dst_serial == dst_archetype->serial) {
+                return record;
+            }
+            slot = (slot + 1u) & (world->transition_slot_capacity - 1u);
+        }
     }
 
-    world = query->world;
-    new_size = sizeof(*new_columns) * (size_t)min_capacity;
-    new_columns = (void**)lt_alloc_bytes(&world->allocator, new_size, _Alignof(void*));
-    if (new_columns == NULL) {
-        return LT_STATUS_ALLOCATION_FAILED;
+    if (lt_grow_transitions(world) != LT_STATUS_OK) {
+        return NULL;
     }
-    memset(new_columns, 0, new_size);
 
-    if (query->scratch_columns != NULL) {
-        if (query->scratch_capacity > 0u) {
+    ids = NULL;
+    id_count = src_archetype->component_count + dst_archetype->component_count;
+    if (id_count > 0u) {
+        ids = (lt_component_id_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*ids) * (size_t)id_count,
+            _Alignof(lt_component_id_t));
+        if (ids == NULL) {
+            return NULL;
+        }
+        if (src_archetype->component_count > 0u) {
+            memcpy(ids, src_archetype->component_ids, sizeof(*ids) * (size_t)src_archetype->component_count);
+        }
+        if (dst_archetype->component_count > 0u) {
             memcpy(
-                new_columns,
-                query->scratch_columns,
-                sizeof(*new_columns) * (size_t)query->scratch_capacity);
+                &ids[src_archetype->component_count],
+                dst_archetype->component_ids,
+                sizeof(*ids) * (size_t)dst_archetype->component_count);
         }
-        lt_free_bytes(
-            &world->allocator,
-            query->scratch_columns,
-            sizeof(*query->scratch_columns) * (size_t)query->scratch_capacity,
-            _Alignof(void*));
     }
 
-    query->scratch_columns = new_columns;
-    query->scratch_capacity = min_capacity;
-    return LT_STATUS_OK;
+    record = &world->transitions[world->transition_count];
+    memset(record, 0, sizeof(*record));
+    record->src_serial = src_archetype->serial;
+    record->dst_serial = dst_archetype->serial;
+    record->stats.src_component_ids = ids;
+    record->stats.src_component_count = src_archetype->component_count;
+    record->stats.dst_component_ids = ids != NULL ? &ids[src_archetype->component_count] : NULL;
+    record->stats.dst_component_count = dst_archetype->component_count;
+
+    slot = lt_transition_hash(record->src_serial, record->dst_serial) & (world->transition_slot_capacity - 1u);
+    while (world->transition_slots[slot] != 0u) {
+        slot = (slot + 1u) & (world->transition_slot_capacity - 1u);
+    }
+    world->transition_count += 1u;
+    world->transition_slots[slot] = world->transition_count;
+    return record;
 }
 
-const char* lt_status_string(lt_status_t status)
+static lt_component_transition_stats_t* lt_component_transition_slot(
+    lt_world_t* world,
+    lt_component_id_t component_id)
 {
-    switch (status) {
-        case LT_STATUS_OK:
-            return "LT_STATUS_OK";
-        case LT_STATUS_INVALID_ARGUMENT:
-            return "LT_STATUS_INVALID_ARGUMENT";
-        case LT_STATUS_NOT_FOUND:
-            return "LT_STATUS_NOT_FOUND";
-        case LT_STATUS_ALREADY_EXISTS:
-            return "LT_STATUS_ALREADY_EXISTS";
-        case LT_STATUS_CAPACITY_REACHED:
-            return "LT_STATUS_CAPACITY_REACHED";
-        case LT_STATUS_ALLOCATION_FAILED:
-            return "LT_STATUS_ALLOCATION_FAILED";
-        case LT_STATUS_STALE_ENTITY:
-            return "LT_STATUS_STALE_ENTITY";
-        case LT_STATUS_CONFLICT:
-            return "LT_STATUS_CONFLICT";
-        case LT_STATUS_NOT_IMPLEMENTED:
-            return "LT_STATUS_NOT_IMPLEMENTED";
-        default:
-            return "LT_STATUS_UNKNOWN";
+    lt_component_transition_stats_t* grown;
+    uint32_t capacity;
+
+    if (component_id < world->component_transition_capacity) {
+        return &world->component_transitions[component_id];
+    }
+
+    capacity = world->component_capacity + 1u;
+    if (component_id >= capacity || sizeof(*grown) > SIZE_MAX / (size_t)capacity) {
+        return NULL;
+    }
+    grown = (lt_component_transition_stats_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*grown) * (size_t)capacity,
+        _Alignof(lt_component_transition_stats_t));
+    if (grown == NULL) {
+        return NULL;
+    }
+    memset(grown, 0, sizeof(*grown) * (size_t)capacity);
+    if (world->component_transitions != NULL) {
+        memcpy(grown, world->component_transitions, sizeof(*grown) * (size_t)world->component_transition_capacity);
+        lt_free_bytes(
+            &world->allocator,
+            world->component_transitions,
+            sizeof(*world->component_transitions) * (size_t)world->component_transition_capacity,
+            _Alignof(lt_component_transition_stats_t));
     }
+    world->component_transitions = grown;
+    world->component_transition_capacity = capacity;
+    return &world->component_transitions[component_id];
 }
 
-lt_status_t lt_world_create(const lt_world_config_t* cfg, lt_world_t** out_world)
+static void lt_world_record_transition(
+    lt_world_t* world,
+    const lt_archetype_t* src_archetype,
+    const lt_archetype_t* dst_archetype,
+    uint32_t count)
 {
-    lt_world_t* world;
-    lt_world_config_t local_cfg;
-    lt_allocator_t allocator;
-    lt_status_t status;
+    lt_transition_record_t* record;
+    uint64_t row_bytes;
+    uint32_t i;
 
-    if (out_world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    row_bytes = 0u;
+    for (i = 0u; i < dst_archetype->component_count; ++i) {
+        if (lt_archetype_find_component_index(src_archetype, dst_archetype->component_ids[i], NULL)) {
+            row_bytes += world->components[dst_archetype->component_ids[i]].size;
+        }
     }
-    *out_world = NULL;
 
-    memset(&local_cfg, 0, sizeof(local_cfg));
-    if (cfg != NULL) {
-        local_cfg = *cfg;
+    record = lt_transition_find_or_add(world, src_archetype, dst_archetype);
+    if (record != NULL) {
+        record->stats.move_count += count;
+        record->stats.bytes_moved += row_bytes * count;
     }
 
-    status = lt_prepare_allocator(cfg, &allocator);
-    if (status != LT_STATUS_OK) {
-        return status;
-    }
+    for (i = 0u; i < dst_archetype->component_count; ++i) {
+        lt_component_transition_stats_t* stats;
 
-    world = (lt_world_t*)lt_alloc_bytes(
-        &allocator,
-        sizeof(*world),
-        _Alignof(lt_world_t));
-    if (world == NULL) {
-        return LT_STATUS_ALLOCATION_FAILED;
+        if (lt_archetype_find_component_index(src_archetype, dst_archetype->component_ids[i], NULL)) {
+            continue;
+        }
+        stats = lt_component_transition_slot(world, dst_archetype->component_ids[i]);
+        if (stats != NULL) {
+            stats->add_count += count;
+            stats->bytes_moved += (uint64_t)world->components[dst_archetype->component_ids[i]].size * count;
+        }
     }
-    memset(world, 0, sizeof(*world));
-
-    world->allocator = allocator;
-    world->target_chunk_bytes =
-        local_cfg.target_chunk_bytes == 0u ? LT_DEFAULT_CHUNK_BYTES : local_cfg.target_chunk_bytes;
-    world->free_entity_head = UINT32_MAX;
+    for (i = 0u; i < src_archetype->component_count; ++i) {
+        lt_component_transition_stats_t* stats;
 
-    if (local_cfg.initial_entity_capacity > 0u) {
-        status = lt_grow_entities(world, local_cfg.initial_entity_capacity);
-        if (status != LT_STATUS_OK) {
-            lt_world_destroy(world);
-            return status;
+        if (lt_archetype_find_component_index(dst_archetype, src_archetype->component_ids[i], NULL)) {
+            continue;
+        }
+        stats = lt_component_transition_slot(world, src_archetype->component_ids[i]);
+        if (stats != NULL) {
+            stats->remove_count += count;
+            stats->bytes_moved += (uint64_t)world->components[src_archetype->component_ids[i]].size * count;
         }
     }
+}
 
-    if (local_cfg.initial_component_capacity > 0u) {
-        status = lt_grow_components(world, local_cfg.initial_component_capacity);
-        if (status != LT_STATUS_OK) {
-            lt_world_destroy(world);
-            return status;
+static void lt_world_record_moved_bytes(
+    lt_world_t* world,
+    const lt_archetype_t* src_archetype,
+    const lt_archetype_t* dst_archetype,
+    uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0u; i < dst_archetype->component_count; ++i) {
+        lt_component_id_t component_id;
+
+        component_id = dst_archetype->component_ids[i];
+        if (lt_archetype_find_component_index(src_archetype, component_id, NULL)) {
+            lt_stat_add_u64(
+                &world->access_stats[component_id].moved_bytes,
+                (uint64_t)world->components[component_id].size * count);
         }
     }
+}
 
-    status = lt_find_or_create_archetype(world, NULL, 0u, &world->root_archetype);
-    if (status != LT_STATUS_OK) {
-        lt_world_destroy(world);
-        return status;
-    }
+static void lt_transition_stats_clear(lt_world_t* world)
+{
+    uint32_t i;
 
-    *out_world = world;
-    return LT_STATUS_OK;
+    for (i = 0u; i < world->transition_count; ++i) {
+        lt_transition_stats_t* stats;
+
+        stats = &world->transitions[i].stats;
+        lt_free_bytes(
+            &world->allocator,
+            (void*)stats->src_component_ids,
+            sizeof(lt_component_id_t) * ((size_t)stats->src_component_count + (size_t)stats->dst_component_count),
+            _Alignof(lt_component_id_t));
+    }
+    world->transition_count = 0u;
+    if (world->transition_slots != NULL) {
+        memset(world->transition_slots, 0, sizeof(*world->transition_slots) * (size_t)world->transition_slot_capacity);
+    }
+    if (world->component_transitions != NULL) {
+        memset(
+            world->component_transitions,
+            0,
+            sizeof(*world->component_transitions) * (size_t)world->component_transition_capacity);
+    }
 }
 
-void lt_world_destroy(lt_world_t* world)
+static lt_status_t lt_entity_move_to_archetype(
+    lt_world_t* world,
+    lt_entity_slot_t* slot,
+    lt_entity_t entity,
+    lt_archetype_t* dst_archetype,
+    const lt_component_id_t* added_ids,
+    const void* const* added_values,
+    uint32_t added_count)
 {
+    lt_archetype_t* src_archetype;
+    lt_chunk_t* src_chunk;
+    uint32_t src_row;
+    lt_chunk_t* dst_chunk;
+    uint32_t dst_row;
     uint32_t i;
+    lt_status_t status;
 
-    if (world == NULL) {
-        return;
+    src_archetype = slot->archetype;
+    src_chunk = slot->chunk;
+    src_row = slot->row;
+
+    status = lt_archetype_alloc_row(world, dst_archetype, &dst_chunk, &dst_row);
+    if (status != LT_STATUS_OK) {
+        return status;
     }
 
-    if (world->archetypes != NULL) {
-        for (i = 0u; i < world->archetype_count; ++i) {
-            lt_archetype_t* archetype;
-            lt_chunk_t* chunk;
+    dst_chunk->entities[dst_row] = entity;
 
-            archetype = world->archetypes[i];
-            if (archetype == NULL) {
-                continue;
-            }
+    for (i = 0u; i < dst_archetype->component_count; ++i) {
+        lt_component_id_t dst_component_id;
+        const lt_component_record_t* component;
+        uint32_t src_i;
+        void* dst_ptr;
 
-            chunk = archetype->chunks;
-            while (chunk != NULL) {
-                lt_chunk_t* next;
-                next = chunk->next;
-                lt_chunk_destroy(world, archetype, chunk, 1);
-                chunk = next;
-            }
+        dst_component_id = dst_archetype->component_ids[i];
+        component = &world->components[dst_component_id];
+        dst_ptr = lt_chunk_component_ptr(world, dst_archetype, dst_chunk, dst_row, i);
 
-            if (archetype->component_ids != NULL) {
-                lt_free_bytes(
-                    &world->allocator,
-                    archetype->component_ids,
-                    sizeof(*archetype->component_ids) * (size_t)archetype->component_count,
-                    _Alignof(lt_component_id_t));
-            }
+        if (lt_archetype_find_component_index(src_archetype, dst_component_id, &src_i)) {
+            void* src_ptr;
 
-            lt_free_bytes(
-                &world->allocator,
-                archetype,
-                sizeof(*archetype),
-                _Alignof(lt_archetype_t));
-        }
+            src_ptr = lt_chunk_component_ptr(world, src_archetype, src_chunk, src_row, src_i);
+            lt_component_transfer(component, dst_ptr, src_ptr);
+        } else {
+            const void* initial_value;
+            uint32_t j;
 
-        lt_free_bytes(
-            &world->allocator,
-            world->archetypes,
-            sizeof(*world->archetypes) * (size_t)world->archetype_capacity,
-            _Alignof(lt_archetype_t*));
-        world->archetypes = NULL;
+            initial_value = NULL;
+            for (j = 0u; j < added_count; ++j) {
+                if (added_ids[j] == dst_component_id) {
+                    initial_value = added_values != NULL ? added_values[j] : NULL;
+                    break;
+                }
+            }
+            lt_component_init_added(component, dst_ptr, initial_value);
+        }
     }
 
-    if (world->components != NULL) {
-        for (i = 1u; i <= world->component_count; ++i) {
-            lt_component_record_t* record;
+    for (i = 0u; i < src_archetype->component_count; ++i) {
+        lt_component_id_t src_component_id;
 
-            record = &world->components[i];
-            if (record->name != NULL) {
-                size_t name_size;
-                name_size = strlen(record->name) + 1u;
-                lt_free_bytes(
-                    &world->allocator,
-                    record->name,
-                    name_size,
-                    _Alignof(char));
-                record->name = NULL;
-            }
+        src_component_id = src_archetype->component_ids[i];
+        if (!lt_archetype_find_component_index(dst_archetype, src_component_id, NULL)) {
+            lt_component_destruct_one(
+                &world->components[src_component_id],
+                lt_chunk_component_ptr(world, src_archetype, src_chunk, src_row, i));
         }
-
-        lt_free_bytes(
-            &world->allocator,
-            world->components,
-            sizeof(*world->components) * (size_t)(world->component_capacity + 1u),
-            _Alignof(lt_component_record_t));
-        world->components = NULL;
     }
 
-    if (world->entities != NULL) {
-        lt_free_bytes(
-            &world->allocator,
-            world->entities,
-            sizeof(*world->entities) * (size_t)world->entity_capacity,
-            _Alignof(lt_entity_slot_t));
-        world->entities = NULL;
-    }
+    lt_chunk_key_range_include_row(world, dst_archetype, dst_chunk, dst_row);
 
-    lt_deferred_clear(world);
-    if (world->deferred_ops != NULL) {
-        lt_free_bytes(
-            &world->allocator,
-            world->deferred_ops,
-            sizeof(*world->deferred_ops) * (size_t)world->deferred_capacity,
-            _Alignof(lt_deferred_op_t));
-        world->deferred_ops = NULL;
+    slot->archetype = dst_archetype;
+    slot->chunk = dst_chunk;
+    slot->row = dst_row;
+    lt_stat_store_u64(&world->structural_move_count, world->structural_move_count + 1u);
+    if (world->transition_tracking != 0u) {
+        lt_world_record_transition(world, src_archetype, dst_archetype, 1u);
+    }
+    if (world->access_counting != 0u) {
+        lt_world_record_moved_bytes(world, src_archetype, dst_archetype, 1u);
     }
 
-    lt_free_bytes(&world->allocator, world, sizeof(*world), _Alignof(lt_world_t));
+    lt_archetype_swap_remove_row(world, src_archetype, src_chunk, src_row);
+    return LT_STATUS_OK;
 }
 
-lt_status_t lt_world_reserve_entities(lt_world_t* world, uint32_t entity_capacity)
+static int lt_deferred_set_target_compare(const void* lhs, const void* rhs)
 {
-    if (world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
+    const lt_deferred_set_target_t* a;
+    const lt_deferred_set_target_t* b;
 
-    return lt_grow_entities(world, entity_capacity);
+    a = (const lt_deferred_set_target_t*)lhs;
+    b = (const lt_deferred_set_target_t*)rhs;
+    if (a->chunk != b->chunk) {
+        return (uintptr_t)a->chunk < (uintptr_t)b->chunk ? -1 : 1;
+    }
+    if (a->row != b->row) {
+        return a->row < b->row ? -1 : 1;
+    }
+    if (a->component_index != b->component_index) {
+        return a->component_index < b->component_index ? -1 : 1;
+    }
+    return 0;
 }
 
-lt_status_t lt_world_reserve_components(lt_world_t* world, uint32_t component_capacity)
+static lt_status_t lt_deferred_sets_apply(lt_world_t* world, uint32_t begin, uint32_t end)
 {
-    if (world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    lt_deferred_set_target_t* targets;
+    uint32_t target_count;
+    uint32_t capacity;
+    uint32_t i;
+    lt_status_t status;
+
+    if (begin == end) {
+        return LT_STATUS_OK;
     }
 
-    return lt_grow_components(world, component_capacity);
+    capacity = end - begin;
+    targets = (lt_deferred_set_target_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*targets) * (size_t)capacity,
+        _Alignof(lt_deferred_set_target_t));
+    if (targets == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    status = LT_STATUS_OK;
+    target_count = 0u;
+    for (i = begin; i < end; ++i) {
+        const lt_deferred_set_t* set;
+        lt_entity_slot_t* slot;
+        uint32_t component_index;
+        lt_status_t set_status;
+
+        set = &world->deferred_sets[i];
+        set_status = lt_world_get_live_slot(world, set->entity, &slot);
+        if (set_status == LT_STATUS_OK
+            && !lt_archetype_find_component_index(slot->archetype, set->component_id, &component_index)) {
+            set_status = LT_STATUS_NOT_FOUND;
+        }
+        if (set_status != LT_STATUS_OK) {
+            lt_trace_emit(
+                world,
+                LT_TRACE_EVENT_FLUSH_APPLY,
+                set_status,
+                set->entity,
+                set->component_id,
+                (uint32_t)LT_DEFERRED_OP_SET_COMPONENT);
+            if (status == LT_STATUS_OK) {
+                status = set_status;
+            }
+            continue;
+        }
+
+        targets[target_count].chunk = slot->chunk;
+        targets[target_count].row = slot->row;
+        targets[target_count].component_index = component_index;
+        targets[target_count].set_index = i;
+        target_count += 1u;
+    }
+
+    qsort(targets, target_count, sizeof(*targets), lt_deferred_set_target_compare);
+    for (i = 0u; i < target_count; ++i) {
+        const lt_deferred_set_target_t* target;
+        const lt_deferred_set_t* set;
+        lt_entity_slot_t* slot;
+
+        target = &targets[i];
+        set = &world->deferred_sets[target->set_index];
+        slot = &world->entities[lt_entity_index(set->entity)];
+        memcpy(
+            target->chunk->columns[target->component_index] + (size_t)set->payload_size * (size_t)target->row,
+            set->payload,
+            set->payload_size);
+        lt_chunk_key_range_include_row(world, slot->archetype, target->chunk, target->row);
+        lt_trace_emit_payload(
+            world,
+            LT_TRACE_EVENT_COMPONENT_SET,
+            LT_STATUS_OK,
+            set->entity,
+            set->component_id,
+            0u,
+            NULL,
+            set->payload,
+            set->payload_size);
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_FLUSH_APPLY,
+            LT_STATUS_OK,
+            set->entity,
+            set->component_id,
+            (uint32_t)LT_DEFERRED_OP_SET_COMPONENT);
+    }
+
+    lt_free_bytes(
+        &world->allocator,
+        targets,
+        sizeof(*targets) * (size_t)capacity,
+        _Alignof(lt_deferred_set_target_t));
+    return status;
 }
 
-lt_status_t lt_world_set_trace_hook(lt_world_t* world, lt_trace_hook_fn hook, void* user_data)
+static lt_status_t lt_query_validate_desc(const lt_world_t* world, const lt_query_desc_t* desc)
 {
-    if (world == NULL) {
+    uint32_t i;
+    uint32_t j;
+
+    if (world == NULL || desc == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    world->trace_hook = hook;
-    world->trace_user_data = user_data;
+    if ((desc->with_count > 0u && desc->with_terms == NULL)
+        || (desc->without_count > 0u && desc->without == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (i = 0u; i < desc->with_count; ++i) {
+        lt_component_id_t component_id;
+
+        component_id = desc->with_terms[i].component_id;
+        if (component_id == LT_COMPONENT_INVALID || component_id > world->component_count) {
+            return LT_STATUS_NOT_FOUND;
+        }
+
+        if (desc->with_terms[i].access != LT_ACCESS_READ
+            && desc->with_terms[i].access != LT_ACCESS_WRITE) {
+            return LT_STATUS_INVALID_ARGUMENT;
+        }
+
+        for (j = i + 1u; j < desc->with_count; ++j) {
+            if (desc->with_terms[j].component_id == component_id) {
+                return LT_STATUS_CONFLICT;
+            }
+        }
+    }
+
+    for (i = 0u; i < desc->without_count; ++i) {
+        lt_component_id_t component_id;
+
+        component_id = desc->without[i];
+        if (component_id == LT_COMPONENT_INVALID || component_id > world->component_count) {
+            return LT_STATUS_NOT_FOUND;
+        }
+
+        for (j = i + 1u; j < desc->without_count; ++j) {
+            if (desc->without[j] == component_id) {
+                return LT_STATUS_CONFLICT;
+            }
+        }
+
+        for (j = 0u; j < desc->with_count; ++j) {
+            if (desc->with_terms[j].component_id == component_id) {
+                return LT_STATUS_CONFLICT;
+            }
+        }
+    }
+
+    if (desc->range_count > 0u && desc->ranges == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (i = 0u; i < desc->range_count; ++i) {
+        const lt_query_range_t* range;
+        int in_terms;
+
+        range = &desc->ranges[i];
+        if (range->component_id == LT_COMPONENT_INVALID || range->component_id > world->component_count) {
+            return LT_STATUS_NOT_FOUND;
+        }
+        if (world->components[range->component_id].key == NULL || !(range->min <= range->max)) {
+            return LT_STATUS_INVALID_ARGUMENT;
+        }
+
+        in_terms = 0;
+        for (j = 0u; j < desc->with_count; ++j) {
+            if (desc->with_terms[j].component_id == range->component_id) {
+                in_terms = 1;
+            }
+        }
+        if (!in_terms) {
+            return LT_STATUS_INVALID_ARGUMENT;
+        }
+    }
+
     return LT_STATUS_OK;
 }
 
-lt_status_t lt_world_begin_defer(lt_world_t* world)
+static lt_status_t lt_query_copy_desc(lt_query_t* query, const lt_query_desc_t* desc)
 {
-    if (world == NULL) {
+    lt_world_t* world;
+
+    if (query == NULL || query->world == NULL || desc == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (world->defer_depth == UINT32_MAX) {
-        return LT_STATUS_CAPACITY_REACHED;
+    world = query->world;
+
+    if (desc->with_count > 0u) {
+        if (sizeof(*query->with_terms) > SIZE_MAX / desc->with_count) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+
+        query->with_terms = (lt_query_term_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*query->with_terms) * (size_t)desc->with_count,
+            _Alignof(lt_query_term_t));
+        if (query->with_terms == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memcpy(
+            query->with_terms,
+            desc->with_terms,
+            sizeof(*query->with_terms) * (size_t)desc->with_count);
+        query->with_count = desc->with_count;
     }
 
-    world->defer_depth += 1u;
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_DEFER_BEGIN,
-        LT_STATUS_OK,
-        LT_ENTITY_NULL,
-        LT_COMPONENT_INVALID,
-        0u);
+    if (desc->without_count > 0u) {
+        if (sizeof(*query->without) > SIZE_MAX / desc->without_count) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+
+        query->without = (lt_component_id_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*query->without) * (size_t)desc->without_count,
+            _Alignof(lt_component_id_t));
+        if (query->without == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memcpy(
+            query->without,
+            desc->without,
+            sizeof(*query->without) * (size_t)desc->without_count);
+        query->without_count = desc->without_count;
+    }
+
+    if (desc->range_count > 0u) {
+        if (sizeof(*query->ranges) > SIZE_MAX / desc->range_count) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+
+        query->ranges = (lt_query_range_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*query->ranges) * (size_t)desc->range_count,
+            _Alignof(lt_query_range_t));
+        if (query->ranges == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memcpy(
+            query->ranges,
+            desc->ranges,
+            sizeof(*query->ranges) * (size_t)desc->range_count);
+        query->range_count = desc->range_count;
+    }
+
+    query->group_by = desc->group_by;
+    query->group_by_user_data = desc->group_by_user_data;
+    query->auto_defer = desc->auto_defer;
     return LT_STATUS_OK;
 }
 
-lt_status_t lt_world_end_defer(lt_world_t* world)
+static int lt_query_chunk_in_ranges(
+    const lt_query_t* query,
+    const lt_archetype_t* archetype,
+    lt_chunk_t* chunk)
 {
-    if (world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    uint32_t i;
+
+    for (i = 0u; i < query->range_count; ++i) {
+        const lt_chunk_key_range_t* summary;
+        uint32_t component_index;
+
+        if (!lt_archetype_find_component_index(archetype, query->ranges[i].component_id, &component_index)) {
+            return 0;
+        }
+
+        summary = lt_chunk_key_range_resolve(query->world, archetype, chunk, component_index);
+        if (summary->max < query->ranges[i].min || summary->min > query->ranges[i].max) {
+            return 0;
+        }
     }
 
-    if (world->defer_depth == 0u) {
-        return LT_STATUS_CONFLICT;
+    return 1;
+}
+
+static uint64_t lt_query_match_group(const lt_query_t* query, uint32_t match_index)
+{
+    if (query->match_groups == NULL) {
+        return 0u;
     }
+    return query->match_groups[match_index];
+}
 
-    world->defer_depth -= 1u;
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_DEFER_END,
-        LT_STATUS_OK,
-        LT_ENTITY_NULL,
-        LT_COMPONENT_INVALID,
-        0u);
-    return LT_STATUS_OK;
+static void lt_query_mark_written_key_ranges(
+    const lt_query_t* query,
+    const lt_archetype_t* archetype,
+    lt_chunk_t* chunk)
+{
+    uint32_t i;
+
+    if (chunk->key_ranges == NULL) {
+        return;
+    }
+
+    for (i = 0u; i < query->with_count; ++i) {
+        uint32_t component_index;
+
+        if (query->with_terms[i].access == LT_ACCESS_WRITE
+            && lt_archetype_find_component_index(archetype, query->with_terms[i].component_id, &component_index)) {
+            lt_chunk_key_range_mark_dirty(chunk, component_index);
+        }
+    }
 }
 
-lt_status_t lt_world_flush(lt_world_t* world)
+static void lt_query_record_row_access(const lt_query_t* query, uint32_t row_count)
+{
+    lt_world_t* world;
+    uint32_t i;
+
+    world = query->world;
+    if (world->access_counting == 0u) {
+        return;
+    }
+
+    for (i = 0u; i < query->with_count; ++i) {
+        lt_component_access_stats_t* stats;
+
+        stats = &world->access_stats[query->with_terms[i].component_id];
+        lt_stat_add_u64(
+            query->with_terms[i].access == LT_ACCESS_WRITE ? &stats->write_rows : &stats->read_rows,
+            row_count);
+    }
+}
+
+static int lt_query_matches_archetype(const lt_query_t* query, const lt_archetype_t* archetype)
 {
-    lt_status_t status;
     uint32_t i;
 
-    if (world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
+    if (query == NULL || archetype == NULL) {
+        return 0;
+    }
+
+    for (i = 0u; i < query->with_count; ++i) {
+        if (!lt_archetype_find_component_index(
+                archetype,
+                query->with_terms[i].component_id,
+                NULL)) {
+            return 0;
+        }
+    }
+
+    for (i = 0u; i < query->without_count; ++i) {
+        if (lt_archetype_find_component_index(archetype, query->without[i], NULL)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static lt_status_t lt_query_ensure_match_capacity(lt_query_t* query, uint32_t min_capacity)
+{
+    lt_world_t* world;
+    lt_archetype_t** new_matches;
+    uint64_t* new_groups;
+    size_t old_size;
+    size_t new_size;
+
+    if (query == NULL || query->world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (query->match_capacity >= min_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    if (sizeof(*new_matches) > SIZE_MAX / (size_t)min_capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    world = query->world;
+    new_groups = NULL;
+    if (query->group_by != NULL) {
+        new_groups = (uint64_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*new_groups) * (size_t)min_capacity,
+            _Alignof(uint64_t));
+        if (new_groups == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+    }
+
+    new_size = sizeof(*new_matches) * (size_t)min_capacity;
+    new_matches = (lt_archetype_t**)lt_alloc_bytes(
+        &world->allocator,
+        new_size,
+        _Alignof(lt_archetype_t*));
+    if (new_matches == NULL) {
+        if (new_groups != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                new_groups,
+                sizeof(*new_groups) * (size_t)min_capacity,
+                _Alignof(uint64_t));
+        }
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(new_matches, 0, new_size);
+
+    if (query->matches != NULL && query->match_count > 0u) {
+        old_size = sizeof(*new_matches) * (size_t)query->match_count;
+        memcpy(new_matches, query->matches, old_size);
+        if (new_groups != NULL) {
+            memcpy(new_groups, query->match_groups, sizeof(*new_groups) * (size_t)query->match_count);
+        }
+    }
+
+    if (query->match_groups != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            query->match_groups,
+            sizeof(*query->match_groups) * (size_t)query->match_capacity,
+            _Alignof(uint64_t));
+    }
+
+    if (query->matches != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            query->matches,
+            sizeof(*query->matches) * (size_t)query->match_capacity,
+            _Alignof(lt_archetype_t*));
+    }
+
+    query->matches = new_matches;
+    query->match_groups = new_groups;
+    query->match_capacity = min_capacity;
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_query_ensure_scratch_capacity(lt_query_t* query, uint32_t min_capacity)
+{
+    lt_world_t* world;
+    void** new_columns;
+    size_t new_size;
+
+    if (query == NULL || query->world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (min_capacity == 0u || query->scratch_capacity >= min_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    if (sizeof(*new_columns) > SIZE_MAX / (size_t)min_capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    world = query->world;
+    new_size = sizeof(*new_columns) * (size_t)min_capacity;
+    new_columns = (void**)lt_alloc_bytes(&world->allocator, new_size, _Alignof(void*));
+    if (new_columns == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(new_columns, 0, new_size);
+
+    if (query->scratch_columns != NULL) {
+        if (query->scratch_capacity > 0u) {
+            memcpy(
+                new_columns,
+                query->scratch_columns,
+                sizeof(*new_columns) * (size_t)query->scratch_capacity);
+        }
+        lt_free_bytes(
+            &world->allocator,
+            query->scratch_columns,
+            sizeof(*query->scratch_columns) * (size_t)query->scratch_capacity,
+            _Alignof(void*));
+    }
+
+    query->scratch_columns = new_columns;
+    query->scratch_capacity = min_capacity;
+    return LT_STATUS_OK;
+}
+
+const char* lt_status_string(lt_status_t status)
+{
+    switch (status) {
+        case LT_STATUS_OK:
+            return "LT_STATUS_OK";
+        case LT_STATUS_INVALID_ARGUMENT:
+            return "LT_STATUS_INVALID_ARGUMENT";
+        case LT_STATUS_NOT_FOUND:
+            return "LT_STATUS_NOT_FOUND";
+        case LT_STATUS_ALREADY_EXISTS:
+            return "LT_STATUS_ALREADY_EXISTS";
+        case LT_STATUS_CAPACITY_REACHED:
+            return "LT_STATUS_CAPACITY_REACHED";
+        case LT_STATUS_ALLOCATION_FAILED:
+            return "LT_STATUS_ALLOCATION_FAILED";
+        case LT_STATUS_STALE_ENTITY:
+            return "LT_STATUS_STALE_ENTITY";
+        case LT_STATUS_CONFLICT:
+            return "LT_STATUS_CONFLICT";
+        case LT_STATUS_NOT_IMPLEMENTED:
+            return "LT_STATUS_NOT_IMPLEMENTED";
+        default:
+            return "LT_STATUS_UNKNOWN";
+    }
+}
+
+lt_status_t lt_world_create(const lt_world_config_t* cfg, lt_world_t** out_world)
+{
+    lt_world_t* world;
+    lt_world_config_t local_cfg;
+    lt_allocator_t allocator;
+    lt_status_t status;
+
+    if (out_world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    *out_world = NULL;
+
+    memset(&local_cfg, 0, sizeof(local_cfg));
+    if (cfg != NULL) {
+        local_cfg = *cfg;
+    }
+
+    status = lt_prepare_allocator(cfg, &allocator);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    world = (lt_world_t*)lt_alloc_bytes(
+        &allocator,
+        sizeof(*world),
+        _Alignof(lt_world_t));
+    if (world == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(world, 0, sizeof(*world));
+
+    world->allocator = allocator;
+    world->target_chunk_bytes =
+        local_cfg.target_chunk_bytes == 0u ? LT_DEFAULT_CHUNK_BYTES : local_cfg.target_chunk_bytes;
+    world->empty_archetype_reclaim_flushes = local_cfg.empty_archetype_reclaim_flushes;
+    world->free_entity_head = UINT32_MAX;
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    if (pthread_mutex_init(&world->epoch_mutex, NULL) != 0) {
+        lt_world_destroy(world);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    world->epoch_mutex_ready = 1u;
+#endif
+
+    if (local_cfg.initial_entity_capacity > 0u) {
+        status = lt_grow_entities(world, local_cfg.initial_entity_capacity);
+        if (status != LT_STATUS_OK) {
+            lt_world_destroy(world);
+            return status;
+        }
+    }
+
+    if (local_cfg.initial_component_capacity > 0u) {
+        status = lt_grow_components(world, local_cfg.initial_component_capacity);
+        if (status != LT_STATUS_OK) {
+            lt_world_destroy(world);
+            return status;
+        }
+    }
+
+    status = lt_find_or_create_archetype(world, NULL, 0u, &world->root_archetype);
+    if (status != LT_STATUS_OK) {
+        lt_world_destroy(world);
+        return status;
+    }
+
+    *out_world = world;
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_event_buffer_reserve(
+    const lt_event_channel_t* channel,
+    lt_event_buffer_t* buffer,
+    uint32_t min_capacity)
+{
+    uint32_t new_capacity;
+    size_t new_size;
+    uint8_t* new_data;
+
+    if (buffer->capacity >= min_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    new_capacity = buffer->capacity == 0u ? 64u : buffer->capacity;
+    while (new_capacity < min_capacity) {
+        if (new_capacity > UINT32_MAX / 2u) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        new_capacity *= 2u;
+    }
+
+    if ((size_t)channel->event_size > SIZE_MAX / (size_t)new_capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    new_size = (size_t)channel->event_size * (size_t)new_capacity;
+    new_data = (uint8_t*)lt_default_alloc(NULL, new_size, (size_t)channel->align);
+    if (new_data == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    if (buffer->data != NULL) {
+        memcpy(new_data, buffer->data, (size_t)channel->event_size * (size_t)buffer->count);
+        lt_default_free(
+            NULL,
+            buffer->data,
+            (size_t)channel->event_size * (size_t)buffer->capacity,
+            (size_t)channel->align);
+    }
+
+    buffer->data = new_data;
+    buffer->capacity = new_capacity;
+    return LT_STATUS_OK;
+}
+
+static void lt_event_buffer_release(const lt_event_channel_t* channel, lt_event_buffer_t* buffer)
+{
+    if (buffer->data != NULL) {
+        lt_default_free(
+            NULL,
+            buffer->data,
+            (size_t)channel->event_size * (size_t)buffer->capacity,
+            (size_t)channel->align);
+    }
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+static void lt_event_channel_release(lt_world_t* world, lt_event_channel_t* channel)
+{
+    uint32_t i;
+
+    if (channel->writers != NULL) {
+        for (i = 0u; i < channel->worker_count; ++i) {
+            lt_event_buffer_release(channel, &channel->writers[i]);
+        }
+        lt_free_bytes(
+            &world->allocator,
+            channel->writers,
+            sizeof(*channel->writers) * (size_t)channel->worker_count,
+            _Alignof(lt_event_buffer_t));
+        channel->writers = NULL;
+    }
+    lt_event_buffer_release(channel, &channel->front);
+}
+
+static void lt_world_epoch_lock(lt_world_t* world)
+{
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    (void)pthread_mutex_lock(&world->epoch_mutex);
+#else
+    (void)world;
+#endif
+}
+
+static void lt_world_epoch_unlock(lt_world_t* world)
+{
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    (void)pthread_mutex_unlock(&world->epoch_mutex);
+#else
+    (void)world;
+#endif
+}
+
+static void lt_epoch_chunk_release(lt_world_t* world, lt_epoch_chunk_t* chunk)
+{
+    chunk->refs -= 1u;
+    if (chunk->refs == 0u) {
+        lt_free_bytes(&world->allocator, chunk, chunk->block_size, chunk->block_align);
+    }
+}
+
+static void lt_epoch_free(lt_world_t* world, lt_epoch_t* epoch)
+{
+    uint32_t i;
+
+    if (epoch == NULL) {
+        return;
+    }
+
+    for (i = 0u; i < epoch->chunk_count; ++i) {
+        if (epoch->chunks[i] != NULL) {
+            lt_epoch_chunk_release(world, epoch->chunks[i]);
+        }
+    }
+    for (i = 0u; i < epoch->archetype_count; ++i) {
+        lt_free_bytes(
+            &world->allocator,
+            epoch->archetypes[i].component_ids,
+            sizeof(lt_component_id_t) * (size_t)epoch->archetypes[i].component_count,
+            _Alignof(lt_component_id_t));
+    }
+    lt_free_bytes(
+        &world->allocator,
+        epoch->chunks,
+        sizeof(*epoch->chunks) * (size_t)epoch->chunk_count,
+        _Alignof(lt_epoch_chunk_t*));
+    lt_free_bytes(
+        &world->allocator,
+        epoch->archetypes,
+        sizeof(*epoch->archetypes) * (size_t)epoch->archetype_count,
+        _Alignof(lt_epoch_archetype_t));
+    lt_free_bytes(
+        &world->allocator,
+        epoch->slots,
+        sizeof(*epoch->slots) * (size_t)epoch->slot_count,
+        _Alignof(lt_epoch_slot_t));
+    lt_free_bytes(
+        &world->allocator,
+        epoch->component_sizes,
+        sizeof(*epoch->component_sizes) * ((size_t)epoch->component_count + 1u),
+        _Alignof(uint32_t));
+    lt_free_bytes(&world->allocator, epoch, sizeof(*epoch), _Alignof(lt_epoch_t));
+}
+
+void lt_world_destroy(lt_world_t* world)
+{
+    uint32_t i;
+
+    if (world == NULL) {
+        return;
+    }
+
+    lt_deferred_clear(world);
+
+    lt_epoch_free(world, world->epoch_current);
+    while (world->epoch_retired != NULL) {
+        lt_epoch_t* retired;
+
+        retired = world->epoch_retired;
+        world->epoch_retired = retired->next_retired;
+        lt_epoch_free(world, retired);
+    }
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    if (world->epoch_mutex_ready != 0u) {
+        (void)pthread_mutex_destroy(&world->epoch_mutex);
+    }
+#endif
+
+    lt_transition_stats_clear(world);
+    lt_free_bytes(
+        &world->allocator,
+        world->transitions,
+        sizeof(*world->transitions) * (size_t)world->transition_capacity,
+        _Alignof(lt_transition_record_t));
+    lt_free_bytes(
+        &world->allocator,
+        world->transition_slots,
+        sizeof(*world->transition_slots) * (size_t)world->transition_slot_capacity,
+        _Alignof(uint32_t));
+    lt_free_bytes(
+        &world->allocator,
+        world->component_transitions,
+        sizeof(*world->component_transitions) * (size_t)world->component_transition_capacity,
+        _Alignof(lt_component_transition_stats_t));
+    lt_free_bytes(
+        &world->allocator,
+        world->access_stats,
+        sizeof(*world->access_stats) * (size_t)world->access_stats_capacity,
+        _Alignof(lt_component_access_stats_t));
+
+    if (world->archetypes != NULL) {
+        for (i = 0u; i < world->archetype_count; ++i) {
+            lt_archetype_destroy(world, world->archetypes[i]);
+        }
+
+        lt_free_bytes(
+            &world->allocator,
+            world->archetypes,
+            sizeof(*world->archetypes) * (size_t)world->archetype_capacity,
+            _Alignof(lt_archetype_t*));
+        world->archetypes = NULL;
+    }
+
+    if (world->components != NULL) {
+        for (i = 1u; i <= world->component_count; ++i) {
+            lt_component_record_t* record;
+
+            record = &world->components[i];
+            if (record->name != NULL) {
+                size_t name_size;
+                name_size = strlen(record->name) + 1u;
+                lt_free_bytes(
+                    &world->allocator,
+                    record->name,
+                    name_size,
+                    _Alignof(char));
+                record->name = NULL;
+            }
+        }
+
+        lt_free_bytes(
+            &world->allocator,
+            world->components,
+            sizeof(*world->components) * (size_t)(world->component_capacity + 1u),
+            _Alignof(lt_component_record_t));
+        world->components = NULL;
+    }
+
+    if (world->entities != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->entities,
+            sizeof(*world->entities) * (size_t)world->entity_capacity,
+            _Alignof(lt_entity_slot_t));
+        world->entities = NULL;
+    }
+
+    if (world->deferred_ops != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->deferred_ops,
+            sizeof(*world->deferred_ops) * (size_t)world->deferred_capacity,
+            _Alignof(lt_deferred_op_t));
+        world->deferred_ops = NULL;
+    }
+    if (world->deferred_sets != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->deferred_sets,
+            sizeof(*world->deferred_sets) * (size_t)world->deferred_set_capacity,
+            _Alignof(lt_deferred_set_t));
+        world->deferred_sets = NULL;
+    }
+    if (world->deferred_set_slots != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            world->deferred_set_slots,
+            sizeof(*world->deferred_set_slots) * (size_t)world->deferred_set_slot_capacity,
+            _Alignof(uint32_t));
+        world->deferred_set_slots = NULL;
+    }
+
+    if (world->event_channels != NULL) {
+        for (i = 0u; i < world->event_channel_count; ++i) {
+            lt_event_channel_release(world, &world->event_channels[i]);
+        }
+        lt_free_bytes(
+            &world->allocator,
+            world->event_channels,
+            sizeof(*world->event_channels) * (size_t)world->event_channel_capacity,
+            _Alignof(lt_event_channel_t));
+        world->event_channels = NULL;
+    }
+
+    lt_free_bytes(&world->allocator, world, sizeof(*world), _Alignof(lt_world_t));
+}
+
+lt_status_t lt_world_reserve_entities(lt_world_t* world, uint32_t entity_capacity)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    return lt_grow_entities(world, entity_capacity);
+}
+
+lt_status_t lt_world_reserve_components(lt_world_t* world, uint32_t component_capacity)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    return lt_grow_components(world, component_capacity);
+}
+
+lt_status_t lt_world_set_trace_hook(lt_world_t* world, lt_trace_hook_fn hook, void* user_data)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world->trace_hook = hook;
+    world->trace_user_data = user_data;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_set_access_checks(lt_world_t* world, uint8_t enabled)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world->access_checks = (uint8_t)(enabled != 0u);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_set_access_violation_hook(lt_world_t* world, lt_access_violation_fn hook, void* user_data)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world->access_violation_hook = hook;
+    world->access_violation_user_data = user_data;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_begin_defer(lt_world_t* world)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->defer_depth == UINT32_MAX) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    lt_stat_store_u32(&world->defer_depth, world->defer_depth + 1u);
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_DEFER_BEGIN,
+        LT_STATUS_OK,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        0u);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_end_defer(lt_world_t* world)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->defer_depth == 0u) {
+        return LT_STATUS_CONFLICT;
+    }
+
+    lt_stat_store_u32(&world->defer_depth, world->defer_depth - 1u);
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_DEFER_END,
+        LT_STATUS_OK,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        0u);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_flush(lt_world_t* world)
+{
+    lt_status_t status;
+    uint32_t set_begin;
+    uint32_t set_end;
+    uint32_t i;
+
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->defer_depth != 0u) {
+        return LT_STATUS_CONFLICT;
+    }
+
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_FLUSH_BEGIN,
+        LT_STATUS_OK,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        0u);
+
+    status = LT_STATUS_OK;
+    set_begin = 0u;
+    for (i = 0u; i < world->deferred_count; ++i) {
+        lt_deferred_op_t* op;
+
+        set_end = set_begin;
+        while (set_end < world->deferred_set_count && world->deferred_sets[set_end].sequence <= i) {
+            set_end += 1u;
+        }
+        status = lt_deferred_sets_apply(world, set_begin, set_end);
+        set_begin = set_end;
+        if (status != LT_STATUS_OK) {
+            break;
+        }
+
+        op = &world->deferred_ops[i];
+        switch (op->kind) {
+            case LT_DEFERRED_OP_ADD_COMPONENT:
+                status = lt_add_component(world, op->entity, op->component_id, op->payload);
+                break;
+            case LT_DEFERRED_OP_REMOVE_COMPONENT:
+                status = lt_remove_component(world, op->entity, op->component_id);
+                break;
+            case LT_DEFERRED_OP_DESTROY_ENTITY:
+                status = lt_entity_destroy(world, op->entity);
+                break;
+            case LT_DEFERRED_OP_ADD_COMPONENTS:
+                status = lt_add_components(
+                    world,
+                    op->entity,
+                    op->component_ids,
+                    (const void* const*)op->payloads,
+                    op->component_count);
+                break;
+            case LT_DEFERRED_OP_REMOVE_COMPONENTS:
+                status = lt_remove_components(world, op->entity, op->component_ids, op->component_count);
+                break;
+            default:
+                status = LT_STATUS_INVALID_ARGUMENT;
+                break;
+        }
+
+        if (status != LT_STATUS_OK) {
+            lt_trace_emit(
+                world,
+                LT_TRACE_EVENT_FLUSH_APPLY,
+                status,
+                op->entity,
+                op->component_id,
+                (uint32_t)op->kind);
+            break;
+        }
+
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_FLUSH_APPLY,
+            LT_STATUS_OK,
+            op->entity,
+            op->component_id,
+            (uint32_t)op->kind);
+    }
+
+    if (status == LT_STATUS_OK) {
+        status = lt_deferred_sets_apply(world, set_begin, world->deferred_set_count);
+    }
+
+    lt_deferred_clear(world);
+    lt_world_reclaim_empty_archetypes(world);
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_FLUSH_END,
+        status,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        0u);
+    return status;
+}
+
+lt_status_t lt_entity_create(lt_world_t* world, lt_entity_t* out_entity)
+{
+    uint32_t index;
+    uint32_t generation;
+    lt_entity_slot_t* slot;
+    lt_entity_t entity;
+    lt_chunk_t* chunk;
+    uint32_t row;
+    lt_status_t status;
+    uint8_t reused_slot;
+
+    if (world == NULL || out_entity == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    reused_slot = 0u;
+    if (world->free_entity_head != UINT32_MAX) {
+        index = world->free_entity_head;
+        slot = &world->entities[index];
+        world->free_entity_head = slot->next_free;
+        lt_stat_store_u32(&world->free_entity_count, world->free_entity_count - 1u);
+        reused_slot = 1u;
+    } else {
+        if (world->entity_count == world->entity_capacity) {
+            status = lt_grow_entities(world, world->entity_count + 1u);
+            if (status != LT_STATUS_OK) {
+                return status;
+            }
+        }
+
+        index = world->entity_count;
+        lt_stat_store_u32(&world->entity_count, world->entity_count + 1u);
+        slot = &world->entities[index];
+        memset(slot, 0, sizeof(*slot));
+    }
+
+    if (slot->generation == 0u) {
+        slot->generation = 1u;
+    }
+
+    generation = slot->generation;
+    entity = lt_entity_pack(index, generation);
+
+    status = lt_archetype_alloc_row(world, world->root_archetype, &chunk, &row);
+    if (status != LT_STATUS_OK) {
+        if (reused_slot != 0u) {
+            slot->next_free = world->free_entity_head;
+            world->free_entity_head = index;
+            lt_stat_store_u32(&world->free_entity_count, world->free_entity_count + 1u);
+        } else {
+            lt_stat_store_u32(&world->entity_count, world->entity_count - 1u);
+            memset(slot, 0, sizeof(*slot));
+        }
+        return status;
+    }
+
+    chunk->entities[row] = entity;
+
+    slot->alive = 1u;
+    slot->next_free = UINT32_MAX;
+    slot->archetype = world->root_archetype;
+    slot->chunk = chunk;
+    slot->row = row;
+
+    lt_stat_store_u32(&world->live_entity_count, world->live_entity_count + 1u);
+    *out_entity = entity;
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_ENTITY_CREATE,
+        LT_STATUS_OK,
+        entity,
+        LT_COMPONENT_INVALID,
+        0u);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_entity_destroy(lt_world_t* world, lt_entity_t entity)
+{
+    lt_entity_slot_t* slot;
+    lt_archetype_t* archetype;
+    lt_chunk_t* chunk;
+    uint32_t row;
+    uint32_t i;
+    lt_status_t status;
+
+    if (world == NULL || entity == LT_ENTITY_NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->defer_depth > 0u) {
+        return lt_enqueue_destroy_entity(world, entity);
+    }
+
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_ENTITY_DESTROY,
+            status,
+            entity,
+            LT_COMPONENT_INVALID,
+            0u);
+        return status;
+    }
+
+    archetype = slot->archetype;
+    chunk = slot->chunk;
+    row = slot->row;
+
+    for (i = 0u; i < archetype->component_count; ++i) {
+        lt_component_id_t component_id;
+        const lt_component_record_t* component;
+        void* ptr;
+
+        component_id = archetype->component_ids[i];
+        component = &world->components[component_id];
+        if (component->dtor == NULL || component->size == 0u) {
+            continue;
+        }
+
+        ptr = lt_chunk_component_ptr(world, archetype, chunk, row, i);
+        lt_component_destruct_one(component, ptr);
+    }
+
+    lt_archetype_swap_remove_row(world, archetype, chunk, row);
+
+    slot->alive = 0u;
+    slot->generation += 1u;
+    if (slot->generation == 0u) {
+        slot->generation = 1u;
+    }
+
+    slot->archetype = NULL;
+    slot->chunk = NULL;
+    slot->row = 0u;
+
+    slot->next_free = world->free_entity_head;
+    world->free_entity_head = lt_entity_index(entity);
+    lt_stat_store_u32(&world->free_entity_count, world->free_entity_count + 1u);
+
+    if (world->live_entity_count > 0u) {
+        lt_stat_store_u32(&world->live_entity_count, world->live_entity_count - 1u);
+    }
+
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_ENTITY_DESTROY,
+        LT_STATUS_OK,
+        entity,
+        LT_COMPONENT_INVALID,
+        0u);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_entity_is_alive(const lt_world_t* world, lt_entity_t entity, uint8_t* out_alive)
+{
+    uint32_t index;
+    uint32_t generation;
+    const lt_entity_slot_t* slot;
+
+    if (world == NULL || out_alive == NULL || entity == LT_ENTITY_NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    index = lt_entity_index(entity);
+    generation = lt_entity_generation(entity);
+
+    if (index >= world->entity_count) {
+        *out_alive = 0u;
+        return LT_STATUS_OK;
+    }
+
+    slot = &world->entities[index];
+    *out_alive = (uint8_t)(slot->alive != 0u && slot->generation == generation);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_add_component(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void* initial_value)
+{
+    lt_entity_slot_t* slot;
+    lt_archetype_t* src_archetype;
+    lt_component_id_t* dst_ids;
+    uint32_t dst_count;
+    lt_archetype_t* dst_archetype;
+    lt_status_t status;
+
+    if (world == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    if (world->defer_depth > 0u) {
+        return lt_enqueue_add_component(world, entity, component_id, initial_value);
+    }
+
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_COMPONENT_ADD,
+            status,
+            entity,
+            component_id,
+            0u);
+        return status;
+    }
+
+    src_archetype = slot->archetype;
+
+    if (lt_archetype_find_component_index(src_archetype, component_id, NULL)) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_COMPONENT_ADD,
+            LT_STATUS_ALREADY_EXISTS,
+            entity,
+            component_id,
+            0u);
+        return LT_STATUS_ALREADY_EXISTS;
+    }
+
+    dst_ids = NULL;
+    dst_count = 0u;
+    status = lt_world_component_key_with_add(world, src_archetype, component_id, &dst_ids, &dst_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
+    if (dst_ids != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            dst_ids,
+            sizeof(*dst_ids) * (size_t)dst_count,
+            _Alignof(lt_component_id_t));
+    }
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_entity_move_to_archetype(world, slot, entity, dst_archetype, &component_id, &initial_value, 1u);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    lt_trace_emit_payload(
+        world,
+        LT_TRACE_EVENT_COMPONENT_ADD,
+        LT_STATUS_OK,
+        entity,
+        component_id,
+        0u,
+        NULL,
+        initial_value,
+        world->components[component_id].size);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_remove_component(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id)
+{
+    lt_entity_slot_t* slot;
+    lt_archetype_t* src_archetype;
+    lt_component_id_t* dst_ids;
+    uint32_t dst_count;
+    lt_archetype_t* dst_archetype;
+    lt_status_t status;
+
+    if (world == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    if (world->defer_depth > 0u) {
+        return lt_enqueue_remove_component(world, entity, component_id);
+    }
+
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_COMPONENT_REMOVE,
+            status,
+            entity,
+            component_id,
+            0u);
+        return status;
+    }
+
+    src_archetype = slot->archetype;
+
+    if (!lt_archetype_find_component_index(src_archetype, component_id, NULL)) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_COMPONENT_REMOVE,
+            LT_STATUS_NOT_FOUND,
+            entity,
+            component_id,
+            0u);
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    dst_ids = NULL;
+    dst_count = 0u;
+    status = lt_world_component_key_with_remove(world, src_archetype, component_id, &dst_ids, &dst_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
+    if (dst_ids != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            dst_ids,
+            sizeof(*dst_ids) * (size_t)dst_count,
+            _Alignof(lt_component_id_t));
+    }
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_entity_move_to_archetype(world, slot, entity, dst_archetype, NULL, NULL, 0u);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_COMPONENT_REMOVE,
+        LT_STATUS_OK,
+        entity,
+        component_id,
+        0u);
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_change_components(
+    lt_world_t* world,
+    lt_entity_t entity,
+    const lt_component_id_t* component_ids,
+    const void* const* initial_values,
+    uint32_t component_count,
+    int add)
+{
+    lt_entity_slot_t* slot;
+    lt_archetype_t* src_archetype;
+    lt_component_id_t* dst_ids;
+    uint32_t dst_count;
+    lt_archetype_t* dst_archetype;
+    lt_trace_event_kind_t trace_kind;
+    uint32_t i;
+    lt_status_t status;
+
+    if (world == NULL || entity == LT_ENTITY_NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = lt_component_id_list_validate(world, component_ids, component_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    if (world->defer_depth > 0u) {
+        return lt_enqueue_add_components(
+            world,
+            add ? LT_DEFERRED_OP_ADD_COMPONENTS : LT_DEFERRED_OP_REMOVE_COMPONENTS,
+            entity,
+            component_ids,
+            initial_values,
+            component_count);
+    }
+
+    trace_kind = add ? LT_TRACE_EVENT_COMPONENT_ADD : LT_TRACE_EVENT_COMPONENT_REMOVE;
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(world, trace_kind, status, entity, component_ids[0], component_count);
+        return status;
+    }
+
+    src_archetype = slot->archetype;
+    for (i = 0u; i < component_count; ++i) {
+        if (lt_archetype_find_component_index(src_archetype, component_ids[i], NULL) == add) {
+            status = add ? LT_STATUS_ALREADY_EXISTS : LT_STATUS_NOT_FOUND;
+            lt_trace_emit(world, trace_kind, status, entity, component_ids[i], component_count);
+            return status;
+        }
+    }
+
+    dst_ids = NULL;
+    dst_count = 0u;
+    status = lt_world_component_key_with_set(
+        world,
+        src_archetype,
+        component_ids,
+        component_count,
+        add,
+        &dst_ids,
+        &dst_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
+    if (dst_ids != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            dst_ids,
+            sizeof(*dst_ids) * (size_t)dst_count,
+            _Alignof(lt_component_id_t));
+    }
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_entity_move_to_archetype(
+        world,
+        slot,
+        entity,
+        dst_archetype,
+        add ? component_ids : NULL,
+        add ? initial_values : NULL,
+        add ? component_count : 0u);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    for (i = 0u; i < component_count; ++i) {
+        lt_trace_emit_payload(
+            world,
+            trace_kind,
+            LT_STATUS_OK,
+            entity,
+            component_ids[i],
+            component_count,
+            NULL,
+            add && initial_values != NULL ? initial_values[i] : NULL,
+            world->components[component_ids[i]].size);
+    }
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_add_components(
+    lt_world_t* world,
+    lt_entity_t entity,
+    const lt_component_id_t* component_ids,
+    const void* const* initial_values,
+    uint32_t component_count)
+{
+    return lt_change_components(world, entity, component_ids, initial_values, component_count, 1);
+}
+
+lt_status_t lt_remove_components(
+    lt_world_t* world,
+    lt_entity_t entity,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count)
+{
+    return lt_change_components(world, entity, component_ids, NULL, component_count, 0);
+}
+
+static lt_status_t lt_component_batch_move_group(
+    lt_world_t* world,
+    const lt_entity_t* entities,
+    const uint32_t* order,
+    uint32_t order_count,
+    lt_component_id_t component_id,
+    const uint8_t* initial_values,
+    int add,
+    lt_batch_row_t* rows)
+{
+    const lt_component_record_t* changed;
+    lt_archetype_t* src_archetype;
+    lt_archetype_t* dst_archetype;
+    lt_component_id_t* dst_ids;
+    uint32_t dst_count;
+    uint32_t removed_index;
+    uint32_t position;
+    lt_status_t status;
+
+    changed = &world->components[component_id];
+    src_archetype = world->entities[lt_entity_index(entities[order[0]])].archetype;
+    removed_index = 0u;
+    if (!add) {
+        (void)lt_archetype_find_component_index(src_archetype, component_id, &removed_index);
+    }
+
+    dst_ids = NULL;
+    dst_count = 0u;
+    status = add
+        ? lt_world_component_key_with_add(world, src_archetype, component_id, &dst_ids, &dst_count)
+        : lt_world_component_key_with_remove(world, src_archetype, component_id, &dst_ids, &dst_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
+    if (dst_ids != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            dst_ids,
+            sizeof(*dst_ids) * (size_t)dst_count,
+            _Alignof(lt_component_id_t));
+    }
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    position = 0u;
+    while (position < order_count) {
+        lt_chunk_t* dst_chunk;
+        uint32_t dst_first;
+        uint32_t run_count;
+        uint32_t i;
+        uint32_t k;
+
+        status = lt_archetype_alloc_rows(
+            world,
+            dst_archetype,
+            order_count - position,
+            &dst_chunk,
+            &dst_first,
+            &run_count);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+
+        for (k = 0u; k < run_count; ++k) {
+            const lt_entity_slot_t* slot;
+            lt_entity_t entity;
+
+            entity = entities[order[position + k]];
+            slot = &world->entities[lt_entity_index(entity)];
+            rows[k].chunk = slot->chunk;
+            rows[k].row = slot->row;
+            dst_chunk->entities[dst_first + k] = entity;
+        }
+
+        for (i = 0u; i < dst_archetype->component_count; ++i) {
+            const lt_component_record_t* component;
+            uint8_t* dst_column;
+            uint32_t src_i;
+
+            component = &world->components[dst_archetype->component_ids[i]];
+            if (component->size == 0u) {
+                continue;
+            }
+
+            dst_column = dst_chunk->columns[i] + (size_t)component->size * (size_t)dst_first;
+            if (lt_archetype_find_component_index(src_archetype, dst_archetype->component_ids[i], &src_i)) {
+                for (k = 0u; k < run_count; ++k) {
+                    lt_component_transfer(
+                        component,
+                        dst_column + (size_t)component->size * (size_t)k,
+                        rows[k].chunk->columns[src_i] + (size_t)component->size * (size_t)rows[k].row);
+                }
+            } else {
+                for (k = 0u; k < run_count; ++k) {
+                    lt_component_init_added(
+                        component,
+                        dst_column + (size_t)component->size * (size_t)k,
+                        initial_values != NULL
+                            ? initial_values + (size_t)component->size * (size_t)order[position + k]
+                            : NULL);
+                }
+            }
+        }
+
+        for (k = 0u; k < run_count; ++k) {
+            lt_entity_slot_t* slot;
+
+            if (!add) {
+                lt_component_destruct_one(
+                    changed,
+                    lt_chunk_component_ptr(world, src_archetype, rows[k].chunk, rows[k].row, removed_index));
+            }
+
+            lt_chunk_key_range_include_row(world, dst_archetype, dst_chunk, dst_first + k);
+            slot = &world->entities[lt_entity_index(dst_chunk->entities[dst_first + k])];
+            slot->archetype = dst_archetype;
+            slot->chunk = dst_chunk;
+            slot->row = dst_first + k;
+        }
+        lt_stat_store_u64(&world->structural_move_count, world->structural_move_count + run_count);
+        if (world->transition_tracking != 0u) {
+            lt_world_record_transition(world, src_archetype, dst_archetype, run_count);
+        }
+        if (world->access_counting != 0u) {
+            lt_world_record_moved_bytes(world, src_archetype, dst_archetype, run_count);
+        }
+
+        qsort(rows, run_count, sizeof(*rows), lt_batch_row_compare);
+        for (k = 0u; k < run_count; ++k) {
+            lt_archetype_swap_remove_row(world, src_archetype, rows[k].chunk, rows[k].row);
+        }
+
+        for (k = 0u; k < run_count; ++k) {
+            lt_trace_emit_payload(
+                world,
+                add ? LT_TRACE_EVENT_COMPONENT_ADD : LT_TRACE_EVENT_COMPONENT_REMOVE,
+                LT_STATUS_OK,
+                dst_chunk->entities[dst_first + k],
+                component_id,
+                run_count,
+                NULL,
+                initial_values != NULL ? initial_values + (size_t)changed->size * (size_t)order[position + k] : NULL,
+                changed->size);
+        }
+
+        position += run_count;
+    }
+
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_component_batch_apply(
+    lt_world_t* world,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    lt_component_id_t component_id,
+    const void* initial_values,
+    int add)
+{
+    const lt_component_record_t* component;
+    lt_archetype_t** groups;
+    uint32_t* group_of;
+    uint32_t* group_offsets;
+    uint32_t* order;
+    uint8_t* seen;
+    lt_batch_row_t* rows;
+    uint32_t group_count;
+    uint32_t seen_count;
+    uint32_t i;
+    lt_status_t status;
+
+    if (world == NULL || entities == NULL || entity_count == 0u || component_id == LT_COMPONENT_INVALID) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    component = &world->components[component_id];
+    if (world->defer_depth > 0u) {
+        for (i = 0u; i < entity_count; ++i) {
+            status = add
+                ? lt_enqueue_add_component(
+                    world,
+                    entities[i],
+                    component_id,
+                    initial_values != NULL && component->size > 0u
+                        ? (const uint8_t*)initial_values + (size_t)component->size * (size_t)i
+                        : NULL)
+                : lt_enqueue_remove_component(world, entities[i], component_id);
+            if (status != LT_STATUS_OK) {
+                return status;
+            }
+        }
+        return LT_STATUS_OK;
+    }
+
+    seen_count = world->entity_count > 0u ? world->entity_count : 1u;
+    groups = (lt_archetype_t**)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*groups) * (size_t)entity_count,
+        _Alignof(lt_archetype_t*));
+    group_of = (uint32_t*)lt_alloc_bytes(&world->allocator, sizeof(uint32_t) * (size_t)entity_count, _Alignof(uint32_t));
+    group_offsets = (uint32_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(uint32_t) * ((size_t)entity_count + 1u),
+        _Alignof(uint32_t));
+    order = (uint32_t*)lt_alloc_bytes(&world->allocator, sizeof(uint32_t) * (size_t)entity_count, _Alignof(uint32_t));
+    rows = (lt_batch_row_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*rows) * (size_t)entity_count,
+        _Alignof(lt_batch_row_t));
+    seen = (uint8_t*)lt_alloc_bytes(&world->allocator, (size_t)seen_count, 1u);
+
+    status = LT_STATUS_OK;
+    if (groups == NULL || group_of == NULL || group_offsets == NULL || order == NULL || rows == NULL || seen == NULL) {
+        status = LT_STATUS_ALLOCATION_FAILED;
+    } else {
+        memset(seen, 0, (size_t)seen_count);
+        memset(group_offsets, 0, sizeof(uint32_t) * ((size_t)entity_count + 1u));
+    }
+
+    group_count = 0u;
+    for (i = 0u; i < entity_count && status == LT_STATUS_OK; ++i) {
+        lt_entity_slot_t* slot;
+        uint32_t index;
+        uint32_t g;
+
+        status = lt_world_get_live_slot(world, entities[i], &slot);
+        if (status != LT_STATUS_OK) {
+            break;
+        }
+
+        index = lt_entity_index(entities[i]);
+        if (seen[index] != 0u) {
+            status = LT_STATUS_INVALID_ARGUMENT;
+            break;
+        }
+        seen[index] = 1u;
+
+        if (lt_archetype_find_component_index(slot->archetype, component_id, NULL) == add) {
+            status = add ? LT_STATUS_ALREADY_EXISTS : LT_STATUS_NOT_FOUND;
+            break;
+        }
+
+        for (g = 0u; g < group_count; ++g) {
+            if (groups[g] == slot->archetype) {
+                break;
+            }
+        }
+        if (g == group_count) {
+            groups[group_count] = slot->archetype;
+            group_count += 1u;
+        }
+        group_of[i] = g;
+        group_offsets[g + 1u] += 1u;
+    }
+
+    if (status == LT_STATUS_OK) {
+        for (i = 0u; i < group_count; ++i) {
+            group_offsets[i + 1u] += group_offsets[i];
+        }
+        for (i = 0u; i < entity_count; ++i) {
+            order[group_offsets[group_of[i]]] = i;
+            group_offsets[group_of[i]] += 1u;
+        }
+
+        for (i = 0u; i < group_count && status == LT_STATUS_OK; ++i) {
+            uint32_t begin;
+
+            begin = i == 0u ? 0u : group_offsets[i - 1u];
+            status = lt_component_batch_move_group(
+                world,
+                entities,
+                &order[begin],
+                group_offsets[i] - begin,
+                component_id,
+                (const uint8_t*)initial_values,
+                add,
+                rows);
+        }
+    }
+
+    if (groups != NULL) {
+        lt_free_bytes(&world->allocator, groups, sizeof(*groups) * (size_t)entity_count, _Alignof(lt_archetype_t*));
+    }
+    if (group_of != NULL) {
+        lt_free_bytes(&world->allocator, group_of, sizeof(uint32_t) * (size_t)entity_count, _Alignof(uint32_t));
+    }
+    if (group_offsets != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            group_offsets,
+            sizeof(uint32_t) * ((size_t)entity_count + 1u),
+            _Alignof(uint32_t));
+    }
+    if (order != NULL) {
+        lt_free_bytes(&world->allocator, order, sizeof(uint32_t) * (size_t)entity_count, _Alignof(uint32_t));
+    }
+    if (rows != NULL) {
+        lt_free_bytes(&world->allocator, rows, sizeof(*rows) * (size_t)entity_count, _Alignof(lt_batch_row_t));
+    }
+    if (seen != NULL) {
+        lt_free_bytes(&world->allocator, seen, (size_t)seen_count, 1u);
+    }
+    return status;
+}
+
+lt_status_t lt_add_component_batch(
+    lt_world_t* world,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    lt_component_id_t component_id,
+    const void* initial_values)
+{
+    return lt_component_batch_apply(world, entities, entity_count, component_id, initial_values, 1);
+}
+
+lt_status_t lt_remove_component_batch(
+    lt_world_t* world,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    lt_component_id_t component_id)
+{
+    return lt_component_batch_apply(world, entities, entity_count, component_id, NULL, 0);
+}
+
+static const lt_query_term_t* lt_entry_term(
+    const lt_query_t* query,
+    const lt_query_term_t* random_access,
+    uint32_t index)
+{
+    if (index < query->with_count) {
+        return &query->with_terms[index];
+    }
+    return &random_access[index - query->with_count];
+}
+
+static void lt_world_report_access_violation(
+    const lt_world_t* world,
+    const lt_access_scope_t* scope,
+    lt_access_violation_kind_t kind,
+    lt_entity_t entity,
+    lt_component_id_t component_id)
+{
+    lt_access_violation_t violation;
+
+    if (world->access_violation_hook == NULL) {
+        return;
+    }
+
+    memset(&violation, 0, sizeof(violation));
+    violation.kind = kind;
+    violation.system_name = scope->entry->name;
+    violation.component_name = world->components[component_id].name;
+    violation.component_id = component_id;
+    violation.entity = entity;
+    violation.worker_index = scope->worker_index;
+    world->access_violation_hook(&violation, world->access_violation_user_data);
+}
+
+static lt_status_t lt_world_check_access(
+    const lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    lt_access_t access)
+{
+    const lt_access_scope_t* scope;
+    const lt_schedule_item_t* entry;
+    uint32_t term_count;
+    uint32_t i;
+
+    scope = lt_access_scope;
+    if (scope == NULL || scope->entry->query->world != world) {
+        return LT_STATUS_OK;
+    }
+
+    entry = scope->entry;
+    term_count = entry->query->with_count + entry->random_access_count;
+    for (i = 0u; i < term_count; ++i) {
+        const lt_query_term_t* term;
+
+        term = lt_entry_term(entry->query, entry->random_access, i);
+        if (term->component_id == component_id && (access == LT_ACCESS_READ || term->access == LT_ACCESS_WRITE)) {
+            return LT_STATUS_OK;
+        }
+    }
+
+    lt_world_report_access_violation(
+        world,
+        scope,
+        access == LT_ACCESS_WRITE ? LT_ACCESS_VIOLATION_UNDECLARED_WRITE : LT_ACCESS_VIOLATION_UNDECLARED_READ,
+        entity,
+        component_id);
+    return LT_STATUS_CONFLICT;
+}
+
+lt_status_t lt_has_component(
+    const lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    uint8_t* out_has)
+{
+    lt_entity_slot_t* slot;
+    lt_status_t status;
+
+    if (LT_CHECK(world == NULL || out_has == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (component_id > world->component_count) {
+        *out_has = 0u;
+        return LT_STATUS_OK;
+    }
+
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    *out_has = (uint8_t)lt_archetype_find_component_index(slot->archetype, component_id, NULL);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_get_component(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    void** out_ptr)
+{
+    lt_entity_slot_t* slot;
+    uint32_t component_index;
+    lt_status_t status;
+
+    if (LT_CHECK(world == NULL
+        || out_ptr == NULL
+        || entity == LT_ENTITY_NULL
+        || component_id == LT_COMPONENT_INVALID)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_ptr = NULL;
+
+    if (LT_CHECK(component_id > world->component_count)) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    if (LT_CHECK(world->access_checks != 0u)) {
+        status = lt_world_check_access(world, entity, component_id, LT_ACCESS_READ);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+    }
+
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    if (!lt_archetype_find_component_index(slot->archetype, component_id, &component_index)) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    lt_chunk_key_range_mark_dirty(slot->chunk, component_index);
+    if (world->access_counting != 0u) {
+        lt_stat_add_u64(&world->access_stats[component_id].random_lookups, 1u);
+    }
+    *out_ptr = lt_chunk_component_ptr(world, slot->archetype, slot->chunk, slot->row, component_index);
+    lt_trace_emit(world, LT_TRACE_EVENT_COMPONENT_GET, LT_STATUS_OK, entity, component_id, 0u);
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_component_ref_resolve(lt_world_t* world, lt_component_ref_t* ref)
+{
+    lt_entity_slot_t* slot;
+    uint32_t component_index;
+    lt_status_t status;
+
+    ref->chunk = NULL;
+    ref->ptr = NULL;
+    ref->version = 0u;
+
+    if (ref->component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    status = lt_world_get_live_slot(world, ref->entity, &slot);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    if (!lt_archetype_find_component_index(slot->archetype, ref->component_id, &component_index)) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    ref->chunk = slot->chunk;
+    ref->version = slot->chunk->version;
+    ref->row = slot->row;
+    ref->column = component_index;
+    ref->ptr = lt_chunk_component_ptr(world, slot->archetype, slot->chunk, slot->row, component_index);
+    lt_chunk_key_range_mark_dirty(slot->chunk, component_index);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_component_ref_init(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    lt_component_ref_t* out_ref)
+{
+    if (LT_CHECK(world == NULL
+        || out_ref == NULL
+        || entity == LT_ENTITY_NULL
+        || component_id == LT_COMPONENT_INVALID)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(out_ref, 0, sizeof(*out_ref));
+    out_ref->entity = entity;
+    out_ref->component_id = component_id;
+    if (LT_CHECK(world->access_checks != 0u)) {
+        lt_status_t status;
+
+        status = lt_world_check_access(world, entity, component_id, LT_ACCESS_READ);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+    }
+    return lt_component_ref_resolve(world, out_ref);
+}
+
+lt_status_t lt_component_ref_get(lt_world_t* world, lt_component_ref_t* ref, void** out_ptr)
+{
+    const lt_entity_slot_t* slot;
+    uint32_t index;
+    lt_status_t status;
+
+    if (LT_CHECK(world == NULL || ref == NULL || out_ptr == NULL || ref->entity == LT_ENTITY_NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (LT_CHECK(world->access_checks != 0u)) {
+        status = lt_world_check_access(world, ref->entity, ref->component_id, LT_ACCESS_READ);
+        if (status != LT_STATUS_OK) {
+            *out_ptr = NULL;
+            return status;
+        }
+    }
+
+    index = lt_entity_index(ref->entity);
+    if (index < world->entity_count) {
+        slot = &world->entities[index];
+        if (slot->chunk != NULL
+            && (const void*)slot->chunk == ref->chunk
+            && slot->row == ref->row
+            && slot->chunk->version == ref->version
+            && slot->alive != 0u
+            && slot->generation == lt_entity_generation(ref->entity)) {
+            lt_chunk_key_range_mark_dirty(slot->chunk, ref->column);
+            if (world->access_counting != 0u) {
+                lt_stat_add_u64(&world->access_stats[ref->component_id].random_lookups, 1u);
+            }
+            *out_ptr = ref->ptr;
+            return LT_STATUS_OK;
+        }
+    }
+
+    status = lt_component_ref_resolve(world, ref);
+    if (status == LT_STATUS_OK && world->access_counting != 0u) {
+        lt_stat_add_u64(&world->access_stats[ref->component_id].random_lookups, 1u);
+    }
+    *out_ptr = ref->ptr;
+    return status;
+}
+
+lt_status_t lt_set_component(
+    lt_world_t* world,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void* value)
+{
+    lt_entity_slot_t* slot;
+    uint32_t component_index;
+    lt_status_t status;
+
+    if (LT_CHECK(world == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID || value == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (LT_CHECK(component_id > world->component_count)) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    if (LT_CHECK(world->components[component_id].size == 0u)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (LT_CHECK(world->access_checks != 0u)) {
+        status = lt_world_check_access(world, entity, component_id, LT_ACCESS_WRITE);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+    }
+
+    if (world->defer_depth > 0u) {
+        return lt_enqueue_set_component(world, entity, component_id, value);
+    }
+
+    status = lt_world_get_live_slot(world, entity, &slot);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    if (!lt_archetype_find_component_index(slot->archetype, component_id, &component_index)) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    memcpy(
+        lt_chunk_component_ptr(world, slot->archetype, slot->chunk, slot->row, component_index),
+        value,
+        world->components[component_id].size);
+    lt_chunk_key_range_include_row(world, slot->archetype, slot->chunk, slot->row);
+    lt_trace_emit_payload(
+        world,
+        LT_TRACE_EVENT_COMPONENT_SET,
+        LT_STATUS_OK,
+        entity,
+        component_id,
+        0u,
+        NULL,
+        value,
+        world->components[component_id].size);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_register_component(
+    lt_world_t* world,
+    const lt_component_desc_t* desc,
+    lt_component_id_t* out_id)
+{
+    uint32_t i;
+    lt_component_id_t id;
+    lt_status_t status;
+    lt_component_record_t* record;
+
+    if (world == NULL || desc == NULL || out_id == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = lt_component_desc_validate(desc);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    for (i = 1u; i <= world->component_count; ++i) {
+        if (lt_component_names_equal(world->components[i].name, desc->name)) {
+            return LT_STATUS_ALREADY_EXISTS;
+        }
+    }
+
+    if (world->component_count == UINT32_MAX - 1u) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    id = world->component_count + 1u;
+    status = lt_grow_components(world, id);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    record = &world->components[id];
+    memset(record, 0, sizeof(*record));
+
+    status = lt_component_name_copy(world, desc->name, &record->name);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    record->size = desc->size;
+    record->align = desc->align == 0u ? 1u : desc->align;
+    record->flags = desc->flags;
+    record->ctor = desc->ctor;
+    record->dtor = desc->dtor;
+    record->move = desc->move;
+    record->key = desc->key;
+    record->user = desc->user;
+
+    lt_stat_store_u32(&world->component_count, id);
+    *out_id = id;
+    lt_trace_emit(world, LT_TRACE_EVENT_COMPONENT_REGISTER, LT_STATUS_OK, LT_ENTITY_NULL, id, record->size);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_find_component(
+    const lt_world_t* world,
+    const char* name,
+    lt_component_id_t* out_id)
+{
+    uint32_t i;
+
+    if (world == NULL || name == NULL || name[0] == '\0' || out_id == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (i = 1u; i <= world->component_count; ++i) {
+        if (lt_component_names_equal(world->components[i].name, name)) {
+            *out_id = i;
+            return LT_STATUS_OK;
+        }
+    }
+
+    return LT_STATUS_NOT_FOUND;
+}
+
+static lt_status_t lt_grow_event_channels(lt_world_t* world, uint32_t min_capacity)
+{
+    uint32_t new_capacity;
+    lt_event_channel_t* new_channels;
+
+    if (world->event_channel_capacity >= min_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    new_capacity = world->event_channel_capacity == 0u ? 8u : world->event_channel_capacity;
+    while (new_capacity < min_capacity) {
+        if (new_capacity > UINT32_MAX / 2u) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        new_capacity *= 2u;
+    }
+
+    if (sizeof(*new_channels) > SIZE_MAX / (size_t)new_capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    new_channels = (lt_event_channel_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*new_channels) * (size_t)new_capacity,
+        _Alignof(lt_event_channel_t));
+    if (new_channels == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(new_channels, 0, sizeof(*new_channels) * (size_t)new_capacity);
+
+    if (world->event_channels != NULL) {
+        memcpy(
+            new_channels,
+            world->event_channels,
+            sizeof(*new_channels) * (size_t)world->event_channel_count);
+        lt_free_bytes(
+            &world->allocator,
+            world->event_channels,
+            sizeof(*world->event_channels) * (size_t)world->event_channel_capacity,
+            _Alignof(lt_event_channel_t));
+    }
+
+    world->event_channels = new_channels;
+    world->event_channel_capacity = new_capacity;
+    return LT_STATUS_OK;
+}
+
+static lt_event_channel_t* lt_event_channel_lookup(const lt_world_t* world, lt_event_channel_id_t channel)
+{
+    if (channel == 0u || channel > world->event_channel_count) {
+        return NULL;
+    }
+    return &world->event_channels[channel - 1u];
+}
+
+lt_status_t lt_event_channel_create(
+    lt_world_t* world,
+    const lt_event_channel_desc_t* desc,
+    lt_event_channel_id_t* out_id)
+{
+    lt_event_channel_t* channel;
+    uint32_t worker_count;
+    uint32_t i;
+    lt_status_t status;
+
+    if (world == NULL || desc == NULL || out_id == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (desc->event_size == 0u || (desc->align != 0u && !lt_is_power_of_two_u32(desc->align))) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->event_channel_count == UINT32_MAX - 1u) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    status = lt_grow_event_channels(world, world->event_channel_count + 1u);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    worker_count = desc->worker_count == 0u ? 1u : desc->worker_count;
+    if (sizeof(lt_event_buffer_t) > SIZE_MAX / (size_t)worker_count) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    channel = &world->event_channels[world->event_channel_count];
+    memset(channel, 0, sizeof(*channel));
+    channel->event_size = desc->event_size;
+    channel->align = desc->align == 0u ? 1u : desc->align;
+    channel->worker_count = worker_count;
+    channel->writers = (lt_event_buffer_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*channel->writers) * (size_t)worker_count,
+        _Alignof(lt_event_buffer_t));
+    if (channel->writers == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(channel->writers, 0, sizeof(*channel->writers) * (size_t)worker_count);
+
+    if (desc->initial_capacity > 0u) {
+        for (i = 0u; i < worker_count; ++i) {
+            status = lt_event_buffer_reserve(channel, &channel->writers[i], desc->initial_capacity);
+            if (status != LT_STATUS_OK) {
+                lt_event_channel_release(world, channel);
+                return status;
+            }
+        }
+    }
+
+    world->event_channel_count += 1u;
+    *out_id = world->event_channel_count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_event_write(
+    lt_world_t* world,
+    lt_event_channel_id_t channel,
+    uint32_t worker_index,
+    const void* event)
+{
+    lt_event_channel_t* record;
+    lt_event_buffer_t* buffer;
+    lt_status_t status;
+
+    if (world == NULL || event == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    record = lt_event_channel_lookup(world, channel);
+    if (record == NULL || worker_index >= record->worker_count) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    buffer = &record->writers[worker_index];
+    if (buffer->count == UINT32_MAX) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+    status = lt_event_buffer_reserve(record, buffer, buffer->count + 1u);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    memcpy(
+        buffer->data + (size_t)record->event_size * (size_t)buffer->count,
+        event,
+        (size_t)record->event_size);
+    buffer->count += 1u;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_event_read(
+    const lt_world_t* world,
+    lt_event_channel_id_t channel,
+    const void** out_events,
+    uint32_t* out_count)
+{
+    const lt_event_channel_t* record;
+
+    if (world == NULL || out_events == NULL || out_count == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    record = lt_event_channel_lookup(world, channel);
+    if (record == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_events = record->front.data;
+    *out_count = record->front.count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_swap_events(lt_world_t* world)
+{
+    uint32_t c;
+
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (c = 0u; c < world->event_channel_count; ++c) {
+        lt_event_channel_t* channel;
+        lt_event_buffer_t swapped;
+        uint32_t total;
+        uint32_t i;
+        lt_status_t status;
+
+        channel = &world->event_channels[c];
+        if (channel->worker_count == 1u) {
+            swapped = channel->front;
+            channel->front = channel->writers[0];
+            channel->writers[0] = swapped;
+            channel->writers[0].count = 0u;
+            continue;
+        }
+
+        total = 0u;
+        for (i = 0u; i < channel->worker_count; ++i) {
+            if (channel->writers[i].count > UINT32_MAX - total) {
+                return LT_STATUS_CAPACITY_REACHED;
+            }
+            total += channel->writers[i].count;
+        }
+
+        channel->front.count = 0u;
+        status = lt_event_buffer_reserve(channel, &channel->front, total);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+
+        for (i = 0u; i < channel->worker_count; ++i) {
+            lt_event_buffer_t* writer;
+
+            writer = &channel->writers[i];
+            if (writer->count == 0u) {
+                continue;
+            }
+            memcpy(
+                channel->front.data + (size_t)channel->event_size * (size_t)channel->front.count,
+                writer->data,
+                (size_t)channel->event_size * (size_t)writer->count);
+            channel->front.count += writer->count;
+            writer->count = 0u;
+        }
+    }
+
+    return LT_STATUS_OK;
+}
+
+static size_t lt_epoch_align_up(size_t offset, size_t align)
+{
+    return (offset + align - 1u) & ~(align - 1u);
+}
+
+static lt_status_t lt_epoch_chunk_layout(
+    const lt_world_t* world,
+    const lt_archetype_t* archetype,
+    uint32_t count,
+    uint8_t* block,
+    size_t* out_size,
+    size_t* out_align)
+{
+    lt_epoch_chunk_t* copy;
+    size_t offset;
+    size_t align;
+    uint32_t i;
+
+    copy = (lt_epoch_chunk_t*)(void*)block;
+    align = _Alignof(lt_epoch_chunk_t);
+    if (_Alignof(lt_entity_t) > align) {
+        align = _Alignof(lt_entity_t);
+    }
+
+    offset = lt_epoch_align_up(sizeof(lt_epoch_chunk_t), _Alignof(uint8_t*));
+    if (copy != NULL) {
+        copy->columns = (uint8_t**)(void*)(block + offset);
+    }
+    offset += sizeof(uint8_t*) * (size_t)archetype->component_count;
+    offset = lt_epoch_align_up(offset, _Alignof(lt_entity_t));
+    if (copy != NULL) {
+        copy->entities = (lt_entity_t*)(void*)(block + offset);
+    }
+    offset += sizeof(lt_entity_t) * (size_t)count;
+
+    for (i = 0u; i < archetype->component_count; ++i) {
+        const lt_component_record_t* component;
+        size_t bytes;
+
+        component = &world->components[archetype->component_ids[i]];
+        if (copy != NULL) {
+            copy->columns[i] = NULL;
+        }
+        if (component->size == 0u) {
+            continue;
+        }
+        if ((size_t)component->size > SIZE_MAX / ((size_t)count + 1u)) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        bytes = (size_t)component->size * (size_t)count;
+        if (component->align > align) {
+            align = component->align;
+        }
+        if (offset > SIZE_MAX - align || bytes > SIZE_MAX - align - offset) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        offset = lt_epoch_align_up(offset, component->align);
+        if (copy != NULL) {
+            copy->columns[i] = block + offset;
+        }
+        offset += bytes;
+    }
+
+    *out_size = offset;
+    *out_align = align;
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_epoch_chunk_copy(
+    lt_world_t* world,
+    const lt_archetype_t* archetype,
+    const lt_chunk_t* chunk,
+    lt_epoch_chunk_t** out_chunk)
+{
+    lt_epoch_chunk_t* copy;
+    uint8_t* block;
+    size_t block_size;
+    size_t block_align;
+    uint32_t i;
+    lt_status_t status;
+
+    *out_chunk = NULL;
+    status = lt_epoch_chunk_layout(world, archetype, chunk->count, NULL, &block_size, &block_align);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    block = (uint8_t*)lt_alloc_bytes(&world->allocator, block_size, block_align);
+    if (block == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    copy = (lt_epoch_chunk_t*)(void*)block;
+    memset(copy, 0, sizeof(*copy));
+    (void)lt_epoch_chunk_layout(world, archetype, chunk->count, block, &block_size, &block_align);
+    copy->source = chunk;
+    copy->version = chunk->version;
+    copy->refs = 1u;
+    copy->count = chunk->count;
+    copy->component_count = archetype->component_count;
+    copy->block_size = block_size;
+    copy->block_align = block_align;
+
+    memcpy(copy->entities, chunk->entities, sizeof(lt_entity_t) * (size_t)chunk->count);
+    for (i = 0u; i < archetype->component_count; ++i) {
+        if (copy->columns[i] != NULL) {
+            memcpy(
+                copy->columns[i],
+                chunk->columns[i],
+                (size_t)world->components[archetype->component_ids[i]].size * (size_t)chunk->count);
+        }
+    }
+
+    *out_chunk = copy;
+    return LT_STATUS_OK;
+}
+
+static int lt_epoch_chunk_matches(
+    const lt_world_t* world,
+    const lt_archetype_t* archetype,
+    const lt_chunk_t* chunk,
+    const lt_epoch_chunk_t* copy)
+{
+    uint32_t i;
+
+    if (copy->source != (const void*)chunk
+        || copy->version != chunk->version
+        || copy->count != chunk->count
+        || copy->component_count != archetype->component_count) {
+        return 0;
+    }
+    if (memcmp(copy->entities, chunk->entities, sizeof(lt_entity_t) * (size_t)chunk->count) != 0) {
+        return 0;
+    }
+    for (i = 0u; i < archetype->component_count; ++i) {
+        if (copy->columns[i] != NULL
+            && memcmp(
+                   copy->columns[i],
+                   chunk->columns[i],
+                   (size_t)world->components[archetype->component_ids[i]].size * (size_t)chunk->count)
+                != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int lt_epoch_chunk_source_compare(const void* lhs, const void* rhs)
+{
+    const lt_epoch_chunk_t* a;
+    const lt_epoch_chunk_t* b;
+
+    a = *(const lt_epoch_chunk_t* const*)lhs;
+    b = *(const lt_epoch_chunk_t* const*)rhs;
+    if (a->source != b->source) {
+        return (uintptr_t)a->source < (uintptr_t)b->source ? -1 : 1;
+    }
+    return 0;
+}
+
+static lt_epoch_chunk_t* lt_epoch_find_chunk(
+    lt_epoch_chunk_t* const* sorted,
+    uint32_t count,
+    const lt_chunk_t* chunk)
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    lo = 0u;
+    hi = count;
+    while (lo < hi) {
+        uint32_t mid;
+
+        mid = lo + (hi - lo) / 2u;
+        if ((uintptr_t)sorted[mid]->source < (uintptr_t)(const void*)chunk) {
+            lo = mid + 1u;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < count && sorted[lo]->source == (const void*)chunk) {
+        return sorted[lo];
+    }
+    return NULL;
+}
+
+static lt_status_t lt_epoch_build(
+    lt_world_t* world,
+    lt_epoch_t* epoch,
+    lt_epoch_chunk_t* const* previous,
+    uint32_t previous_count)
+{
+    uint32_t archetype_index;
+    uint32_t chunk_index;
+    uint32_t a;
+    uint32_t i;
+
+    epoch->component_count = world->component_count;
+    epoch->component_sizes = (uint32_t*)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*epoch->component_sizes) * ((size_t)world->component_count + 1u),
+        _Alignof(uint32_t));
+    if (epoch->component_sizes == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    epoch->component_sizes[0] = 0u;
+    for (i = 1u; i <= world->component_count; ++i) {
+        epoch->component_sizes[i] = world->components[i].size;
+    }
+
+    epoch->archetype_count = 0u;
+    epoch->chunk_count = 0u;
+    for (a = 0u; a < world->archetype_count; ++a) {
+        const lt_chunk_t* chunk;
+        uint32_t live_chunks;
+
+        live_chunks = 0u;
+        for (chunk = world->archetypes[a]->chunks; chunk != NULL; chunk = chunk->next) {
+            if (chunk->count > 0u) {
+                live_chunks += 1u;
+            }
+        }
+        if (live_chunks > 0u) {
+            epoch->archetype_count += 1u;
+            epoch->chunk_count += live_chunks;
+        }
+    }
+
+    if (epoch->archetype_count > 0u) {
+        epoch->archetypes = (lt_epoch_archetype_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*epoch->archetypes) * (size_t)epoch->archetype_count,
+            _Alignof(lt_epoch_archetype_t));
+        epoch->chunks = (lt_epoch_chunk_t**)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*epoch->chunks) * (size_t)epoch->chunk_count,
+            _Alignof(lt_epoch_chunk_t*));
+        if (epoch->archetypes == NULL || epoch->chunks == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memset(epoch->archetypes, 0, sizeof(*epoch->archetypes) * (size_t)epoch->archetype_count);
+        memset(epoch->chunks, 0, sizeof(*epoch->chunks) * (size_t)epoch->chunk_count);
+    }
+
+    if (world->entity_count > 0u) {
+        epoch->slots = (lt_epoch_slot_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*epoch->slots) * (size_t)world->entity_count,
+            _Alignof(lt_epoch_slot_t));
+        if (epoch->slots == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        epoch->slot_count = world->entity_count;
+        for (i = 0u; i < world->entity_count; ++i) {
+            epoch->slots[i].generation = world->entities[i].generation;
+            epoch->slots[i].archetype = UINT32_MAX;
+            epoch->slots[i].chunk = 0u;
+            epoch->slots[i].row = 0u;
+        }
+    }
+
+    archetype_index = 0u;
+    chunk_index = 0u;
+    for (a = 0u; a < world->archetype_count; ++a) {
+        const lt_archetype_t* archetype;
+        const lt_chunk_t* chunk;
+        lt_epoch_archetype_t* dst;
+
+        archetype = world->archetypes[a];
+        dst = NULL;
+        for (chunk = archetype->chunks; chunk != NULL; chunk = chunk->next) {
+            lt_epoch_chunk_t* copy;
+            uint32_t row;
+            lt_status_t status;
+
+            if (chunk->count == 0u) {
+                continue;
+            }
+
+            if (dst == NULL) {
+                dst = &epoch->archetypes[archetype_index];
+                archetype_index += 1u;
+                dst->chunk_begin = chunk_index;
+                if (archetype->component_count > 0u) {
+                    dst->component_ids = (lt_component_id_t*)lt_alloc_bytes(
+                        &world->allocator,
+                        sizeof(lt_component_id_t) * (size_t)archetype->component_count,
+                        _Alignof(lt_component_id_t));
+                    if (dst->component_ids == NULL) {
+                        return LT_STATUS_ALLOCATION_FAILED;
+                    }
+                    memcpy(
+                        dst->component_ids,
+                        archetype->component_ids,
+                        sizeof(lt_component_id_t) * (size_t)archetype->component_count);
+                    dst->component_count = archetype->component_count;
+                }
+            }
+
+            copy = lt_epoch_find_chunk(previous, previous_count, chunk);
+            if (copy != NULL && lt_epoch_chunk_matches(world, archetype, chunk, copy)) {
+                copy->refs += 1u;
+                epoch->shared_chunk_count += 1u;
+            } else {
+                status = lt_epoch_chunk_copy(world, archetype, chunk, &copy);
+                if (status != LT_STATUS_OK) {
+                    return status;
+                }
+            }
+            epoch->chunks[chunk_index] = copy;
+            chunk_index += 1u;
+            dst->chunk_end = chunk_index;
+
+            for (row = 0u; row < chunk->count; ++row) {
+                lt_epoch_slot_t* slot;
+
+                slot = &epoch->slots[lt_entity_index(chunk->entities[row])];
+                slot->archetype = archetype_index - 1u;
+                slot->chunk = chunk_index - 1u;
+                slot->row = row;
+            }
+        }
+    }
+
+    epoch->live_entity_count = world->live_entity_count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_publish_epoch(lt_world_t* world, uint64_t* out_epoch_id)
+{
+    lt_epoch_t* epoch;
+    lt_epoch_t* reclaim;
+    lt_epoch_t** link;
+    lt_epoch_chunk_t** previous;
+    uint32_t previous_count;
+    lt_status_t status;
+
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    previous = NULL;
+    previous_count = 0u;
+    if (world->epoch_current != NULL && world->epoch_current->chunk_count > 0u) {
+        previous_count = world->epoch_current->chunk_count;
+        previous = (lt_epoch_chunk_t**)malloc(sizeof(*previous) * (size_t)previous_count);
+        if (previous == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memcpy(previous, world->epoch_current->chunks, sizeof(*previous) * (size_t)previous_count);
+        qsort(previous, previous_count, sizeof(*previous), lt_epoch_chunk_source_compare);
+    }
+
+    epoch = (lt_epoch_t*)lt_alloc_bytes(&world->allocator, sizeof(*epoch), _Alignof(lt_epoch_t));
+    if (epoch == NULL) {
+        free(previous);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(epoch, 0, sizeof(*epoch));
+
+    status = lt_epoch_build(world, epoch, previous, previous_count);
+    free(previous);
+    if (status != LT_STATUS_OK) {
+        lt_epoch_free(world, epoch);
+        return status;
+    }
+
+    reclaim = NULL;
+    lt_world_epoch_lock(world);
+    world->epoch_counter += 1u;
+    epoch->id = world->epoch_counter;
+    if (world->epoch_current != NULL) {
+        world->epoch_current->next_retired = world->epoch_retired;
+        world->epoch_retired = world->epoch_current;
+    }
+    world->epoch_current = epoch;
+    link = &world->epoch_retired;
+    while (*link != NULL) {
+        lt_epoch_t* retired;
+
+        retired = *link;
+        if (retired->pins == 0u) {
+            *link = retired->next_retired;
+            retired->next_retired = reclaim;
+            reclaim = retired;
+        } else {
+            link = &retired->next_retired;
+        }
+    }
+    lt_world_epoch_unlock(world);
+
+    while (reclaim != NULL) {
+        lt_epoch_t* next;
+
+        next = reclaim->next_retired;
+        lt_epoch_free(world, reclaim);
+        reclaim = next;
+    }
+
+    if (out_epoch_id != NULL) {
+        *out_epoch_id = epoch->id;
+    }
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_epoch_pin(lt_world_t* world, const lt_epoch_t** out_epoch)
+{
+    lt_status_t status;
+
+    if (world == NULL || out_epoch == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_epoch = NULL;
+    status = LT_STATUS_NOT_FOUND;
+    lt_world_epoch_lock(world);
+    if (world->epoch_current != NULL) {
+        world->epoch_current->pins += 1u;
+        *out_epoch = world->epoch_current;
+        status = LT_STATUS_OK;
+    }
+    lt_world_epoch_unlock(world);
+    return status;
+}
+
+lt_status_t lt_epoch_release(lt_world_t* world, const lt_epoch_t* epoch)
+{
+    lt_status_t status;
+
+    if (world == NULL || epoch == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = LT_STATUS_INVALID_ARGUMENT;
+    lt_world_epoch_lock(world);
+    if (epoch->pins > 0u) {
+        ((lt_epoch_t*)epoch)->pins -= 1u;
+        status = LT_STATUS_OK;
+    }
+    lt_world_epoch_unlock(world);
+    return status;
+}
+
+lt_status_t lt_epoch_get_info(const lt_epoch_t* epoch, lt_epoch_info_t* out_info)
+{
+    if (epoch == NULL || out_info == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->id = epoch->id;
+    out_info->live_entity_count = epoch->live_entity_count;
+    out_info->chunk_count = epoch->chunk_count;
+    out_info->shared_chunk_count = epoch->shared_chunk_count;
+    return LT_STATUS_OK;
+}
+
+static int lt_epoch_archetype_find(
+    const lt_epoch_archetype_t* archetype,
+    lt_component_id_t component_id,
+    uint32_t* out_index)
+{
+    uint32_t i;
+
+    for (i = 0u; i < archetype->component_count; ++i) {
+        if (archetype->component_ids[i] == component_id) {
+            *out_index = i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+lt_status_t lt_epoch_get_component(
+    const lt_epoch_t* epoch,
+    lt_entity_t entity,
+    lt_component_id_t component_id,
+    const void** out_ptr)
+{
+    const lt_epoch_slot_t* slot;
+    const lt_epoch_chunk_t* chunk;
+    uint32_t index;
+    uint32_t column;
+
+    if (epoch == NULL || out_ptr == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_ptr = NULL;
+    if (component_id > epoch->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    index = lt_entity_index(entity);
+    if (index >= epoch->slot_count) {
+        return LT_STATUS_STALE_ENTITY;
+    }
+    slot = &epoch->slots[index];
+    if (slot->archetype == UINT32_MAX || slot->generation != lt_entity_generation(entity)) {
+        return LT_STATUS_STALE_ENTITY;
+    }
+
+    if (!lt_epoch_archetype_find(&epoch->archetypes[slot->archetype], component_id, &column)) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    chunk = epoch->chunks[slot->chunk];
+    if (chunk->columns[column] != NULL) {
+        *out_ptr = chunk->columns[column] + (size_t)epoch->component_sizes[component_id] * (size_t)slot->row;
+    }
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_epoch_for_each_chunk(
+    const lt_epoch_t* epoch,
+    const lt_component_id_t* component_ids,
+    uint32_t component_count,
+    lt_epoch_chunk_fn callback,
+    void* user_data)
+{
+    uint32_t* indices;
+    void** columns;
+    uint32_t a;
+
+    if (epoch == NULL || callback == NULL || (component_ids == NULL && component_count > 0u)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    if (sizeof(*columns) > SIZE_MAX / ((size_t)component_count + 1u)) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    indices = (uint32_t*)malloc(sizeof(*indices) * ((size_t)component_count + 1u));
+    columns = (void**)malloc(sizeof(*columns) * ((size_t)component_count + 1u));
+    if (indices == NULL || columns == NULL) {
+        free(columns);
+        free(indices);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    for (a = 0u; a < epoch->archetype_count; ++a) {
+        const lt_epoch_archetype_t* archetype;
+        uint32_t c;
+        uint32_t i;
+
+        archetype = &epoch->archetypes[a];
+        for (i = 0u; i < component_count; ++i) {
+            if (!lt_epoch_archetype_find(archetype, component_ids[i], &indices[i])) {
+                break;
+            }
+        }
+        if (i < component_count) {
+            continue;
+        }
+
+        for (c = archetype->chunk_begin; c < archetype->chunk_end; ++c) {
+            const lt_epoch_chunk_t* chunk;
+            lt_chunk_view_t view;
+
+            chunk = epoch->chunks[c];
+            for (i = 0u; i < component_count; ++i) {
+                columns[i] = chunk->columns[indices[i]];
+            }
+            memset(&view, 0, sizeof(view));
+            view.count = chunk->count;
+            view.entities = chunk->entities;
+            view.columns = columns;
+            view.column_count = component_count;
+            callback(&view, user_data);
+        }
+    }
+
+    free(columns);
+    free(indices);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_query_create(lt_world_t* world, const lt_query_desc_t* desc, lt_query_t** out_query)
+{
+    lt_query_t* query;
+    lt_status_t status;
+
+    if (world == NULL || desc == NULL || out_query == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    *out_query = NULL;
+
+    status = lt_query_validate_desc(world, desc);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    query = (lt_query_t*)lt_alloc_bytes(&world->allocator, sizeof(*query), _Alignof(lt_query_t));
+    if (query == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(query, 0, sizeof(*query));
+    query->world = world;
+
+    status = lt_query_copy_desc(query, desc);
+    if (status != LT_STATUS_OK) {
+        lt_query_destroy(query);
+        return status;
+    }
+
+    status = lt_query_ensure_scratch_capacity(query, query->with_count);
+    if (status != LT_STATUS_OK) {
+        lt_query_destroy(query);
+        return status;
+    }
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK) {
+        lt_query_destroy(query);
+        return status;
+    }
+
+    *out_query = query;
+    return LT_STATUS_OK;
+}
+
+void lt_query_destroy(lt_query_t* query)
+{
+    lt_world_t* world;
+
+    if (query == NULL) {
+        return;
+    }
+
+    world = query->world;
+    if (world != NULL) {
+        if (query->with_terms != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                query->with_terms,
+                sizeof(*query->with_terms) * (size_t)query->with_count,
+                _Alignof(lt_query_term_t));
+        }
+        if (query->without != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                query->without,
+                sizeof(*query->without) * (size_t)query->without_count,
+                _Alignof(lt_component_id_t));
+        }
+        if (query->ranges != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                query->ranges,
+                sizeof(*query->ranges) * (size_t)query->range_count,
+                _Alignof(lt_query_range_t));
+        }
+        if (query->matches != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                query->matches,
+                sizeof(*query->matches) * (size_t)query->match_capacity,
+                _Alignof(lt_archetype_t*));
+        }
+        if (query->match_groups != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                query->match_groups,
+                sizeof(*query->match_groups) * (size_t)query->match_capacity,
+                _Alignof(uint64_t));
+        }
+        if (query->scratch_columns != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                query->scratch_columns,
+                sizeof(*query->scratch_columns) * (size_t)query->scratch_capacity,
+                _Alignof(void*));
+        }
+        lt_free_bytes(&world->allocator, query, sizeof(*query), _Alignof(lt_query_t));
+    }
+}
+
+static void lt_query_insert_match(lt_query_t* query, lt_archetype_t* archetype)
+{
+    uint64_t group_id;
+    uint32_t position;
+
+    if (query->group_by == NULL) {
+        query->matches[query->match_count] = archetype;
+        query->match_count += 1u;
+        return;
+    }
+
+    group_id = query->group_by(archetype->component_ids, archetype->component_count, query->group_by_user_data);
+    position = query->match_count;
+    while (position > 0u && query->match_groups[position - 1u] > group_id) {
+        query->matches[position] = query->matches[position - 1u];
+        query->match_groups[position] = query->match_groups[position - 1u];
+        position -= 1u;
+    }
+
+    query->matches[position] = archetype;
+    query->match_groups[position] = group_id;
+    query->match_count += 1u;
+}
+
+lt_status_t lt_query_copy_terms(
+    const lt_query_t* query,
+    lt_query_term_t* out_terms,
+    uint32_t max_terms,
+    uint32_t* out_count)
+{
+    uint32_t copied;
+
+    if (query == NULL || out_count == NULL || (max_terms > 0u && out_terms == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    copied = query->with_count < max_terms ? query->with_count : max_terms;
+    if (copied > 0u) {
+        memcpy(out_terms, query->with_terms, sizeof(*out_terms) * (size_t)copied);
+    }
+    *out_count = copied;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_query_copy_without(
+    const lt_query_t* query,
+    lt_component_id_t* out_component_ids,
+    uint32_t max_component_ids,
+    uint32_t* out_count)
+{
+    uint32_t copied;
+
+    if (query == NULL || out_count == NULL || (max_component_ids > 0u && out_component_ids == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    copied = query->without_count < max_component_ids ? query->without_count : max_component_ids;
+    if (copied > 0u) {
+        memcpy(out_component_ids, query->without, sizeof(*out_component_ids) * (size_t)copied);
+    }
+    *out_count = copied;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_query_refresh(lt_query_t* query)
+{
+    lt_world_t* world;
+    uint32_t i;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world = query->world;
+    if (query->archetype_generation != world->archetype_generation) {
+        query->archetype_generation = world->archetype_generation;
+        query->scanned_archetype_count = 0u;
+        query->match_count = 0u;
+    }
+
+    if (query->scanned_archetype_count == world->archetype_count) {
+        return LT_STATUS_OK;
+    }
+
+    status = lt_query_ensure_match_capacity(query, world->archetype_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    for (i = query->scanned_archetype_count; i < world->archetype_count; ++i) {
+        lt_archetype_t* archetype;
+
+        archetype = world->archetypes[i];
+        if (archetype == NULL) {
+            continue;
+        }
+
+        if (lt_query_matches_archetype(query, archetype)) {
+            lt_query_insert_match(query, archetype);
+        }
+    }
+
+    query->scanned_archetype_count = world->archetype_count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_query_count(
+    lt_query_t* query,
+    uint32_t* out_entity_count,
+    uint32_t* out_chunk_count)
+{
+    uint32_t entity_count;
+    uint32_t chunk_count;
+    uint32_t i;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL || out_entity_count == NULL || out_chunk_count == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_entity_count = 0u;
+    *out_chunk_count = 0u;
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    entity_count = 0u;
+    chunk_count = 0u;
+    for (i = 0u; i < query->match_count; ++i) {
+        entity_count += query->matches[i]->row_count;
+        chunk_count += query->matches[i]->live_chunk_count;
+    }
+
+    *out_entity_count = entity_count;
+    *out_chunk_count = chunk_count;
+    return LT_STATUS_OK;
+}
+
+typedef struct lt_sort_scratch_s {
+    uint32_t capacity;
+    uint64_t* keys;
+    uint64_t* keys_tmp;
+    uint32_t* order;
+    uint32_t* order_tmp;
+    lt_chunk_t** row_chunks;
+    uint32_t* row_rows;
+    uint8_t* values;
+    size_t value_bytes;
+    size_t value_align;
+} lt_sort_scratch_t;
+
+static uint64_t lt_sort_key_bits(double key)
+{
+    uint64_t bits;
+
+    if (key == 0.0) {
+        key = 0.0;
+    }
+
+    memcpy(&bits, &key, sizeof(bits));
+    if ((bits >> 63) != 0u) {
+        return ~bits;
+    }
+    return bits | ((uint64_t)1u << 63);
+}
+
+static void lt_sort_scratch_free(lt_world_t* world, lt_sort_scratch_t* scratch)
+{
+    size_t capacity;
+
+    capacity = (size_t)scratch->capacity;
+    if (scratch->keys != NULL) {
+        lt_free_bytes(&world->allocator, scratch->keys, sizeof(*scratch->keys) * capacity, _Alignof(uint64_t));
+    }
+    if (scratch->keys_tmp != NULL) {
+        lt_free_bytes(&world->allocator, scratch->keys_tmp, sizeof(*scratch->keys_tmp) * capacity, _Alignof(uint64_t));
+    }
+    if (scratch->order != NULL) {
+        lt_free_bytes(&world->allocator, scratch->order, sizeof(*scratch->order) * capacity, _Alignof(uint32_t));
+    }
+    if (scratch->order_tmp != NULL) {
+        lt_free_bytes(&world->allocator, scratch->order_tmp, sizeof(*scratch->order_tmp) * capacity, _Alignof(uint32_t));
+    }
+    if (scratch->row_chunks != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            scratch->row_chunks,
+            sizeof(*scratch->row_chunks) * capacity,
+            _Alignof(lt_chunk_t*));
+    }
+    if (scratch->row_rows != NULL) {
+        lt_free_bytes(&world->allocator, scratch->row_rows, sizeof(*scratch->row_rows) * capacity, _Alignof(uint32_t));
+    }
+    if (scratch->values != NULL) {
+        lt_free_bytes(&world->allocator, scratch->values, scratch->value_bytes, scratch->value_align);
+    }
+    memset(scratch, 0, sizeof(*scratch));
+}
+
+static lt_status_t lt_sort_scratch_init(
+    lt_world_t* world,
+    const lt_query_t* query,
+    lt_sort_scratch_t* scratch)
+{
+    uint32_t max_rows;
+    size_t max_size;
+    size_t max_align;
+    size_t capacity;
+    uint32_t i;
+    uint32_t j;
+
+    memset(scratch, 0, sizeof(*scratch));
+    max_rows = 0u;
+    max_size = sizeof(lt_entity_t);
+    max_align = _Alignof(lt_entity_t);
+    for (i = 0u; i < query->match_count; ++i) {
+        const lt_archetype_t* archetype;
+
+        archetype = query->matches[i];
+        if (archetype->row_count > max_rows) {
+            max_rows = archetype->row_count;
+        }
+        for (j = 0u; j < archetype->component_count; ++j) {
+            const lt_component_record_t* component;
+
+            component = &world->components[archetype->component_ids[j]];
+            if (component->size > max_size) {
+                max_size = component->size;
+            }
+            if (component->align > max_align) {
+                max_align = component->align;
+            }
+        }
+    }
+
+    if (max_rows < 2u) {
+        return LT_STATUS_OK;
+    }
+
+    capacity = (size_t)max_rows;
+    if (max_size > SIZE_MAX / capacity || sizeof(uint64_t) > SIZE_MAX / capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    scratch->capacity = max_rows;
+    scratch->value_bytes = max_size * capacity;
+    scratch->value_align = max_align;
+    scratch->keys = (uint64_t*)lt_alloc_bytes(&world->allocator, sizeof(uint64_t) * capacity, _Alignof(uint64_t));
+    scratch->keys_tmp = (uint64_t*)lt_alloc_bytes(&world->allocator, sizeof(uint64_t) * capacity, _Alignof(uint64_t));
+    scratch->order = (uint32_t*)lt_alloc_bytes(&world->allocator, sizeof(uint32_t) * capacity, _Alignof(uint32_t));
+    scratch->order_tmp = (uint32_t*)lt_alloc_bytes(&world->allocator, sizeof(uint32_t) * capacity, _Alignof(uint32_t));
+    scratch->row_chunks = (lt_chunk_t**)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(lt_chunk_t*) * capacity,
+        _Alignof(lt_chunk_t*));
+    scratch->row_rows = (uint32_t*)lt_alloc_bytes(&world->allocator, sizeof(uint32_t) * capacity, _Alignof(uint32_t));
+    scratch->values = (uint8_t*)lt_alloc_bytes(&world->allocator, scratch->value_bytes, scratch->value_align);
+    if (scratch->keys == NULL || scratch->keys_tmp == NULL || scratch->order == NULL || scratch->order_tmp == NULL
+        || scratch->row_chunks == NULL || scratch->row_rows == NULL || scratch->values == NULL) {
+        lt_sort_scratch_free(world, scratch);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    return LT_STATUS_OK;
+}
+
+static void lt_sort_radix(lt_sort_scratch_t* scratch, uint32_t count)
+{
+    uint32_t histogram[256];
+    uint64_t* keys;
+    uint64_t* keys_tmp;
+    uint32_t* order;
+    uint32_t* order_tmp;
+    uint32_t shift;
+    uint32_t i;
+
+    keys = scratch->keys;
+    keys_tmp = scratch->keys_tmp;
+    order = scratch->order;
+    order_tmp = scratch->order_tmp;
+    for (shift = 0u; shift < 64u; shift += 8u) {
+        uint32_t offset;
+        uint64_t* swap_keys;
+        uint32_t* swap_order;
+
+        memset(histogram, 0, sizeof(histogram));
+        for (i = 0u; i < count; ++i) {
+            histogram[(keys[i] >> shift) & 0xFFu] += 1u;
+        }
+        if (histogram[(keys[0] >> shift) & 0xFFu] == count) {
+            continue;
+        }
+
+        offset = 0u;
+        for (i = 0u; i < 256u; ++i) {
+            uint32_t bucket_count;
+
+            bucket_count = histogram[i];
+            histogram[i] = offset;
+            offset += bucket_count;
+        }
+
+        for (i = 0u; i < count; ++i) {
+            uint32_t dst;
+
+            dst = histogram[(keys[i] >> shift) & 0xFFu]++;
+            keys_tmp[dst] = keys[i];
+            order_tmp[dst] = order[i];
+        }
+
+        swap_keys = keys;
+        keys = keys_tmp;
+        keys_tmp = swap_keys;
+        swap_order = order;
+        order = order_tmp;
+        order_tmp = swap_order;
+    }
+
+    scratch->keys = keys;
+    scratch->keys_tmp = keys_tmp;
+    scratch->order = order;
+    scratch->order_tmp = order_tmp;
+}
+
+static void lt_sort_merge(
+    lt_sort_scratch_t* scratch,
+    uint32_t count,
+    const lt_component_record_t* component,
+    uint32_t component_index,
+    lt_component_compare_fn compare,
+    void* user)
+{
+    uint32_t* order;
+    uint32_t* order_tmp;
+    uint32_t width;
+
+    order = scratch->order;
+    order_tmp = scratch->order_tmp;
+    for (width = 1u; width < count; width = (width > count / 2u) ? count : width * 2u) {
+        uint32_t begin;
+        uint32_t* swap_order;
+
+        for (begin = 0u; begin < count; begin += 2u * width) {
+            uint32_t left;
+            uint32_t middle;
+            uint32_t right;
+            uint32_t end;
+            uint32_t out;
+
+            middle = (count - begin > width) ? begin + width : count;
+            end = (count - middle > width) ? middle + width : count;
+            left = begin;
+            right = middle;
+            out = begin;
+            while (left < middle && right < end) {
+                const uint8_t* lhs;
+                const uint8_t* rhs;
+
+                lhs = scratch->row_chunks[order[left]]->columns[component_index]
+                    + (size_t)component->size * (size_t)scratch->row_rows[order[left]];
+                rhs = scratch->row_chunks[order[right]]->columns[component_index]
+                    + (size_t)component->size * (size_t)scratch->row_rows[order[right]];
+                if (compare(rhs, lhs, user) < 0) {
+                    order_tmp[out++] = order[right++];
+                } else {
+                    order_tmp[out++] = order[left++];
+                }
+            }
+            while (left < middle) {
+                order_tmp[out++] = order[left++];
+            }
+            while (right < end) {
+                order_tmp[out++] = order[right++];
+            }
+        }
+
+        swap_order = order;
+        order = order_tmp;
+        order_tmp = swap_order;
+    }
+
+    scratch->order = order;
+    scratch->order_tmp = order_tmp;
+}
+
+static void lt_sort_apply_permutation(
+    lt_world_t* world,
+    lt_archetype_t* archetype,
+    lt_sort_scratch_t* scratch,
+    uint32_t count)
+{
+    lt_entity_t* entities;
+    lt_chunk_t* chunk;
+    uint32_t offset;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0u; i < archetype->component_count; ++i) {
+        const lt_component_record_t* component;
+        size_t size;
+
+        component = &world->components[archetype->component_ids[i]];
+        size = (size_t)component->size;
+        if (size == 0u) {
+            continue;
+        }
+
+        for (j = 0u; j < count; ++j) {
+            uint32_t src;
+
+            src = scratch->order[j];
+            lt_component_transfer(
+                component,
+                scratch->values + size * (size_t)j,
+                scratch->row_chunks[src]->columns[i] + size * (size_t)scratch->row_rows[src]);
+        }
+
+        offset = 0u;
+        for (chunk = archetype->chunks; chunk != NULL; chunk = chunk->next) {
+            if (chunk->count == 0u) {
+                continue;
+            }
+            if (component->move != NULL) {
+                component->move(chunk->columns[i], scratch->values + size * (size_t)offset, chunk->count, component->user);
+            } else {
+                memcpy(chunk->columns[i], scratch->values + size * (size_t)offset, size * (size_t)chunk->count);
+            }
+            offset += chunk->count;
+        }
+    }
+
+    entities = (lt_entity_t*)scratch->values;
+    for (j = 0u; j < count; ++j) {
+        uint32_t src;
+
+        src = scratch->order[j];
+        entities[j] = scratch->row_chunks[src]->entities[scratch->row_rows[src]];
+    }
+
+    offset = 0u;
+    for (chunk = archetype->chunks; chunk != NULL; chunk = chunk->next) {
+        if (chunk->count == 0u) {
+            continue;
+        }
+
+        memcpy(chunk->entities, entities + offset, sizeof(*entities) * (size_t)chunk->count);
+        world->chunk_version += 1u;
+        chunk->version = world->chunk_version;
+        for (j = 0u; j < chunk->count; ++j) {
+            lt_entity_slot_t* slot;
+
+            slot = &world->entities[lt_entity_index(chunk->entities[j])];
+            slot->chunk = chunk;
+            slot->row = j;
+        }
+        if (chunk->key_ranges != NULL) {
+            for (j = 0u; j < archetype->component_count; ++j) {
+                lt_chunk_key_range_mark_dirty(chunk, j);
+            }
+        }
+        offset += chunk->count;
+    }
+}
+
+lt_status_t lt_query_sort(
+    lt_query_t* query,
+    lt_component_id_t component_id,
+    lt_component_key_fn key,
+    lt_component_compare_fn compare,
+    void* user)
+{
+    lt_world_t* world;
+    const lt_component_record_t* component;
+    lt_sort_scratch_t scratch;
+    void* key_user;
+    uint32_t match_index;
+    uint32_t i;
+    int in_terms;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL || (key != NULL && compare != NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world = query->world;
+    if (component_id == LT_COMPONENT_INVALID || component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+
+    component = &world->components[component_id];
+    key_user = user;
+    if (key == NULL && compare == NULL) {
+        key = component->key;
+        key_user = component->user;
+    }
+    if (component->size == 0u || (key == NULL && compare == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    in_terms = 0;
+    for (i = 0u; i < query->with_count; ++i) {
+        if (query->with_terms[i].component_id == component_id) {
+            in_terms = 1;
+        }
+    }
+    if (!in_terms) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (world->defer_depth > 0u) {
+        return LT_STATUS_CONFLICT;
+    }
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    status = lt_sort_scratch_init(world, query, &scratch);
+    if (status != LT_STATUS_OK || scratch.capacity == 0u) {
+        return status;
+    }
+
+    for (match_index = 0u; match_index < query->match_count; ++match_index) {
+        lt_archetype_t* archetype;
+        lt_chunk_t* chunk;
+        uint32_t component_index;
+        uint32_t count;
+
+        archetype = query->matches[match_index];
+        if (archetype->row_count < 2u
+            || !lt_archetype_find_component_index(archetype, component_id, &component_index)) {
+            continue;
+        }
+
+        count = 0u;
+        for (chunk = archetype->chunks; chunk != NULL; chunk = chunk->next) {
+            uint32_t row;
+
+            for (row = 0u; row < chunk->count; ++row) {
+                scratch.row_chunks[count] = chunk;
+                scratch.row_rows[count] = row;
+                scratch.order[count] = count;
+                if (key != NULL) {
+                    scratch.keys[count] = lt_sort_key_bits(
+                        key(chunk->columns[component_index] + (size_t)component->size * (size_t)row, key_user));
+                }
+                count += 1u;
+            }
+        }
+
+        if (key != NULL) {
+            lt_sort_radix(&scratch, count);
+        } else {
+            lt_sort_merge(&scratch, count, component, component_index, compare, user);
+        }
+
+        for (i = 0u; i < count; ++i) {
+            if (scratch.order[i] != i) {
+                break;
+            }
+        }
+        if (i < count) {
+            lt_sort_apply_permutation(world, archetype, &scratch, count);
+        }
+    }
+
+    lt_sort_scratch_free(world, &scratch);
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_chunk_relink_columns(
+    lt_world_t* world,
+    const lt_archetype_t* src_archetype,
+    const lt_archetype_t* dst_archetype,
+    lt_chunk_t* chunk)
+{
+    uint8_t** columns;
+    lt_chunk_key_range_t* key_ranges;
+    uint32_t src_i;
+    uint32_t dst_i;
+
+    columns = NULL;
+    if (dst_archetype->component_count > 0u) {
+        columns = (uint8_t**)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*columns) * (size_t)dst_archetype->component_count,
+            _Alignof(uint8_t*));
+        if (columns == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+    }
+
+    key_ranges = NULL;
+    if (chunk->key_ranges != NULL) {
+        key_ranges = (lt_chunk_key_range_t*)lt_alloc_bytes(
+            &world->allocator,
+            sizeof(*key_ranges) * (size_t)dst_archetype->component_count,
+            _Alignof(lt_chunk_key_range_t));
+        if (key_ranges == NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                columns,
+                sizeof(*columns) * (size_t)dst_archetype->component_count,
+                _Alignof(uint8_t*));
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+    }
+
+    src_i = 0u;
+    for (dst_i = 0u; dst_i < dst_archetype->component_count; ++dst_i) {
+        while (src_i < src_archetype->component_count
+            && src_archetype->component_ids[src_i] < dst_archetype->component_ids[dst_i]) {
+            src_i += 1u;
+        }
+
+        if (src_i < src_archetype->component_count
+            && src_archetype->component_ids[src_i] == dst_archetype->component_ids[dst_i]) {
+            columns[dst_i] = chunk->columns[src_i];
+            if (key_ranges != NULL) {
+                key_ranges[dst_i] = chunk->key_ranges[src_i];
+            }
+            src_i += 1u;
+            continue;
+        }
+
+        columns[dst_i] = NULL;
+        if (key_ranges != NULL) {
+            key_ranges[dst_i].min = DBL_MAX;
+            key_ranges[dst_i].max = -DBL_MAX;
+            key_ranges[dst_i].dirty = 0u;
+        }
+    }
+
+    if (chunk->columns != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            chunk->columns,
+            sizeof(*chunk->columns) * (size_t)src_archetype->component_count,
+            _Alignof(uint8_t*));
+    }
+    if (chunk->key_ranges != NULL) {
+        lt_free_bytes(
+            &world->allocator,
+            chunk->key_ranges,
+            sizeof(*chunk->key_ranges) * (size_t)src_archetype->component_count,
+            _Alignof(lt_chunk_key_range_t));
+    }
+
+    chunk->columns = columns;
+    chunk->key_ranges = key_ranges;
+    world->chunk_version += 1u;
+    chunk->version = world->chunk_version;
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_archetype_relink_chunks(
+    lt_world_t* world,
+    lt_archetype_t* src_archetype,
+    lt_archetype_t* dst_archetype,
+    lt_component_id_t tag_id,
+    int add)
+{
+    lt_chunk_t* chunk;
+    lt_chunk_t* kept_head;
+    lt_chunk_t* kept_tail;
+    lt_status_t status;
+
+    status = LT_STATUS_OK;
+    kept_head = NULL;
+    kept_tail = NULL;
+    chunk = src_archetype->chunks;
+    while (chunk != NULL) {
+        lt_chunk_t* next;
+        uint32_t row;
+
+        next = chunk->next;
+        chunk->next = NULL;
+        if (chunk->count == 0u || status != LT_STATUS_OK
+            || (status = lt_chunk_relink_columns(world, src_archetype, dst_archetype, chunk)) != LT_STATUS_OK) {
+            if (kept_tail != NULL) {
+                kept_tail->next = chunk;
+            } else {
+                kept_head = chunk;
+            }
+            kept_tail = chunk;
+            chunk = next;
+            continue;
+        }
+
+        for (row = 0u; row < chunk->count; ++row) {
+            world->entities[lt_entity_index(chunk->entities[row])].archetype = dst_archetype;
+        }
+        if (world->transition_tracking != 0u) {
+            lt_world_record_transition(world, src_archetype, dst_archetype, chunk->count);
+        }
+        if (world->access_counting != 0u) {
+            lt_world_record_moved_bytes(world, src_archetype, dst_archetype, chunk->count);
+        }
+        for (row = 0u; row < chunk->count; ++row) {
+            lt_trace_emit(
+                world,
+                add ? LT_TRACE_EVENT_COMPONENT_ADD : LT_TRACE_EVENT_COMPONENT_REMOVE,
+                LT_STATUS_OK,
+                chunk->entities[row],
+                tag_id,
+                chunk->count);
+        }
+
+        if (dst_archetype->chunk_tail != NULL) {
+            dst_archetype->chunk_tail->next = chunk;
+        } else {
+            dst_archetype->chunks = chunk;
+        }
+        dst_archetype->chunk_tail = chunk;
+        dst_archetype->chunk_count += 1u;
+        dst_archetype->live_chunk_count += 1u;
+        dst_archetype->row_count += chunk->count;
+        src_archetype->chunk_count -= 1u;
+        src_archetype->live_chunk_count -= 1u;
+        src_archetype->row_count -= chunk->count;
+        chunk = next;
+    }
+
+    src_archetype->chunks = kept_head;
+    src_archetype->chunk_tail = kept_tail;
+    return status;
+}
+
+static lt_status_t lt_query_retag(lt_query_t* query, lt_component_id_t tag_id, int add)
+{
+    lt_world_t* world;
+    lt_archetype_t** sources;
+    uint32_t source_count;
+    uint32_t i;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL || tag_id == LT_COMPONENT_INVALID) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world = query->world;
+    if (tag_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
+    if ((world->components[tag_id].flags & LT_COMPONENT_FLAG_TAG) == 0u) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK || query->match_count == 0u) {
+        return status;
+    }
+
+    sources = (lt_archetype_t**)lt_alloc_bytes(
+        &world->allocator,
+        sizeof(*sources) * (size_t)query->match_count,
+        _Alignof(lt_archetype_t*));
+    if (sources == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    source_count = 0u;
+    for (i = 0u; i < query->match_count; ++i) {
+        lt_archetype_t* archetype;
+
+        archetype = query->matches[i];
+        if (archetype->row_count > 0u
+            && lt_archetype_find_component_index(archetype, tag_id, NULL) == !add) {
+            sources[source_count] = archetype;
+            source_count += 1u;
+        }
+    }
+
+    for (i = 0u; i < source_count && status == LT_STATUS_OK; ++i) {
+        lt_archetype_t* src_archetype;
+        lt_archetype_t* dst_archetype;
+        lt_component_id_t* dst_ids;
+        uint32_t dst_count;
+
+        src_archetype = sources[i];
+        if (world->defer_depth > 0u) {
+            lt_chunk_t* chunk;
+            uint32_t row;
+
+            for (chunk = src_archetype->chunks; chunk != NULL && status == LT_STATUS_OK; chunk = chunk->next) {
+                for (row = 0u; row < chunk->count && status == LT_STATUS_OK; ++row) {
+                    status = add
+                        ? lt_enqueue_add_component(world, chunk->entities[row], tag_id, NULL)
+                        : lt_enqueue_remove_component(world, chunk->entities[row], tag_id);
+                }
+            }
+            continue;
+        }
+
+        dst_ids = NULL;
+        dst_count = 0u;
+        status = add
+            ? lt_world_component_key_with_add(world, src_archetype, tag_id, &dst_ids, &dst_count)
+            : lt_world_component_key_with_remove(world, src_archetype, tag_id, &dst_ids, &dst_count);
+        if (status != LT_STATUS_OK) {
+            break;
+        }
+
+        status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
+        if (dst_ids != NULL) {
+            lt_free_bytes(
+                &world->allocator,
+                dst_ids,
+                sizeof(*dst_ids) * (size_t)dst_count,
+                _Alignof(lt_component_id_t));
+        }
+        if (status != LT_STATUS_OK) {
+            break;
+        }
+
+        status = lt_archetype_relink_chunks(world, src_archetype, dst_archetype, tag_id, add);
+    }
+
+    lt_free_bytes(
+        &world->allocator,
+        sources,
+        sizeof(*sources) * (size_t)query->match_count,
+        _Alignof(lt_archetype_t*));
+    return status;
+}
+
+lt_status_t lt_query_add_tag(lt_query_t* query, lt_component_id_t tag_id)
+{
+    return lt_query_retag(query, tag_id, 1);
+}
+
+lt_status_t lt_query_remove_tag(lt_query_t* query, lt_component_id_t tag_id)
+{
+    return lt_query_retag(query, tag_id, 0);
+}
+
+static lt_status_t lt_query_iter_release(lt_query_iter_t* iter)
+{
+    lt_world_t* world;
+    lt_status_t status;
+
+    if (iter->deferring == 0u) {
+        return LT_STATUS_OK;
+    }
+
+    world = iter->query->world;
+    iter->deferring = 0u;
+    status = lt_world_end_defer(world);
+    if (status != LT_STATUS_OK || world->defer_depth > 0u) {
+        return status;
+    }
+    return lt_world_flush(world);
+}
+
+lt_status_t lt_query_iter_begin(lt_query_t* query, lt_query_iter_t* out_iter)
+{
+    lt_world_t* world;
+    lt_status_t status;
+
+    if (LT_CHECK(query == NULL || out_iter == NULL || query->world == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    world = query->world;
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_QUERY_ITER_BEGIN,
+            status,
+            LT_ENTITY_NULL,
+            LT_COMPONENT_INVALID,
+            query->match_count);
+        return status;
+    }
+
+    status = lt_query_ensure_scratch_capacity(query, query->with_count);
+    if (status != LT_STATUS_OK) {
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_QUERY_ITER_BEGIN,
+            status,
+            LT_ENTITY_NULL,
+            LT_COMPONENT_INVALID,
+            query->match_count);
+        return status;
+    }
+
+    memset(out_iter, 0, sizeof(*out_iter));
+    if (query->auto_defer != 0u) {
+        status = lt_world_begin_defer(world);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+        out_iter->deferring = 1u;
+    }
+
+    out_iter->query = query;
+    out_iter->archetype_index = 0u;
+    out_iter->chunk_cursor = NULL;
+    out_iter->columns = query->scratch_columns;
+    out_iter->column_capacity = query->scratch_capacity;
+    out_iter->finished = 0u;
+    lt_trace_emit_payload(
+        world,
+        LT_TRACE_EVENT_QUERY_ITER_BEGIN,
+        LT_STATUS_OK,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        query->match_count,
+        query,
+        NULL,
+        0u);
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_query_iter_next(
+    lt_query_iter_t* iter,
+    lt_chunk_view_t* out_view,
+    uint8_t* out_has_value)
+{
+    lt_query_t* query;
+    lt_world_t* world;
+
+    if (LT_CHECK(iter == NULL || out_view == NULL || out_has_value == NULL)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    query = iter->query;
+    if (LT_CHECK(query == NULL || query->world == NULL || iter->column_capacity < query->with_count)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    world = query->world;
+
+    out_view->count = 0u;
+    out_view->entities = NULL;
+    out_view->columns = NULL;
+    out_view->column_count = 0u;
+    out_view->group_id = 0u;
+    out_view->group_begin = 0u;
+    out_view->rows = NULL;
+    out_view->row_count = 0u;
+    *out_has_value = 0u;
+
+    if (iter->finished != 0u) {
+        return LT_STATUS_OK;
+    }
+
+    while (iter->archetype_index < query->match_count) {
+        lt_archetype_t* archetype;
+        lt_chunk_t* chunk;
+        uint32_t i;
+
+        archetype = query->matches[iter->archetype_index];
+        if (archetype->row_count == 0u) {
+            iter->archetype_index += 1u;
+            iter->chunk_cursor = NULL;
+            continue;
+        }
+
+        chunk = (lt_chunk_t*)iter->chunk_cursor;
+        if (chunk == NULL) {
+            chunk = archetype->chunks;
+        }
+
+        while (chunk != NULL
+            && (chunk->count == 0u
+                || (query->range_count > 0u && !lt_query_chunk_in_ranges(query, archetype, chunk)))) {
+            chunk = chunk->next;
+        }
+
+        if (chunk == NULL) {
+            iter->archetype_index += 1u;
+            iter->chunk_cursor = NULL;
+            continue;
+        }
+
+        for (i = 0u; i < query->with_count; ++i) {
+            uint32_t component_index;
+            int found;
+
+            found = lt_archetype_find_component_index(
+                archetype,
+                query->with_terms[i].component_id,
+                &component_index);
+            if (!found) {
+                iter->finished = 1u;
+                lt_trace_emit(
+                    world,
+                    LT_TRACE_EVENT_QUERY_ITER_END,
+                    LT_STATUS_CONFLICT,
+                    LT_ENTITY_NULL,
+                    LT_COMPONENT_INVALID,
+                    query->match_count);
+                (void)lt_query_iter_release(iter);
+                return LT_STATUS_CONFLICT;
+            }
+
+            query->scratch_columns[i] = lt_chunk_component_ptr(
+                world,
+                archetype,
+                chunk,
+                0u,
+                component_index);
+        }
+
+        lt_query_mark_written_key_ranges(query, archetype, chunk);
+        lt_query_record_row_access(query, chunk->count);
+
+        out_view->count = chunk->count;
+        out_view->entities = chunk->entities;
+        out_view->columns = query->scratch_columns;
+        out_view->column_count = query->with_count;
+        out_view->group_id = lt_query_match_group(query, iter->archetype_index);
+        out_view->group_begin = (uint8_t)(iter->group_started == 0u || iter->group_id != out_view->group_id);
+        *out_has_value = 1u;
+
+        iter->group_id = out_view->group_id;
+        iter->group_started = 1u;
+
+        iter->columns = query->scratch_columns;
+        iter->column_capacity = query->scratch_capacity;
+        iter->finished = 0u;
+        iter->chunk_cursor = chunk->next;
+        if (iter->chunk_cursor == NULL) {
+            iter->archetype_index += 1u;
+        }
+        lt_trace_emit(
+            world,
+            LT_TRACE_EVENT_QUERY_ITER_CHUNK,
+            LT_STATUS_OK,
+            LT_ENTITY_NULL,
+            LT_COMPONENT_INVALID,
+            out_view->count);
+        return LT_STATUS_OK;
+    }
+
+    iter->finished = 1u;
+    lt_trace_emit(
+        world,
+        LT_TRACE_EVENT_QUERY_ITER_END,
+        LT_STATUS_OK,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        query->match_count);
+    return lt_query_iter_release(iter);
+}
+
+lt_status_t lt_query_iter_end(lt_query_iter_t* iter)
+{
+    if (iter == NULL || iter->query == NULL || iter->query->world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    iter->finished = 1u;
+    return lt_query_iter_release(iter);
+}
+
+static lt_status_t lt_query_collect_parallel_work_items(
+    lt_query_t* query,
+    lt_parallel_work_item_t** out_items,
+    uint32_t* out_count)
+{
+    lt_parallel_work_item_t* items;
+    uint32_t item_count;
+    uint32_t match_index;
+    uint32_t write_index;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL || out_items == NULL || out_count == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_items = NULL;
+    *out_count = 0u;
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+    lt_trace_emit_payload(
+        query->world,
+        LT_TRACE_EVENT_QUERY_DISPATCH,
+        LT_STATUS_OK,
+        LT_ENTITY_NULL,
+        LT_COMPONENT_INVALID,
+        query->match_count,
+        query,
+        NULL,
+        0u);
+
+    item_count = 0u;
+    for (match_index = 0u; match_index < query->match_count; ++match_index) {
+        if (item_count > UINT32_MAX - query->matches[match_index]->live_chunk_count) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        item_count += query->matches[match_index]->live_chunk_count;
+    }
+
+    if (item_count == 0u) {
+        return LT_STATUS_OK;
+    }
+
+    if (sizeof(*items) > SIZE_MAX / (size_t)item_count) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    items = (lt_parallel_work_item_t*)malloc(sizeof(*items) * (size_t)item_count);
+    if (items == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    write_index = 0u;
+    for (match_index = 0u; match_index < query->match_count; ++match_index) {
+        lt_archetype_t* archetype;
+        lt_chunk_t* chunk;
+
+        archetype = query->matches[match_index];
+        if (archetype->row_count == 0u) {
+            continue;
+        }
+
+        chunk = archetype->chunks;
+        while (chunk != NULL) {
+            if (chunk->count > 0u
+                && (query->range_count == 0u || lt_query_chunk_in_ranges(query, archetype, chunk))) {
+                lt_query_mark_written_key_ranges(query, archetype, chunk);
+                lt_query_record_row_access(query, chunk->count);
+                items[write_index].archetype = archetype;
+                items[write_index].chunk = chunk;
+                items[write_index].group_id = lt_query_match_group(query, match_index);
+                items[write_index].rows = NULL;
+                items[write_index].row_count = 0u;
+                write_index += 1u;
+            }
+            chunk = chunk->next;
+        }
+    }
+
+    if (write_index == 0u) {
+        free(items);
+        return LT_STATUS_OK;
+    }
+
+    *out_items = items;
+    *out_count = write_index;
+    return LT_STATUS_OK;
+}
+
+static lt_status_t lt_query_execute_parallel_range(lt_parallel_worker_ctx_t* ctx)
+{
+    uint32_t item_index;
+
+    if (ctx == NULL || ctx->world == NULL || ctx->query == NULL || ctx->callback == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (ctx->query->with_count > 0u && ctx->columns == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (item_index = ctx->begin_index; item_index < ctx->end_index; ++item_index) {
+        const lt_parallel_work_item_t* item;
+        lt_chunk_view_t view;
+        uint32_t i;
+
+        item = &ctx->work_items[item_index];
+        for (i = 0u; i < ctx->query->with_count; ++i) {
+            uint32_t component_index;
+            int found;
+
+            found = lt_archetype_find_component_index(
+                item->archetype,
+                ctx->query->with_terms[i].component_id,
+                &component_index);
+            if (!found) {
+                return LT_STATUS_CONFLICT;
+            }
+
+            ctx->columns[i] = lt_chunk_component_ptr(
+                ctx->world,
+                item->archetype,
+                item->chunk,
+                0u,
+                component_index);
+        }
+
+        view.count = item->chunk->count;
+        view.entities = item->chunk->entities;
+        view.columns = ctx->columns;
+        view.column_count = ctx->query->with_count;
+        view.group_id = item->group_id;
+        view.group_begin = (uint8_t)(
+            item_index == 0u || ctx->work_items[item_index - 1u].group_id != item->group_id);
+        view.rows = item->rows;
+        view.row_count = item->row_count;
+        ctx->callback(&view, ctx->worker_index, ctx->user_data);
+    }
+
+    return LT_STATUS_OK;
+}
+
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+static void* lt_query_parallel_worker_entry(void* user_data)
+{
+    lt_parallel_worker_ctx_t* ctx;
+
+    ctx = (lt_parallel_worker_ctx_t*)user_data;
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    lt_trace_queue = ctx->trace_queue;
+    ctx->status = lt_query_execute_parallel_range(ctx);
+    return NULL;
+}
+#endif
+
+static lt_status_t lt_query_run_parallel_work_items(
+    lt_query_t* query,
+    const lt_parallel_work_item_t* work_items,
+    uint32_t work_count,
+    uint32_t worker_count,
+    lt_query_parallel_chunk_fn callback,
+    void* user_data)
+{
+    lt_world_t* world;
+    lt_parallel_worker_ctx_t* contexts;
+    lt_status_t status;
+    uint32_t effective_workers;
+    uint32_t base_items;
+    uint32_t extra_items;
+    uint32_t begin_index;
+    uint32_t worker_index;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    uint32_t started_threads;
+    pthread_t* threads;
+    lt_trace_queue_t trace_queue;
+    lt_trace_queue_t* trace_previous;
+    uint8_t trace_open;
+#endif
+
+    world = query->world;
+    effective_workers = worker_count;
+    if (effective_workers > work_count) {
+        effective_workers = work_count;
+    }
+
+#if !(defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS)
+    effective_workers = 1u;
+#endif
+
+    if (sizeof(*contexts) > SIZE_MAX / (size_t)effective_workers) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    contexts = (lt_parallel_worker_ctx_t*)malloc(sizeof(*contexts) * (size_t)effective_workers);
+    if (contexts == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(contexts, 0, sizeof(*contexts) * (size_t)effective_workers);
+
+    status = LT_STATUS_OK;
+    base_items = work_count / effective_workers;
+    extra_items = work_count % effective_workers;
+    begin_index = 0u;
+    for (worker_index = 0u; worker_index < effective_workers; ++worker_index) {
+        uint32_t item_count;
+
+        item_count = base_items + (worker_index < extra_items ? 1u : 0u);
+        contexts[worker_index].world = world;
+        contexts[worker_index].query = query;
+        contexts[worker_index].work_items = work_items;
+        contexts[worker_index].begin_index = begin_index;
+        contexts[worker_index].end_index = begin_index + item_count;
+        contexts[worker_index].callback = callback;
+        contexts[worker_index].user_data = user_data;
+        contexts[worker_index].worker_index = worker_index;
+        contexts[worker_index].status = LT_STATUS_OK;
+        begin_index += item_count;
+
+        if (query->with_count > 0u) {
+            if (sizeof(*contexts[worker_index].columns) > SIZE_MAX / (size_t)query->with_count) {
+                status = LT_STATUS_CAPACITY_REACHED;
+                break;
+            }
+
+            contexts[worker_index].columns =
+                (void**)malloc(sizeof(*contexts[worker_index].columns) * (size_t)query->with_count);
+            if (contexts[worker_index].columns == NULL) {
+                status = LT_STATUS_ALLOCATION_FAILED;
+                break;
+            }
+        }
+    }
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    threads = NULL;
+    started_threads = 0u;
+#endif
+    if (status == LT_STATUS_OK && effective_workers > 1u) {
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+        if (sizeof(*threads) > SIZE_MAX / (size_t)(effective_workers - 1u)) {
+            status = LT_STATUS_CAPACITY_REACHED;
+        } else {
+            threads = (pthread_t*)malloc(sizeof(*threads) * (size_t)(effective_workers - 1u));
+            if (threads == NULL) {
+                status = LT_STATUS_ALLOCATION_FAILED;
+            }
+        }
+
+        trace_open = 0u;
+        trace_previous = NULL;
+        if (status == LT_STATUS_OK) {
+            status = lt_trace_queue_open(&trace_queue, &trace_previous);
+            trace_open = status == LT_STATUS_OK ? 1u : 0u;
+        }
+
+        if (status == LT_STATUS_OK) {
+            for (worker_index = 1u; worker_index < effective_workers; ++worker_index) {
+                int rc;
+
+                contexts[worker_index].trace_queue = &trace_queue;
+                rc = pthread_create(
+                    &threads[worker_index - 1u],
+                    NULL,
+                    lt_query_parallel_worker_entry,
+                    &contexts[worker_index]);
+                if (rc != 0) {
+                    status = LT_STATUS_ALLOCATION_FAILED;
+                    break;
+                }
+                started_threads += 1u;
+            }
+        }
+
+        if (status == LT_STATUS_OK) {
+            contexts[0].status = lt_query_execute_parallel_range(&contexts[0]);
+        }
+
+        for (worker_index = 0u; worker_index < started_threads; ++worker_index) {
+            (void)pthread_join(threads[worker_index], NULL);
+        }
+        if (trace_open != 0u) {
+            lt_trace_queue_close(&trace_queue, trace_previous);
+        }
+#endif
+    } else if (status == LT_STATUS_OK) {
+        contexts[0].status = lt_query_execute_parallel_range(&contexts[0]);
+    }
+
+    if (status == LT_STATUS_OK) {
+        for (worker_index = 0u; worker_index < effective_workers; ++worker_index) {
+            if (contexts[worker_index].status != LT_STATUS_OK) {
+                status = contexts[worker_index].status;
+                break;
+            }
+        }
+    }
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    free(threads);
+#endif
+    for (worker_index = 0u; worker_index < effective_workers; ++worker_index) {
+        free(contexts[worker_index].columns);
+    }
+    free(contexts);
+    return status;
+}
+
+lt_status_t lt_query_for_each_chunk_parallel(
+    lt_query_t* query,
+    uint32_t worker_count,
+    lt_query_parallel_chunk_fn callback,
+    void* user_data)
+{
+    lt_parallel_work_item_t* work_items;
+    uint32_t work_count;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL || callback == NULL || worker_count == 0u) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (worker_count > 1u && query->world->defer_depth > 0u) {
+        return LT_STATUS_CONFLICT;
+    }
+
+    status = lt_query_collect_parallel_work_items(query, &work_items, &work_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
+
+    if (work_count == 0u) {
+        free(work_items);
+        return LT_STATUS_OK;
+    }
+
+    status = lt_query_run_parallel_work_items(query, work_items, work_count, worker_count, callback, user_data);
+    free(work_items);
+    return status;
+}
+
+static int lt_subset_row_compare(const void* lhs, const void* rhs)
+{
+    const lt_subset_row_t* a;
+    const lt_subset_row_t* b;
+
+    a = (const lt_subset_row_t*)lhs;
+    b = (const lt_subset_row_t*)rhs;
+    if (a->match_index != b->match_index) {
+        return a->match_index < b->match_index ? -1 : 1;
+    }
+    if (a->chunk != b->chunk) {
+        return (uintptr_t)a->chunk < (uintptr_t)b->chunk ? -1 : 1;
+    }
+    if (a->row != b->row) {
+        return a->row < b->row ? -1 : 1;
+    }
+    return 0;
+}
+
+static int lt_subset_match_compare(const void* lhs, const void* rhs)
+{
+    uintptr_t a;
+    uintptr_t b;
+
+    a = (uintptr_t)((const lt_subset_match_t*)lhs)->archetype;
+    b = (uintptr_t)((const lt_subset_match_t*)rhs)->archetype;
+    if (a != b) {
+        return a < b ? -1 : 1;
+    }
+    return 0;
+}
+
+static uint32_t lt_subset_find_match(
+    const lt_subset_match_t* matches,
+    uint32_t match_count,
+    const lt_archetype_t* archetype)
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    lo = 0u;
+    hi = match_count;
+    while (lo < hi) {
+        uint32_t mid;
+
+        mid = lo + (hi - lo) / 2u;
+        if ((uintptr_t)matches[mid].archetype < (uintptr_t)archetype) {
+            lo = mid + 1u;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < match_count && matches[lo].archetype == archetype) {
+        return matches[lo].match_index;
+    }
+    return UINT32_MAX;
+}
+
+lt_status_t lt_query_for_each_subset_chunk(
+    lt_query_t* query,
+    const lt_entity_t* entities,
+    uint32_t entity_count,
+    uint32_t worker_count,
+    lt_query_parallel_chunk_fn callback,
+    void* user_data)
+{
+    lt_world_t* world;
+    lt_subset_row_t* rows;
+    lt_subset_match_t* matches;
+    uint32_t* row_indices;
+    lt_parallel_work_item_t* work_items;
+    const lt_archetype_t* last_archetype;
+    uint32_t last_match;
+    uint32_t row_count;
+    uint32_t work_count;
+    uint32_t begin;
+    uint32_t i;
+    lt_status_t status;
+
+    if (query == NULL || query->world == NULL || callback == NULL || worker_count == 0u
+        || (entities == NULL && entity_count > 0u)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    world = query->world;
+    if (worker_count > 1u && world->defer_depth > 0u) {
+        return LT_STATUS_CONFLICT;
+    }
+
+    status = lt_query_refresh(query);
+    if (status != LT_STATUS_OK || entity_count == 0u) {
+        return status;
+    }
+
+    if (sizeof(*rows) > SIZE_MAX / (size_t)entity_count) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    rows = (lt_subset_row_t*)malloc(sizeof(*rows) * (size_t)entity_count);
+    matches = (lt_subset_match_t*)malloc(sizeof(*matches) * ((size_t)query->match_count + 1u));
+    row_indices = (uint32_t*)malloc(sizeof(*row_indices) * (size_t)entity_count);
+    work_items = (lt_parallel_work_item_t*)malloc(sizeof(*work_items) * (size_t)entity_count);
+    if (rows == NULL || matches == NULL || row_indices == NULL || work_items == NULL) {
+        free(work_items);
+        free(row_indices);
+        free(matches);
+        free(rows);
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+
+    for (i = 0u; i < query->match_count; ++i) {
+        matches[i].archetype = query->matches[i];
+        matches[i].match_index = i;
+    }
+    qsort(matches, query->match_count, sizeof(*matches), lt_subset_match_compare);
+
+    row_count = 0u;
+    last_archetype = NULL;
+    last_match = UINT32_MAX;
+    for (i = 0u; i < entity_count; ++i) {
+        lt_entity_slot_t* slot;
+
+        status = lt_world_get_live_slot(world, entities[i], &slot);
+        if (status != LT_STATUS_OK) {
+            free(work_items);
+            free(row_indices);
+            free(matches);
+            free(rows);
+            return status;
+        }
+        if (slot->chunk == NULL) {
+            continue;
+        }
+
+        if (slot->archetype != last_archetype) {
+            last_archetype = slot->archetype;
+            last_match = lt_subset_find_match(matches, query->match_count, last_archetype);
+        }
+        if (last_match == UINT32_MAX) {
+            continue;
+        }
+
+        rows[row_count].chunk = slot->chunk;
+        rows[row_count].row = slot->row;
+        rows[row_count].match_index = last_match;
+        row_count += 1u;
+    }
+
+    qsort(rows, row_count, sizeof(*rows), lt_subset_row_compare);
+
+    work_count = 0u;
+    for (begin = 0u; begin < row_count;) {
+        lt_archetype_t* archetype;
+        lt_chunk_t* chunk;
+        uint32_t cursor;
+        uint32_t count;
+
+        chunk = rows[begin].chunk;
+        archetype = query->matches[rows[begin].match_index];
+        count = 0u;
+        for (cursor = begin; cursor < row_count && rows[cursor].chunk == chunk; ++cursor) {
+            if (count > 0u && row_indices[begin + count - 1u] == rows[cursor].row) {
+                continue;
+            }
+            row_indices[begin + count] = rows[cursor].row;
+            count += 1u;
+        }
+
+        if (query->range_count == 0u || lt_query_chunk_in_ranges(query, archetype, chunk)) {
+            lt_query_mark_written_key_ranges(query, archetype, chunk);
+            lt_query_record_row_access(query, count);
+            work_items[work_count].archetype = archetype;
+            work_items[work_count].chunk = chunk;
+            work_items[work_count].group_id = lt_query_match_group(query, rows[begin].match_index);
+            work_items[work_count].rows = &row_indices[begin];
+            work_items[work_count].row_count = count;
+            work_count += 1u;
+        }
+        begin = cursor;
+    }
+
+    status = LT_STATUS_OK;
+    if (work_count > 0u) {
+        status = lt_query_run_parallel_work_items(query, work_items, work_count, worker_count, callback, user_data);
+    }
+
+    free(work_items);
+    free(row_indices);
+    free(matches);
+    free(rows);
+    return status;
+}
+
+static int lt_query_entries_conflict(
+    const lt_query_t* a,
+    const lt_query_term_t* a_random,
+    uint32_t a_random_count,
+    const lt_query_t* b,
+    const lt_query_term_t* b_random,
+    uint32_t b_random_count)
+{
+    uint32_t a_count;
+    uint32_t b_count;
+    uint32_t i;
+    uint32_t j;
+
+    if (a == NULL || b == NULL) {
+        return 0;
+    }
+
+    a_count = a->with_count + a_random_count;
+    b_count = b->with_count + b_random_count;
+    for (i = 0u; i < a_count; ++i) {
+        const lt_query_term_t* term_a;
+
+        term_a = lt_entry_term(a, a_random, i);
+        for (j = 0u; j < b_count; ++j) {
+            const lt_query_term_t* term_b;
+
+            term_b = lt_entry_term(b, b_random, j);
+            if (term_a->component_id != term_b->component_id) {
+                continue;
+            }
+
+            if (term_a->access == LT_ACCESS_WRITE || term_b->access == LT_ACCESS_WRITE) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static uint64_t lt_column_checksum(const void* column, size_t bytes)
+{
+    const uint8_t* data;
+    uint64_t hash;
+    size_t i;
+
+    data = (const uint8_t*)column;
+    hash = 14695981039346656037ull;
+    for (i = 0u; i < bytes; ++i) {
+        hash ^= (uint64_t)data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static size_t lt_schedule_guarded_bytes(
+    const lt_schedule_item_t* entry,
+    const lt_chunk_view_t* view,
+    uint32_t column)
+{
+    const lt_query_t* query;
+    lt_component_id_t component_id;
+    uint32_t i;
+
+    query = entry->query;
+    component_id = query->with_terms[column].component_id;
+    if (query->with_terms[column].access != LT_ACCESS_READ || view->columns[column] == NULL) {
+        return 0u;
+    }
+    for (i = 0u; i < entry->random_access_count; ++i) {
+        if (entry->random_access[i].component_id == component_id
+            && entry->random_access[i].access == LT_ACCESS_WRITE) {
+            return 0u;
+        }
+    }
+    return (size_t)query->world->components[component_id].size * (size_t)view->count;
+}
+
+static void lt_schedule_scoped_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    const lt_schedule_item_t* entry;
+    const lt_access_scope_t* previous;
+    lt_access_scope_t scope;
+    uint64_t inline_sums[LT_ACCESS_GUARD_INLINE_COLUMNS];
+    uint64_t* sums;
+    uint32_t i;
+
+    entry = (const lt_schedule_item_t*)user_data;
+    sums = inline_sums;
+    if (view->column_count > LT_ACCESS_GUARD_INLINE_COLUMNS) {
+        sums = (uint64_t*)malloc(sizeof(*sums) * (size_t)view->column_count);
+    }
+    if (sums != NULL) {
+        for (i = 0u; i < view->column_count; ++i) {
+            sums[i] = lt_column_checksum(view->columns[i], lt_schedule_guarded_bytes(entry, view, i));
+        }
+    }
+
+    memset(&scope, 0, sizeof(scope));
+    scope.entry = entry;
+    scope.worker_index = worker_index;
+    previous = lt_access_scope;
+    lt_access_scope = &scope;
+    entry->callback(view, worker_index, entry->user_data);
+    lt_access_scope = previous;
+
+    if (sums == NULL) {
+        return;
+    }
+    for (i = 0u; i < view->column_count; ++i) {
+        if (sums[i] != lt_column_checksum(view->columns[i], lt_schedule_guarded_bytes(entry, view, i))) {
+            lt_world_report_access_violation(
+                entry->query->world,
+                &scope,
+                LT_ACCESS_VIOLATION_READ_COLUMN_WRITE,
+                LT_ENTITY_NULL,
+                entry->query->with_terms[i].component_id);
+        }
+    }
+    if (sums != inline_sums) {
+        free(sums);
+    }
+}
+
+static lt_status_t lt_schedule_run_entry(const lt_schedule_item_t* entry, uint32_t worker_count)
+{
+    if (LT_CHECK(entry->query->world->access_checks != 0u)) {
+        return lt_query_for_each_chunk_parallel(entry->query, worker_count, lt_schedule_scoped_chunk, (void*)entry);
+    }
+    return lt_query_for_each_chunk_parallel(entry->query, worker_count, entry->callback, entry->user_data);
+}
+
+static uint64_t lt_now_ns(void)
+{
+    struct timespec ts;
+
+    if (timespec_get(&ts, TIME_UTC) != TIME_UTC) {
+        return 0u;
+    }
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static lt_status_t lt_schedule_run_timed(
+    const lt_schedule_item_t* entry,
+    uint32_t worker_count,
+    lt_schedule_entry_timing_t* timing)
+{
+    lt_status_t status;
+    uint64_t start_ns;
+    uint64_t elapsed_ns;
+
+    if (timing == NULL) {
+        return lt_schedule_run_entry(entry, worker_count);
+    }
+
+    start_ns = lt_now_ns();
+    status = lt_schedule_run_entry(entry, worker_count);
+    elapsed_ns = lt_now_ns() - start_ns;
+    timing->last_ns = elapsed_ns;
+    timing->total_ns += elapsed_ns;
+    if (elapsed_ns > timing->max_ns) {
+        timing->max_ns = elapsed_ns;
+    }
+    timing->run_count += 1u;
+    return status;
+}
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+static void* lt_query_schedule_stage_worker_entry(void* user_data)
+{
+    lt_schedule_stage_worker_ctx_t* ctx;
+
+    ctx = (lt_schedule_stage_worker_ctx_t*)user_data;
+    if (ctx == NULL || ctx->entry == NULL || ctx->entry->query == NULL || ctx->entry->callback == NULL) {
+        return NULL;
+    }
+
+    lt_trace_queue = ctx->trace_queue;
+    ctx->status = lt_schedule_run_timed(ctx->entry, 1u, ctx->timing);
+    return NULL;
+}
+#endif
+
+static lt_status_t lt_query_schedule_execute_stage(
+    const lt_schedule_item_t* entries,
+    lt_schedule_entry_timing_t* timings,
+    const uint32_t* stage_nodes,
+    uint32_t stage_count,
+    uint32_t worker_count)
+{
+    lt_status_t status;
+    uint32_t i;
+
+    if (entries == NULL || stage_nodes == NULL || worker_count == 0u) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (stage_count == 0u) {
+        return LT_STATUS_OK;
+    }
+
+    if (stage_count == 1u || worker_count == 1u) {
+        for (i = 0u; i < stage_count; ++i) {
+            const lt_schedule_item_t* entry;
+
+            entry = &entries[stage_nodes[i]];
+            status = lt_schedule_run_timed(entry, worker_count, timings != NULL ? &timings[stage_nodes[i]] : NULL);
+            if (status != LT_STATUS_OK) {
+                return status;
+            }
+        }
+        return LT_STATUS_OK;
+    }
+
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    {
+        lt_schedule_stage_worker_ctx_t* contexts;
+        pthread_t* threads;
+        lt_trace_queue_t trace_queue;
+        lt_trace_queue_t* trace_previous;
+        uint32_t parallel_queries;
+        uint32_t stage_offset;
+
+        parallel_queries = worker_count;
+        if (parallel_queries > stage_count) {
+            parallel_queries = stage_count;
+        }
+
+        if (sizeof(*contexts) > SIZE_MAX / (size_t)parallel_queries) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        contexts = (lt_schedule_stage_worker_ctx_t*)malloc(
+            sizeof(*contexts) * (size_t)parallel_queries);
+        if (contexts == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memset(contexts, 0, sizeof(*contexts) * (size_t)parallel_queries);
+
+        threads = NULL;
+        if (parallel_queries > 1u) {
+            if (sizeof(*threads) > SIZE_MAX / (size_t)(parallel_queries - 1u)) {
+                free(contexts);
+                return LT_STATUS_CAPACITY_REACHED;
+            }
+            threads = (pthread_t*)malloc(sizeof(*threads) * (size_t)(parallel_queries - 1u));
+            if (threads == NULL) {
+                free(contexts);
+                return LT_STATUS_ALLOCATION_FAILED;
+            }
+        }
+
+        status = LT_STATUS_OK;
+        for (stage_offset = 0u; stage_offset < stage_count; stage_offset += parallel_queries) {
+            uint32_t wave_count;
+            uint32_t launched_threads;
+
+            wave_count = stage_count - stage_offset;
+            if (wave_count > parallel_queries) {
+                wave_count = parallel_queries;
+            }
+
+            for (i = 0u; i < wave_count; ++i) {
+                const lt_schedule_item_t* entry;
+
+                entry = &entries[stage_nodes[stage_offset + i]];
+                contexts[i].entry = entry;
+                contexts[i].timing = timings != NULL ? &timings[stage_nodes[stage_offset + i]] : NULL;
+                contexts[i].trace_queue = &trace_queue;
+                contexts[i].status = LT_STATUS_OK;
+            }
+
+            status = lt_trace_queue_open(&trace_queue, &trace_previous);
+            if (status != LT_STATUS_OK) {
+                break;
+            }
+
+            launched_threads = 0u;
+            for (i = 1u; i < wave_count; ++i) {
+                int rc;
+
+                rc = pthread_create(
+                    &threads[i - 1u],
+                    NULL,
+                    lt_query_schedule_stage_worker_entry,
+                    &contexts[i]);
+                if (rc != 0) {
+                    status = LT_STATUS_ALLOCATION_FAILED;
+                    break;
+                }
+                launched_threads += 1u;
+            }
+
+            if (status == LT_STATUS_OK) {
+                contexts[0].status = lt_schedule_run_timed(contexts[0].entry, 1u, contexts[0].timing);
+            }
+
+            for (i = 0u; i < launched_threads; ++i) {
+                (void)pthread_join(threads[i], NULL);
+            }
+            lt_trace_queue_close(&trace_queue, trace_previous);
+
+            for (i = 0u; status == LT_STATUS_OK && i < wave_count; ++i) {
+                if (contexts[i].status == LT_STATUS_OK) {
+                    lt_trace_emit_payload(
+                        contexts[i].entry->query->world,
+                        LT_TRACE_EVENT_QUERY_DISPATCH,
+                        LT_STATUS_OK,
+                        LT_ENTITY_NULL,
+                        LT_COMPONENT_INVALID,
+                        contexts[i].entry->query->match_count,
+                        contexts[i].entry->query,
+                        NULL,
+                        0u);
+                }
+            }
+
+            if (status == LT_STATUS_OK) {
+                for (i = 0u; i < wave_count; ++i) {
+                    if (contexts[i].status != LT_STATUS_OK) {
+                        status = contexts[i].status;
+                        break;
+                    }
+                }
+            }
+
+            if (status != LT_STATUS_OK) {
+                break;
+            }
+        }
+
+        free(threads);
+        free(contexts);
+        return status;
+    }
+#else
+    for (i = 0u; i < stage_count; ++i) {
+        const lt_schedule_item_t* entry;
+
+        entry = &entries[stage_nodes[i]];
+        status = lt_schedule_run_timed(entry, worker_count, timings != NULL ? &timings[stage_nodes[i]] : NULL);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+    }
+    return LT_STATUS_OK;
+#endif
+}
+
+static lt_status_t lt_query_schedule_validate_entries(
+    const lt_schedule_item_t* entries,
+    uint32_t entry_count,
+    lt_world_t** out_world)
+{
+    lt_world_t* world;
+    uint32_t i;
+
+    if (out_world != NULL) {
+        *out_world = NULL;
+    }
+
+    if (entry_count == 0u) {
+        return LT_STATUS_OK;
+    }
+
+    if (entries == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (entries[0].query == NULL || entries[0].query->world == NULL || entries[0].callback == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    world = entries[0].query->world;
+
+    for (i = 0u; i < entry_count; ++i) {
+        uint32_t e;
+
+        if (entries[i].query == NULL || entries[i].query->world != world || entries[i].callback == NULL) {
+            return LT_STATUS_INVALID_ARGUMENT;
+        }
+        if (entries[i].event_count > 0u && entries[i].events == NULL) {
+            return LT_STATUS_INVALID_ARGUMENT;
+        }
+        for (e = 0u; e < entries[i].event_count; ++e) {
+            if (lt_event_channel_lookup(world, entries[i].events[e].channel) == NULL) {
+                return LT_STATUS_INVALID_ARGUMENT;
+            }
+            if (entries[i].events[e].access != LT_ACCESS_READ
+                && entries[i].events[e].access != LT_ACCESS_WRITE) {
+                return LT_STATUS_INVALID_ARGUMENT;
+            }
+        }
+        if (entries[i].random_access_count > 0u && entries[i].random_access == NULL) {
+            return LT_STATUS_INVALID_ARGUMENT;
+        }
+        for (e = 0u; e < entries[i].random_access_count; ++e) {
+            lt_component_id_t component_id;
+
+            component_id = entries[i].random_access[e].component_id;
+            if (component_id == LT_COMPONENT_INVALID || component_id > world->component_count) {
+                return LT_STATUS_INVALID_ARGUMENT;
+            }
+            if (entries[i].random_access[e].access != LT_ACCESS_READ
+                && entries[i].random_access[e].access != LT_ACCESS_WRITE) {
+                return LT_STATUS_INVALID_ARGUMENT;
+            }
+        }
+    }
+
+    if (out_world != NULL) {
+        *out_world = world;
+    }
+    return LT_STATUS_OK;
+}
+
+static int lt_schedule_edge_compare(const void* lhs, const void* rhs)
+{
+    uint64_t a;
+    uint64_t b;
+
+    a = *(const uint64_t*)lhs;
+    b = *(const uint64_t*)rhs;
+    if (a != b) {
+        return a < b ? -1 : 1;
+    }
+    return 0;
+}
+
+static int lt_schedule_node_compare(const void* lhs, const void* rhs)
+{
+    uint32_t a;
+    uint32_t b;
+
+    a = *(const uint32_t*)lhs;
+    b = *(const uint32_t*)rhs;
+    if (a != b) {
+        return a < b ? -1 : 1;
+    }
+    return 0;
+}
+
+static lt_status_t lt_schedule_collect_edges(
+    const lt_world_t* world,
+    const lt_schedule_item_t* entries,
+    uint32_t entry_count,
+    uint64_t** out_edges,
+    uint32_t* out_edge_count)
+{
+    uint32_t* last_writer;
+    uint32_t* reader_head;
+    uint32_t* reader_next;
+    uint32_t* reader_entry;
+    uint32_t* channel_writer;
+    uint64_t* edges;
+    size_t term_total;
+    size_t event_total;
+    size_t edge_capacity;
+    size_t resource_count;
+    size_t channel_count;
+    uint32_t edge_count;
+    uint32_t reader_count;
+    uint32_t unique_count;
+    uint32_t i;
+    lt_status_t status;
+
+    *out_edges = NULL;
+    *out_edge_count = 0u;
+
+    term_total = 0u;
+    event_total = 0u;
+    for (i = 0u; i < entry_count; ++i) {
+        term_total += (size_t)entries[i].query->with_count + (size_t)entries[i].random_access_count;
+        event_total += (size_t)entries[i].event_count;
+    }
+
+    if (term_total > (SIZE_MAX - event_total) / 2u || term_total > (size_t)UINT32_MAX) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+    edge_capacity = term_total * 2u + event_total;
+    if (edge_capacity > (size_t)UINT32_MAX) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    resource_count = (size_t)world->component_count + 1u;
+    channel_count = (size_t)world->event_channel_count + 1u;
+    if (sizeof(*last_writer) > SIZE_MAX / resource_count
+        || sizeof(*channel_writer) > SIZE_MAX / channel_count
+        || sizeof(*reader_next) > SIZE_MAX / (term_total + 1u)
+        || sizeof(*edges) > SIZE_MAX / (edge_capacity + 1u)) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    last_writer = (uint32_t*)malloc(sizeof(*last_writer) * resource_count);
+    reader_head = (uint32_t*)malloc(sizeof(*reader_head) * resource_count);
+    reader_next = (uint32_t*)malloc(sizeof(*reader_next) * (term_total + 1u));
+    reader_entry = (uint32_t*)malloc(sizeof(*reader_entry) * (term_total + 1u));
+    channel_writer = (uint32_t*)malloc(sizeof(*channel_writer) * channel_count);
+    edges = (uint64_t*)malloc(sizeof(*edges) * (edge_capacity + 1u));
+    if (last_writer == NULL
+        || reader_head == NULL
+        || reader_next == NULL
+        || reader_entry == NULL
+        || channel_writer == NULL
+        || edges == NULL) {
+        status = LT_STATUS_ALLOCATION_FAILED;
+        goto cleanup;
+    }
+
+    memset(last_writer, 0xFF, sizeof(*last_writer) * resource_count);
+    memset(reader_head, 0xFF, sizeof(*reader_head) * resource_count);
+    memset(channel_writer, 0xFF, sizeof(*channel_writer) * channel_count);
+
+    edge_count = 0u;
+    reader_count = 0u;
+    for (i = 0u; i < entry_count; ++i) {
+        uint32_t term_count;
+        uint32_t t;
+
+        term_count = entries[i].query->with_count + entries[i].random_access_count;
+        for (t = 0u; t < term_count; ++t) {
+            const lt_query_term_t* term;
+            lt_component_id_t component_id;
+            uint32_t writer;
+
+            term = lt_entry_term(entries[i].query, entries[i].random_access, t);
+            component_id = term->component_id;
+            writer = last_writer[component_id];
+            if (writer != UINT32_MAX && writer != i) {
+                edges[edge_count] = ((uint64_t)writer << 32u) | (uint64_t)i;
+                edge_count += 1u;
+            }
+
+            if (term->access == LT_ACCESS_WRITE) {
+                uint32_t node;
 
-    if (world->defer_depth != 0u) {
-        return LT_STATUS_CONFLICT;
+                for (node = reader_head[component_id]; node != UINT32_MAX; node = reader_next[node]) {
+                    if (reader_entry[node] != i) {
+                        edges[edge_count] = ((uint64_t)reader_entry[node] << 32u) | (uint64_t)i;
+                        edge_count += 1u;
+                    }
+                }
+                reader_head[component_id] = UINT32_MAX;
+                last_writer[component_id] = i;
+            } else {
+                reader_entry[reader_count] = i;
+                reader_next[reader_count] = reader_head[component_id];
+                reader_head[component_id] = reader_count;
+                reader_count += 1u;
+            }
+        }
+
+        for (t = 0u; t < entries[i].event_count; ++t) {
+            lt_event_channel_id_t channel;
+
+            if (entries[i].events[t].access != LT_ACCESS_WRITE) {
+                continue;
+            }
+            channel = entries[i].events[t].channel;
+            if (channel_writer[channel] != UINT32_MAX && channel_writer[channel] != i) {
+                edges[edge_count] = ((uint64_t)channel_writer[channel] << 32u) | (uint64_t)i;
+                edge_count += 1u;
+            }
+            channel_writer[channel] = i;
+        }
     }
 
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_FLUSH_BEGIN,
-        LT_STATUS_OK,
-        LT_ENTITY_NULL,
-        LT_COMPONENT_INVALID,
-        0u);
+    for (i = 0u; i < entry_count; ++i) {
+        uint32_t t;
 
-    status = LT_STATUS_OK;
-    for (i = 0u; i < world->deferred_count; ++i) {
-        lt_deferred_op_t* op;
+        for (t = 0u; t < entries[i].event_count; ++t) {
+            uint32_t writer;
 
-        op = &world->deferred_ops[i];
-        switch (op->kind) {
-            case LT_DEFERRED_OP_ADD_COMPONENT:
-                status = lt_add_component(world, op->entity, op->component_id, op->payload);
-                break;
-            case LT_DEFERRED_OP_REMOVE_COMPONENT:
-                status = lt_remove_component(world, op->entity, op->component_id);
-                break;
-            case LT_DEFERRED_OP_DESTROY_ENTITY:
-                status = lt_entity_destroy(world, op->entity);
-                break;
-            default:
-                status = LT_STATUS_INVALID_ARGUMENT;
-                break;
+            if (entries[i].events[t].access != LT_ACCESS_READ) {
+                continue;
+            }
+            writer = channel_writer[entries[i].events[t].channel];
+            if (writer != UINT32_MAX && writer != i) {
+                edges[edge_count] = ((uint64_t)writer << 32u) | (uint64_t)i;
+                edge_count += 1u;
+            }
         }
+    }
 
-        if (status != LT_STATUS_OK) {
-            lt_trace_emit(
-                world,
-                LT_TRACE_EVENT_FLUSH_APPLY,
-                status,
-                op->entity,
-                op->component_id,
-                (uint32_t)op->kind);
-            break;
+    unique_count = 0u;
+    if (edge_count > 0u) {
+        qsort(edges, edge_count, sizeof(*edges), lt_schedule_edge_compare);
+        for (i = 0u; i < edge_count; ++i) {
+            if (unique_count == 0u || edges[unique_count - 1u] != edges[i]) {
+                edges[unique_count] = edges[i];
+                unique_count += 1u;
+            }
         }
-
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_FLUSH_APPLY,
-            LT_STATUS_OK,
-            op->entity,
-            op->component_id,
-            (uint32_t)op->kind);
     }
 
-    lt_deferred_clear(world);
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_FLUSH_END,
-        status,
-        LT_ENTITY_NULL,
-        LT_COMPONENT_INVALID,
-        0u);
+    *out_edges = edges;
+    *out_edge_count = unique_count;
+    edges = NULL;
+    status = LT_STATUS_OK;
+
+cleanup:
+    free(edges);
+    free(channel_writer);
+    free(reader_entry);
+    free(reader_next);
+    free(reader_head);
+    free(last_writer);
     return status;
 }
 
-lt_status_t lt_entity_create(lt_world_t* world, lt_entity_t* out_entity)
+static lt_status_t lt_schedule_reserve_entries(lt_schedule_t* schedule, uint32_t min_capacity)
 {
-    uint32_t index;
-    uint32_t generation;
-    lt_entity_slot_t* slot;
-    lt_entity_t entity;
-    lt_chunk_t* chunk;
-    uint32_t row;
-    lt_status_t status;
-    uint8_t reused_slot;
+    lt_schedule_item_t* entries;
+    uint8_t* enabled;
+    uint8_t* queued;
+    uint32_t* levels;
+    uint32_t* pred_counts;
+    uint32_t* saved_levels;
+    uint32_t* saved_pred_counts;
+    uint32_t* queue;
+    uint32_t* batch_nodes;
+    uint32_t* batch_offsets;
+    lt_schedule_entry_timing_t* timings;
+    uint32_t capacity;
 
-    if (world == NULL || out_entity == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    if (schedule->entry_capacity >= min_capacity) {
+        return LT_STATUS_OK;
     }
 
-    reused_slot = 0u;
-    if (world->free_entity_head != UINT32_MAX) {
-        index = world->free_entity_head;
-        slot = &world->entities[index];
-        world->free_entity_head = slot->next_free;
-        world->free_entity_count -= 1u;
-        reused_slot = 1u;
-    } else {
-        if (world->entity_count == world->entity_capacity) {
-            status = lt_grow_entities(world, world->entity_count + 1u);
-            if (status != LT_STATUS_OK) {
-                return status;
-            }
+    capacity = schedule->entry_capacity == 0u ? 8u : schedule->entry_capacity;
+    while (capacity < min_capacity) {
+        if (capacity > UINT32_MAX / 2u) {
+            return LT_STATUS_CAPACITY_REACHED;
         }
-
-        index = world->entity_count;
-        world->entity_count += 1u;
-        slot = &world->entities[index];
-        memset(slot, 0, sizeof(*slot));
+        capacity *= 2u;
     }
-
-    if (slot->generation == 0u) {
-        slot->generation = 1u;
+    if (sizeof(*entries) > SIZE_MAX / (size_t)capacity
+        || sizeof(*batch_offsets) > SIZE_MAX / ((size_t)capacity + 1u)) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
 
-    generation = slot->generation;
-    entity = lt_entity_pack(index, generation);
-
-    status = lt_archetype_alloc_row(world, world->root_archetype, &chunk, &row);
-    if (status != LT_STATUS_OK) {
-        if (reused_slot != 0u) {
-            slot->next_free = world->free_entity_head;
-            world->free_entity_head = index;
-            world->free_entity_count += 1u;
-        } else {
-            world->entity_count -= 1u;
-            memset(slot, 0, sizeof(*slot));
-        }
-        return status;
+    entries = (lt_schedule_item_t*)realloc(schedule->entries, sizeof(*entries) * (size_t)capacity);
+    if (entries != NULL) {
+        schedule->entries = entries;
+    }
+    enabled = (uint8_t*)realloc(schedule->enabled, sizeof(*enabled) * (size_t)capacity);
+    if (enabled != NULL) {
+        schedule->enabled = enabled;
+    }
+    queued = (uint8_t*)realloc(schedule->queued, sizeof(*queued) * (size_t)capacity);
+    if (queued != NULL) {
+        schedule->queued = queued;
+    }
+    levels = (uint32_t*)realloc(schedule->levels, sizeof(*levels) * (size_t)capacity);
+    if (levels != NULL) {
+        schedule->levels = levels;
+    }
+    pred_counts = (uint32_t*)realloc(schedule->pred_counts, sizeof(*pred_counts) * (size_t)capacity);
+    if (pred_counts != NULL) {
+        schedule->pred_counts = pred_counts;
+    }
+    saved_levels = (uint32_t*)realloc(schedule->saved_levels, sizeof(*saved_levels) * (size_t)capacity);
+    if (saved_levels != NULL) {
+        schedule->saved_levels = saved_levels;
+    }
+    saved_pred_counts =
+        (uint32_t*)realloc(schedule->saved_pred_counts, sizeof(*saved_pred_counts) * (size_t)capacity);
+    if (saved_pred_counts != NULL) {
+        schedule->saved_pred_counts = saved_pred_counts;
+    }
+    queue = (uint32_t*)realloc(schedule->queue, sizeof(*queue) * (size_t)capacity);
+    if (queue != NULL) {
+        schedule->queue = queue;
+    }
+    batch_nodes = (uint32_t*)realloc(schedule->batch_nodes, sizeof(*batch_nodes) * (size_t)capacity);
+    if (batch_nodes != NULL) {
+        schedule->batch_nodes = batch_nodes;
+    }
+    batch_offsets =
+        (uint32_t*)realloc(schedule->batch_offsets, sizeof(*batch_offsets) * ((size_t)capacity + 1u));
+    if (batch_offsets != NULL) {
+        schedule->batch_offsets = batch_offsets;
+    }
+    timings = (lt_schedule_entry_timing_t*)realloc(schedule->timings, sizeof(*timings) * (size_t)capacity);
+    if (timings != NULL) {
+        schedule->timings = timings;
     }
 
-    chunk->entities[row] = entity;
-
-    slot->alive = 1u;
-    slot->next_free = UINT32_MAX;
-    slot->archetype = world->root_archetype;
-    slot->chunk = chunk;
-    slot->row = row;
+    if (entries == NULL
+        || enabled == NULL
+        || queued == NULL
+        || levels == NULL
+        || pred_counts == NULL
+        || saved_levels == NULL
+        || saved_pred_counts == NULL
+        || queue == NULL
+        || batch_nodes == NULL
+        || batch_offsets == NULL
+        || timings == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
 
-    world->live_entity_count += 1u;
-    *out_entity = entity;
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_ENTITY_CREATE,
-        LT_STATUS_OK,
-        entity,
-        LT_COMPONENT_INVALID,
-        0u);
+    memset(&queued[schedule->entry_capacity], 0, (size_t)(capacity - schedule->entry_capacity));
+    schedule->entry_capacity = capacity;
     return LT_STATUS_OK;
 }
 
-lt_status_t lt_entity_destroy(lt_world_t* world, lt_entity_t entity)
+static lt_status_t lt_schedule_reserve_lists(
+    lt_schedule_access_list_t** lists,
+    uint32_t* list_count,
+    uint32_t min_count)
 {
-    lt_entity_slot_t* slot;
-    lt_archetype_t* archetype;
-    lt_chunk_t* chunk;
-    uint32_t row;
-    uint32_t i;
-    lt_status_t status;
+    lt_schedule_access_list_t* grown;
 
-    if (world == NULL || entity == LT_ENTITY_NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    if (*list_count >= min_count) {
+        return LT_STATUS_OK;
     }
-
-    if (world->defer_depth > 0u) {
-        return lt_enqueue_destroy_entity(world, entity);
+    if (sizeof(*grown) > SIZE_MAX / (size_t)min_count) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
 
-    status = lt_world_get_live_slot(world, entity, &slot);
-    if (status != LT_STATUS_OK) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_ENTITY_DESTROY,
-            status,
-            entity,
-            LT_COMPONENT_INVALID,
-            0u);
-        return status;
+    grown = (lt_schedule_access_list_t*)realloc(*lists, sizeof(*grown) * (size_t)min_count);
+    if (grown == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
     }
+    memset(&grown[*list_count], 0, sizeof(*grown) * (size_t)(min_count - *list_count));
+    *lists = grown;
+    *list_count = min_count;
+    return LT_STATUS_OK;
+}
 
-    archetype = slot->archetype;
-    chunk = slot->chunk;
-    row = slot->row;
+static uint32_t lt_schedule_list_find(const lt_schedule_access_list_t* list, uint32_t entry)
+{
+    uint32_t lo;
+    uint32_t hi;
 
-    for (i = 0u; i < archetype->component_count; ++i) {
-        lt_component_id_t component_id;
-        const lt_component_record_t* component;
-        void* ptr;
+    lo = 0u;
+    hi = list->count;
+    while (lo < hi) {
+        uint32_t mid;
 
-        component_id = archetype->component_ids[i];
-        component = &world->components[component_id];
-        if (component->dtor == NULL || component->size == 0u) {
-            continue;
+        mid = lo + (hi - lo) / 2u;
+        if (list->items[mid].entry < entry) {
+            lo = mid + 1u;
+        } else {
+            hi = mid;
         }
-
-        ptr = lt_chunk_component_ptr(world, archetype, chunk, row, i);
-        lt_component_destruct_one(component, ptr);
     }
+    return lo;
+}
 
-    lt_archetype_swap_remove_row(world, archetype, chunk, row);
+static lt_status_t lt_schedule_list_insert(
+    lt_schedule_access_list_t* list,
+    uint32_t entry,
+    lt_access_t access)
+{
+    uint32_t position;
 
-    slot->alive = 0u;
-    slot->generation += 1u;
-    if (slot->generation == 0u) {
-        slot->generation = 1u;
+    if (list->count == list->capacity) {
+        lt_schedule_access_t* items;
+        uint32_t capacity;
+
+        capacity = list->capacity == 0u ? 8u : list->capacity * 2u;
+        if (capacity <= list->capacity || sizeof(*items) > SIZE_MAX / (size_t)capacity) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        items = (lt_schedule_access_t*)realloc(list->items, sizeof(*items) * (size_t)capacity);
+        if (items == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    position = lt_schedule_list_find(list, entry + 1u);
+    memmove(
+        &list->items[position + 1u],
+        &list->items[position],
+        sizeof(*list->items) * (size_t)(list->count - position));
+    list->items[position].entry = entry;
+    list->items[position].access = access;
+    list->count += 1u;
+    return LT_STATUS_OK;
+}
+
+static void lt_schedule_list_erase(lt_schedule_access_list_t* list, uint32_t entry)
+{
+    uint32_t read;
+    uint32_t write;
+
+    write = lt_schedule_list_find(list, entry);
+    for (read = write; read < list->count; ++read) {
+        if (list->items[read].entry != entry) {
+            list->items[write] = list->items[read];
+            write += 1u;
+        }
     }
+    list->count = write;
+}
 
-    slot->archetype = NULL;
-    slot->chunk = NULL;
-    slot->row = 0u;
+static void lt_schedule_shift_lists(
+    lt_schedule_access_list_t* lists,
+    uint32_t list_count,
+    uint32_t from_entry,
+    int inserting)
+{
+    uint32_t l;
 
-    slot->next_free = world->free_entity_head;
-    world->free_entity_head = lt_entity_index(entity);
-    world->free_entity_count += 1u;
+    for (l = 0u; l < list_count; ++l) {
+        uint32_t i;
 
-    if (world->live_entity_count > 0u) {
-        world->live_entity_count -= 1u;
+        for (i = lt_schedule_list_find(&lists[l], from_entry); i < lists[l].count; ++i) {
+            if (inserting) {
+                lists[l].items[i].entry += 1u;
+            } else {
+                lists[l].items[i].entry -= 1u;
+            }
+        }
     }
-
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_ENTITY_DESTROY,
-        LT_STATUS_OK,
-        entity,
-        LT_COMPONENT_INVALID,
-        0u);
-    return LT_STATUS_OK;
 }
 
-lt_status_t lt_entity_is_alive(const lt_world_t* world, lt_entity_t entity, uint8_t* out_alive)
+static lt_status_t lt_schedule_index_entry(lt_schedule_t* schedule, uint32_t entry_index)
 {
-    uint32_t index;
-    uint32_t generation;
-    const lt_entity_slot_t* slot;
+    const lt_schedule_item_t* entry;
+    uint32_t term_count;
+    uint32_t i;
+    lt_status_t status;
 
-    if (world == NULL || out_alive == NULL || entity == LT_ENTITY_NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    entry = &schedule->entries[entry_index];
+    term_count = entry->query->with_count + entry->random_access_count;
+    for (i = 0u; i < term_count; ++i) {
+        const lt_query_term_t* term;
+
+        term = lt_entry_term(entry->query, entry->random_access, i);
+        status = lt_schedule_reserve_lists(
+            &schedule->component_lists,
+            &schedule->component_list_count,
+            term->component_id + 1u);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+        status = lt_schedule_list_insert(&schedule->component_lists[term->component_id], entry_index, term->access);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
     }
 
-    index = lt_entity_index(entity);
-    generation = lt_entity_generation(entity);
+    for (i = 0u; i < entry->event_count; ++i) {
+        lt_event_channel_id_t channel;
 
-    if (index >= world->entity_count) {
-        *out_alive = 0u;
-        return LT_STATUS_OK;
+        channel = entry->events[i].channel;
+        status = lt_schedule_reserve_lists(&schedule->channel_lists, &schedule->channel_list_count, channel + 1u);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
+        status = lt_schedule_list_insert(&schedule->channel_lists[channel], entry_index, entry->events[i].access);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
     }
 
-    slot = &world->entities[index];
-    *out_alive = (uint8_t)(slot->alive != 0u && slot->generation == generation);
     return LT_STATUS_OK;
 }
 
-lt_status_t lt_add_component(
-    lt_world_t* world,
-    lt_entity_t entity,
-    lt_component_id_t component_id,
-    const void* initial_value)
+static void lt_schedule_unindex_entry(lt_schedule_t* schedule, uint32_t entry_index)
 {
-    lt_entity_slot_t* slot;
-    lt_archetype_t* src_archetype;
-    lt_chunk_t* src_chunk;
-    uint32_t src_row;
-    lt_component_id_t* dst_ids;
-    uint32_t dst_count;
-    lt_archetype_t* dst_archetype;
-    lt_chunk_t* dst_chunk;
-    uint32_t dst_row;
+    const lt_schedule_item_t* entry;
+    uint32_t term_count;
     uint32_t i;
-    lt_status_t status;
-
-    if (world == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
 
-    if (component_id > world->component_count) {
-        return LT_STATUS_NOT_FOUND;
-    }
+    entry = &schedule->entries[entry_index];
+    term_count = entry->query->with_count + entry->random_access_count;
+    for (i = 0u; i < term_count; ++i) {
+        lt_component_id_t component_id;
 
-    if (world->defer_depth > 0u) {
-        return lt_enqueue_add_component(world, entity, component_id, initial_value);
+        component_id = lt_entry_term(entry->query, entry->random_access, i)->component_id;
+        if (component_id < schedule->component_list_count) {
+            lt_schedule_list_erase(&schedule->component_lists[component_id], entry_index);
+        }
     }
+    for (i = 0u; i < entry->event_count; ++i) {
+        lt_event_channel_id_t channel;
 
-    status = lt_world_get_live_slot(world, entity, &slot);
-    if (status != LT_STATUS_OK) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_COMPONENT_ADD,
-            status,
-            entity,
-            component_id,
-            0u);
-        return status;
+        channel = entry->events[i].channel;
+        if (channel < schedule->channel_list_count) {
+            lt_schedule_list_erase(&schedule->channel_lists[channel], entry_index);
+        }
     }
+}
 
-    src_archetype = slot->archetype;
-    src_chunk = slot->chunk;
-    src_row = slot->row;
-
-    if (lt_archetype_find_component_index(src_archetype, component_id, NULL)) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_COMPONENT_ADD,
-            LT_STATUS_ALREADY_EXISTS,
-            entity,
-            component_id,
-            0u);
-        return LT_STATUS_ALREADY_EXISTS;
-    }
+static lt_status_t lt_schedule_copy_declarations(lt_schedule_item_t* entry)
+{
+    lt_event_access_t* events;
+    lt_query_term_t* random_access;
 
-    dst_ids = NULL;
-    dst_count = 0u;
-    status = lt_world_component_key_with_add(world, src_archetype, component_id, &dst_ids, &dst_count);
-    if (status != LT_STATUS_OK) {
-        return status;
+    events = NULL;
+    random_access = NULL;
+    if (sizeof(*events) > SIZE_MAX / ((size_t)entry->event_count + 1u)
+        || sizeof(*random_access) > SIZE_MAX / ((size_t)entry->random_access_count + 1u)) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
 
-    status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
-    if (dst_ids != NULL) {
-        lt_free_bytes(
-            &world->allocator,
-            dst_ids,
-            sizeof(*dst_ids) * (size_t)dst_count,
-            _Alignof(lt_component_id_t));
-    }
-    if (status != LT_STATUS_OK) {
-        return status;
+    if (entry->event_count > 0u) {
+        events = (lt_event_access_t*)malloc(sizeof(*events) * (size_t)entry->event_count);
+        if (events == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memcpy(events, entry->events, sizeof(*events) * (size_t)entry->event_count);
     }
-
-    status = lt_archetype_alloc_row(world, dst_archetype, &dst_chunk, &dst_row);
-    if (status != LT_STATUS_OK) {
-        return status;
+    if (entry->random_access_count > 0u) {
+        random_access = (lt_query_term_t*)malloc(sizeof(*random_access) * (size_t)entry->random_access_count);
+        if (random_access == NULL) {
+            free(events);
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        memcpy(random_access, entry->random_access, sizeof(*random_access) * (size_t)entry->random_access_count);
     }
 
-    dst_chunk->entities[dst_row] = entity;
-
-    for (i = 0u; i < dst_archetype->component_count; ++i) {
-        lt_component_id_t dst_component_id;
-        const lt_component_record_t* component;
-        void* dst_ptr;
+    entry->events = events;
+    entry->random_access = random_access;
+    return LT_STATUS_OK;
+}
 
-        dst_component_id = dst_archetype->component_ids[i];
-        component = &world->components[dst_component_id];
-        dst_ptr = lt_chunk_component_ptr(world, dst_archetype, dst_chunk, dst_row, i);
+static void lt_schedule_free_declarations(lt_schedule_item_t* entry)
+{
+    free((void*)entry->events);
+    free((void*)entry->random_access);
+    entry->events = NULL;
+    entry->random_access = NULL;
+}
 
-        if (dst_component_id == component_id) {
-            lt_component_init_added(component, dst_ptr, initial_value);
-        } else {
-            uint32_t src_i = 0u;
-            void* src_ptr;
+static lt_status_t lt_schedule_add_pred(lt_schedule_t* schedule, uint32_t* pred_count, uint32_t pred)
+{
+    if (*pred_count == schedule->pred_capacity) {
+        uint32_t* preds;
+        uint32_t capacity;
 
-            (void)lt_archetype_find_component_index(src_archetype, dst_component_id, &src_i);
-            src_ptr = lt_chunk_component_ptr(world, src_archetype, src_chunk, src_row, src_i);
-            lt_component_transfer(component, dst_ptr, src_ptr);
+        capacity = schedule->pred_capacity == 0u ? 16u : schedule->pred_capacity * 2u;
+        if (capacity <= schedule->pred_capacity || sizeof(*preds) > SIZE_MAX / (size_t)capacity) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+        preds = (uint32_t*)realloc(schedule->preds, sizeof(*preds) * (size_t)capacity);
+        if (preds == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
         }
+        schedule->preds = preds;
+        schedule->pred_capacity = capacity;
     }
 
-    slot->archetype = dst_archetype;
-    slot->chunk = dst_chunk;
-    slot->row = dst_row;
-    world->structural_move_count += 1u;
-
-    lt_archetype_swap_remove_row(world, src_archetype, src_chunk, src_row);
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_COMPONENT_ADD,
-        LT_STATUS_OK,
-        entity,
-        component_id,
-        0u);
+    schedule->preds[*pred_count] = pred;
+    *pred_count += 1u;
     return LT_STATUS_OK;
 }
 
-lt_status_t lt_remove_component(
-    lt_world_t* world,
-    lt_entity_t entity,
-    lt_component_id_t component_id)
+static lt_status_t lt_schedule_compute_level(
+    lt_schedule_t* schedule,
+    uint32_t entry_index,
+    uint32_t* out_level,
+    uint32_t* out_pred_count)
 {
-    lt_entity_slot_t* slot;
-    lt_archetype_t* src_archetype;
-    lt_chunk_t* src_chunk;
-    uint32_t src_row;
-    lt_component_id_t* dst_ids;
-    uint32_t dst_count;
-    lt_archetype_t* dst_archetype;
-    lt_chunk_t* dst_chunk;
-    uint32_t dst_row;
-    uint32_t removed_index;
+    const lt_schedule_item_t* entry;
+    uint32_t term_count;
+    uint32_t pred_count;
+    uint32_t unique_count;
+    uint32_t level;
     uint32_t i;
     lt_status_t status;
 
-    if (world == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    *out_level = 0u;
+    *out_pred_count = 0u;
+    if (schedule->enabled[entry_index] == 0u) {
+        return LT_STATUS_OK;
     }
 
-    if (component_id > world->component_count) {
-        return LT_STATUS_NOT_FOUND;
-    }
+    entry = &schedule->entries[entry_index];
+    term_count = entry->query->with_count + entry->random_access_count;
+    pred_count = 0u;
+    for (i = 0u; i < term_count; ++i) {
+        const lt_query_term_t* term;
+        const lt_schedule_access_list_t* list;
+        lt_access_t access;
+        uint32_t k;
 
-    if (world->defer_depth > 0u) {
-        return lt_enqueue_remove_component(world, entity, component_id);
-    }
+        term = lt_entry_term(entry->query, entry->random_access, i);
+        list = &schedule->component_lists[term->component_id];
+        access = term->access;
+        for (k = lt_schedule_list_find(list, entry_index); k > 0u; --k) {
+            const lt_schedule_access_t* item;
 
-    status = lt_world_get_live_slot(world, entity, &slot);
-    if (status != LT_STATUS_OK) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_COMPONENT_REMOVE,
-            status,
-            entity,
-            component_id,
-            0u);
-        return status;
+            item = &list->items[k - 1u];
+            if (schedule->enabled[item->entry] == 0u) {
+                continue;
+            }
+            if (item->access == LT_ACCESS_WRITE || access == LT_ACCESS_WRITE) {
+                status = lt_schedule_add_pred(schedule, &pred_count, item->entry);
+                if (status != LT_STATUS_OK) {
+                    return status;
+                }
+            }
+            if (item->access == LT_ACCESS_WRITE) {
+                break;
+            }
+        }
     }
 
-    src_archetype = slot->archetype;
-    src_chunk = slot->chunk;
-    src_row = slot->row;
+    for (i = 0u; i < entry->event_count; ++i) {
+        const lt_schedule_access_list_t* list;
+        uint32_t k;
 
-    if (!lt_archetype_find_component_index(src_archetype, component_id, &removed_index)) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_COMPONENT_REMOVE,
-            LT_STATUS_NOT_FOUND,
-            entity,
-            component_id,
-            0u);
-        return LT_STATUS_NOT_FOUND;
-    }
+        list = &schedule->channel_lists[entry->events[i].channel];
+        k = entry->events[i].access == LT_ACCESS_READ ? list->count : lt_schedule_list_find(list, entry_index);
+        for (; k > 0u; --k) {
+            const lt_schedule_access_t* item;
 
-    dst_ids = NULL;
-    dst_count = 0u;
-    status = lt_world_component_key_with_remove(world, src_archetype, component_id, &dst_ids, &dst_count);
-    if (status != LT_STATUS_OK) {
-        return status;
+            item = &list->items[k - 1u];
+            if (item->entry == entry_index
+                || item->access != LT_ACCESS_WRITE
+                || schedule->enabled[item->entry] == 0u) {
+                continue;
+            }
+            status = lt_schedule_add_pred(schedule, &pred_count, item->entry);
+            if (status != LT_STATUS_OK) {
+                return status;
+            }
+            break;
+        }
     }
 
-    status = lt_find_or_create_archetype(world, dst_ids, dst_count, &dst_archetype);
-    if (dst_ids != NULL) {
-        lt_free_bytes(
-            &world->allocator,
-            dst_ids,
-            sizeof(*dst_ids) * (size_t)dst_count,
-            _Alignof(lt_component_id_t));
-    }
-    if (status != LT_STATUS_OK) {
-        return status;
+    if (pred_count > 1u) {
+        qsort(schedule->preds, pred_count, sizeof(*schedule->preds), lt_schedule_node_compare);
     }
 
-    status = lt_archetype_alloc_row(world, dst_archetype, &dst_chunk, &dst_row);
-    if (status != LT_STATUS_OK) {
-        return status;
+    level = 0u;
+    unique_count = 0u;
+    for (i = 0u; i < pred_count; ++i) {
+        if (i > 0u && schedule->preds[i] == schedule->preds[i - 1u]) {
+            continue;
+        }
+        unique_count += 1u;
+        if (schedule->levels[schedule->preds[i]] + 1u > level) {
+            level = schedule->levels[schedule->preds[i]] + 1u;
+        }
     }
 
-    dst_chunk->entities[dst_row] = entity;
-
-    for (i = 0u; i < dst_archetype->component_count; ++i) {
-        lt_component_id_t dst_component_id;
-        const lt_component_record_t* component;
-        uint32_t src_i = 0u;
-        void* src_ptr;
-        void* dst_ptr;
-
-        dst_component_id = dst_archetype->component_ids[i];
-        component = &world->components[dst_component_id];
-        (void)lt_archetype_find_component_index(src_archetype, dst_component_id, &src_i);
+    *out_level = level;
+    *out_pred_count = unique_count;
+    return LT_STATUS_OK;
+}
 
-        src_ptr = lt_chunk_component_ptr(world, src_archetype, src_chunk, src_row, src_i);
-        dst_ptr = lt_chunk_component_ptr(world, dst_archetype, dst_chunk, dst_row, i);
-        lt_component_transfer(component, dst_ptr, src_ptr);
+static void lt_schedule_queue_push(lt_schedule_t* schedule, uint32_t* tail, uint32_t* queued_count, uint32_t entry)
+{
+    if (schedule->queued[entry] != 0u) {
+        return;
     }
+    schedule->queued[entry] = 1u;
+    schedule->queue[*tail] = entry;
+    *tail = (*tail + 1u) % schedule->entry_count;
+    *queued_count += 1u;
+}
 
-    {
-        const lt_component_record_t* removed_component;
-        void* removed_ptr;
+static void lt_schedule_queue_dependents(
+    lt_schedule_t* schedule,
+    uint32_t entry_index,
+    uint32_t* tail,
+    uint32_t* queued_count)
+{
+    const lt_schedule_item_t* entry;
+    uint32_t term_count;
+    uint32_t i;
+
+    entry = &schedule->entries[entry_index];
+    term_count = entry->query->with_count + entry->random_access_count;
+    for (i = 0u; i < term_count; ++i) {
+        const lt_schedule_access_list_t* list;
+        uint32_t k;
 
-        removed_component = &world->components[component_id];
-        removed_ptr = lt_chunk_component_ptr(world, src_archetype, src_chunk, src_row, removed_index);
-        lt_component_destruct_one(removed_component, removed_ptr);
+        list = &schedule->component_lists[lt_entry_term(entry->query, entry->random_access, i)->component_id];
+        for (k = lt_schedule_list_find(list, entry_index + 1u); k < list->count; ++k) {
+            lt_schedule_queue_push(schedule, tail, queued_count, list->items[k].entry);
+            if (list->items[k].access == LT_ACCESS_WRITE && schedule->enabled[list->items[k].entry] != 0u) {
+                break;
+            }
+        }
     }
 
-    slot->archetype = dst_archetype;
-    slot->chunk = dst_chunk;
-    slot->row = dst_row;
-    world->structural_move_count += 1u;
+    for (i = 0u; i < entry->event_count; ++i) {
+        const lt_schedule_access_list_t* list;
+        uint32_t k;
 
-    lt_archetype_swap_remove_row(world, src_archetype, src_chunk, src_row);
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_COMPONENT_REMOVE,
-        LT_STATUS_OK,
-        entity,
-        component_id,
-        0u);
-    return LT_STATUS_OK;
+        if (entry->events[i].access != LT_ACCESS_WRITE) {
+            continue;
+        }
+        list = &schedule->channel_lists[entry->events[i].channel];
+        for (k = 0u; k < list->count; ++k) {
+            if (list->items[k].entry != entry_index) {
+                lt_schedule_queue_push(schedule, tail, queued_count, list->items[k].entry);
+            }
+        }
+    }
 }
 
-lt_status_t lt_has_component(
-    const lt_world_t* world,
-    lt_entity_t entity,
-    lt_component_id_t component_id,
-    uint8_t* out_has)
+static lt_status_t lt_schedule_relevel(lt_schedule_t* schedule, uint32_t seed)
 {
-    lt_entity_slot_t* slot;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t queued_count;
     lt_status_t status;
 
-    if (world == NULL || out_has == NULL || entity == LT_ENTITY_NULL || component_id == LT_COMPONENT_INVALID) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
+    head = 0u;
+    tail = 0u;
+    queued_count = 0u;
+    lt_schedule_queue_push(schedule, &tail, &queued_count, seed);
+    lt_schedule_queue_dependents(schedule, seed, &tail, &queued_count);
 
-    if (component_id > world->component_count) {
-        *out_has = 0u;
-        return LT_STATUS_OK;
-    }
+    status = LT_STATUS_OK;
+    while (queued_count > 0u) {
+        uint32_t entry_index;
+        uint32_t level;
+        uint32_t pred_count;
+
+        entry_index = schedule->queue[head];
+        head = (head + 1u) % schedule->entry_count;
+        queued_count -= 1u;
+        schedule->queued[entry_index] = 0u;
+        if (status != LT_STATUS_OK) {
+            continue;
+        }
+
+        status = lt_schedule_compute_level(schedule, entry_index, &level, &pred_count);
+        if (status != LT_STATUS_OK) {
+            continue;
+        }
+        if (level >= schedule->entry_count) {
+            status = LT_STATUS_CONFLICT;
+            continue;
+        }
 
-    status = lt_world_get_live_slot(world, entity, &slot);
-    if (status != LT_STATUS_OK) {
-        return status;
+        schedule->edge_count = schedule->edge_count - schedule->pred_counts[entry_index] + pred_count;
+        schedule->pred_counts[entry_index] = pred_count;
+        if (level != schedule->levels[entry_index]) {
+            schedule->levels[entry_index] = level;
+            lt_schedule_queue_dependents(schedule, entry_index, &tail, &queued_count);
+        }
     }
 
-    *out_has = (uint8_t)lt_archetype_find_component_index(slot->archetype, component_id, NULL);
-    return LT_STATUS_OK;
+    return status;
 }
 
-lt_status_t lt_get_component(
-    lt_world_t* world,
-    lt_entity_t entity,
-    lt_component_id_t component_id,
-    void** out_ptr)
+static void lt_schedule_rebuild_batches(lt_schedule_t* schedule)
 {
-    lt_entity_slot_t* slot;
-    uint32_t component_index;
-    lt_status_t status;
+    uint32_t i;
 
-    if (world == NULL
-        || out_ptr == NULL
-        || entity == LT_ENTITY_NULL
-        || component_id == LT_COMPONENT_INVALID) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    schedule->batch_count = 0u;
+    schedule->max_batch_size = 0u;
+    memset(schedule->batch_offsets, 0, sizeof(*schedule->batch_offsets) * ((size_t)schedule->entry_count + 1u));
+    for (i = 0u; i < schedule->entry_count; ++i) {
+        if (schedule->enabled[i] == 0u) {
+            continue;
+        }
+        schedule->batch_offsets[schedule->levels[i] + 1u] += 1u;
+        if (schedule->levels[i] + 1u > schedule->batch_count) {
+            schedule->batch_count = schedule->levels[i] + 1u;
+        }
     }
 
-    *out_ptr = NULL;
+    for (i = 0u; i < schedule->batch_count; ++i) {
+        uint32_t size;
 
-    if (component_id > world->component_count) {
-        return LT_STATUS_NOT_FOUND;
+        size = schedule->batch_offsets[i + 1u];
+        if (size > schedule->max_batch_size) {
+            schedule->max_batch_size = size;
+        }
+        schedule->batch_offsets[i + 1u] += schedule->batch_offsets[i];
     }
 
-    status = lt_world_get_live_slot(world, entity, &slot);
-    if (status != LT_STATUS_OK) {
-        return status;
+    for (i = 0u; i < schedule->entry_count; ++i) {
+        if (schedule->enabled[i] == 0u) {
+            continue;
+        }
+        schedule->batch_nodes[schedule->batch_offsets[schedule->levels[i]]] = i;
+        schedule->batch_offsets[schedule->levels[i]] += 1u;
     }
 
-    if (!lt_archetype_find_component_index(slot->archetype, component_id, &component_index)) {
-        return LT_STATUS_NOT_FOUND;
+    for (i = schedule->batch_count; i > 0u; --i) {
+        schedule->batch_offsets[i] = schedule->batch_offsets[i - 1u];
     }
-
-    *out_ptr = lt_chunk_component_ptr(world, slot->archetype, slot->chunk, slot->row, component_index);
-    return LT_STATUS_OK;
+    schedule->batch_offsets[0] = 0u;
 }
 
-lt_status_t lt_register_component(
-    lt_world_t* world,
-    const lt_component_desc_t* desc,
-    lt_component_id_t* out_id)
+static lt_status_t lt_schedule_apply_enabled(lt_schedule_t* schedule, uint32_t entry_index, uint8_t enabled)
 {
-    uint32_t i;
-    lt_component_id_t id;
+    uint32_t saved_edge_count;
     lt_status_t status;
-    lt_component_record_t* record;
 
-    if (world == NULL || desc == NULL || out_id == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    if (schedule->enabled[entry_index] == enabled) {
+        return LT_STATUS_OK;
     }
 
-    status = lt_component_desc_validate(desc);
+    memcpy(schedule->saved_levels, schedule->levels, sizeof(*schedule->levels) * (size_t)schedule->entry_count);
+    memcpy(
+        schedule->saved_pred_counts,
+        schedule->pred_counts,
+        sizeof(*schedule->pred_counts) * (size_t)schedule->entry_count);
+    saved_edge_count = schedule->edge_count;
+
+    schedule->enabled[entry_index] = enabled;
+    status = lt_schedule_relevel(schedule, entry_index);
     if (status != LT_STATUS_OK) {
+        schedule->enabled[entry_index] = (uint8_t)(enabled == 0u ? 1u : 0u);
+        memcpy(schedule->levels, schedule->saved_levels, sizeof(*schedule->levels) * (size_t)schedule->entry_count);
+        memcpy(
+            schedule->pred_counts,
+            schedule->saved_pred_counts,
+            sizeof(*schedule->pred_counts) * (size_t)schedule->entry_count);
+        schedule->edge_count = saved_edge_count;
         return status;
     }
 
-    for (i = 1u; i <= world->component_count; ++i) {
-        if (lt_component_names_equal(world->components[i].name, desc->name)) {
-            return LT_STATUS_ALREADY_EXISTS;
-        }
-    }
-
-    if (world->component_count == UINT32_MAX - 1u) {
-        return LT_STATUS_CAPACITY_REACHED;
-    }
+    lt_schedule_rebuild_batches(schedule);
+    return LT_STATUS_OK;
+}
 
-    id = world->component_count + 1u;
-    status = lt_grow_components(world, id);
-    if (status != LT_STATUS_OK) {
-        return status;
-    }
+static void lt_schedule_erase_entry(lt_schedule_t* schedule, uint32_t entry_index)
+{
+    uint32_t tail_count;
+
+    lt_schedule_unindex_entry(schedule, entry_index);
+    lt_schedule_free_declarations(&schedule->entries[entry_index]);
+    lt_schedule_shift_lists(schedule->component_lists, schedule->component_list_count, entry_index + 1u, 0);
+    lt_schedule_shift_lists(schedule->channel_lists, schedule->channel_list_count, entry_index + 1u, 0);
+
+    tail_count = schedule->entry_count - entry_index - 1u;
+    memmove(
+        &schedule->entries[entry_index],
+        &schedule->entries[entry_index + 1u],
+        sizeof(*schedule->entries) * (size_t)tail_count);
+    memmove(
+        &schedule->enabled[entry_index],
+        &schedule->enabled[entry_index + 1u],
+        sizeof(*schedule->enabled) * (size_t)tail_count);
+    memmove(
+        &schedule->levels[entry_index],
+        &schedule->levels[entry_index + 1u],
+        sizeof(*schedule->levels) * (size_t)tail_count);
+    memmove(
+        &schedule->pred_counts[entry_index],
+        &schedule->pred_counts[entry_index + 1u],
+        sizeof(*schedule->pred_counts) * (size_t)tail_count);
+    memmove(
+        &schedule->timings[entry_index],
+        &schedule->timings[entry_index + 1u],
+        sizeof(*schedule->timings) * (size_t)tail_count);
+    schedule->entry_count -= 1u;
+    lt_schedule_rebuild_batches(schedule);
+}
 
-    record = &world->components[id];
-    memset(record, 0, sizeof(*record));
+void lt_schedule_destroy(lt_schedule_t* schedule)
+{
+    uint32_t i;
 
-    status = lt_component_name_copy(world, desc->name, &record->name);
-    if (status != LT_STATUS_OK) {
-        return status;
+    if (schedule == NULL) {
+        return;
     }
 
-    record->size = desc->size;
-    record->align = desc->align == 0u ? 1u : desc->align;
-    record->flags = desc->flags;
-    record->ctor = desc->ctor;
-    record->dtor = desc->dtor;
-    record->move = desc->move;
-    record->user = desc->user;
+    for (i = 0u; i < schedule->entry_count; ++i) {
+        lt_schedule_free_declarations(&schedule->entries[i]);
+    }
+    for (i = 0u; i < schedule->component_list_count; ++i) {
+        free(schedule->component_lists[i].items);
+    }
+    for (i = 0u; i < schedule->channel_list_count; ++i) {
+        free(schedule->channel_lists[i].items);
+    }
 
-    world->component_count = id;
-    *out_id = id;
-    return LT_STATUS_OK;
+    free(schedule->timings);
+    free(schedule->preds);
+    free(schedule->queued);
+    free(schedule->queue);
+    free(schedule->saved_pred_counts);
+    free(schedule->saved_levels);
+    free(schedule->channel_lists);
+    free(schedule->component_lists);
+    free(schedule->batch_offsets);
+    free(schedule->batch_nodes);
+    free(schedule->pred_counts);
+    free(schedule->levels);
+    free(schedule->enabled);
+    free(schedule->entries);
+    free(schedule);
 }
 
-lt_status_t lt_find_component(
-    const lt_world_t* world,
-    const char* name,
-    lt_component_id_t* out_id)
+static lt_status_t lt_schedule_make_items(
+    const lt_query_schedule_entry_t* entries,
+    const lt_schedule_entry_decl_t* decls,
+    uint32_t entry_count,
+    lt_schedule_item_t** out_items)
 {
+    lt_schedule_item_t* items;
     uint32_t i;
 
-    if (world == NULL || name == NULL || name[0] == '\0' || out_id == NULL) {
+    *out_items = NULL;
+    if (entries == NULL || entry_count == 0u) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
+    if (sizeof(*items) > SIZE_MAX / (size_t)entry_count) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
 
-    for (i = 1u; i <= world->component_count; ++i) {
-        if (lt_component_names_equal(world->components[i].name, name)) {
-            *out_id = i;
-            return LT_STATUS_OK;
+    items = (lt_schedule_item_t*)malloc(sizeof(*items) * (size_t)entry_count);
+    if (items == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    memset(items, 0, sizeof(*items) * (size_t)entry_count);
+    for (i = 0u; i < entry_count; ++i) {
+        items[i].query = entries[i].query;
+        items[i].callback = entries[i].callback;
+        items[i].user_data = entries[i].user_data;
+        if (decls == NULL) {
+            continue;
+        }
+        if (decls[i].version != LT_SCHEDULE_ENTRY_DECL_VERSION) {
+            free(items);
+            return LT_STATUS_INVALID_ARGUMENT;
         }
+        items[i].name = decls[i].name;
+        items[i].events = decls[i].events;
+        items[i].event_count = decls[i].event_count;
+        items[i].random_access = decls[i].random_access;
+        items[i].random_access_count = decls[i].random_access_count;
     }
 
-    return LT_STATUS_NOT_FOUND;
+    *out_items = items;
+    return LT_STATUS_OK;
 }
 
-lt_status_t lt_query_create(lt_world_t* world, const lt_query_desc_t* desc, lt_query_t** out_query)
+static lt_status_t lt_schedule_create_items(
+    const lt_schedule_item_t* entries,
+    uint32_t entry_count,
+    lt_schedule_t** out_schedule)
 {
-    lt_query_t* query;
+    lt_world_t* world;
+    uint64_t* edges;
+    uint32_t* indegree;
+    uint32_t* successor_offsets;
+    uint32_t* successors;
+    uint32_t* batch_nodes;
+    uint32_t* batch_offsets;
+    lt_schedule_t* schedule;
+    uint32_t i;
+    uint32_t edge_count;
+    uint32_t batch_count;
+    uint32_t max_batch_size;
+    uint32_t stage_begin;
+    uint32_t stage_end;
+    size_t entry_plus_one;
     lt_status_t status;
 
-    if (world == NULL || desc == NULL || out_query == NULL) {
+    if (out_schedule == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
-    *out_query = NULL;
+    *out_schedule = NULL;
 
-    status = lt_query_validate_desc(world, desc);
+    if (entries == NULL || entry_count == 0u) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = lt_query_schedule_validate_entries(entries, entry_count, &world);
     if (status != LT_STATUS_OK) {
         return status;
     }
 
-    query = (lt_query_t*)lt_alloc_bytes(&world->allocator, sizeof(*query), _Alignof(lt_query_t));
-    if (query == NULL) {
-        return LT_STATUS_ALLOCATION_FAILED;
+    entry_plus_one = (size_t)entry_count + 1u;
+    if (entry_plus_one <= (size_t)entry_count) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
-    memset(query, 0, sizeof(*query));
-    query->world = world;
 
-    status = lt_query_copy_desc(query, desc);
-    if (status != LT_STATUS_OK) {
-        lt_query_destroy(query);
-        return status;
+    if (sizeof(*indegree) > SIZE_MAX / (size_t)entry_count
+        || sizeof(*batch_nodes) > SIZE_MAX / (size_t)entry_count
+        || sizeof(*batch_offsets) > SIZE_MAX / entry_plus_one
+        || sizeof(*successor_offsets) > SIZE_MAX / entry_plus_one
+        || sizeof(*schedule->entries) > SIZE_MAX / (size_t)entry_count) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
 
-    status = lt_query_ensure_scratch_capacity(query, query->with_count);
+    status = lt_schedule_collect_edges(world, entries, entry_count, &edges, &edge_count);
     if (status != LT_STATUS_OK) {
-        lt_query_destroy(query);
         return status;
     }
 
-    status = lt_query_refresh(query);
-    if (status != LT_STATUS_OK) {
-        lt_query_destroy(query);
-        return status;
+    indegree = (uint32_t*)malloc(sizeof(*indegree) * (size_t)entry_count);
+    successor_offsets = (uint32_t*)malloc(sizeof(*successor_offsets) * entry_plus_one);
+    successors = (uint32_t*)malloc(sizeof(*successors) * ((size_t)edge_count + 1u));
+    batch_nodes = (uint32_t*)malloc(sizeof(*batch_nodes) * (size_t)entry_count);
+    batch_offsets = (uint32_t*)malloc(sizeof(*batch_offsets) * entry_plus_one);
+    schedule = NULL;
+    if (indegree == NULL
+        || successor_offsets == NULL
+        || successors == NULL
+        || batch_nodes == NULL
+        || batch_offsets == NULL) {
+        status = LT_STATUS_ALLOCATION_FAILED;
+        goto cleanup;
     }
 
-    *out_query = query;
-    return LT_STATUS_OK;
-}
-
-void lt_query_destroy(lt_query_t* query)
-{
-    lt_world_t* world;
-
-    if (query == NULL) {
-        return;
+    memset(indegree, 0, sizeof(*indegree) * (size_t)entry_count);
+    memset(successor_offsets, 0, sizeof(*successor_offsets) * entry_plus_one);
+    for (i = 0u; i < edge_count; ++i) {
+        successor_offsets[(uint32_t)(edges[i] >> 32u) + 1u] += 1u;
+        indegree[(uint32_t)(edges[i] & 0xFFFFFFFFu)] += 1u;
+    }
+    for (i = 0u; i < entry_count; ++i) {
+        successor_offsets[i + 1u] += successor_offsets[i];
+    }
+    for (i = 0u; i < edge_count; ++i) {
+        successors[i] = (uint32_t)(edges[i] & 0xFFFFFFFFu);
     }
 
-    world = query->world;
-    if (world != NULL) {
-        if (query->with_terms != NULL) {
-            lt_free_bytes(
-                &world->allocator,
-                query->with_terms,
-                sizeof(*query->with_terms) * (size_t)query->with_count,
-                _Alignof(lt_query_term_t));
-        }
-        if (query->without != NULL) {
-            lt_free_bytes(
-                &world->allocator,
-                query->without,
-                sizeof(*query->without) * (size_t)query->without_count,
-                _Alignof(lt_component_id_t));
+    stage_end = 0u;
+    for (i = 0u; i < entry_count; ++i) {
+        if (indegree[i] == 0u) {
+            batch_nodes[stage_end] = i;
+            stage_end += 1u;
         }
-        if (query->matches != NULL) {
-            lt_free_bytes(
-                &world->allocator,
-                query->matches,
-                sizeof(*query->matches) * (size_t)query->match_capacity,
-                _Alignof(lt_archetype_t*));
+    }
+
+    batch_count = 0u;
+    max_batch_size = 0u;
+    stage_begin = 0u;
+    batch_offsets[0] = 0u;
+    while (stage_begin < stage_end) {
+        uint32_t next_end;
+
+        if (stage_end - stage_begin > max_batch_size) {
+            max_batch_size = stage_end - stage_begin;
         }
-        if (query->scratch_columns != NULL) {
-            lt_free_bytes(
-                &world->allocator,
-                query->scratch_columns,
-                sizeof(*query->scratch_columns) * (size_t)query->scratch_capacity,
-                _Alignof(void*));
+
+        next_end = stage_end;
+        for (i = stage_begin; i < stage_end; ++i) {
+            uint32_t s;
+
+            for (s = successor_offsets[batch_nodes[i]]; s < successor_offsets[batch_nodes[i] + 1u]; ++s) {
+                indegree[successors[s]] -= 1u;
+                if (indegree[successors[s]] == 0u) {
+                    batch_nodes[next_end] = successors[s];
+                    next_end += 1u;
+                }
+            }
         }
-        lt_free_bytes(&world->allocator, query, sizeof(*query), _Alignof(lt_query_t));
+
+        batch_count += 1u;
+        batch_offsets[batch_count] = stage_end;
+        qsort(&batch_nodes[stage_end], next_end - stage_end, sizeof(*batch_nodes), lt_schedule_node_compare);
+        stage_begin = stage_end;
+        stage_end = next_end;
     }
-}
 
-lt_status_t lt_query_refresh(lt_query_t* query)
-{
-    lt_world_t* world;
-    uint32_t i;
-    lt_status_t status;
+    if (stage_end != entry_count) {
+        status = LT_STATUS_CONFLICT;
+        goto cleanup;
+    }
 
-    if (query == NULL || query->world == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    schedule = (lt_schedule_t*)malloc(sizeof(*schedule));
+    if (schedule == NULL) {
+        status = LT_STATUS_ALLOCATION_FAILED;
+        goto cleanup;
     }
+    memset(schedule, 0, sizeof(*schedule));
+    schedule->world = world;
 
-    world = query->world;
-    status = lt_query_ensure_match_capacity(query, world->archetype_count);
+    status = lt_schedule_reserve_entries(schedule, entry_count);
     if (status != LT_STATUS_OK) {
-        return status;
+        goto cleanup;
+    }
+
+    for (i = 0u; i < entry_count; ++i) {
+        schedule->entries[i] = entries[i];
+        status = lt_schedule_copy_declarations(&schedule->entries[i]);
+        if (status != LT_STATUS_OK) {
+            goto cleanup;
+        }
+        schedule->entry_count = i + 1u;
+        schedule->enabled[i] = 1u;
+        schedule->pred_counts[i] = 0u;
+        memset(&schedule->timings[i], 0, sizeof(schedule->timings[i]));
     }
 
-    query->match_count = 0u;
-    for (i = 0u; i < world->archetype_count; ++i) {
-        lt_archetype_t* archetype;
+    for (i = 0u; i < batch_count; ++i) {
+        uint32_t k;
 
-        archetype = world->archetypes[i];
-        if (archetype == NULL) {
-            continue;
+        for (k = batch_offsets[i]; k < batch_offsets[i + 1u]; ++k) {
+            schedule->levels[batch_nodes[k]] = i;
         }
+    }
+    for (i = 0u; i < edge_count; ++i) {
+        schedule->pred_counts[(uint32_t)(edges[i] & 0xFFFFFFFFu)] += 1u;
+    }
+    schedule->edge_count = edge_count;
 
-        if (lt_query_matches_archetype(query, archetype)) {
-            query->matches[query->match_count] = archetype;
-            query->match_count += 1u;
+    for (i = 0u; i < entry_count; ++i) {
+        status = lt_schedule_index_entry(schedule, i);
+        if (status != LT_STATUS_OK) {
+            goto cleanup;
         }
     }
 
-    return LT_STATUS_OK;
+    lt_schedule_rebuild_batches(schedule);
+    *out_schedule = schedule;
+    status = LT_STATUS_OK;
+
+cleanup:
+    free(edges);
+    free(successors);
+    free(successor_offsets);
+    free(indegree);
+    free(batch_offsets);
+    free(batch_nodes);
+    if (status != LT_STATUS_OK) {
+        lt_schedule_destroy(schedule);
+    }
+    return status;
 }
 
-lt_status_t lt_query_iter_begin(lt_query_t* query, lt_query_iter_t* out_iter)
+lt_status_t lt_schedule_create(
+    const lt_query_schedule_entry_t* entries,
+    uint32_t entry_count,
+    lt_schedule_t** out_schedule)
 {
-    lt_world_t* world;
+    return lt_schedule_create_with_decls(entries, NULL, entry_count, out_schedule);
+}
+
+lt_status_t lt_schedule_create_with_decls(
+    const lt_query_schedule_entry_t* entries,
+    const lt_schedule_entry_decl_t* decls,
+    uint32_t entry_count,
+    lt_schedule_t** out_schedule)
+{
+    lt_schedule_item_t* items;
     lt_status_t status;
 
-    if (query == NULL || out_iter == NULL || query->world == NULL) {
+    if (out_schedule == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
-    world = query->world;
-
-    status = lt_query_refresh(query);
-    if (status != LT_STATUS_OK) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_QUERY_ITER_BEGIN,
-            status,
-            LT_ENTITY_NULL,
-            LT_COMPONENT_INVALID,
-            query->match_count);
-        return status;
-    }
+    *out_schedule = NULL;
 
-    status = lt_query_ensure_scratch_capacity(query, query->with_count);
+    status = lt_schedule_make_items(entries, decls, entry_count, &items);
     if (status != LT_STATUS_OK) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_QUERY_ITER_BEGIN,
-            status,
-            LT_ENTITY_NULL,
-            LT_COMPONENT_INVALID,
-            query->match_count);
         return status;
     }
-
-    memset(out_iter, 0, sizeof(*out_iter));
-    out_iter->query = query;
-    out_iter->archetype_index = 0u;
-    out_iter->chunk_cursor = NULL;
-    out_iter->columns = query->scratch_columns;
-    out_iter->column_capacity = query->scratch_capacity;
-    out_iter->finished = 0u;
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_QUERY_ITER_BEGIN,
-        LT_STATUS_OK,
-        LT_ENTITY_NULL,
-        LT_COMPONENT_INVALID,
-        query->match_count);
-    return LT_STATUS_OK;
+    status = lt_schedule_create_items(items, entry_count, out_schedule);
+    free(items);
+    return status;
 }
 
-lt_status_t lt_query_iter_next(
-    lt_query_iter_t* iter,
-    lt_chunk_view_t* out_view,
-    uint8_t* out_has_value)
+lt_status_t lt_schedule_insert_entry(
+    lt_schedule_t* schedule,
+    uint32_t position,
+    const lt_query_schedule_entry_t* entry,
+    const lt_schedule_entry_decl_t* decl)
 {
-    lt_query_t* query;
+    lt_schedule_item_t copy;
     lt_world_t* world;
+    uint32_t tail_count;
     lt_status_t status;
 
-    if (iter == NULL || out_view == NULL || out_has_value == NULL) {
+    if (schedule == NULL || entry == NULL || position > schedule->entry_count) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
-
-    query = iter->query;
-    if (query == NULL || query->world == NULL) {
+    if (decl != NULL && decl->version != LT_SCHEDULE_ENTRY_DECL_VERSION) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
-    world = query->world;
 
-    out_view->count = 0u;
-    out_view->entities = NULL;
-    out_view->columns = NULL;
-    out_view->column_count = 0u;
-    *out_has_value = 0u;
+    memset(&copy, 0, sizeof(copy));
+    copy.query = entry->query;
+    copy.callback = entry->callback;
+    copy.user_data = entry->user_data;
+    if (decl != NULL) {
+        copy.name = decl->name;
+        copy.events = decl->events;
+        copy.event_count = decl->event_count;
+        copy.random_access = decl->random_access;
+        copy.random_access_count = decl->random_access_count;
+    }
 
-    status = lt_query_ensure_scratch_capacity(query, query->with_count);
+    status = lt_query_schedule_validate_entries(&copy, 1u, &world);
     if (status != LT_STATUS_OK) {
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_QUERY_ITER_END,
-            status,
-            LT_ENTITY_NULL,
-            LT_COMPONENT_INVALID,
-            query->match_count);
         return status;
     }
-
-    if (iter->finished != 0u) {
-        return LT_STATUS_OK;
+    if (world != schedule->world) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    while (iter->archetype_index < query->match_count) {
-        lt_archetype_t* archetype;
-        lt_chunk_t* chunk;
-        uint32_t i;
-
-        archetype = query->matches[iter->archetype_index];
-        chunk = (lt_chunk_t*)iter->chunk_cursor;
-        if (chunk == NULL) {
-            chunk = archetype->chunks;
-        }
-
-        while (chunk != NULL && chunk->count == 0u) {
-            chunk = chunk->next;
-        }
-
-        if (chunk == NULL) {
-            iter->archetype_index += 1u;
-            iter->chunk_cursor = NULL;
-            continue;
-        }
-
-        for (i = 0u; i < query->with_count; ++i) {
-            uint32_t component_index;
-            int found;
-
-            found = lt_archetype_find_component_index(
-                archetype,
-                query->with_terms[i].component_id,
-                &component_index);
-            if (!found) {
-                iter->finished = 1u;
-                lt_trace_emit(
-                    world,
-                    LT_TRACE_EVENT_QUERY_ITER_END,
-                    LT_STATUS_CONFLICT,
-                    LT_ENTITY_NULL,
-                    LT_COMPONENT_INVALID,
-                    query->match_count);
-                return LT_STATUS_CONFLICT;
-            }
-
-            query->scratch_columns[i] = lt_chunk_component_ptr(
-                world,
-                archetype,
-                chunk,
-                0u,
-                component_index);
-        }
+    if (schedule->entry_count >= UINT32_MAX / 2u) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+    status = lt_schedule_reserve_entries(schedule, schedule->entry_count + 1u);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
 
-        out_view->count = chunk->count;
-        out_view->entities = chunk->entities;
-        out_view->columns = query->scratch_columns;
-        out_view->column_count = query->with_count;
-        *out_has_value = 1u;
+    status = lt_schedule_copy_declarations(&copy);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
 
-        iter->columns = query->scratch_columns;
-        iter->column_capacity = query->scratch_capacity;
-        iter->finished = 0u;
-        iter->chunk_cursor = chunk->next;
-        if (iter->chunk_cursor == NULL) {
-            iter->archetype_index += 1u;
-        }
-        lt_trace_emit(
-            world,
-            LT_TRACE_EVENT_QUERY_ITER_CHUNK,
-            LT_STATUS_OK,
-            LT_ENTITY_NULL,
-            LT_COMPONENT_INVALID,
-            out_view->count);
-        return LT_STATUS_OK;
+    tail_count = schedule->entry_count - position;
+    memmove(
+        &schedule->entries[position + 1u],
+        &schedule->entries[position],
+        sizeof(*schedule->entries) * (size_t)tail_count);
+    memmove(
+        &schedule->enabled[position + 1u],
+        &schedule->enabled[position],
+        sizeof(*schedule->enabled) * (size_t)tail_count);
+    memmove(
+        &schedule->levels[position + 1u],
+        &schedule->levels[position],
+        sizeof(*schedule->levels) * (size_t)tail_count);
+    memmove(
+        &schedule->pred_counts[position + 1u],
+        &schedule->pred_counts[position],
+        sizeof(*schedule->pred_counts) * (size_t)tail_count);
+    memmove(
+        &schedule->timings[position + 1u],
+        &schedule->timings[position],
+        sizeof(*schedule->timings) * (size_t)tail_count);
+    lt_schedule_shift_lists(schedule->component_lists, schedule->component_list_count, position, 1);
+    lt_schedule_shift_lists(schedule->channel_lists, schedule->channel_list_count, position, 1);
+
+    schedule->entries[position] = copy;
+    schedule->enabled[position] = 0u;
+    schedule->levels[position] = 0u;
+    schedule->pred_counts[position] = 0u;
+    memset(&schedule->timings[position], 0, sizeof(schedule->timings[position]));
+    schedule->entry_count += 1u;
+
+    status = lt_schedule_index_entry(schedule, position);
+    if (status == LT_STATUS_OK) {
+        status = lt_schedule_apply_enabled(schedule, position, 1u);
+    }
+    if (status != LT_STATUS_OK) {
+        lt_schedule_erase_entry(schedule, position);
+        return status;
     }
 
-    iter->finished = 1u;
-    lt_trace_emit(
-        world,
-        LT_TRACE_EVENT_QUERY_ITER_END,
-        LT_STATUS_OK,
-        LT_ENTITY_NULL,
-        LT_COMPONENT_INVALID,
-        query->match_count);
     return LT_STATUS_OK;
 }
 
-static lt_status_t lt_query_collect_parallel_work_items(
-    lt_query_t* query,
-    lt_parallel_work_item_t** out_items,
-    uint32_t* out_count)
+lt_status_t lt_schedule_remove_entry(lt_schedule_t* schedule, uint32_t position)
 {
-    lt_parallel_work_item_t* items;
-    uint32_t item_count;
-    uint32_t match_index;
-    uint32_t write_index;
     lt_status_t status;
 
-    if (query == NULL || query->world == NULL || out_items == NULL || out_count == NULL) {
+    if (schedule == NULL || position >= schedule->entry_count) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    *out_items = NULL;
-    *out_count = 0u;
-
-    status = lt_query_refresh(query);
+    status = lt_schedule_apply_enabled(schedule, position, 0u);
     if (status != LT_STATUS_OK) {
         return status;
     }
 
-    item_count = 0u;
-    for (match_index = 0u; match_index < query->match_count; ++match_index) {
-        lt_chunk_t* chunk;
+    lt_schedule_erase_entry(schedule, position);
+    return LT_STATUS_OK;
+}
 
-        chunk = query->matches[match_index]->chunks;
-        while (chunk != NULL) {
-            if (chunk->count > 0u) {
-                if (item_count == UINT32_MAX) {
-                    return LT_STATUS_CAPACITY_REACHED;
-                }
-                item_count += 1u;
-            }
-            chunk = chunk->next;
-        }
+lt_status_t lt_schedule_set_entry_enabled(lt_schedule_t* schedule, uint32_t position, uint8_t enabled)
+{
+    if (schedule == NULL || position >= schedule->entry_count) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (item_count == 0u) {
-        return LT_STATUS_OK;
-    }
+    return lt_schedule_apply_enabled(schedule, position, (uint8_t)(enabled != 0u ? 1u : 0u));
+}
 
-    if (sizeof(*items) > SIZE_MAX / (size_t)item_count) {
-        return LT_STATUS_CAPACITY_REACHED;
+lt_status_t lt_schedule_get_stats(const lt_schedule_t* schedule, lt_query_schedule_stats_t* out_stats)
+{
+    if (schedule == NULL || out_stats == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    items = (lt_parallel_work_item_t*)malloc(sizeof(*items) * (size_t)item_count);
-    if (items == NULL) {
-        return LT_STATUS_ALLOCATION_FAILED;
+    memset(out_stats, 0, sizeof(*out_stats));
+    out_stats->batch_count = schedule->batch_count;
+    out_stats->edge_count = schedule->edge_count;
+    out_stats->max_batch_size = schedule->max_batch_size;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_schedule_set_profiling(lt_schedule_t* schedule, uint8_t enabled)
+{
+    if (schedule == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    write_index = 0u;
-    for (match_index = 0u; match_index < query->match_count; ++match_index) {
-        lt_archetype_t* archetype;
-        lt_chunk_t* chunk;
+    schedule->profiling = (uint8_t)(enabled != 0u);
+    return LT_STATUS_OK;
+}
 
-        archetype = query->matches[match_index];
-        chunk = archetype->chunks;
-        while (chunk != NULL) {
-            if (chunk->count > 0u) {
-                items[write_index].archetype = archetype;
-                items[write_index].chunk = chunk;
-                write_index += 1u;
-            }
-            chunk = chunk->next;
-        }
+lt_status_t lt_schedule_get_entry_timing(
+    const lt_schedule_t* schedule,
+    uint32_t position,
+    lt_schedule_entry_timing_t* out_timing)
+{
+    if (schedule == NULL || out_timing == NULL || position >= schedule->entry_count) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    *out_timing = schedule->timings[position];
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_schedule_get_entry_name(const lt_schedule_t* schedule, uint32_t position, const char** out_name)
+{
+    if (schedule == NULL || out_name == NULL || position >= schedule->entry_count) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    *out_items = items;
-    *out_count = item_count;
+    *out_name = schedule->entries[position].name;
     return LT_STATUS_OK;
 }
 
-static lt_status_t lt_query_execute_parallel_range(lt_parallel_worker_ctx_t* ctx)
+lt_status_t lt_schedule_get_entry_count(const lt_schedule_t* schedule, uint32_t* out_count)
 {
-    uint32_t item_index;
-
-    if (ctx == NULL || ctx->world == NULL || ctx->query == NULL || ctx->callback == NULL) {
+    if (schedule == NULL || out_count == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (ctx->query->with_count > 0u && ctx->columns == NULL) {
+    *out_count = schedule->entry_count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_schedule_execute(
+    lt_schedule_t* schedule,
+    uint32_t worker_count,
+    lt_query_schedule_stats_t* out_stats)
+{
+    uint32_t batch_index;
+
+    if (out_stats != NULL) {
+        memset(out_stats, 0, sizeof(*out_stats));
+    }
+
+    if (schedule == NULL || worker_count == 0u || schedule->world == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    for (item_index = ctx->begin_index; item_index < ctx->end_index; ++item_index) {
-        const lt_parallel_work_item_t* item;
-        lt_chunk_view_t view;
-        uint32_t i;
+    if (worker_count > 1u && schedule->world->defer_depth > 0u) {
+        return LT_STATUS_CONFLICT;
+    }
 
-        item = &ctx->work_items[item_index];
-        for (i = 0u; i < ctx->query->with_count; ++i) {
-            uint32_t component_index;
-            int found;
+    if (out_stats != NULL) {
+        out_stats->batch_count = schedule->batch_count;
+        out_stats->edge_count = schedule->edge_count;
+        out_stats->max_batch_size = schedule->max_batch_size;
+    }
 
-            found = lt_archetype_find_component_index(
-                item->archetype,
-                ctx->query->with_terms[i].component_id,
-                &component_index);
-            if (!found) {
-                return LT_STATUS_CONFLICT;
-            }
+    for (batch_index = 0u; batch_index < schedule->batch_count; ++batch_index) {
+        uint32_t offset;
+        uint32_t count;
+        lt_status_t status;
 
-            ctx->columns[i] = lt_chunk_component_ptr(
-                ctx->world,
-                item->archetype,
-                item->chunk,
-                0u,
-                component_index);
+        offset = schedule->batch_offsets[batch_index];
+        count = schedule->batch_offsets[batch_index + 1u] - offset;
+        status = lt_query_schedule_execute_stage(
+            schedule->entries,
+            schedule->profiling != 0u ? schedule->timings : NULL,
+            &schedule->batch_nodes[offset],
+            count,
+            worker_count);
+        if (status != LT_STATUS_OK) {
+            return status;
         }
-
-        view.count = item->chunk->count;
-        view.entities = item->chunk->entities;
-        view.columns = ctx->columns;
-        view.column_count = ctx->query->with_count;
-        ctx->callback(&view, ctx->worker_index, ctx->user_data);
     }
 
     return LT_STATUS_OK;
 }
 
-#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-static void* lt_query_parallel_worker_entry(void* user_data)
+lt_status_t lt_query_schedule_execute(
+    const lt_query_schedule_entry_t* entries,
+    uint32_t entry_count,
+    uint32_t worker_count,
+    lt_query_schedule_stats_t* out_stats)
 {
-    lt_parallel_worker_ctx_t* ctx;
-
-    ctx = (lt_parallel_worker_ctx_t*)user_data;
-    if (ctx == NULL) {
-        return NULL;
-    }
-
-    ctx->status = lt_query_execute_parallel_range(ctx);
-    return NULL;
+    return lt_query_schedule_execute_with_decls(entries, NULL, entry_count, worker_count, out_stats);
 }
-#endif
 
-lt_status_t lt_query_for_each_chunk_parallel(
-    lt_query_t* query,
+lt_status_t lt_query_schedule_execute_with_decls(
+    const lt_query_schedule_entry_t* entries,
+    const lt_schedule_entry_decl_t* decls,
+    uint32_t entry_count,
     uint32_t worker_count,
-    lt_query_parallel_chunk_fn callback,
-    void* user_data)
+    lt_query_schedule_stats_t* out_stats)
 {
     lt_world_t* world;
-    lt_parallel_work_item_t* work_items;
-    uint32_t work_count;
-    lt_parallel_worker_ctx_t* contexts;
+    lt_schedule_item_t* items;
+    lt_schedule_t* schedule;
     lt_status_t status;
-    uint32_t effective_workers;
-    uint32_t base_items;
-    uint32_t extra_items;
-    uint32_t begin_index;
-    uint32_t worker_index;
-#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-    uint32_t started_threads;
-    pthread_t* threads;
-#endif
 
-    if (query == NULL || query->world == NULL || callback == NULL || worker_count == 0u) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    if (out_stats != NULL) {
+        memset(out_stats, 0, sizeof(*out_stats));
     }
 
-    world = query->world;
-    if (worker_count > 1u && world->defer_depth > 0u) {
-        return LT_STATUS_CONFLICT;
+    if (entry_count == 0u) {
+        return LT_STATUS_OK;
     }
 
-    status = lt_query_collect_parallel_work_items(query, &work_items, &work_count);
+    if (entries == NULL || worker_count == 0u) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    status = lt_schedule_make_items(entries, decls, entry_count, &items);
     if (status != LT_STATUS_OK) {
         return status;
     }
-
-    if (work_count == 0u) {
-        free(work_items);
-        return LT_STATUS_OK;
+    status = lt_query_schedule_validate_entries(items, entry_count, &world);
+    if (status == LT_STATUS_OK && worker_count > 1u && world->defer_depth > 0u) {
+        status = LT_STATUS_CONFLICT;
     }
-
-    effective_workers = worker_count;
-    if (effective_workers > work_count) {
-        effective_workers = work_count;
+    if (status == LT_STATUS_OK) {
+        status = lt_schedule_create_items(items, entry_count, &schedule);
+    }
+    free(items);
+    if (status != LT_STATUS_OK) {
+        return status;
     }
 
-#if !(defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS)
-    effective_workers = 1u;
-#endif
+    status = lt_schedule_execute(schedule, worker_count, out_stats);
+    lt_schedule_destroy(schedule);
+    return status;
+}
 
-    if (sizeof(*contexts) > SIZE_MAX / (size_t)effective_workers) {
-        free(work_items);
-        return LT_STATUS_CAPACITY_REACHED;
+lt_status_t lt_task_graph_create(lt_task_graph_t** out_graph)
+{
+    lt_task_graph_t* graph;
+
+    if (out_graph == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
+    *out_graph = NULL;
 
-    contexts = (lt_parallel_worker_ctx_t*)malloc(sizeof(*contexts) * (size_t)effective_workers);
-    if (contexts == NULL) {
-        free(work_items);
+    graph = (lt_task_graph_t*)malloc(sizeof(*graph));
+    if (graph == NULL) {
         return LT_STATUS_ALLOCATION_FAILED;
     }
-    memset(contexts, 0, sizeof(*contexts) * (size_t)effective_workers);
+    memset(graph, 0, sizeof(*graph));
 
-    status = LT_STATUS_OK;
-    base_items = work_count / effective_workers;
-    extra_items = work_count % effective_workers;
-    begin_index = 0u;
-    for (worker_index = 0u; worker_index < effective_workers; ++worker_index) {
-        uint32_t item_count;
+    *out_graph = graph;
+    return LT_STATUS_OK;
+}
 
-        item_count = base_items + (worker_index < extra_items ? 1u : 0u);
-        contexts[worker_index].world = world;
-        contexts[worker_index].query = query;
-        contexts[worker_index].work_items = work_items;
-        contexts[worker_index].begin_index = begin_index;
-        contexts[worker_index].end_index = begin_index + item_count;
-        contexts[worker_index].callback = callback;
-        contexts[worker_index].user_data = user_data;
-        contexts[worker_index].worker_index = worker_index;
-        contexts[worker_index].status = LT_STATUS_OK;
-        begin_index += item_count;
+void lt_task_graph_destroy(lt_task_graph_t* graph)
+{
+    if (graph == NULL) {
+        return;
+    }
 
-        if (query->with_count > 0u) {
-            if (sizeof(*contexts[worker_index].columns) > SIZE_MAX / (size_t)query->with_count) {
-                status = LT_STATUS_CAPACITY_REACHED;
-                break;
-            }
+    free(graph->terms);
+    free(graph->deps);
+    free(graph->nodes);
+    free(graph);
+}
 
-            contexts[worker_index].columns =
-                (void**)malloc(sizeof(*contexts[worker_index].columns) * (size_t)query->with_count);
-            if (contexts[worker_index].columns == NULL) {
-                status = LT_STATUS_ALLOCATION_FAILED;
-                break;
-            }
+static lt_status_t lt_task_graph_reserve(lt_task_graph_t* graph, uint32_t dep_count, uint32_t term_count)
+{
+    if (graph->node_count == graph->node_capacity) {
+        lt_task_node_t* nodes;
+        uint32_t capacity;
+
+        capacity = graph->node_capacity == 0u ? 8u : graph->node_capacity * 2u;
+        if (capacity <= graph->node_capacity || sizeof(*nodes) > SIZE_MAX / (size_t)capacity) {
+            return LT_STATUS_CAPACITY_REACHED;
+        }
+
+        nodes = (lt_task_node_t*)realloc(graph->nodes, sizeof(*nodes) * (size_t)capacity);
+        if (nodes == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
         }
+        graph->nodes = nodes;
+        graph->node_capacity = capacity;
     }
 
-#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-    threads = NULL;
-    started_threads = 0u;
-#endif
-    if (status == LT_STATUS_OK && effective_workers > 1u) {
-#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-        if (sizeof(*threads) > SIZE_MAX / (size_t)(effective_workers - 1u)) {
-            status = LT_STATUS_CAPACITY_REACHED;
-        } else {
-            threads = (pthread_t*)malloc(sizeof(*threads) * (size_t)(effective_workers - 1u));
-            if (threads == NULL) {
-                status = LT_STATUS_ALLOCATION_FAILED;
+    if (dep_count > UINT32_MAX - graph->dep_total) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    if (graph->dep_total + dep_count > graph->dep_capacity) {
+        lt_task_id_t* deps;
+        uint32_t capacity;
+
+        capacity = graph->dep_capacity == 0u ? 16u : graph->dep_capacity;
+        while (capacity < graph->dep_total + dep_count) {
+            if (capacity > UINT32_MAX / 2u) {
+                return LT_STATUS_CAPACITY_REACHED;
             }
+            capacity *= 2u;
+        }
+        if (sizeof(*deps) > SIZE_MAX / (size_t)capacity) {
+            return LT_STATUS_CAPACITY_REACHED;
         }
 
-        if (status == LT_STATUS_OK) {
-            for (worker_index = 1u; worker_index < effective_workers; ++worker_index) {
-                int rc;
+        deps = (lt_task_id_t*)realloc(graph->deps, sizeof(*deps) * (size_t)capacity);
+        if (deps == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
+        }
+        graph->deps = deps;
+        graph->dep_capacity = capacity;
+    }
 
-                rc = pthread_create(
-                    &threads[worker_index - 1u],
-                    NULL,
-                    lt_query_parallel_worker_entry,
-                    &contexts[worker_index]);
-                if (rc != 0) {
-                    status = LT_STATUS_ALLOCATION_FAILED;
-                    break;
-                }
-                started_threads += 1u;
+    if (term_count > UINT32_MAX - graph->term_total) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+
+    if (graph->term_total + term_count > graph->term_capacity) {
+        lt_query_term_t* terms;
+        uint32_t capacity;
+
+        capacity = graph->term_capacity == 0u ? 16u : graph->term_capacity;
+        while (capacity < graph->term_total + term_count) {
+            if (capacity > UINT32_MAX / 2u) {
+                return LT_STATUS_CAPACITY_REACHED;
             }
+            capacity *= 2u;
+        }
+        if (sizeof(*terms) > SIZE_MAX / (size_t)capacity) {
+            return LT_STATUS_CAPACITY_REACHED;
         }
 
-        if (status == LT_STATUS_OK) {
-            contexts[0].status = lt_query_execute_parallel_range(&contexts[0]);
+        terms = (lt_query_term_t*)realloc(graph->terms, sizeof(*terms) * (size_t)capacity);
+        if (terms == NULL) {
+            return LT_STATUS_ALLOCATION_FAILED;
         }
+        graph->terms = terms;
+        graph->term_capacity = capacity;
+    }
 
-        for (worker_index = 0u; worker_index < started_threads; ++worker_index) {
-            (void)pthread_join(threads[worker_index], NULL);
+    return LT_STATUS_OK;
+}
+
+static int lt_task_nodes_conflict(
+    const lt_task_graph_t* graph,
+    const lt_task_node_t* existing,
+    const lt_task_node_t* node,
+    const lt_query_term_t* terms,
+    uint32_t term_count)
+{
+    if (existing->kind != LT_TASK_KIND_QUERY) {
+        return 0;
+    }
+    return lt_query_entries_conflict(
+        existing->query,
+        existing->term_count > 0u ? &graph->terms[existing->term_offset] : NULL,
+        existing->term_count,
+        node->query,
+        terms,
+        term_count);
+}
+
+static lt_status_t lt_task_graph_push(
+    lt_task_graph_t* graph,
+    const lt_task_node_t* node,
+    const lt_query_term_t* terms,
+    uint32_t term_count,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id)
+{
+    lt_task_node_t* dst;
+    uint32_t auto_count;
+    uint32_t i;
+    lt_status_t status;
+
+    if (graph == NULL || (deps == NULL && dep_count > 0u)) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+
+    for (i = 0u; i < dep_count; ++i) {
+        if (deps[i] >= graph->node_count) {
+            return LT_STATUS_NOT_FOUND;
         }
-#endif
-    } else if (status == LT_STATUS_OK) {
-        contexts[0].status = lt_query_execute_parallel_range(&contexts[0]);
     }
 
-    if (status == LT_STATUS_OK) {
-        for (worker_index = 0u; worker_index < effective_workers; ++worker_index) {
-            if (contexts[worker_index].status != LT_STATUS_OK) {
-                status = contexts[worker_index].status;
-                break;
+    auto_count = 0u;
+    if (node->kind == LT_TASK_KIND_QUERY) {
+        for (i = 0u; i < graph->node_count; ++i) {
+            if (lt_task_nodes_conflict(graph, &graph->nodes[i], node, terms, term_count)) {
+                auto_count += 1u;
             }
         }
     }
 
-#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-    free(threads);
-#endif
-    for (worker_index = 0u; worker_index < effective_workers; ++worker_index) {
-        free(contexts[worker_index].columns);
+    if (auto_count > UINT32_MAX - dep_count) {
+        return LT_STATUS_CAPACITY_REACHED;
     }
-    free(contexts);
-    free(work_items);
-    return status;
-}
 
-static int lt_query_entries_conflict(const lt_query_t* a, const lt_query_t* b)
-{
-    uint32_t i;
-    uint32_t j;
+    status = lt_task_graph_reserve(graph, dep_count + auto_count, term_count);
+    if (status != LT_STATUS_OK) {
+        return status;
+    }
 
-    if (a == NULL || b == NULL) {
-        return 0;
+    dst = &graph->nodes[graph->node_count];
+    *dst = *node;
+    dst->dep_offset = graph->dep_total;
+    dst->dep_count = dep_count + auto_count;
+    dst->term_offset = graph->term_total;
+    dst->term_count = term_count;
+    if (term_count > 0u) {
+        memcpy(&graph->terms[graph->term_total], terms, sizeof(*terms) * (size_t)term_count);
+        graph->term_total += term_count;
     }
 
-    for (i = 0u; i < a->with_count; ++i) {
-        lt_component_id_t component_id;
-        lt_access_t access_a;
+    for (i = 0u; i < dep_count; ++i) {
+        graph->deps[graph->dep_total] = deps[i];
+        graph->dep_total += 1u;
+    }
+    if (auto_count > 0u) {
+        for (i = 0u; i < graph->node_count; ++i) {
+            if (lt_task_nodes_conflict(graph, &graph->nodes[i], node, terms, term_count)) {
+                graph->deps[graph->dep_total] = i;
+                graph->dep_total += 1u;
+            }
+        }
+    }
+
+    if (out_id != NULL) {
+        *out_id = graph->node_count;
+    }
+    graph->node_count += 1u;
+    return LT_STATUS_OK;
+}
 
-        component_id = a->with_terms[i].component_id;
-        access_a = a->with_terms[i].access;
-        for (j = 0u; j < b->with_count; ++j) {
-            lt_access_t access_b;
+lt_status_t lt_task_graph_add_task(
+    lt_task_graph_t* graph,
+    lt_task_fn fn,
+    void* user_data,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id)
+{
+    return lt_task_graph_add_parallel_for(graph, fn, user_data, 1u, 1u, deps, dep_count, out_id);
+}
 
-            if (component_id != b->with_terms[j].component_id) {
-                continue;
-            }
+lt_status_t lt_task_graph_add_parallel_for(
+    lt_task_graph_t* graph,
+    lt_task_fn fn,
+    void* user_data,
+    uint32_t count,
+    uint32_t grain,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id)
+{
+    lt_task_node_t node;
 
-            access_b = b->with_terms[j].access;
-            if (access_a == LT_ACCESS_WRITE || access_b == LT_ACCESS_WRITE) {
-                return 1;
-            }
-        }
+    if (graph == NULL || fn == NULL || grain == 0u) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    return 0;
+    memset(&node, 0, sizeof(node));
+    node.kind = LT_TASK_KIND_RANGE;
+    node.fn = fn;
+    node.user_data = user_data;
+    node.count = count;
+    node.grain = grain;
+    return lt_task_graph_push(graph, &node, NULL, 0u, deps, dep_count, out_id);
 }
 
-#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-static void* lt_query_schedule_stage_worker_entry(void* user_data)
+lt_status_t lt_task_graph_add_query(
+    lt_task_graph_t* graph,
+    lt_query_t* query,
+    lt_query_parallel_chunk_fn callback,
+    void* user_data,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id)
 {
-    lt_schedule_stage_worker_ctx_t* ctx;
+    lt_task_node_t node;
 
-    ctx = (lt_schedule_stage_worker_ctx_t*)user_data;
-    if (ctx == NULL || ctx->entry == NULL || ctx->entry->query == NULL || ctx->entry->callback == NULL) {
-        return NULL;
+    if (graph == NULL || query == NULL || query->world == NULL || callback == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    ctx->status = lt_query_for_each_chunk_parallel(
-        ctx->entry->query,
-        1u,
-        ctx->entry->callback,
-        ctx->entry->user_data);
-    return NULL;
+    memset(&node, 0, sizeof(node));
+    node.kind = LT_TASK_KIND_QUERY;
+    node.query = query;
+    node.chunk_fn = callback;
+    node.user_data = user_data;
+    return lt_task_graph_push(graph, &node, NULL, 0u, deps, dep_count, out_id);
 }
-#endif
 
-static lt_status_t lt_query_schedule_execute_stage(
-    const lt_query_schedule_entry_t* entries,
-    const uint32_t* stage_nodes,
-    uint32_t stage_count,
-    uint32_t worker_count)
+lt_status_t lt_task_graph_add_schedule(
+    lt_task_graph_t* graph,
+    lt_schedule_t* schedule,
+    const lt_task_id_t* deps,
+    uint32_t dep_count,
+    lt_task_id_t* out_id)
 {
-    lt_status_t status;
+    lt_task_id_t* entry_ids;
+    lt_task_node_t node;
+    uint32_t entry_count;
+    uint32_t first_id;
+    uint32_t first_dep;
+    uint32_t first_term;
+    uint32_t b;
     uint32_t i;
+    lt_status_t status;
 
-    if (entries == NULL || stage_nodes == NULL || worker_count == 0u) {
+    if (graph == NULL || schedule == NULL || (deps == NULL && dep_count > 0u)) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (stage_count == 0u) {
-        return LT_STATUS_OK;
+    for (i = 0u; i < dep_count; ++i) {
+        if (deps[i] >= graph->node_count) {
+            return LT_STATUS_NOT_FOUND;
+        }
     }
 
-    if (stage_count == 1u || worker_count == 1u) {
-        for (i = 0u; i < stage_count; ++i) {
-            const lt_query_schedule_entry_t* entry;
+    entry_count = schedule->batch_offsets[schedule->batch_count];
+    entry_ids = (lt_task_id_t*)malloc(sizeof(*entry_ids) * ((size_t)entry_count + 1u));
+    if (entry_ids == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
 
-            entry = &entries[stage_nodes[i]];
-            status = lt_query_for_each_chunk_parallel(
-                entry->query,
-                worker_count,
-                entry->callback,
-                entry->user_data);
-            if (status != LT_STATUS_OK) {
-                return status;
-            }
+    first_id = graph->node_count;
+    first_dep = graph->dep_total;
+    first_term = graph->term_total;
+    status = LT_STATUS_OK;
+    for (b = 0u; b < schedule->batch_count && status == LT_STATUS_OK; ++b) {
+        const lt_task_id_t* batch_deps;
+        uint32_t batch_dep_count;
+
+        batch_deps = deps;
+        batch_dep_count = dep_count;
+        if (b > 0u) {
+            batch_deps = &entry_ids[schedule->batch_offsets[b - 1u]];
+            batch_dep_count = schedule->batch_offsets[b] - schedule->batch_offsets[b - 1u];
         }
-        return LT_STATUS_OK;
+
+        for (i = schedule->batch_offsets[b]; i < schedule->batch_offsets[b + 1u] && status == LT_STATUS_OK; ++i) {
+            const lt_schedule_item_t* entry;
+
+            entry = &schedule->entries[schedule->batch_nodes[i]];
+            memset(&node, 0, sizeof(node));
+            node.kind = LT_TASK_KIND_QUERY;
+            node.query = entry->query;
+            node.chunk_fn = entry->callback;
+            node.user_data = entry->user_data;
+            node.name = entry->name;
+            status = lt_task_graph_push(
+                graph,
+                &node,
+                entry->random_access,
+                entry->random_access_count,
+                batch_deps,
+                batch_dep_count,
+                &entry_ids[i]);
+        }
+    }
+
+    if (status == LT_STATUS_OK) {
+        memset(&node, 0, sizeof(node));
+        node.kind = LT_TASK_KIND_JOIN;
+        if (entry_count > 0u) {
+            status = lt_task_graph_push(graph, &node, NULL, 0u, entry_ids, entry_count, out_id);
+        } else {
+            status = lt_task_graph_push(graph, &node, NULL, 0u, deps, dep_count, out_id);
+        }
+    }
+
+    if (status != LT_STATUS_OK) {
+        graph->node_count = first_id;
+        graph->dep_total = first_dep;
+        graph->term_total = first_term;
     }
 
+    free(entry_ids);
+    return status;
+}
+
+static void lt_task_exec_lock(lt_task_exec_t* exec)
+{
 #if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
-    {
-        lt_schedule_stage_worker_ctx_t* contexts;
-        pthread_t* threads;
-        uint32_t parallel_queries;
-        uint32_t stage_offset;
+    (void)pthread_mutex_lock(&exec->mutex);
+#else
+    (void)exec;
+#endif
+}
 
-        parallel_queries = worker_count;
-        if (parallel_queries > stage_count) {
-            parallel_queries = stage_count;
-        }
+static void lt_task_exec_unlock(lt_task_exec_t* exec)
+{
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    (void)pthread_mutex_unlock(&exec->mutex);
+#else
+    (void)exec;
+#endif
+}
 
-        if (sizeof(*contexts) > SIZE_MAX / (size_t)parallel_queries) {
-            return LT_STATUS_CAPACITY_REACHED;
-        }
-        contexts = (lt_schedule_stage_worker_ctx_t*)malloc(
-            sizeof(*contexts) * (size_t)parallel_queries);
-        if (contexts == NULL) {
-            return LT_STATUS_ALLOCATION_FAILED;
-        }
-        memset(contexts, 0, sizeof(*contexts) * (size_t)parallel_queries);
+static lt_status_t lt_task_exec_reserve(lt_task_exec_t* exec, uint32_t unit_count)
+{
+    lt_task_unit_t* queue;
+    uint32_t capacity;
 
-        threads = NULL;
-        if (parallel_queries > 1u) {
-            if (sizeof(*threads) > SIZE_MAX / (size_t)(parallel_queries - 1u)) {
-                free(contexts);
-                return LT_STATUS_CAPACITY_REACHED;
-            }
-            threads = (pthread_t*)malloc(sizeof(*threads) * (size_t)(parallel_queries - 1u));
-            if (threads == NULL) {
-                free(contexts);
-                return LT_STATUS_ALLOCATION_FAILED;
-            }
+    if (exec->queue_head > 0u) {
+        memmove(
+            exec->queue,
+            exec->queue + exec->queue_head,
+            sizeof(*exec->queue) * (size_t)(exec->queue_tail - exec->queue_head));
+        exec->queue_tail -= exec->queue_head;
+        exec->queue_head = 0u;
+    }
+
+    if (unit_count > UINT32_MAX - exec->queue_tail) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
+    if (exec->queue_tail + unit_count <= exec->queue_capacity) {
+        return LT_STATUS_OK;
+    }
+
+    capacity = exec->queue_capacity == 0u ? 64u : exec->queue_capacity;
+    while (capacity < exec->queue_tail + unit_count) {
+        if (capacity > UINT32_MAX / 2u) {
+            capacity = exec->queue_tail + unit_count;
+            break;
         }
+        capacity *= 2u;
+    }
+    if (sizeof(*queue) > SIZE_MAX / (size_t)capacity) {
+        return LT_STATUS_CAPACITY_REACHED;
+    }
 
-        status = LT_STATUS_OK;
-        for (stage_offset = 0u; stage_offset < stage_count; stage_offset += parallel_queries) {
-            uint32_t wave_count;
-            uint32_t launched_threads;
+    queue = (lt_task_unit_t*)realloc(exec->queue, sizeof(*queue) * (size_t)capacity);
+    if (queue == NULL) {
+        return LT_STATUS_ALLOCATION_FAILED;
+    }
+    exec->queue = queue;
+    exec->queue_capacity = capacity;
+    return LT_STATUS_OK;
+}
 
-            wave_count = stage_count - stage_offset;
-            if (wave_count > parallel_queries) {
-                wave_count = parallel_queries;
-            }
+static int lt_task_exec_enqueue(lt_task_exec_t* exec, uint32_t node_index)
+{
+    lt_task_node_t* node;
+    lt_status_t status;
+    uint32_t unit;
 
-            for (i = 0u; i < wave_count; ++i) {
-                const lt_query_schedule_entry_t* entry;
+    node = &exec->graph->nodes[node_index];
+    if (node->kind == LT_TASK_KIND_QUERY) {
+        status = lt_query_collect_parallel_work_items(node->query, &node->items, &node->unit_count);
+        node->units_left = node->unit_count;
+    } else {
+        status = LT_STATUS_OK;
+    }
+    if (status == LT_STATUS_OK) {
+        status = lt_task_exec_reserve(exec, node->unit_count);
+    }
+    if (status != LT_STATUS_OK) {
+        if (exec->status == LT_STATUS_OK) {
+            exec->status = status;
+        }
+        free(node->items);
+        node->items = NULL;
+        node->unit_count = 0u;
+        node->units_left = 0u;
+        return 0;
+    }
 
-                entry = &entries[stage_nodes[stage_offset + i]];
-                contexts[i].entry = entry;
-                contexts[i].status = LT_STATUS_OK;
-            }
+    for (unit = 0u; unit < node->unit_count; ++unit) {
+        exec->queue[exec->queue_tail].node = node_index;
+        exec->queue[exec->queue_tail].unit = unit;
+        exec->queue_tail += 1u;
+    }
+    return node->unit_count != 0u;
+}
 
-            launched_threads = 0u;
-            for (i = 1u; i < wave_count; ++i) {
-                int rc;
+static void lt_task_exec_complete(lt_task_exec_t* exec, uint32_t node_index)
+{
+    uint32_t stack_count;
 
-                rc = pthread_create(
-                    &threads[i - 1u],
-                    NULL,
-                    lt_query_schedule_stage_worker_entry,
-                    &contexts[i]);
-                if (rc != 0) {
-                    status = LT_STATUS_ALLOCATION_FAILED;
-                    break;
-                }
-                launched_threads += 1u;
-            }
+    exec->complete_stack[0] = node_index;
+    stack_count = 1u;
+    while (stack_count > 0u) {
+        uint32_t current;
+        uint32_t i;
 
-            if (status == LT_STATUS_OK) {
-                contexts[0].status = lt_query_for_each_chunk_parallel(
-                    contexts[0].entry->query,
-                    1u,
-                    contexts[0].entry->callback,
-                    contexts[0].entry->user_data);
-            }
+        stack_count -= 1u;
+        current = exec->complete_stack[stack_count];
+        exec->nodes_left -= 1u;
 
-            for (i = 0u; i < launched_threads; ++i) {
-                (void)pthread_join(threads[i], NULL);
-            }
+        for (i = exec->succ_offsets[current]; i < exec->succ_offsets[current + 1u]; ++i) {
+            lt_task_node_t* succ;
+            uint32_t succ_index;
 
-            if (status == LT_STATUS_OK) {
-                for (i = 0u; i < wave_count; ++i) {
-                    if (contexts[i].status != LT_STATUS_OK) {
-                        status = contexts[i].status;
-                        break;
-                    }
-                }
+            succ_index = exec->succ_nodes[i];
+            succ = &exec->graph->nodes[succ_index];
+            succ->pending -= 1u;
+            if (succ->pending != 0u) {
+                continue;
             }
 
-            if (status != LT_STATUS_OK) {
-                break;
+            if (!lt_task_exec_enqueue(exec, succ_index)) {
+                exec->complete_stack[stack_count] = succ_index;
+                stack_count += 1u;
             }
         }
+    }
+}
 
-        free(threads);
-        free(contexts);
-        return status;
+static lt_status_t lt_task_run_unit(lt_task_worker_t* worker, const lt_task_unit_t* unit)
+{
+    lt_task_node_t* node;
+
+    node = &worker->exec->graph->nodes[unit->node];
+    if (node->kind == LT_TASK_KIND_RANGE) {
+        uint32_t begin;
+        uint32_t end;
+
+        begin = unit->unit * node->grain;
+        end = node->count - begin < node->grain ? node->count : begin + node->grain;
+        node->fn(begin, end, worker->worker_index, node->user_data);
+        return LT_STATUS_OK;
     }
-#else
-    for (i = 0u; i < stage_count; ++i) {
-        const lt_query_schedule_entry_t* entry;
 
-        entry = &entries[stage_nodes[i]];
-        status = lt_query_for_each_chunk_parallel(
-            entry->query,
-            worker_count,
-            entry->callback,
-            entry->user_data);
-        if (status != LT_STATUS_OK) {
-            return status;
+    if (node->kind == LT_TASK_KIND_QUERY) {
+        lt_parallel_worker_ctx_t ctx;
+        lt_schedule_item_t entry;
+
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.world = node->query->world;
+        ctx.query = node->query;
+        ctx.work_items = node->items;
+        ctx.begin_index = unit->unit;
+        ctx.end_index = unit->unit + 1u;
+        ctx.callback = node->chunk_fn;
+        ctx.user_data = node->user_data;
+        ctx.worker_index = worker->worker_index;
+        ctx.columns = worker->columns;
+        if (LT_CHECK(node->query->world->access_checks != 0u)) {
+            memset(&entry, 0, sizeof(entry));
+            entry.query = node->query;
+            entry.callback = node->chunk_fn;
+            entry.user_data = node->user_data;
+            entry.name = node->name;
+            entry.random_access = node->term_count > 0u ? &worker->exec->graph->terms[node->term_offset] : NULL;
+            entry.random_access_count = node->term_count;
+            ctx.callback = lt_schedule_scoped_chunk;
+            ctx.user_data = &entry;
         }
+        return lt_query_execute_parallel_range(&ctx);
     }
+
     return LT_STATUS_OK;
-#endif
 }
 
-static lt_status_t lt_query_schedule_validate_entries(
-    const lt_query_schedule_entry_t* entries,
-    uint32_t entry_count,
-    lt_world_t** out_world)
+static void lt_task_worker_loop(lt_task_worker_t* worker)
 {
-    lt_world_t* world;
-    uint32_t i;
+    lt_task_exec_t* exec;
 
-    if (out_world != NULL) {
-        *out_world = NULL;
-    }
+    exec = worker->exec;
+    lt_task_exec_lock(exec);
+    for (;;) {
+        lt_task_unit_t unit;
+        lt_task_node_t* node;
+        lt_status_t status;
 
-    if (entry_count == 0u) {
-        return LT_STATUS_OK;
-    }
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+        while (exec->queue_head == exec->queue_tail && exec->nodes_left > 0u) {
+            (void)pthread_cond_wait(&exec->cond, &exec->mutex);
+        }
+#endif
+        if (exec->queue_head == exec->queue_tail) {
+            break;
+        }
 
-    if (entries == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
+        unit = exec->queue[exec->queue_head];
+        exec->queue_head += 1u;
+        lt_task_exec_unlock(exec);
 
-    if (entries[0].query == NULL || entries[0].query->world == NULL || entries[0].callback == NULL) {
-        return LT_STATUS_INVALID_ARGUMENT;
-    }
-    world = entries[0].query->world;
+        status = lt_task_run_unit(worker, &unit);
 
-    for (i = 0u; i < entry_count; ++i) {
-        if (entries[i].query == NULL || entries[i].query->world != world || entries[i].callback == NULL) {
-            return LT_STATUS_INVALID_ARGUMENT;
+        lt_task_exec_lock(exec);
+        if (status != LT_STATUS_OK && exec->status == LT_STATUS_OK) {
+            exec->status = status;
+        }
+        node = &exec->graph->nodes[unit.node];
+        node->units_left -= 1u;
+        if (node->units_left == 0u) {
+            lt_task_exec_complete(exec, unit.node);
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+            (void)pthread_cond_broadcast(&exec->cond);
+#endif
         }
     }
-
-    if (out_world != NULL) {
-        *out_world = world;
-    }
-    return LT_STATUS_OK;
+    lt_task_exec_unlock(exec);
 }
 
-lt_status_t lt_schedule_create(
-    const lt_query_schedule_entry_t* entries,
-    uint32_t entry_count,
-    lt_schedule_t** out_schedule)
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+static void* lt_task_worker_entry(void* user_data)
 {
-    lt_world_t* world;
-    uint8_t* active;
-    uint8_t* edges;
-    uint32_t* indegree;
-    uint32_t* stage_nodes;
-    uint32_t* batch_nodes;
-    uint32_t* batch_offsets;
-    lt_schedule_t* schedule;
+    lt_task_worker_t* worker;
+
+    worker = (lt_task_worker_t*)user_data;
+    lt_trace_queue = &worker->exec->trace_queue;
+    lt_task_worker_loop(worker);
+    return NULL;
+}
+#endif
+
+lt_status_t lt_task_graph_execute(lt_task_graph_t* graph, uint32_t worker_count)
+{
+    lt_task_exec_t exec;
+    lt_task_worker_t* workers;
+    uint32_t total_units;
+    uint32_t query_nodes;
+    uint32_t max_columns;
+    uint32_t effective_workers;
     uint32_t i;
-    uint32_t remaining_count;
-    uint32_t batch_count;
-    uint32_t edge_count;
-    uint32_t max_batch_size;
-    uint32_t batch_node_write;
-    size_t edge_matrix_count;
-    size_t entry_plus_one;
     lt_status_t status;
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+    pthread_t* threads;
+    lt_trace_queue_t* trace_previous;
+    uint32_t started_threads;
+#endif
 
-    if (out_schedule == NULL) {
+    if (graph == NULL || worker_count == 0u) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
-    *out_schedule = NULL;
 
-    if (entries == NULL || entry_count == 0u) {
-        return LT_STATUS_INVALID_ARGUMENT;
+    if (graph->node_count == 0u) {
+        return LT_STATUS_OK;
     }
 
-    status = lt_query_schedule_validate_entries(entries, entry_count, &world);
-    if (status != LT_STATUS_OK) {
-        return status;
-    }
+    memset(&exec, 0, sizeof(exec));
+    exec.graph = graph;
+    exec.status = LT_STATUS_OK;
+    workers = NULL;
+    effective_workers = 0u;
+    status = LT_STATUS_OK;
 
-    edge_matrix_count = (size_t)entry_count;
-    if (edge_matrix_count > SIZE_MAX / (size_t)entry_count) {
-        return LT_STATUS_CAPACITY_REACHED;
+    for (i = 0u; i < graph->node_count; ++i) {
+        graph->nodes[i].items = NULL;
     }
-    edge_matrix_count *= (size_t)entry_count;
 
-    entry_plus_one = (size_t)entry_count + 1u;
-    if (entry_plus_one <= (size_t)entry_count) {
-        return LT_STATUS_CAPACITY_REACHED;
-    }
+    total_units = 0u;
+    query_nodes = 0u;
+    max_columns = 0u;
+    for (i = 0u; i < graph->node_count; ++i) {
+        lt_task_node_t* node;
 
-    if (sizeof(*active) > SIZE_MAX / (size_t)entry_count
-        || sizeof(*indegree) > SIZE_MAX / (size_t)entry_count
-        || sizeof(*stage_nodes) > SIZE_MAX / (size_t)entry_count
-        || sizeof(*batch_nodes) > SIZE_MAX / (size_t)entry_count
-        || sizeof(*batch_offsets) > SIZE_MAX / entry_plus_one
-        || sizeof(*edges) > SIZE_MAX / edge_matrix_count
-        || sizeof(*schedule->entries) > SIZE_MAX / (size_t)entry_count) {
-        return LT_STATUS_CAPACITY_REACHED;
-    }
+        node = &graph->nodes[i];
+        node->unit_count = 0u;
+        if (node->kind == LT_TASK_KIND_RANGE) {
+            node->unit_count = node->count / node->grain + (node->count % node->grain != 0u ? 1u : 0u);
+        } else if (node->kind == LT_TASK_KIND_QUERY) {
+            if (worker_count > 1u && node->query->world->defer_depth > 0u) {
+                status = LT_STATUS_CONFLICT;
+                break;
+            }
+            query_nodes += 1u;
+            if (node->query->with_count > max_columns) {
+                max_columns = node->query->with_count;
+            }
+        }
 
-    active = (uint8_t*)malloc(sizeof(*active) * (size_t)entry_count);
-    indegree = (uint32_t*)malloc(sizeof(*indegree) * (size_t)entry_count);
-    stage_nodes = (uint32_t*)malloc(sizeof(*stage_nodes) * (size_t)entry_count);
-    batch_nodes = (uint32_t*)malloc(sizeof(*batch_nodes) * (size_t)entry_count);
-    batch_offsets = (uint32_t*)malloc(sizeof(*batch_offsets) * entry_plus_one);
-    edges = (uint8_t*)malloc(sizeof(*edges) * edge_matrix_count);
-    schedule = NULL;
-    if (active == NULL
-        || indegree == NULL
-        || stage_nodes == NULL
-        || batch_nodes == NULL
-        || batch_offsets == NULL
-        || edges == NULL) {
-        status = LT_STATUS_ALLOCATION_FAILED;
-        goto cleanup;
+        total_units = node->unit_count > UINT32_MAX - total_units ? UINT32_MAX : total_units + node->unit_count;
+        node->units_left = node->unit_count;
+        node->pending = node->dep_count;
     }
 
-    memset(active, 1, sizeof(*active) * (size_t)entry_count);
-    memset(indegree, 0, sizeof(*indegree) * (size_t)entry_count);
-    memset(edges, 0, sizeof(*edges) * edge_matrix_count);
-
-    edge_count = 0u;
-    for (i = 0u; i < entry_count; ++i) {
-        uint32_t j;
-
-        for (j = i + 1u; j < entry_count; ++j) {
-            if (lt_query_entries_conflict(entries[i].query, entries[j].query)) {
-                edges[(size_t)i * (size_t)entry_count + (size_t)j] = 1u;
-                indegree[j] += 1u;
-                edge_count += 1u;
-            }
+    if (status == LT_STATUS_OK) {
+        exec.succ_offsets = (uint32_t*)calloc((size_t)graph->node_count + 1u, sizeof(*exec.succ_offsets));
+        exec.succ_nodes = (uint32_t*)malloc(sizeof(*exec.succ_nodes) * ((size_t)graph->dep_total + 1u));
+        exec.complete_stack = (uint32_t*)malloc(sizeof(*exec.complete_stack) * (size_t)graph->node_count);
+        if (exec.succ_offsets == NULL || exec.succ_nodes == NULL || exec.complete_stack == NULL) {
+            status = LT_STATUS_ALLOCATION_FAILED;
         }
     }
 
-    remaining_count = entry_count;
-    batch_count = 0u;
-    max_batch_size = 0u;
-    batch_node_write = 0u;
-    batch_offsets[0] = 0u;
+    if (status == LT_STATUS_OK) {
+        for (i = 0u; i < graph->dep_total; ++i) {
+            exec.succ_offsets[graph->deps[i] + 1u] += 1u;
+        }
+        for (i = 0u; i < graph->node_count; ++i) {
+            exec.succ_offsets[i + 1u] += exec.succ_offsets[i];
+        }
+        memcpy(exec.complete_stack, exec.succ_offsets, sizeof(*exec.complete_stack) * (size_t)graph->node_count);
+        for (i = 0u; i < graph->node_count; ++i) {
+            uint32_t d;
 
-    while (remaining_count > 0u) {
-        uint32_t stage_count;
+            for (d = 0u; d < graph->nodes[i].dep_count; ++d) {
+                uint32_t dep;
 
-        stage_count = 0u;
-        for (i = 0u; i < entry_count; ++i) {
-            if (active[i] != 0u && indegree[i] == 0u) {
-                stage_nodes[stage_count] = i;
-                stage_count += 1u;
+                dep = graph->deps[graph->nodes[i].dep_offset + d];
+                exec.succ_nodes[exec.complete_stack[dep]] = i;
+                exec.complete_stack[dep] += 1u;
             }
         }
 
-        if (stage_count == 0u) {
-            status = LT_STATUS_CONFLICT;
-            goto cleanup;
+        exec.nodes_left = graph->node_count;
+        for (i = 0u; i < graph->node_count; ++i) {
+            if (graph->nodes[i].dep_count == 0u && !lt_task_exec_enqueue(&exec, i)) {
+                lt_task_exec_complete(&exec, i);
+            }
         }
 
-        if (stage_count > max_batch_size) {
-            max_batch_size = stage_count;
+        effective_workers = worker_count;
+        if (query_nodes == 0u && effective_workers > total_units) {
+            effective_workers = total_units == 0u ? 1u : total_units;
         }
+#if !(defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS)
+        effective_workers = 1u;
+#endif
 
-        for (i = 0u; i < stage_count; ++i) {
-            uint32_t node_index;
-            uint32_t j;
-
-            node_index = stage_nodes[i];
-            batch_nodes[batch_node_write] = node_index;
-            batch_node_write += 1u;
-
-            active[node_index] = 0u;
-            remaining_count -= 1u;
+        workers = (lt_task_worker_t*)calloc((size_t)effective_workers, sizeof(*workers));
+        if (workers == NULL) {
+            status = LT_STATUS_ALLOCATION_FAILED;
+        }
+        for (i = 0u; i < effective_workers && status == LT_STATUS_OK; ++i) {
+            workers[i].exec = &exec;
+            workers[i].worker_index = i;
+            if (max_columns > 0u) {
+                workers[i].columns = (void**)malloc(sizeof(*workers[i].columns) * (size_t)max_columns);
+                if (workers[i].columns == NULL) {
+                    status = LT_STATUS_ALLOCATION_FAILED;
+                }
+            }
+        }
+    }
 
-            for (j = 0u; j < entry_count; ++j) {
-                size_t edge_index;
+    if (status == LT_STATUS_OK) {
+#if defined(LT_HAS_PTHREADS) && LT_HAS_PTHREADS
+        threads = NULL;
+        trace_previous = NULL;
+        started_threads = 0u;
+        if (pthread_mutex_init(&exec.mutex, NULL) != 0) {
+            status = LT_STATUS_ALLOCATION_FAILED;
+        } else if (pthread_cond_init(&exec.cond, NULL) != 0) {
+            (void)pthread_mutex_destroy(&exec.mutex);
+            status = LT_STATUS_ALLOCATION_FAILED;
+        }
 
-                edge_index = (size_t)node_index * (size_t)entry_count + (size_t)j;
-                if (edges[edge_index] == 0u) {
-                    continue;
+        if (status == LT_STATUS_OK) {
+            if (effective_workers > 1u) {
+                threads = (pthread_t*)malloc(sizeof(*threads) * (size_t)(effective_workers - 1u));
+                if (threads != NULL && lt_trace_queue_open(&exec.trace_queue, &trace_previous) != LT_STATUS_OK) {
+                    free(threads);
+                    threads = NULL;
                 }
-                if (indegree[j] > 0u) {
-                    indegree[j] -= 1u;
+            }
+            for (i = 1u; threads != NULL && i < effective_workers; ++i) {
+                if (pthread_create(&threads[i - 1u], NULL, lt_task_worker_entry, &workers[i]) != 0) {
+                    break;
                 }
-                edges[edge_index] = 0u;
+                started_threads += 1u;
             }
-        }
 
-        batch_count += 1u;
-        batch_offsets[batch_count] = batch_node_write;
+            lt_task_worker_loop(&workers[0]);
+            for (i = 0u; i < started_threads; ++i) {
+                (void)pthread_join(threads[i], NULL);
+            }
+            if (threads != NULL) {
+                lt_trace_queue_close(&exec.trace_queue, trace_previous);
+            }
+            free(threads);
+            (void)pthread_cond_destroy(&exec.cond);
+            (void)pthread_mutex_destroy(&exec.mutex);
+        }
+#else
+        lt_task_worker_loop(&workers[0]);
+#endif
+        if (status == LT_STATUS_OK) {
+            status = exec.status;
+        }
     }
 
-    schedule = (lt_schedule_t*)malloc(sizeof(*schedule));
-    if (schedule == NULL) {
-        status = LT_STATUS_ALLOCATION_FAILED;
-        goto cleanup;
+    if (workers != NULL) {
+        for (i = 0u; i < effective_workers; ++i) {
+            free(workers[i].columns);
+        }
+        free(workers);
     }
-    memset(schedule, 0, sizeof(*schedule));
-
-    schedule->entries =
-        (lt_query_schedule_entry_t*)malloc(sizeof(*schedule->entries) * (size_t)entry_count);
-    if (schedule->entries == NULL) {
-        status = LT_STATUS_ALLOCATION_FAILED;
-        goto cleanup;
+    for (i = 0u; i < graph->node_count; ++i) {
+        free(graph->nodes[i].items);
+        graph->nodes[i].items = NULL;
     }
-    memcpy(schedule->entries, entries, sizeof(*schedule->entries) * (size_t)entry_count);
+    free(exec.queue);
+    free(exec.complete_stack);
+    free(exec.succ_nodes);
+    free(exec.succ_offsets);
+    return status;
+}
 
-    schedule->world = world;
-    schedule->entry_count = entry_count;
-    schedule->batch_nodes = batch_nodes;
-    schedule->batch_offsets = batch_offsets;
-    schedule->batch_count = batch_count;
-    schedule->edge_count = edge_count;
-    schedule->max_batch_size = max_batch_size;
+lt_status_t lt_world_get_stats(const lt_world_t* world, lt_world_stats_t* out_stats)
+{
+    if (world == NULL || out_stats == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
 
-    batch_nodes = NULL;
-    batch_offsets = NULL;
-    *out_schedule = schedule;
-    status = LT_STATUS_OK;
+    out_stats->live_entities = lt_stat_load_u32(&world->live_entity_count);
+    out_stats->entity_capacity = lt_stat_load_u32(&world->entity_capacity);
+    out_stats->allocated_entity_slots = lt_stat_load_u32(&world->entity_count);
+    out_stats->free_entity_slots = lt_stat_load_u32(&world->free_entity_count);
+    out_stats->registered_components = lt_stat_load_u32(&world->component_count);
+    out_stats->archetype_count = lt_stat_load_u32(&world->archetype_count);
+    out_stats->chunk_count = lt_stat_load_u32(&world->total_chunk_count);
+    out_stats->pending_commands =
+        lt_stat_load_u32(&world->deferred_count) + lt_stat_load_u32(&world->deferred_set_count);
+    out_stats->defer_depth = lt_stat_load_u32(&world->defer_depth);
+    out_stats->structural_moves = lt_stat_load_u64(&world->structural_move_count);
+    out_stats->chunk_bytes = lt_stat_load_u64(&world->total_chunk_bytes);
+    return LT_STATUS_OK;
+}
 
-cleanup:
-    free(edges);
-    free(stage_nodes);
-    free(indegree);
-    free(active);
-    free(batch_offsets);
-    free(batch_nodes);
-    if (status != LT_STATUS_OK) {
-        if (schedule != NULL) {
-            free(schedule->entries);
-            free(schedule);
-        }
+lt_status_t lt_world_set_transition_tracking(lt_world_t* world, uint8_t enabled)
+{
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
-    return status;
+
+    world->transition_tracking = (uint8_t)(enabled != 0u);
+    return LT_STATUS_OK;
 }
 
-void lt_schedule_destroy(lt_schedule_t* schedule)
+lt_status_t lt_world_reset_transition_stats(lt_world_t* world)
 {
-    if (schedule == NULL) {
-        return;
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    free(schedule->batch_offsets);
-    free(schedule->batch_nodes);
-    free(schedule->entries);
-    free(schedule);
+    lt_transition_stats_clear(world);
+    return LT_STATUS_OK;
 }
 
-lt_status_t lt_schedule_execute(
-    lt_schedule_t* schedule,
-    uint32_t worker_count,
-    lt_query_schedule_stats_t* out_stats)
+lt_status_t lt_world_get_transition_count(const lt_world_t* world, uint32_t* out_count)
 {
-    uint32_t batch_index;
-
-    if (out_stats != NULL) {
-        memset(out_stats, 0, sizeof(*out_stats));
+    if (world == NULL || out_count == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (schedule == NULL || worker_count == 0u || schedule->world == NULL) {
+    *out_count = world->transition_count;
+    return LT_STATUS_OK;
+}
+
+lt_status_t lt_world_copy_transitions(
+    const lt_world_t* world,
+    lt_transition_stats_t* out_transitions,
+    uint32_t max_transitions,
+    uint32_t* out_count)
+{
+    uint32_t copied;
+    uint32_t i;
+
+    if (world == NULL || out_count == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
-
-    if (worker_count > 1u && schedule->world->defer_depth > 0u) {
-        return LT_STATUS_CONFLICT;
+    if (max_transitions > 0u && out_transitions == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    if (out_stats != NULL) {
-        out_stats->batch_count = schedule->batch_count;
-        out_stats->edge_count = schedule->edge_count;
-        out_stats->max_batch_size = schedule->max_batch_size;
+    copied = world->transition_count < max_transitions ? world->transition_count : max_transitions;
+    for (i = 0u; i < copied; ++i) {
+        out_transitions[i] = world->transitions[i].stats;
     }
 
-    for (batch_index = 0u; batch_index < schedule->batch_count; ++batch_index) {
-        uint32_t offset;
-        uint32_t count;
-        lt_status_t status;
+    *out_count = copied;
+    return LT_STATUS_OK;
+}
 
-        offset = schedule->batch_offsets[batch_index];
-        count = schedule->batch_offsets[batch_index + 1u] - offset;
-        status = lt_query_schedule_execute_stage(
-            schedule->entries,
-            &schedule->batch_nodes[offset],
-            count,
-            worker_count);
-        if (status != LT_STATUS_OK) {
-            return status;
-        }
+lt_status_t lt_component_get_transition_stats(
+    const lt_world_t* world,
+    lt_component_id_t component_id,
+    lt_component_transition_stats_t* out_stats)
+{
+    if (world == NULL || out_stats == NULL || component_id == LT_COMPONENT_INVALID) {
+        return LT_STATUS_INVALID_ARGUMENT;
+    }
+    if (component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
     }
 
+    memset(out_stats, 0, sizeof(*out_stats));
+    if (component_id < world->component_transition_capacity) {
+        *out_stats = world->component_transitions[component_id];
+    }
     return LT_STATUS_OK;
 }
 
-lt_status_t lt_query_schedule_execute(
-    const lt_query_schedule_entry_t* entries,
-    uint32_t entry_count,
-    uint32_t worker_count,
-    lt_query_schedule_stats_t* out_stats)
+lt_status_t lt_world_set_access_counting(lt_world_t* world, uint8_t enabled)
 {
-    lt_world_t* world;
-    lt_schedule_t* schedule;
     lt_status_t status;
 
-    if (out_stats != NULL) {
-        memset(out_stats, 0, sizeof(*out_stats));
-    }
-
-    if (entry_count == 0u) {
-        return LT_STATUS_OK;
-    }
-
-    if (entries == NULL || worker_count == 0u) {
+    if (world == NULL) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    status = lt_query_schedule_validate_entries(entries, entry_count, &world);
-    if (status != LT_STATUS_OK) {
-        return status;
+    if (enabled != 0u && world->access_stats == NULL) {
+        status = lt_grow_access_stats(world);
+        if (status != LT_STATUS_OK) {
+            return status;
+        }
     }
+    world->access_counting = (uint8_t)(enabled != 0u);
+    return LT_STATUS_OK;
+}
 
-    if (worker_count > 1u && world->defer_depth > 0u) {
-        return LT_STATUS_CONFLICT;
-    }
+lt_status_t lt_world_reset_access_stats(lt_world_t* world)
+{
+    uint32_t i;
 
-    status = lt_schedule_create(entries, entry_count, &schedule);
-    if (status != LT_STATUS_OK) {
-        return status;
+    if (world == NULL) {
+        return LT_STATUS_INVALID_ARGUMENT;
     }
 
-    status = lt_schedule_execute(schedule, worker_count, out_stats);
-    lt_schedule_destroy(schedule);
-    return status;
+    for (i = 0u; i < world->access_stats_capacity; ++i) {
+        lt_stat_store_u64(&world->access_stats[i].read_rows, 0u);
+        lt_stat_store_u64(&world->access_stats[i].write_rows, 0u);
+        lt_stat_store_u64(&world->access_stats[i].random_lookups, 0u);
+        lt_stat_store_u64(&world->access_stats[i].moved_bytes, 0u);
+    }
+    return LT_STATUS_OK;
 }
 
-lt_status_t lt_world_get_stats(const lt_world_t* world, lt_world_stats_t* out_stats)
+lt_status_t lt_component_get_access_stats(
+    const lt_world_t* world,
+    lt_component_id_t component_id,
+    lt_component_access_stats_t* out_stats)
 {
-    if (world == NULL || out_stats == NULL) {
+    const lt_component_access_stats_t* stats;
+
+    if (world == NULL || out_stats == NULL || component_id == LT_COMPONENT_INVALID) {
         return LT_STATUS_INVALID_ARGUMENT;
     }
+    if (component_id > world->component_count) {
+        return LT_STATUS_NOT_FOUND;
+    }
 
-    out_stats->live_entities = world->live_entity_count;
-    out_stats->entity_capacity = world->entity_capacity;
-    out_stats->allocated_entity_slots = world->entity_count;
-    out_stats->free_entity_slots = world->free_entity_count;
-    out_stats->registered_components = world->component_count;
-    out_stats->archetype_count = world->archetype_count;
-    out_stats->chunk_count = world->total_chunk_count;
-    out_stats->pending_commands = world->deferred_count;
-    out_stats->defer_depth = world->defer_depth;
-    out_stats->structural_moves = world->structural_move_count;
+    memset(out_stats, 0, sizeof(*out_stats));
+    if (component_id < world->access_stats_capacity) {
+        stats = &world->access_stats[component_id];
+        out_stats->read_rows = lt_stat_load_u64(&stats->read_rows);
+        out_stats->write_rows = lt_stat_load_u64(&stats->write_rows);
+        out_stats->random_lookups = lt_stat_load_u64(&stats->random_lookups);
+        out_stats->moved_bytes = lt_stat_load_u64(&stats->moved_bytes);
+    }
     return LT_STATUS_OK;
 }
 
@@ -42,6 +42,14 @@ if(DEFINED WORKERS)
     list(APPEND bench_cmd "--workers" "${WORKERS}")
 endif()
 
+if(DEFINED SCHEDULE_COMPILE)
+    list(APPEND bench_cmd "--schedule-compile" "${SCHEDULE_COMPILE}")
+endif()
+
+if(DEFINED TRANSITIONS)
+    list(APPEND bench_cmd "--transitions" "${TRANSITIONS}")
+endif()
+
 execute_process(
     COMMAND ${bench_cmd}
     RESULT_VARIABLE bench_status
@@ -64,7 +72,16 @@ function(assert_output_contains needle)
     endif()
 endfunction()
 
-if(MODE STREQUAL "text")
+if(DEFINED SCHEDULE_COMPILE)
+    string(REPLACE "," ";" schedule_compile_list "${SCHEDULE_COMPILE}")
+    list(LENGTH schedule_compile_list schedule_compile_count)
+    assert_output_contains("schedule_compile_count=${schedule_compile_count}")
+    foreach(entry_count ${schedule_compile_list})
+        assert_output_contains("schedule_compile_entries=${entry_count} schedule_compile_ms=")
+    endforeach()
+    assert_output_contains("schedule_compile_batches=")
+    assert_output_contains("schedule_compile_edges=")
+elseif(MODE STREQUAL "text")
     assert_output_contains("entities=10000")
     assert_output_contains("scene=${SCENE}")
     assert_output_contains("churn_rate=${CHURN_RATE}")
@@ -76,6 +93,12 @@ if(MODE STREQUAL "text")
     assert_output_contains("scheduler_speedup_vs_serial=")
     assert_output_contains("scheduler_structural_ops=")
     assert_output_contains("scheduler_batches=")
+    assert_output_contains("random_access_unchecked_ms=")
+    if(DEFINED TRANSITIONS)
+        assert_output_contains("transition_count=")
+        assert_output_contains("transition_rank=1 transition_src=")
+        assert_output_contains("component_transition_name=Position")
+    endif()
 elseif(MODE STREQUAL "csv")
     assert_output_contains(
         "entities,frames,seed,defer,workers,spawn_ms,simulate_ms,speedup_vs_serial,")
@@ -84,7 +107,8 @@ elseif(MODE STREQUAL "csv")
     foreach(worker ${expected_worker_list})
         assert_output_contains(",7,1,${worker},")
     endforeach()
-    assert_output_contains(",${SCENE},${CHURN_RATE},${CHURN_INITIAL_RATIO}")
+    assert_output_contains(",${SCENE},${CHURN_RATE},${CHURN_INITIAL_RATIO},")
+    assert_output_contains("random_access_lookups,random_access_checked_ms,random_access_unchecked_ms")
 elseif(MODE STREQUAL "json")
     assert_output_contains("\"scene\": \"${SCENE}\"")
     assert_output_contains("\"churn_rate\": ${CHURN_RATE}")
@@ -96,6 +120,7 @@ elseif(MODE STREQUAL "json")
     assert_output_contains("\"speedup_vs_serial\":")
     assert_output_contains("\"structural_ops\":")
     assert_output_contains("\"schedule_batch_count\":")
+    assert_output_contains("\"random_access_unchecked_ms\":")
 else()
     message(FATAL_ERROR "Unsupported MODE=${MODE}; expected text/csv/json")
 endif()
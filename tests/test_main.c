@@ -1,8 +1,19 @@
 #include "lattice/lattice.h"
+#include "lattice/recorder.h"
+#include "lattice/shm_export.h"
+#include "lattice/unchecked.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #define ASSERT_TRUE(condition)                                                      \
     do {                                                                            \
         if (!(condition)) {                                                         \
@@ -53,6 +64,7 @@ typedef struct test_trace_capture_s {
     uint32_t query_begin_count;
     uint32_t query_chunk_count;
     uint32_t query_end_count;
+    uint32_t component_get_count;
     lt_status_t last_status;
     lt_trace_event_kind_t last_kind;
 } test_trace_capture_t;
@@ -78,6 +90,21 @@ static void* test_alloc_only(void* user, size_t size, size_t align)
     return NULL;
 }
 
+static void* test_counting_alloc(void* user, size_t size, size_t align)
+{
+    (void)align;
+    *(uint32_t*)user += 1u;
+    return malloc(size);
+}
+
+static void test_counting_free(void* user, void* ptr, size_t size, size_t align)
+{
+    (void)user;
+    (void)size;
+    (void)align;
+    free(ptr);
+}
+
 static void test_counting_dtor(void* dst, uint32_t count, void* user)
 {
     int* total;
@@ -141,6 +168,9 @@ static void test_trace_hook(const lt_trace_event_t* event, void* user_data)
         case LT_TRACE_EVENT_QUERY_ITER_END:
             capture->query_end_count += 1u;
             break;
+        case LT_TRACE_EVENT_COMPONENT_GET:
+            capture->component_get_count += 1u;
+            break;
         default:
             break;
     }
@@ -1201,6 +1231,332 @@ static int test_add_remove_components_preserve_data(void)
     return 0;
 }
 
+static int test_add_remove_components_single_move(void)
+{
+    lt_world_t* world;
+    lt_component_desc_t component_desc;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_id_t cooldown_id;
+    lt_component_id_t ids[3];
+    lt_component_id_t duplicate_ids[2];
+    const void* values[3];
+    lt_entity_t entity;
+    lt_world_stats_t before;
+    lt_world_stats_t after;
+    test_vec3_t position;
+    test_vec3_t velocity;
+    float cooldown;
+    uint8_t has_value;
+    void* ptr;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "Cooldown";
+    component_desc.size = (uint32_t)sizeof(float);
+    component_desc.align = (uint32_t)_Alignof(float);
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &cooldown_id), LT_STATUS_OK);
+
+    position.x = 1.0f;
+    position.y = 2.0f;
+    position.z = 3.0f;
+    velocity.x = 4.0f;
+    velocity.y = 5.0f;
+    velocity.z = 6.0f;
+    cooldown = 0.5f;
+    ids[0] = cooldown_id;
+    ids[1] = position_id;
+    ids[2] = velocity_id;
+    values[0] = &cooldown;
+    values[1] = &position;
+    values[2] = NULL;
+
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    duplicate_ids[0] = position_id;
+    duplicate_ids[1] = position_id;
+    ASSERT_STATUS(lt_add_components(world, entity, duplicate_ids, NULL, 2u), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_add_components(world, entity, ids, values, 0u), LT_STATUS_INVALID_ARGUMENT);
+
+    ASSERT_STATUS(lt_world_get_stats(world, &before), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_components(world, entity, ids, values, 3u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &after), LT_STATUS_OK);
+    ASSERT_TRUE(after.structural_moves == before.structural_moves + 1u);
+    ASSERT_TRUE(after.archetype_count == before.archetype_count + 1u);
+
+    ASSERT_STATUS(lt_get_component(world, entity, position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->z == 3.0f);
+    ASSERT_STATUS(lt_get_component(world, entity, velocity_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 0.0f);
+    ASSERT_STATUS(lt_get_component(world, entity, cooldown_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(*(const float*)ptr == 0.5f);
+
+    ASSERT_STATUS(lt_add_components(world, entity, ids, values, 3u), LT_STATUS_ALREADY_EXISTS);
+
+    ASSERT_STATUS(lt_remove_components(world, entity, &ids[1], 2u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has_value), LT_STATUS_OK);
+    ASSERT_TRUE(has_value == 0u);
+    ASSERT_STATUS(lt_has_component(world, entity, velocity_id, &has_value), LT_STATUS_OK);
+    ASSERT_TRUE(has_value == 0u);
+    ASSERT_STATUS(lt_get_component(world, entity, cooldown_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(*(const float*)ptr == 0.5f);
+    ASSERT_STATUS(lt_remove_components(world, entity, &ids[1], 2u), LT_STATUS_NOT_FOUND);
+
+    values[2] = &velocity;
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_components(world, entity, &ids[1], &values[1], 2u), LT_STATUS_OK);
+    velocity.y = -1.0f;
+    ASSERT_STATUS(lt_world_get_stats(world, &before), LT_STATUS_OK);
+    ASSERT_TRUE(before.pending_commands == 1u);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &after), LT_STATUS_OK);
+    ASSERT_TRUE(after.structural_moves == before.structural_moves + 1u);
+    ASSERT_STATUS(lt_get_component(world, entity, velocity_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->y == 5.0f);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_components(world, entity, ids, 3u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_has_component(world, entity, cooldown_id, &has_value), LT_STATUS_OK);
+    ASSERT_TRUE(has_value == 0u);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_component_batch_add_remove_moves_runs(void)
+{
+    enum { ENTITY_COUNT = 400u, BATCH_COUNT = 200u };
+    lt_world_t* world;
+    lt_world_config_t cfg;
+    lt_component_desc_t component_desc;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_id_t cooldown_id;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_entity_t batch[BATCH_COUNT];
+    float cooldowns[BATCH_COUNT];
+    lt_world_stats_t before;
+    lt_world_stats_t after;
+    test_vec3_t position;
+    uint8_t has_value;
+    void* ptr;
+    uint32_t i;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 512u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "Cooldown";
+    component_desc.size = (uint32_t)sizeof(float);
+    component_desc.align = (uint32_t)_Alignof(float);
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &cooldown_id), LT_STATUS_OK);
+
+    memset(&position, 0, sizeof(position));
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        position.x = (float)i;
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &position), LT_STATUS_OK);
+        if ((i % 3u) == 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, &position), LT_STATUS_OK);
+        }
+    }
+
+    for (i = 0u; i < BATCH_COUNT; ++i) {
+        batch[i] = entities[(i * 2u + (i % 5u == 0u ? 1u : 0u)) % ENTITY_COUNT];
+        cooldowns[i] = (float)i + 0.5f;
+    }
+
+    batch[1] = batch[0];
+    ASSERT_STATUS(lt_world_get_stats(world, &before), LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_add_component_batch(world, batch, BATCH_COUNT, cooldown_id, cooldowns),
+        LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_world_get_stats(world, &after), LT_STATUS_OK);
+    ASSERT_TRUE(after.structural_moves == before.structural_moves);
+    batch[1] = entities[2];
+
+    ASSERT_STATUS(lt_add_component_batch(world, batch, BATCH_COUNT, cooldown_id, cooldowns), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &after), LT_STATUS_OK);
+    ASSERT_TRUE(after.structural_moves >= before.structural_moves + BATCH_COUNT);
+    ASSERT_TRUE(after.archetype_count == before.archetype_count + 2u);
+    ASSERT_TRUE(after.live_entities == ENTITY_COUNT);
+
+    for (i = 0u; i < BATCH_COUNT; ++i) {
+        ASSERT_STATUS(lt_get_component(world, batch[i], cooldown_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(*(const float*)ptr == cooldowns[i]);
+    }
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)i);
+        if ((i % 3u) == 0u) {
+            ASSERT_STATUS(lt_get_component(world, entities[i], velocity_id, &ptr), LT_STATUS_OK);
+            ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)i);
+        }
+    }
+
+    ASSERT_STATUS(lt_add_component_batch(world, batch, 1u, cooldown_id, NULL), LT_STATUS_ALREADY_EXISTS);
+
+    ASSERT_STATUS(lt_remove_component_batch(world, batch, BATCH_COUNT / 2u, cooldown_id), LT_STATUS_OK);
+    for (i = 0u; i < BATCH_COUNT; ++i) {
+        ASSERT_STATUS(lt_has_component(world, batch[i], cooldown_id, &has_value), LT_STATUS_OK);
+        ASSERT_TRUE(has_value == (i >= BATCH_COUNT / 2u ? 1u : 0u));
+    }
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)i);
+    }
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_remove_component_batch(world, &batch[BATCH_COUNT / 2u], BATCH_COUNT / 2u, cooldown_id),
+        LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &before), LT_STATUS_OK);
+    ASSERT_TRUE(before.pending_commands == BATCH_COUNT / 2u);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_has_component(world, batch[BATCH_COUNT - 1u], cooldown_id, &has_value), LT_STATUS_OK);
+    ASSERT_TRUE(has_value == 0u);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_unchecked_accessors_match_checked(void)
+{
+    lt_world_t* world;
+    lt_component_desc_t component_desc;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_id_t tag_id;
+    lt_entity_t entities[64];
+    lt_entity_t stale;
+    test_vec3_t value;
+    uint8_t has_value;
+    void* ptr;
+    uint32_t i;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "Marked";
+    component_desc.flags = LT_COMPONENT_FLAG_TAG;
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &tag_id), LT_STATUS_OK);
+
+    for (i = 0u; i < 64u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        value.x = (float)i;
+        value.y = 0.0f;
+        value.z = 0.0f;
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &value), LT_STATUS_OK);
+        if ((i % 3u) == 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, &value), LT_STATUS_OK);
+        }
+        if ((i % 4u) == 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], tag_id, NULL), LT_STATUS_OK);
+        }
+    }
+
+    stale = entities[5];
+    ASSERT_STATUS(lt_entity_destroy(world, stale), LT_STATUS_OK);
+    ASSERT_TRUE(lt_is_alive_unchecked(world, stale) == 0u);
+    ASSERT_TRUE(lt_is_alive_unchecked(world, entities[6]) == 1u);
+
+    for (i = 0u; i < 64u; ++i) {
+        if (i == 5u) {
+            continue;
+        }
+
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(lt_get_component_unchecked(world, entities[i], position_id) == ptr);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)i);
+
+        ASSERT_STATUS(lt_has_component(world, entities[i], velocity_id, &has_value), LT_STATUS_OK);
+        ASSERT_TRUE(lt_has_component_unchecked(world, entities[i], velocity_id) == has_value);
+        if (has_value == 0u) {
+            ASSERT_TRUE(lt_get_component_unchecked(world, entities[i], velocity_id) == NULL);
+        }
+
+        ASSERT_STATUS(lt_has_component(world, entities[i], tag_id, &has_value), LT_STATUS_OK);
+        ASSERT_TRUE(lt_has_component_unchecked(world, entities[i], tag_id) == has_value);
+        ASSERT_TRUE(lt_get_component_unchecked(world, entities[i], tag_id) == NULL);
+    }
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_component_ref_revalidates_after_moves(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_ref_t ref;
+    lt_entity_t first;
+    lt_entity_t second;
+    lt_entity_t third;
+    test_vec3_t value;
+    void* cached;
+    void* ptr;
+    void* expected;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    value.x = 1.0f;
+    value.y = 0.0f;
+    value.z = 0.0f;
+    ASSERT_STATUS(lt_entity_create(world, &first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, first, position_id, &value), LT_STATUS_OK);
+    value.x = 2.0f;
+    ASSERT_STATUS(lt_entity_create(world, &second), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, second, position_id, &value), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_component_ref_init(world, second, velocity_id, &ref), LT_STATUS_NOT_FOUND);
+    ASSERT_STATUS(lt_component_ref_init(world, second, position_id, &ref), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &cached), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)cached)->x == 2.0f);
+    ASSERT_TRUE(lt_component_ref_ptr_unchecked(world, &ref) == cached);
+
+    ASSERT_STATUS(lt_entity_create(world, &third), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, third, position_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(ptr == cached);
+
+    ASSERT_STATUS(lt_entity_destroy(world, first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, second, position_id, &expected), LT_STATUS_OK);
+    ASSERT_TRUE(lt_component_ref_ptr_unchecked(world, &ref) == NULL);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(ptr == expected);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 2.0f);
+    ASSERT_TRUE(lt_component_ref_ptr_unchecked(world, &ref) == ptr);
+
+    ASSERT_STATUS(lt_add_component(world, second, velocity_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, second, position_id, &expected), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(ptr == expected);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 2.0f);
+
+    ASSERT_STATUS(lt_remove_component(world, second, position_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &ptr), LT_STATUS_NOT_FOUND);
+    ASSERT_TRUE(ptr == NULL);
+
+    ASSERT_STATUS(lt_entity_destroy(world, second), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &ptr), LT_STATUS_STALE_ENTITY);
+#if !LT_NO_VALIDATION
+    ASSERT_STATUS(lt_component_ref_get(world, NULL, &ptr), LT_STATUS_INVALID_ARGUMENT);
+#endif
+
+    lt_world_destroy(world);
+    return 0;
+}
+
 static int test_swap_remove_updates_entity_locations(void)
 {
     lt_world_t* world;
@@ -1283,76 +1639,630 @@ static int test_world_stats_structural_moves(void)
     return 0;
 }
 
-static int test_destructors_called_on_remove_destroy_and_world_destroy(void)
-{
+typedef struct test_stats_monitor_s {
     lt_world_t* world;
-    lt_component_desc_t desc;
-    lt_component_id_t resource_id;
-    lt_entity_t e0;
-    lt_entity_t e1;
-    uint32_t value;
-    int dtor_calls;
+    lt_component_id_t position_id;
+    uint32_t mutator_failures;
+    uint32_t monitor_failures;
+    uint32_t samples;
+} test_stats_monitor_t;
 
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+static void test_stats_mutator_task(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_stats_monitor_t* ctx;
+    lt_entity_t entities[64];
+    uint32_t round;
+    uint32_t i;
 
-    dtor_calls = 0;
-    memset(&desc, 0, sizeof(desc));
-    desc.name = "Resource";
-    desc.size = (uint32_t)sizeof(uint32_t);
-    desc.align = (uint32_t)_Alignof(uint32_t);
-    desc.dtor = test_counting_dtor;
-    desc.user = &dtor_calls;
-    ASSERT_STATUS(lt_register_component(world, &desc, &resource_id), LT_STATUS_OK);
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    ctx = (test_stats_monitor_t*)user_data;
+    for (round = 0u; round < 40u; ++round) {
+        for (i = 0u; i < 64u; ++i) {
+            if (lt_entity_create(ctx->world, &entities[i]) != LT_STATUS_OK
+                || lt_add_component(ctx->world, entities[i], ctx->position_id, NULL) != LT_STATUS_OK) {
+                ctx->mutator_failures += 1u;
+            }
+        }
+        for (i = 0u; i < 64u; ++i) {
+            if (lt_entity_destroy(ctx->world, entities[i]) != LT_STATUS_OK) {
+                ctx->mutator_failures += 1u;
+            }
+        }
+        if (lt_world_flush(ctx->world) != LT_STATUS_OK) {
+            ctx->mutator_failures += 1u;
+        }
+    }
+}
 
-    value = 42u;
-    ASSERT_STATUS(lt_entity_create(world, &e0), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, e0, resource_id, &value), LT_STATUS_OK);
-    ASSERT_STATUS(lt_remove_component(world, e0, resource_id), LT_STATUS_OK);
-    ASSERT_TRUE(dtor_calls == 1);
+static void test_stats_monitor_task(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_stats_monitor_t* ctx;
+    lt_world_stats_t stats;
+    uint64_t last_moves;
+    uint32_t i;
 
-    ASSERT_STATUS(lt_add_component(world, e0, resource_id, &value), LT_STATUS_OK);
-    ASSERT_STATUS(lt_entity_destroy(world, e0), LT_STATUS_OK);
-    ASSERT_TRUE(dtor_calls == 2);
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    ctx = (test_stats_monitor_t*)user_data;
+    last_moves = 0u;
+    for (i = 0u; i < 20000u; ++i) {
+        if (lt_world_get_stats(ctx->world, &stats) != LT_STATUS_OK) {
+            ctx->monitor_failures += 1u;
+            continue;
+        }
+        if (stats.structural_moves < last_moves || stats.live_entities > 64u) {
+            ctx->monitor_failures += 1u;
+        }
+        last_moves = stats.structural_moves;
+        ctx->samples += 1u;
+    }
+}
 
-    ASSERT_STATUS(lt_entity_create(world, &e1), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, e1, resource_id, &value), LT_STATUS_OK);
+static int test_world_stats_sampled_from_monitor_thread(void)
+{
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entities[64];
+    lt_world_stats_t stats;
+    lt_task_graph_t* graph;
+    test_stats_monitor_t monitor;
+    uint64_t peak_bytes;
+    uint32_t i;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    cfg.empty_archetype_reclaim_flushes = 1u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.chunk_bytes == 0u);
+
+    for (i = 0u; i < 64u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, NULL), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.chunk_count > 0u);
+    ASSERT_TRUE(stats.chunk_bytes >= 64u * (sizeof(lt_entity_t) + 2u * sizeof(test_vec3_t)));
+    peak_bytes = stats.chunk_bytes;
+
+    for (i = 0u; i < 64u; ++i) {
+        ASSERT_STATUS(lt_entity_destroy(world, entities[i]), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.live_entities == 0u);
+    ASSERT_TRUE(stats.chunk_bytes < peak_bytes);
+
+    memset(&monitor, 0, sizeof(monitor));
+    monitor.world = world;
+    monitor.position_id = position_id;
+    ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_task(graph, test_stats_mutator_task, &monitor, NULL, 0u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_task(graph, test_stats_monitor_task, &monitor, NULL, 0u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_execute(graph, 2u), LT_STATUS_OK);
+    ASSERT_TRUE(monitor.mutator_failures == 0u);
+    ASSERT_TRUE(monitor.monitor_failures == 0u);
+    ASSERT_TRUE(monitor.samples == 20000u);
+    lt_task_graph_destroy(graph);
+
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.live_entities == 0u && stats.pending_commands == 0u);
 
     lt_world_destroy(world);
-    ASSERT_TRUE(dtor_calls == 3);
     return 0;
 }
 
-static int test_tag_component_behavior(void)
+static const lt_transition_stats_t* test_find_transition(
+    const lt_transition_stats_t* transitions,
+    uint32_t count,
+    uint32_t src_count,
+    uint32_t dst_count)
+{
+    uint32_t i;
+
+    for (i = 0u; i < count; ++i) {
+        if (transitions[i].src_component_count == src_count && transitions[i].dst_component_count == dst_count) {
+            return &transitions[i];
+        }
+    }
+    return NULL;
+}
+
+static int test_transition_heatmap_records_moves(void)
 {
     lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entities[10];
+    lt_transition_stats_t transitions[8];
+    lt_component_transition_stats_t component_stats;
+    const lt_transition_stats_t* found;
     lt_component_desc_t desc;
-    lt_component_id_t tag_id;
-    lt_entity_t entity;
-    uint8_t has;
-    void* ptr;
+    lt_component_id_t mass_id;
+    lt_component_id_t added_ids[2];
+    uint32_t count;
+    uint32_t i;
 
     ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_world_set_transition_tracking(world, 1u), LT_STATUS_OK);
 
-    memset(&desc, 0, sizeof(desc));
-    desc.name = "EnemyTag";
-    desc.flags = LT_COMPONENT_FLAG_TAG;
-    desc.size = 0u;
-    desc.align = 1u;
-    ASSERT_STATUS(lt_register_component(world, &desc, &tag_id), LT_STATUS_OK);
-
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, tag_id, NULL), LT_STATUS_OK);
-
-    ASSERT_STATUS(lt_has_component(world, entity, tag_id, &has), LT_STATUS_OK);
-    ASSERT_TRUE(has == 1u);
+    for (i = 0u; i < 10u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, NULL), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_add_component_batch(world, entities, 10u, velocity_id, NULL), LT_STATUS_OK);
+    for (i = 0u; i < 3u; ++i) {
+        ASSERT_STATUS(lt_remove_component(world, entities[i], position_id), LT_STATUS_OK);
+    }
 
-    ptr = (void*)0x1;
-    ASSERT_STATUS(lt_get_component(world, entity, tag_id, &ptr), LT_STATUS_OK);
-    ASSERT_TRUE(ptr == NULL);
+    ASSERT_STATUS(lt_world_get_transition_count(world, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 3u);
+    ASSERT_STATUS(lt_world_copy_transitions(world, transitions, 8u, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 3u);
+
+    found = test_find_transition(transitions, count, 0u, 1u);
+    ASSERT_TRUE(found != NULL && found->dst_component_ids[0] == position_id);
+    ASSERT_TRUE(found->move_count == 10u && found->bytes_moved == 0u);
+    found = test_find_transition(transitions, count, 1u, 2u);
+    ASSERT_TRUE(found != NULL && found->src_component_ids[0] == position_id);
+    ASSERT_TRUE(found->move_count == 10u && found->bytes_moved == 10u * sizeof(test_vec3_t));
+    found = test_find_transition(transitions, count, 2u, 1u);
+    ASSERT_TRUE(found != NULL && found->dst_component_ids[0] == velocity_id);
+    ASSERT_TRUE(found->move_count == 3u && found->bytes_moved == 3u * sizeof(test_vec3_t));
+
+    ASSERT_STATUS(lt_component_get_transition_stats(world, position_id, &component_stats), LT_STATUS_OK);
+    ASSERT_TRUE(component_stats.add_count == 10u && component_stats.remove_count == 3u);
+    ASSERT_TRUE(component_stats.bytes_moved == 13u * sizeof(test_vec3_t));
+    ASSERT_STATUS(lt_component_get_transition_stats(world, velocity_id, &component_stats), LT_STATUS_OK);
+    ASSERT_TRUE(component_stats.add_count == 10u && component_stats.remove_count == 0u);
+    ASSERT_TRUE(component_stats.bytes_moved == 10u * sizeof(test_vec3_t));
+    ASSERT_STATUS(lt_component_get_transition_stats(world, velocity_id + 1u, &component_stats), LT_STATUS_NOT_FOUND);
+
+    ASSERT_STATUS(lt_world_copy_transitions(world, transitions, 1u, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 1u);
+    ASSERT_STATUS(lt_world_copy_transitions(world, NULL, 1u, &count), LT_STATUS_INVALID_ARGUMENT);
+
+    ASSERT_STATUS(lt_world_reset_transition_stats(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_transition_count(world, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 0u);
+    ASSERT_STATUS(lt_component_get_transition_stats(world, position_id, &component_stats), LT_STATUS_OK);
+    ASSERT_TRUE(component_stats.add_count == 0u && component_stats.remove_count == 0u);
+
+    ASSERT_STATUS(lt_add_component(world, entities[0], position_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_copy_transitions(world, transitions, 8u, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 1u && transitions[0].move_count == 1u);
+    ASSERT_STATUS(lt_world_set_transition_tracking(world, 0u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, entities[0], position_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_transition_count(world, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 1u);
 
-    ASSERT_STATUS(lt_remove_component(world, entity, tag_id), LT_STATUS_OK);
-    ASSERT_STATUS(lt_has_component(world, entity, tag_id, &has), LT_STATUS_OK);
-    ASSERT_TRUE(has == 0u);
+    memset(&desc, 0, sizeof(desc));
+    desc.name = "Mass";
+    desc.size = (uint32_t)sizeof(uint32_t);
+    desc.align = (uint32_t)_Alignof(uint32_t);
+    ASSERT_STATUS(lt_register_component(world, &desc, &mass_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_set_transition_tracking(world, 1u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_reset_transition_stats(world), LT_STATUS_OK);
+    added_ids[0] = position_id;
+    added_ids[1] = mass_id;
+    ASSERT_STATUS(lt_add_components(world, entities[0], added_ids, NULL, 2u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_copy_transitions(world, transitions, 8u, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 1u && transitions[0].bytes_moved == sizeof(test_vec3_t));
+    ASSERT_STATUS(lt_component_get_transition_stats(world, position_id, &component_stats), LT_STATUS_OK);
+    ASSERT_TRUE(component_stats.add_count == 1u && component_stats.bytes_moved == sizeof(test_vec3_t));
+    ASSERT_STATUS(lt_component_get_transition_stats(world, mass_id, &component_stats), LT_STATUS_OK);
+    ASSERT_TRUE(component_stats.add_count == 1u && component_stats.bytes_moved == sizeof(uint32_t));
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_component_access_stats_count_rows_and_lookups(void)
+{
+    lt_world_t* world;
+    lt_component_desc_t desc;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_id_t late_id;
+    lt_entity_t entities[10];
+    lt_query_term_t terms[2];
+    lt_query_desc_t query_desc;
+    lt_query_t* query;
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    lt_component_access_stats_t stats;
+    lt_component_ref_t ref;
+    char name[16];
+    void* ptr;
+    uint8_t has_value;
+    uint32_t i;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_world_set_access_counting(world, 1u), LT_STATUS_OK);
+
+    for (i = 0u; i < 10u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, NULL), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_add_component_batch(world, entities, 10u, velocity_id, NULL), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_component_get_access_stats(world, position_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.moved_bytes == 10u * sizeof(test_vec3_t));
+    ASSERT_STATUS(lt_component_get_access_stats(world, velocity_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.moved_bytes == 0u);
+
+    terms[0].component_id = position_id;
+    terms[0].access = LT_ACCESS_WRITE;
+    terms[1].component_id = velocity_id;
+    terms[1].access = LT_ACCESS_READ;
+    memset(&query_desc, 0, sizeof(query_desc));
+    query_desc.with_terms = terms;
+    query_desc.with_count = 2u;
+    ASSERT_STATUS(lt_query_create(world, &query_desc, &query), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    do {
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+    } while (has_value != 0u);
+
+    for (i = 0u; i < 4u; ++i) {
+        ASSERT_STATUS(lt_get_component(world, entities[i], velocity_id, &ptr), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_component_ref_init(world, entities[0], velocity_id, &ref), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_ref_get(world, &ref, &ptr), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_component_get_access_stats(world, position_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.write_rows == 10u && stats.read_rows == 0u && stats.random_lookups == 0u);
+    ASSERT_STATUS(lt_component_get_access_stats(world, velocity_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.read_rows == 10u && stats.write_rows == 0u && stats.random_lookups == 5u);
+
+    memset(&desc, 0, sizeof(desc));
+    desc.size = (uint32_t)sizeof(uint32_t);
+    desc.align = (uint32_t)_Alignof(uint32_t);
+    for (i = 0u; i < 40u; ++i) {
+        (void)snprintf(name, sizeof(name), "Late%u", (unsigned)i);
+        desc.name = name;
+        ASSERT_STATUS(lt_register_component(world, &desc, &late_id), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_add_component(world, entities[0], late_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, entities[0], late_id, &ptr), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_get_access_stats(world, late_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.random_lookups == 1u);
+    ASSERT_STATUS(lt_component_get_access_stats(world, position_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.write_rows == 10u && stats.moved_bytes == 11u * sizeof(test_vec3_t));
+    ASSERT_STATUS(lt_component_get_access_stats(world, late_id + 1u, &stats), LT_STATUS_NOT_FOUND);
+
+    ASSERT_STATUS(lt_world_reset_access_stats(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_set_access_counting(world, 0u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, entities[1], velocity_id, &ptr), LT_STATUS_OK);
+    ASSERT_STATUS(lt_component_get_access_stats(world, velocity_id, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.read_rows == 0u && stats.random_lookups == 0u && stats.moved_bytes == 0u);
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_recorder_captures_world_operations(void)
+{
+    static const char* path = "lattice_test_capture.ltrc";
+    lt_world_t* world;
+    lt_recorder_t* recorder;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t first;
+    lt_entity_t second;
+    lt_query_term_t term;
+    lt_query_desc_t query_desc;
+    lt_query_t* query;
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    lt_record_t record;
+    test_vec3_t value;
+    uint8_t data[4096];
+    lt_record_op_t ops[16];
+    uint64_t record_count;
+    size_t size;
+    size_t offset;
+    FILE* file;
+    void* ptr;
+    uint8_t has_value;
+    uint32_t op_count;
+    lt_status_t status;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_entity_create(world, &first), LT_STATUS_OK);
+    value.x = 1.0f;
+    value.y = 2.0f;
+    value.z = 3.0f;
+    ASSERT_STATUS(lt_add_component(world, first, position_id, &value), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_recorder_create(world, path, &recorder), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_recorder_create(world, path, &recorder), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_entity_create(world, &second), LT_STATUS_OK);
+    value.x = 4.0f;
+    ASSERT_STATUS(lt_add_component(world, second, velocity_id, &value), LT_STATUS_OK);
+    value.x = 5.0f;
+    ASSERT_STATUS(lt_set_component(world, first, position_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, first, position_id, &ptr), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, second, velocity_id), LT_STATUS_OK);
+
+    term.component_id = position_id;
+    term.access = LT_ACCESS_READ;
+    memset(&query_desc, 0, sizeof(query_desc));
+    query_desc.with_terms = &term;
+    query_desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &query_desc, &query), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    do {
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+    } while (has_value != 0u);
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    ASSERT_STATUS(lt_recorder_mark_frame(recorder), LT_STATUS_OK);
+    ASSERT_STATUS(lt_recorder_get_record_count(recorder, &record_count), LT_STATUS_OK);
+    ASSERT_TRUE(record_count == 13u);
+    lt_recorder_destroy(recorder);
+
+    file = fopen(path, "rb");
+    ASSERT_TRUE(file != NULL);
+    size = fread(data, 1u, sizeof(data), file);
+    (void)fclose(file);
+    (void)remove(path);
+    ASSERT_STATUS(lt_record_read_header(data, 3u, &offset), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_record_read_header(data, size, &offset), LT_STATUS_OK);
+
+    op_count = 0u;
+    for (;;) {
+        status = lt_record_decode(data, size, &offset, &record);
+        if (status == LT_STATUS_NOT_FOUND) {
+            break;
+        }
+        ASSERT_STATUS(status, LT_STATUS_OK);
+        ASSERT_TRUE(op_count < 16u);
+        ops[op_count] = record.op;
+        if (op_count == 3u) {
+            ASSERT_TRUE(record.op == LT_RECORD_OP_ADD && record.payload_size == sizeof(test_vec3_t));
+            memcpy(&value, record.payload, sizeof(value));
+            ASSERT_TRUE(value.x == 1.0f && value.z == 3.0f);
+        }
+        if (op_count == 6u) {
+            ASSERT_TRUE(record.op == LT_RECORD_OP_SET && record.component_id == position_id);
+            memcpy(&value, record.payload, sizeof(value));
+            ASSERT_TRUE(value.x == 5.0f);
+        }
+        if (record.op == LT_RECORD_OP_QUERY_DEFINE) {
+            ASSERT_TRUE(record.term_count == 1u && record.terms[0].component_id == position_id);
+            ASSERT_TRUE(record.without_count == 0u);
+        }
+        op_count += 1u;
+    }
+    ASSERT_TRUE(op_count == 13u);
+    ASSERT_TRUE(ops[0] == LT_RECORD_OP_REGISTER && ops[1] == LT_RECORD_OP_REGISTER);
+    ASSERT_TRUE(ops[2] == LT_RECORD_OP_CREATE && ops[4] == LT_RECORD_OP_CREATE);
+    ASSERT_TRUE(ops[5] == LT_RECORD_OP_ADD && ops[7] == LT_RECORD_OP_GET && ops[8] == LT_RECORD_OP_REMOVE);
+    ASSERT_TRUE(ops[9] == LT_RECORD_OP_QUERY_DEFINE && ops[10] == LT_RECORD_OP_QUERY_RUN);
+    ASSERT_TRUE(ops[11] == LT_RECORD_OP_QUERY_RUN && ops[12] == LT_RECORD_OP_FRAME);
+
+    data[size - 1u] = 0xFFu;
+    offset = sizeof(lt_record_header_t);
+    do {
+        status = lt_record_decode(data, size, &offset, &record);
+    } while (status == LT_STATUS_OK);
+    ASSERT_STATUS(status, LT_STATUS_INVALID_ARGUMENT);
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_task_spawn_s {
+    lt_world_t* world;
+    lt_component_id_t component_id;
+    lt_entity_t entities[100];
+    uint32_t failures;
+} test_task_spawn_t;
+
+static void test_task_spawn_entities(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_task_spawn_t* spawn;
+    uint32_t i;
+
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    spawn = (test_task_spawn_t*)user_data;
+    for (i = 0u; i < 100u; ++i) {
+        if (lt_entity_create(spawn->world, &spawn->entities[i]) != LT_STATUS_OK) {
+            spawn->failures += 1u;
+        }
+    }
+}
+
+static void test_task_add_components(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_task_spawn_t* spawn;
+    uint32_t i;
+
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    spawn = (test_task_spawn_t*)user_data;
+    for (i = 0u; i < 100u; ++i) {
+        if (lt_add_component(spawn->world, spawn->entities[i], spawn->component_id, NULL) != LT_STATUS_OK) {
+            spawn->failures += 1u;
+        }
+    }
+}
+
+static void test_task_idle(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    (void)user_data;
+}
+
+static int test_recorder_captures_task_graph_operations(void)
+{
+    static const char* path = "lattice_test_task_capture.ltrc";
+    lt_world_t* world;
+    lt_recorder_t* recorder;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_task_graph_t* graph;
+    lt_task_id_t spawn_task;
+    test_task_spawn_t spawn;
+    lt_record_t record;
+    uint8_t created[256];
+    uint64_t before;
+    uint64_t after;
+    uint8_t* data;
+    size_t size;
+    size_t offset;
+    FILE* file;
+    uint32_t adds;
+    uint32_t workers;
+    lt_status_t status;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_recorder_create(world, path, &recorder), LT_STATUS_OK);
+
+    for (workers = 1u; workers <= 2u; ++workers) {
+        memset(&spawn, 0, sizeof(spawn));
+        spawn.world = world;
+        spawn.component_id = workers == 1u ? position_id : velocity_id;
+        ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_add_task(graph, test_task_spawn_entities, &spawn, NULL, 0u, &spawn_task),
+                      LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_add_task(graph, test_task_add_components, &spawn, &spawn_task, 1u, NULL),
+                      LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_add_task(graph, test_task_idle, NULL, NULL, 0u, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_recorder_get_record_count(recorder, &before), LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_execute(graph, workers), LT_STATUS_OK);
+        ASSERT_STATUS(lt_recorder_get_record_count(recorder, &after), LT_STATUS_OK);
+        ASSERT_TRUE(spawn.failures == 0u && after - before == 200u);
+        lt_task_graph_destroy(graph);
+    }
+    lt_recorder_destroy(recorder);
+
+    file = fopen(path, "rb");
+    ASSERT_TRUE(file != NULL);
+    ASSERT_TRUE(fseek(file, 0, SEEK_END) == 0);
+    size = (size_t)ftell(file);
+    ASSERT_TRUE(fseek(file, 0, SEEK_SET) == 0);
+    data = (uint8_t*)malloc(size);
+    ASSERT_TRUE(data != NULL);
+    ASSERT_TRUE(fread(data, 1u, size, file) == size);
+    (void)fclose(file);
+    (void)remove(path);
+
+    memset(created, 0, sizeof(created));
+    adds = 0u;
+    ASSERT_STATUS(lt_record_read_header(data, size, &offset), LT_STATUS_OK);
+    for (;;) {
+        status = lt_record_decode(data, size, &offset, &record);
+        if (status == LT_STATUS_NOT_FOUND) {
+            break;
+        }
+        ASSERT_STATUS(status, LT_STATUS_OK);
+        ASSERT_TRUE(record.entity_index < 256u);
+        if (record.op == LT_RECORD_OP_CREATE) {
+            created[record.entity_index] = 1u;
+        } else if (record.op == LT_RECORD_OP_ADD) {
+            ASSERT_TRUE(created[record.entity_index] != 0u);
+            adds += 1u;
+        }
+    }
+    ASSERT_TRUE(adds == 200u);
+    free(data);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_destructors_called_on_remove_destroy_and_world_destroy(void)
+{
+    lt_world_t* world;
+    lt_component_desc_t desc;
+    lt_component_id_t resource_id;
+    lt_entity_t e0;
+    lt_entity_t e1;
+    uint32_t value;
+    int dtor_calls;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+
+    dtor_calls = 0;
+    memset(&desc, 0, sizeof(desc));
+    desc.name = "Resource";
+    desc.size = (uint32_t)sizeof(uint32_t);
+    desc.align = (uint32_t)_Alignof(uint32_t);
+    desc.dtor = test_counting_dtor;
+    desc.user = &dtor_calls;
+    ASSERT_STATUS(lt_register_component(world, &desc, &resource_id), LT_STATUS_OK);
+
+    value = 42u;
+    ASSERT_STATUS(lt_entity_create(world, &e0), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, e0, resource_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, e0, resource_id), LT_STATUS_OK);
+    ASSERT_TRUE(dtor_calls == 1);
+
+    ASSERT_STATUS(lt_add_component(world, e0, resource_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_destroy(world, e0), LT_STATUS_OK);
+    ASSERT_TRUE(dtor_calls == 2);
+
+    ASSERT_STATUS(lt_entity_create(world, &e1), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, e1, resource_id, &value), LT_STATUS_OK);
+
+    lt_world_destroy(world);
+    ASSERT_TRUE(dtor_calls == 3);
+    return 0;
+}
+
+static int test_tag_component_behavior(void)
+{
+    lt_world_t* world;
+    lt_component_desc_t desc;
+    lt_component_id_t tag_id;
+    lt_entity_t entity;
+    uint8_t has;
+    void* ptr;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+
+    memset(&desc, 0, sizeof(desc));
+    desc.name = "EnemyTag";
+    desc.flags = LT_COMPONENT_FLAG_TAG;
+    desc.size = 0u;
+    desc.align = 1u;
+    ASSERT_STATUS(lt_register_component(world, &desc, &tag_id), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, tag_id, NULL), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_has_component(world, entity, tag_id, &has), LT_STATUS_OK);
+    ASSERT_TRUE(has == 1u);
+
+    ptr = (void*)0x1;
+    ASSERT_STATUS(lt_get_component(world, entity, tag_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(ptr == NULL);
+
+    ASSERT_STATUS(lt_remove_component(world, entity, tag_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_has_component(world, entity, tag_id, &has), LT_STATUS_OK);
+    ASSERT_TRUE(has == 0u);
 
     lt_world_destroy(world);
     return 0;
@@ -1514,474 +2424,3076 @@ static int test_query_iteration_and_filters(void)
     return 0;
 }
 
-static int test_query_validation_conflicts(void)
+static int test_query_count_tracks_rows_without_iteration(void)
 {
     lt_world_t* world;
     lt_component_id_t position_id;
     lt_component_id_t velocity_id;
-    lt_query_term_t with_term;
+    lt_entity_t entities[300];
+    lt_query_term_t term;
     lt_query_desc_t desc;
     lt_query_t* query;
+    uint32_t entity_count;
+    uint32_t chunk_count;
+    uint32_t i;
+    lt_world_config_t cfg;
 
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
     ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
 
-    with_term.component_id = position_id;
-    with_term.access = LT_ACCESS_READ;
-
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_READ;
     memset(&desc, 0, sizeof(desc));
-    desc.with_terms = &with_term;
+    desc.with_terms = &term;
     desc.with_count = 1u;
-    desc.without = &position_id;
-    desc.without_count = 1u;
-    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
 
-    with_term.component_id = LT_COMPONENT_INVALID;
-    memset(&desc, 0, sizeof(desc));
-    desc.with_terms = &with_term;
-    desc.with_count = 1u;
-    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_NOT_FOUND);
+    ASSERT_STATUS(lt_query_count(NULL, &entity_count, &chunk_count), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_query_count(query, NULL, &chunk_count), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == 0u);
+    ASSERT_TRUE(chunk_count == 0u);
+
+    for (i = 0u; i < 300u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, NULL), LT_STATUS_OK);
+        if ((i % 3u) == 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, NULL), LT_STATUS_OK);
+        }
+    }
+
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == 300u);
+    ASSERT_TRUE(chunk_count == 8u);
+
+    for (i = 0u; i < 300u; ++i) {
+        if ((i % 3u) == 0u) {
+            ASSERT_STATUS(lt_entity_destroy(world, entities[i]), LT_STATUS_OK);
+        }
+    }
 
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == 200u);
+    ASSERT_TRUE(chunk_count == 4u);
+
+    lt_query_destroy(query);
     lt_world_destroy(world);
     return 0;
 }
 
-static int test_deferred_component_visibility_and_payload_copy(void)
+static int test_empty_archetypes_skipped_and_reclaimed(void)
 {
     lt_world_t* world;
+    lt_world_config_t cfg;
     lt_component_id_t position_id;
     lt_component_id_t velocity_id;
     lt_entity_t entity;
-    test_vec3_t position;
-    test_vec3_t* out_position;
+    lt_query_term_t term;
+    lt_query_desc_t desc;
+    lt_query_t* query;
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
     lt_world_stats_t stats;
-    uint8_t has;
+    uint8_t has_value;
+    uint32_t entity_count;
+    uint32_t chunk_count;
+    uint32_t visited_chunks;
 
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.empty_archetype_reclaim_flushes = 2u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
     ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
 
-    position.x = 3.0f;
-    position.y = 4.0f;
-    position.z = 5.0f;
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
 
-    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, entity, velocity_id), LT_STATUS_OK);
 
-    position.x = 99.0f;
-    position.y = 100.0f;
-    position.z = 101.0f;
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.archetype_count == 3u);
 
-    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has), LT_STATUS_OK);
-    ASSERT_TRUE(has == 0u);
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    visited_chunks = 0u;
+    while (1) {
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+        if (has_value == 0u) {
+            break;
+        }
+        ASSERT_TRUE(view.count == 1u);
+        visited_chunks += 1u;
+    }
+    ASSERT_TRUE(visited_chunks == 1u);
 
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
     ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
-    ASSERT_TRUE(stats.pending_commands == 1u);
-    ASSERT_TRUE(stats.defer_depth == 1u);
+    ASSERT_TRUE(stats.archetype_count == 3u);
 
-    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
     ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.archetype_count == 2u);
+    ASSERT_TRUE(stats.chunk_count == 2u);
 
-    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has), LT_STATUS_OK);
-    ASSERT_TRUE(has == 1u);
-
-    out_position = NULL;
-    ASSERT_STATUS(lt_get_component(world, entity, position_id, (void**)&out_position), LT_STATUS_OK);
-    ASSERT_TRUE(out_position->x == 3.0f);
-    ASSERT_TRUE(out_position->y == 4.0f);
-    ASSERT_TRUE(out_position->z == 5.0f);
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == 1u);
+    ASSERT_TRUE(chunk_count == 1u);
 
+    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, NULL), LT_STATUS_OK);
     ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
-    ASSERT_TRUE(stats.pending_commands == 0u);
-    ASSERT_TRUE(stats.defer_depth == 0u);
+    ASSERT_TRUE(stats.archetype_count == 3u);
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == 1u);
+    ASSERT_TRUE(chunk_count == 1u);
 
+    lt_query_destroy(query);
     lt_world_destroy(world);
     return 0;
 }
 
-static int test_deferred_flush_conflict_and_destroy(void)
+static double test_float_key(const void* value, void* user)
 {
-    lt_world_t* world;
-    lt_entity_t entity;
-    uint8_t alive;
-
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
-
-    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_entity_destroy(world, entity), LT_STATUS_OK);
-
-    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_CONFLICT);
-    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_CONFLICT);
-    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    (void)user;
+    return (double)*(const float*)value;
+}
 
-    ASSERT_STATUS(lt_entity_is_alive(world, entity, &alive), LT_STATUS_OK);
-    ASSERT_TRUE(alive == 0u);
+static int count_range_query_chunks(lt_query_t* query, uint32_t* out_rows)
+{
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    uint8_t has_value;
+    uint32_t visited_chunks;
 
-    lt_world_destroy(world);
-    return 0;
+    visited_chunks = 0u;
+    *out_rows = 0u;
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    while (1) {
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+        if (has_value == 0u) {
+            break;
+        }
+        visited_chunks += 1u;
+        *out_rows += view.count;
+    }
+    return (int)visited_chunks;
 }
 
-static int test_deferred_command_ordering(void)
+static int test_query_ranges_skip_chunks_by_key_summary(void)
 {
+    enum { ENTITY_COUNT = 200u };
     lt_world_t* world;
+    lt_world_config_t cfg;
+    lt_component_desc_t component_desc;
     lt_component_id_t position_id;
     lt_component_id_t velocity_id;
-    lt_entity_t entity;
-    test_vec3_t p0;
-    test_vec3_t p1;
-    test_vec3_t* out_position;
-    uint8_t has;
+    lt_component_id_t health_id;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_query_term_t term;
+    lt_query_range_t range;
+    lt_query_desc_t desc;
+    lt_query_t* query;
+    uint32_t entity_count;
+    uint32_t chunk_count;
+    uint32_t rows;
+    float health;
+    void* health_ptr;
+    uint32_t i;
 
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 512u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
     ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
 
-    p0.x = 1.0f;
-    p0.y = 1.0f;
-    p0.z = 1.0f;
-    p1.x = 2.0f;
-    p1.y = 2.0f;
-    p1.z = 2.0f;
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "Health";
+    component_desc.size = (uint32_t)sizeof(float);
+    component_desc.align = (uint32_t)_Alignof(float);
+    component_desc.key = test_float_key;
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &health_id), LT_STATUS_OK);
 
-    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, position_id, &p0), LT_STATUS_OK);
-    ASSERT_STATUS(lt_remove_component(world, entity, position_id), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, position_id, &p1), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    component_desc.name = "TaggedHealth";
+    component_desc.size = 0u;
+    component_desc.align = 0u;
+    component_desc.flags = LT_COMPONENT_FLAG_TAG;
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &velocity_id), LT_STATUS_INVALID_ARGUMENT);
 
-    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has), LT_STATUS_OK);
-    ASSERT_TRUE(has == 1u);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        health = (float)i;
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], health_id, &health), LT_STATUS_OK);
+    }
 
-    out_position = NULL;
-    ASSERT_STATUS(lt_get_component(world, entity, position_id, (void**)&out_position), LT_STATUS_OK);
-    ASSERT_TRUE(out_position->x == 2.0f);
-    ASSERT_TRUE(out_position->y == 2.0f);
-    ASSERT_TRUE(out_position->z == 2.0f);
+    memset(&term, 0, sizeof(term));
+    term.component_id = health_id;
+    term.access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    desc.ranges = &range;
+    desc.range_count = 1u;
 
-    lt_world_destroy(world);
-    return 0;
-}
+    range.component_id = position_id;
+    range.min = 0.0;
+    range.max = 1.0;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_INVALID_ARGUMENT);
 
-static int test_trace_hook_reports_core_events(void)
-{
-    lt_world_t* world;
-    lt_component_id_t position_id;
-    lt_component_id_t velocity_id;
-    lt_entity_t entity;
-    test_vec3_t position;
-    test_trace_capture_t capture;
+    range.component_id = health_id;
+    range.min = 2.0;
+    range.max = 1.0;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_INVALID_ARGUMENT);
 
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
-    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    range.min = 10.0;
+    range.max = 12.0;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
 
-    memset(&capture, 0, sizeof(capture));
-    ASSERT_STATUS(lt_world_set_trace_hook(world, test_trace_hook, &capture), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == ENTITY_COUNT);
+    ASSERT_TRUE(chunk_count > 2u);
 
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_TRUE(count_range_query_chunks(query, &rows) == 1);
+    ASSERT_TRUE(rows < ENTITY_COUNT);
 
-    position.x = 1.0f;
-    position.y = 2.0f;
-    position.z = 3.0f;
+    ASSERT_STATUS(lt_get_component(world, entities[ENTITY_COUNT - 1u], health_id, &health_ptr), LT_STATUS_OK);
+    *(float*)health_ptr = 11.0f;
+    ASSERT_TRUE(count_range_query_chunks(query, &rows) == 2);
 
-    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_remove_component(world, entity, position_id), LT_STATUS_OK);
-    ASSERT_STATUS(lt_entity_destroy(world, entity), LT_STATUS_OK);
+    *(float*)health_ptr = 500.0f;
+    ASSERT_TRUE(count_range_query_chunks(query, &rows) == 2);
+    ASSERT_STATUS(lt_get_component(world, entities[ENTITY_COUNT - 1u], health_id, &health_ptr), LT_STATUS_OK);
+    ASSERT_TRUE(count_range_query_chunks(query, &rows) == 1);
 
-    ASSERT_TRUE(capture.total > 0u);
-    ASSERT_TRUE(capture.entity_create_count >= 1u);
-    ASSERT_TRUE(capture.defer_begin_count == 1u);
-    ASSERT_TRUE(capture.defer_end_count == 1u);
-    ASSERT_TRUE(capture.defer_enqueue_count >= 1u);
-    ASSERT_TRUE(capture.flush_begin_count == 1u);
-    ASSERT_TRUE(capture.flush_apply_count >= 1u);
-    ASSERT_TRUE(capture.flush_end_count == 1u);
-    ASSERT_TRUE(capture.component_add_count >= 1u);
-    ASSERT_TRUE(capture.component_remove_count >= 1u);
-    ASSERT_TRUE(capture.entity_destroy_count >= 1u);
-    ASSERT_TRUE(capture.last_status == LT_STATUS_OK);
+    for (i = 0u; i < 12u; ++i) {
+        ASSERT_STATUS(lt_entity_destroy(world, entities[i]), LT_STATUS_OK);
+    }
+    ASSERT_TRUE(count_range_query_chunks(query, &rows) <= 1);
 
-    ASSERT_STATUS(lt_world_set_trace_hook(world, NULL, NULL), LT_STATUS_OK);
+    lt_query_destroy(query);
     lt_world_destroy(world);
     return 0;
 }
 
-static int test_trace_hook_reports_query_events(void)
+typedef struct test_group_ctx_s {
+    lt_component_id_t material_a;
+    lt_component_id_t material_b;
+    uint64_t group_ids[8];
+    uint8_t group_begins[8];
+    uint32_t chunk_count;
+} test_group_ctx_t;
+
+static uint64_t test_group_by_material(
+    const lt_component_id_t* component_ids,
+    uint32_t component_count,
+    void* user_data)
+{
+    const test_group_ctx_t* ctx;
+    uint32_t i;
+
+    ctx = (const test_group_ctx_t*)user_data;
+    for (i = 0u; i < component_count; ++i) {
+        if (component_ids[i] == ctx->material_a) {
+            return 1u;
+        }
+        if (component_ids[i] == ctx->material_b) {
+            return 2u;
+        }
+    }
+    return 0u;
+}
+
+static void test_group_record_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_group_ctx_t* ctx;
+
+    (void)worker_index;
+    ctx = (test_group_ctx_t*)user_data;
+    if (ctx->chunk_count < 8u) {
+        ctx->group_ids[ctx->chunk_count] = view->group_id;
+        ctx->group_begins[ctx->chunk_count] = view->group_begin;
+    }
+    ctx->chunk_count += 1u;
+}
+
+static int test_query_group_by_clusters_archetypes(void)
 {
+    static const uint64_t expected_groups[4] = {0u, 1u, 2u, 2u};
+    static const uint8_t expected_begins[4] = {1u, 1u, 1u, 0u};
     lt_world_t* world;
+    lt_component_desc_t component_desc;
     lt_component_id_t position_id;
     lt_component_id_t velocity_id;
     lt_entity_t entity;
-    test_vec3_t position;
-    test_vec3_t velocity;
-    lt_query_term_t terms[2];
-    lt_query_desc_t query_desc;
+    lt_query_term_t term;
+    lt_query_desc_t desc;
     lt_query_t* query;
     lt_query_iter_t iter;
     lt_chunk_view_t view;
+    test_group_ctx_t ctx;
     uint8_t has_value;
-    test_trace_capture_t capture;
+    uint32_t i;
 
     ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
     ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
 
-    memset(&capture, 0, sizeof(capture));
-    ASSERT_STATUS(lt_world_set_trace_hook(world, test_trace_hook, &capture), LT_STATUS_OK);
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "MaterialA";
+    component_desc.flags = LT_COMPONENT_FLAG_TAG;
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &ctx.material_a), LT_STATUS_OK);
+    component_desc.name = "MaterialB";
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &ctx.material_b), LT_STATUS_OK);
 
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    desc.group_by = test_group_by_material;
+    desc.group_by_user_data = &ctx;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
 
-    position.x = 1.0f;
-    position.y = 2.0f;
-    position.z = 3.0f;
-    velocity.x = 0.25f;
-    velocity.y = 0.5f;
-    velocity.z = 0.75f;
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, ctx.material_b, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
 
-    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, &velocity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, ctx.material_a, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
 
-    memset(terms, 0, sizeof(terms));
-    terms[0].component_id = position_id;
-    terms[0].access = LT_ACCESS_WRITE;
-    terms[1].component_id = velocity_id;
-    terms[1].access = LT_ACCESS_READ;
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
 
-    memset(&query_desc, 0, sizeof(query_desc));
-    query_desc.with_terms = terms;
-    query_desc.with_count = 2u;
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, ctx.material_b, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
 
-    ASSERT_STATUS(lt_query_create(world, &query_desc, &query), LT_STATUS_OK);
     ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
-
     while (1) {
         ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
         if (has_value == 0u) {
             break;
         }
-        ASSERT_TRUE(view.count > 0u);
+        test_group_record_chunk(&view, 0u, &ctx);
+    }
+    ASSERT_TRUE(ctx.chunk_count == 4u);
+    for (i = 0u; i < 4u; ++i) {
+        ASSERT_TRUE(ctx.group_ids[i] == expected_groups[i]);
+        ASSERT_TRUE(ctx.group_begins[i] == expected_begins[i]);
     }
 
-    ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
-    ASSERT_TRUE(has_value == 0u);
-
-    ASSERT_TRUE(capture.query_begin_count == 1u);
-    ASSERT_TRUE(capture.query_chunk_count >= 1u);
-    ASSERT_TRUE(capture.query_end_count == 1u);
-    ASSERT_TRUE(capture.last_kind == LT_TRACE_EVENT_QUERY_ITER_END);
-    ASSERT_TRUE(capture.last_status == LT_STATUS_OK);
+    ctx.chunk_count = 0u;
+    ASSERT_STATUS(lt_query_for_each_chunk_parallel(query, 1u, test_group_record_chunk, &ctx), LT_STATUS_OK);
+    ASSERT_TRUE(ctx.chunk_count == 4u);
+    for (i = 0u; i < 4u; ++i) {
+        ASSERT_TRUE(ctx.group_ids[i] == expected_groups[i]);
+        ASSERT_TRUE(ctx.group_begins[i] == expected_begins[i]);
+    }
 
     lt_query_destroy(query);
     lt_world_destroy(world);
     return 0;
 }
 
-static int test_parallel_query_for_each_chunk_validation(void)
+static int test_float_compare_descending(const void* lhs, const void* rhs, void* user)
+{
+    float a;
+    float b;
+
+    (void)user;
+    a = *(const float*)lhs;
+    b = *(const float*)rhs;
+    return (a < b) - (a > b);
+}
+
+static int check_sorted_depth_rows(lt_world_t* world, lt_query_t* query, int descending)
+{
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    uint8_t has_value;
+    float previous;
+    uint32_t visited;
+    uint32_t row;
+
+    previous = descending ? 1.0e9f : -1.0e9f;
+    visited = 0u;
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    while (1) {
+        const float* depths;
+        const test_vec3_t* positions;
+
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+        if (has_value == 0u) {
+            break;
+        }
+
+        depths = (const float*)view.columns[0];
+        positions = (const test_vec3_t*)view.columns[1];
+        for (row = 0u; row < view.count; ++row) {
+            void* depth_ptr;
+
+            ASSERT_TRUE(descending ? depths[row] <= previous : depths[row] >= previous);
+            ASSERT_TRUE(positions[row].x == depths[row]);
+            ASSERT_STATUS(lt_get_component(world, view.entities[row], 3u, &depth_ptr), LT_STATUS_OK);
+            ASSERT_TRUE(depth_ptr == (const void*)&depths[row]);
+            previous = depths[row];
+            visited += 1u;
+        }
+    }
+    return (int)visited;
+}
+
+static int test_query_sort_orders_rows_across_chunks(void)
 {
+    enum { ENTITY_COUNT = 300u };
     lt_world_t* world;
+    lt_world_config_t cfg;
+    lt_component_desc_t component_desc;
     lt_component_id_t position_id;
     lt_component_id_t velocity_id;
+    lt_component_id_t depth_id;
     lt_entity_t entity;
-    test_vec3_t position;
-    test_vec3_t velocity;
     lt_query_term_t terms[2];
-    lt_query_desc_t query_desc;
+    lt_query_desc_t desc;
     lt_query_t* query;
-    test_parallel_step_ctx_t step_ctx;
+    test_vec3_t position;
+    float depth;
+    uint32_t i;
 
-    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
     ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
-    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
 
-    position.x = 0.0f;
-    position.y = 1.0f;
-    position.z = 2.0f;
-    velocity.x = 1.0f;
-    velocity.y = 1.0f;
-    velocity.z = 1.0f;
-    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
-    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, &velocity), LT_STATUS_OK);
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "Depth";
+    component_desc.size = (uint32_t)sizeof(float);
+    component_desc.align = (uint32_t)_Alignof(float);
+    component_desc.key = test_float_key;
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &depth_id), LT_STATUS_OK);
+    ASSERT_TRUE(depth_id == 3u);
+
+    memset(&position, 0, sizeof(position));
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        depth = (float)((i * 7919u) % 1000u) - 500.0f;
+        position.x = depth;
+        ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, depth_id, &depth), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
+    }
 
     memset(terms, 0, sizeof(terms));
-    terms[0].component_id = position_id;
-    terms[0].access = LT_ACCESS_WRITE;
-    terms[1].component_id = velocity_id;
+    terms[0].component_id = depth_id;
+    terms[0].access = LT_ACCESS_READ;
+    terms[1].component_id = position_id;
     terms[1].access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = terms;
+    desc.with_count = 2u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
 
-    memset(&query_desc, 0, sizeof(query_desc));
-    query_desc.with_terms = terms;
-    query_desc.with_count = 2u;
-    ASSERT_STATUS(lt_query_create(world, &query_desc, &query), LT_STATUS_OK);
-
-    step_ctx.dt = 1.0f / 60.0f;
-    ASSERT_STATUS(
-        lt_query_for_each_chunk_parallel(query, 0u, test_parallel_integrate_chunk, &step_ctx),
-        LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_query_sort(query, velocity_id, NULL, NULL, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_query_sort(query, position_id, NULL, NULL, NULL), LT_STATUS_INVALID_ARGUMENT);
     ASSERT_STATUS(
-        lt_query_for_each_chunk_parallel(query, 1u, NULL, &step_ctx),
+        lt_query_sort(query, depth_id, test_float_key, test_float_compare_descending, NULL),
         LT_STATUS_INVALID_ARGUMENT);
 
     ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(
-        lt_query_for_each_chunk_parallel(query, 2u, test_parallel_integrate_chunk, &step_ctx),
-        LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_query_sort(query, depth_id, NULL, NULL, NULL), LT_STATUS_CONFLICT);
     ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_query_sort(query, depth_id, NULL, NULL, NULL), LT_STATUS_OK);
+    ASSERT_TRUE(check_sorted_depth_rows(world, query, 0) == (int)ENTITY_COUNT);
+
+    ASSERT_STATUS(lt_query_sort(query, depth_id, NULL, test_float_compare_descending, NULL), LT_STATUS_OK);
+    ASSERT_TRUE(check_sorted_depth_rows(world, query, 1) == (int)ENTITY_COUNT);
 
     lt_query_destroy(query);
     lt_world_destroy(world);
     return 0;
 }
 
-static int test_parallel_query_for_each_chunk_deterministic(void)
+static int test_query_retag_relinks_chunks_without_moves(void)
 {
-    test_determinism_snapshot_t serial_run;
-    test_determinism_snapshot_t parallel_run_a;
-    test_determinism_snapshot_t parallel_run_b;
+    enum { ENTITY_COUNT = 120u };
+    lt_world_t* world;
+    lt_world_config_t cfg;
+    lt_component_desc_t component_desc;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_id_t alerted_id;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_query_term_t term;
+    lt_query_desc_t desc;
+    lt_query_t* position_query;
+    lt_query_t* alerted_query;
+    lt_world_stats_t before;
+    lt_world_stats_t after;
+    test_trace_capture_t capture;
+    lt_component_transition_stats_t transition_stats;
+    lt_component_access_stats_t access_stats;
+    test_vec3_t position;
+    uint32_t entity_count;
+    uint32_t chunk_count;
+    uint8_t has_tag;
+    void* ptr;
+    uint32_t i;
 
-    ASSERT_TRUE(run_parallel_query_simulation(0x0BADF00Du, 1u, &serial_run) == 0);
-    ASSERT_TRUE(run_parallel_query_simulation(0x0BADF00Du, 4u, &parallel_run_a) == 0);
-    ASSERT_TRUE(run_parallel_query_simulation(0x0BADF00Du, 4u, &parallel_run_b) == 0);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 256u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
 
-    ASSERT_TRUE(serial_run.checksum == parallel_run_a.checksum);
-    ASSERT_TRUE(parallel_run_a.checksum == parallel_run_b.checksum);
-    ASSERT_TRUE(serial_run.stats.live_entities == parallel_run_a.stats.live_entities);
-    ASSERT_TRUE(serial_run.stats.chunk_count == parallel_run_a.stats.chunk_count);
-    ASSERT_TRUE(serial_run.stats.structural_moves == parallel_run_a.stats.structural_moves);
-    ASSERT_TRUE(parallel_run_a.stats.structural_moves == parallel_run_b.stats.structural_moves);
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.name = "Alerted";
+    component_desc.flags = LT_COMPONENT_FLAG_TAG;
+    ASSERT_STATUS(lt_register_component(world, &component_desc, &alerted_id), LT_STATUS_OK);
+
+    memset(&position, 0, sizeof(position));
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        position.x = (float)i;
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &position), LT_STATUS_OK);
+        if ((i % 4u) == 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, &position), LT_STATUS_OK);
+        }
+    }
+
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &position_query), LT_STATUS_OK);
+
+    term.component_id = alerted_id;
+    ASSERT_STATUS(lt_query_create(world, &desc, &alerted_query), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_query_add_tag(position_query, velocity_id), LT_STATUS_INVALID_ARGUMENT);
+
+    memset(&capture, 0, sizeof(capture));
+    ASSERT_STATUS(lt_world_set_trace_hook(world, test_trace_hook, &capture), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_set_transition_tracking(world, 1u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_set_access_counting(world, 1u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &before), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_add_tag(position_query, alerted_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &after), LT_STATUS_OK);
+    ASSERT_TRUE(after.structural_moves == before.structural_moves);
+    ASSERT_TRUE(after.chunk_count == before.chunk_count);
+    ASSERT_TRUE(capture.component_add_count == ENTITY_COUNT);
+    ASSERT_STATUS(lt_component_get_transition_stats(world, alerted_id, &transition_stats), LT_STATUS_OK);
+    ASSERT_TRUE(transition_stats.add_count == ENTITY_COUNT);
+    ASSERT_STATUS(lt_component_get_access_stats(world, position_id, &access_stats), LT_STATUS_OK);
+    ASSERT_TRUE(access_stats.moved_bytes == (uint64_t)ENTITY_COUNT * sizeof(test_vec3_t));
+
+    ASSERT_STATUS(lt_query_count(alerted_query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == ENTITY_COUNT);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_has_component(world, entities[i], alerted_id, &has_tag), LT_STATUS_OK);
+        ASSERT_TRUE(has_tag == 1u);
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)i);
+    }
+
+    ASSERT_STATUS(lt_query_remove_tag(alerted_query, alerted_id), LT_STATUS_OK);
+    ASSERT_TRUE(capture.component_remove_count == ENTITY_COUNT);
+    ASSERT_STATUS(lt_component_get_transition_stats(world, alerted_id, &transition_stats), LT_STATUS_OK);
+    ASSERT_TRUE(transition_stats.remove_count == ENTITY_COUNT);
+    ASSERT_STATUS(lt_world_set_trace_hook(world, NULL, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_count(alerted_query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == 0u);
+    ASSERT_STATUS(lt_query_count(position_query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == ENTITY_COUNT);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_add_tag(position_query, alerted_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_has_component(world, entities[0], alerted_id, &has_tag), LT_STATUS_OK);
+    ASSERT_TRUE(has_tag == 0u);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_count(alerted_query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == ENTITY_COUNT);
+
+    lt_query_destroy(alerted_query);
+    lt_query_destroy(position_query);
+    lt_world_destroy(world);
     return 0;
 }
 
-static int test_query_schedule_validation(void)
+static int test_query_validation_conflicts(void)
 {
-    lt_world_t* world_a;
-    lt_world_t* world_b;
-    lt_component_id_t position_a;
-    lt_component_id_t velocity_a;
-    lt_component_id_t position_b;
-    lt_component_id_t velocity_b;
-    lt_query_term_t term;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_query_term_t with_term;
     lt_query_desc_t desc;
-    lt_query_t* query_a;
-    lt_query_t* query_b;
-    lt_schedule_t* schedule;
-    lt_schedule_t* invalid_schedule;
-    lt_query_schedule_entry_t entry_a;
-    lt_query_schedule_entry_t mixed_entries[2];
+    lt_query_t* query;
 
-    ASSERT_STATUS(lt_world_create(NULL, &world_a), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_create(NULL, &world_b), LT_STATUS_OK);
-    ASSERT_TRUE(register_vec3_components(world_a, &position_a, &velocity_a) == 0);
-    ASSERT_TRUE(register_vec3_components(world_b, &position_b, &velocity_b) == 0);
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    with_term.component_id = position_id;
+    with_term.access = LT_ACCESS_READ;
 
-    memset(&term, 0, sizeof(term));
-    term.component_id = position_a;
-    term.access = LT_ACCESS_WRITE;
     memset(&desc, 0, sizeof(desc));
-    desc.with_terms = &term;
+    desc.with_terms = &with_term;
     desc.with_count = 1u;
-    ASSERT_STATUS(lt_query_create(world_a, &desc, &query_a), LT_STATUS_OK);
+    desc.without = &position_id;
+    desc.without_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_CONFLICT);
 
-    term.component_id = position_b;
-    term.access = LT_ACCESS_WRITE;
+    with_term.component_id = LT_COMPONENT_INVALID;
     memset(&desc, 0, sizeof(desc));
-    desc.with_terms = &term;
+    desc.with_terms = &with_term;
     desc.with_count = 1u;
-    ASSERT_STATUS(lt_query_create(world_b, &desc, &query_b), LT_STATUS_OK);
-    schedule = NULL;
-    invalid_schedule = NULL;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_NOT_FOUND);
 
-    entry_a.query = query_a;
-    entry_a.callback = test_parallel_integrate_chunk;
-    entry_a.user_data = NULL;
+    lt_world_destroy(world);
+    return 0;
+}
 
-    ASSERT_STATUS(lt_schedule_create(NULL, 0u, &schedule), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_STATUS(lt_schedule_create(&entry_a, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_STATUS(lt_schedule_execute(NULL, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+static int test_deferred_component_visibility_and_payload_copy(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entity;
+    test_vec3_t position;
+    test_vec3_t* out_position;
+    lt_world_stats_t stats;
+    uint8_t has;
 
-    ASSERT_STATUS(lt_query_schedule_execute(NULL, 0u, 1u, NULL), LT_STATUS_OK);
-    ASSERT_STATUS(lt_query_schedule_execute(NULL, 1u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_STATUS(lt_query_schedule_execute(&entry_a, 1u, 0u, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
 
-    entry_a.callback = NULL;
-    ASSERT_STATUS(lt_query_schedule_execute(&entry_a, 1u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_STATUS(lt_schedule_create(&entry_a, 1u, &schedule), LT_STATUS_INVALID_ARGUMENT);
-    entry_a.callback = test_parallel_integrate_chunk;
-    ASSERT_STATUS(lt_schedule_create(&entry_a, 1u, &schedule), LT_STATUS_OK);
-    ASSERT_TRUE(schedule != NULL);
-    ASSERT_STATUS(lt_schedule_execute(schedule, 0u, NULL), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_STATUS(lt_schedule_execute(schedule, 1u, NULL), LT_STATUS_OK);
+    position.x = 3.0f;
+    position.y = 4.0f;
+    position.z = 5.0f;
 
-    mixed_entries[0].query = query_a;
-    mixed_entries[0].callback = test_parallel_integrate_chunk;
-    mixed_entries[0].user_data = NULL;
-    mixed_entries[1].query = query_b;
-    mixed_entries[1].callback = test_parallel_integrate_chunk;
-    mixed_entries[1].user_data = NULL;
-    ASSERT_STATUS(lt_query_schedule_execute(mixed_entries, 2u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_STATUS(lt_schedule_create(mixed_entries, 2u, &invalid_schedule), LT_STATUS_INVALID_ARGUMENT);
-    ASSERT_TRUE(invalid_schedule == NULL);
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
 
-    ASSERT_STATUS(lt_world_begin_defer(world_a), LT_STATUS_OK);
-    ASSERT_STATUS(lt_schedule_execute(schedule, 2u, NULL), LT_STATUS_CONFLICT);
-    ASSERT_STATUS(lt_query_schedule_execute(&mixed_entries[0], 1u, 2u, NULL), LT_STATUS_CONFLICT);
-    ASSERT_STATUS(lt_world_end_defer(world_a), LT_STATUS_OK);
-    ASSERT_STATUS(lt_world_flush(world_a), LT_STATUS_OK);
+    position.x = 99.0f;
+    position.y = 100.0f;
+    position.z = 101.0f;
 
-    lt_schedule_destroy(schedule);
-    lt_query_destroy(query_b);
-    lt_query_destroy(query_a);
-    lt_world_destroy(world_b);
-    lt_world_destroy(world_a);
+    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has), LT_STATUS_OK);
+    ASSERT_TRUE(has == 0u);
+
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.pending_commands == 1u);
+    ASSERT_TRUE(stats.defer_depth == 1u);
+
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has), LT_STATUS_OK);
+    ASSERT_TRUE(has == 1u);
+
+    out_position = NULL;
+    ASSERT_STATUS(lt_get_component(world, entity, position_id, (void**)&out_position), LT_STATUS_OK);
+    ASSERT_TRUE(out_position->x == 3.0f);
+    ASSERT_TRUE(out_position->y == 4.0f);
+    ASSERT_TRUE(out_position->z == 5.0f);
+
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.pending_commands == 0u);
+    ASSERT_TRUE(stats.defer_depth == 0u);
+
+    lt_world_destroy(world);
     return 0;
 }
 
-static int test_query_schedule_batches_and_deterministic(void)
+static int test_deferred_flush_conflict_and_destroy(void)
 {
-    test_determinism_snapshot_t serial_run;
-    test_determinism_snapshot_t parallel_run_a;
-    test_determinism_snapshot_t parallel_run_b;
-    test_determinism_snapshot_t one_shot_parallel_run;
-    lt_query_schedule_stats_t serial_stats;
-    lt_query_schedule_stats_t parallel_stats;
-    lt_query_schedule_stats_t one_shot_parallel_stats;
+    lt_world_t* world;
+    lt_entity_t entity;
+    uint8_t alive;
 
-    ASSERT_TRUE(run_schedule_simulation(0x00A11CEAu, 1u, 1u, &serial_run, &serial_stats) == 0);
-    ASSERT_TRUE(run_schedule_simulation(0x00A11CEAu, 4u, 1u, &parallel_run_a, &parallel_stats) == 0);
-    ASSERT_TRUE(run_schedule_simulation(0x00A11CEAu, 4u, 1u, &parallel_run_b, NULL) == 0);
-    ASSERT_TRUE(
-        run_schedule_simulation(
-            0x00A11CEAu,
-            4u,
-            0u,
-            &one_shot_parallel_run,
-            &one_shot_parallel_stats)
-        == 0);
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
 
-    ASSERT_TRUE(parallel_stats.batch_count == 2u);
-    ASSERT_TRUE(parallel_stats.edge_count == 1u);
-    ASSERT_TRUE(parallel_stats.max_batch_size == 2u);
-    ASSERT_TRUE(serial_stats.batch_count == parallel_stats.batch_count);
-    ASSERT_TRUE(serial_stats.edge_count == parallel_stats.edge_count);
-    ASSERT_TRUE(serial_stats.max_batch_size == parallel_stats.max_batch_size);
-    ASSERT_TRUE(one_shot_parallel_stats.batch_count == parallel_stats.batch_count);
-    ASSERT_TRUE(one_shot_parallel_stats.edge_count == parallel_stats.edge_count);
-    ASSERT_TRUE(one_shot_parallel_stats.max_batch_size == parallel_stats.max_batch_size);
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_destroy(world, entity), LT_STATUS_OK);
 
-    ASSERT_TRUE(serial_run.checksum == parallel_run_a.checksum);
-    ASSERT_TRUE(parallel_run_a.checksum == parallel_run_b.checksum);
-    ASSERT_TRUE(one_shot_parallel_run.checksum == parallel_run_a.checksum);
-    ASSERT_TRUE(serial_run.stats.live_entities == parallel_run_a.stats.live_entities);
-    ASSERT_TRUE(serial_run.stats.chunk_count == parallel_run_a.stats.chunk_count);
-    ASSERT_TRUE(serial_run.stats.structural_moves == parallel_run_a.stats.structural_moves);
-    ASSERT_TRUE(parallel_run_a.stats.structural_moves == parallel_run_b.stats.structural_moves);
-    ASSERT_TRUE(one_shot_parallel_run.stats.structural_moves == parallel_run_a.stats.structural_moves);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_entity_is_alive(world, entity, &alive), LT_STATUS_OK);
+    ASSERT_TRUE(alive == 0u);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_deferred_set_component_coalesces(void)
+{
+    enum { ENTITY_COUNT = 64u };
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_entity_t late_entity;
+    lt_world_stats_t stats;
+    test_vec3_t value;
+    void* ptr;
+    uint32_t i;
+    uint32_t pass;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&value, 0, sizeof(value));
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &value), LT_STATUS_OK);
+    }
+
+    ASSERT_STATUS(lt_set_component(world, entities[0], velocity_id, &value), LT_STATUS_NOT_FOUND);
+#if !LT_NO_VALIDATION
+    ASSERT_STATUS(lt_set_component(world, entities[0], position_id, NULL), LT_STATUS_INVALID_ARGUMENT);
+#endif
+    value.x = 7.0f;
+    ASSERT_STATUS(lt_set_component(world, entities[0], position_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, entities[0], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 7.0f);
+
+    ASSERT_STATUS(lt_entity_create(world, &late_entity), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    for (pass = 0u; pass < 3u; ++pass) {
+        for (i = ENTITY_COUNT; i > 0u; --i) {
+            value.x = (float)(pass * 1000u + i - 1u);
+            ASSERT_STATUS(lt_set_component(world, entities[i - 1u], position_id, &value), LT_STATUS_OK);
+        }
+    }
+    value.x = -1.0f;
+    ASSERT_STATUS(lt_add_component(world, late_entity, position_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, late_entity, position_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, entities[1], position_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_destroy(world, entities[1]), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.pending_commands == ENTITY_COUNT + 4u);
+    ASSERT_STATUS(lt_get_component(world, entities[5], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 0.0f);
+
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.pending_commands == 0u);
+
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        if (i == 1u) {
+            continue;
+        }
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)(2000u + i));
+    }
+    ASSERT_STATUS(lt_get_component(world, late_entity, position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == -1.0f);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, entities[0], position_id, &value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_deferred_command_ordering(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entity;
+    test_vec3_t p0;
+    test_vec3_t p1;
+    test_vec3_t* out_position;
+    uint8_t has;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+
+    p0.x = 1.0f;
+    p0.y = 1.0f;
+    p0.z = 1.0f;
+    p1.x = 2.0f;
+    p1.y = 2.0f;
+    p1.z = 2.0f;
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, &p0), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, entity, position_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, &p1), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_has_component(world, entity, position_id, &has), LT_STATUS_OK);
+    ASSERT_TRUE(has == 1u);
+
+    out_position = NULL;
+    ASSERT_STATUS(lt_get_component(world, entity, position_id, (void**)&out_position), LT_STATUS_OK);
+    ASSERT_TRUE(out_position->x == 2.0f);
+    ASSERT_TRUE(out_position->y == 2.0f);
+    ASSERT_TRUE(out_position->z == 2.0f);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, entity, position_id, &p0), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, entity, position_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, entity, velocity_id, &p1), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_NOT_FOUND);
+    ASSERT_STATUS(lt_get_component(world, entity, position_id, (void**)&out_position), LT_STATUS_OK);
+    ASSERT_TRUE(out_position->x == 0.0f);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, entity, position_id, &p1), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, entity, velocity_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_set_component(world, entity, position_id, &p0), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_NOT_FOUND);
+    ASSERT_STATUS(lt_get_component(world, entity, position_id, (void**)&out_position), LT_STATUS_OK);
+    ASSERT_TRUE(out_position->x == 2.0f);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_query_auto_defer_structural_changes(void)
+{
+    enum { ENTITY_COUNT = 200u };
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_entity_t spawned;
+    lt_query_t* query;
+    lt_query_term_t term;
+    lt_query_desc_t desc;
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    lt_world_stats_t stats;
+    test_vec3_t* positions;
+    uint32_t entity_count;
+    uint32_t chunk_count;
+    uint32_t visited;
+    uint32_t i;
+    uint8_t has_value;
+    uint8_t alive;
+    uint8_t has;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, NULL), LT_STATUS_OK);
+    }
+
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_WRITE;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    desc.auto_defer = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
+
+    visited = 0u;
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    while (1) {
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+        if (has_value == 0u) {
+            break;
+        }
+        positions = (test_vec3_t*)view.columns[0];
+        for (i = 0u; i < view.count; ++i) {
+            positions[i].x += 1.0f;
+            if ((view.entities[i] & 1u) == 0u) {
+                ASSERT_STATUS(lt_entity_destroy(world, view.entities[i]), LT_STATUS_OK);
+            } else {
+                ASSERT_STATUS(lt_add_component(world, view.entities[i], velocity_id, NULL), LT_STATUS_OK);
+            }
+            ASSERT_STATUS(lt_entity_create(world, &spawned), LT_STATUS_OK);
+            ASSERT_STATUS(lt_add_component(world, spawned, position_id, NULL), LT_STATUS_OK);
+        }
+        visited += view.count;
+    }
+    ASSERT_TRUE(visited == ENTITY_COUNT);
+
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.pending_commands == 0u);
+    ASSERT_TRUE(stats.defer_depth == 0u);
+    ASSERT_STATUS(lt_query_count(query, &entity_count, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(entity_count == ENTITY_COUNT + ENTITY_COUNT / 2u);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_is_alive(world, entities[i], &alive), LT_STATUS_OK);
+        ASSERT_TRUE(alive == (uint8_t)((entities[i] & 1u) != 0u));
+        if (alive != 0u) {
+            ASSERT_STATUS(lt_has_component(world, entities[i], velocity_id, &has), LT_STATUS_OK);
+            ASSERT_TRUE(has == 1u);
+        }
+    }
+
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+    ASSERT_TRUE(has_value == 1u);
+    ASSERT_STATUS(lt_entity_destroy(world, view.entities[0]), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.defer_depth == 1u);
+    ASSERT_TRUE(stats.pending_commands == 1u);
+    ASSERT_STATUS(lt_query_iter_end(&iter), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_end(&iter), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.defer_depth == 0u);
+    ASSERT_TRUE(stats.pending_commands == 0u);
+    ASSERT_TRUE(stats.live_entities == ENTITY_COUNT + ENTITY_COUNT / 2u - 1u);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_destroy(world, view.entities[0]), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_end(&iter), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_get_stats(world, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.defer_depth == 1u);
+    ASSERT_TRUE(stats.pending_commands == 1u);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_end(NULL), LT_STATUS_INVALID_ARGUMENT);
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_trace_hook_reports_core_events(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entity;
+    test_vec3_t position;
+    test_trace_capture_t capture;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&capture, 0, sizeof(capture));
+    ASSERT_STATUS(lt_world_set_trace_hook(world, test_trace_hook, &capture), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+
+    position.x = 1.0f;
+    position.y = 2.0f;
+    position.z = 3.0f;
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_remove_component(world, entity, position_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_destroy(world, entity), LT_STATUS_OK);
+
+    ASSERT_TRUE(capture.total > 0u);
+    ASSERT_TRUE(capture.entity_create_count >= 1u);
+    ASSERT_TRUE(capture.defer_begin_count == 1u);
+    ASSERT_TRUE(capture.defer_end_count == 1u);
+    ASSERT_TRUE(capture.defer_enqueue_count >= 1u);
+    ASSERT_TRUE(capture.flush_begin_count == 1u);
+    ASSERT_TRUE(capture.flush_apply_count >= 1u);
+    ASSERT_TRUE(capture.flush_end_count == 1u);
+    ASSERT_TRUE(capture.component_add_count >= 1u);
+    ASSERT_TRUE(capture.component_remove_count >= 1u);
+    ASSERT_TRUE(capture.entity_destroy_count >= 1u);
+    ASSERT_TRUE(capture.last_status == LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_world_set_trace_hook(world, NULL, NULL), LT_STATUS_OK);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_trace_lookup_s {
+    lt_world_t* world;
+    lt_component_id_t component_id;
+} test_trace_lookup_t;
+
+static void test_trace_lookup_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    const test_trace_lookup_t* lookup;
+    void* ptr;
+    uint32_t i;
+
+    (void)worker_index;
+    lookup = (const test_trace_lookup_t*)user_data;
+    for (i = 0u; i < view->count; ++i) {
+        (void)lt_get_component(lookup->world, view->entities[i], lookup->component_id, &ptr);
+    }
+}
+
+static int test_trace_hook_reports_query_events(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entity;
+    test_vec3_t position;
+    test_vec3_t velocity;
+    lt_query_term_t terms[2];
+    lt_query_desc_t query_desc;
+    lt_query_t* query;
+    lt_query_iter_t iter;
+    lt_chunk_view_t view;
+    uint8_t has_value;
+    test_trace_capture_t capture;
+    test_trace_lookup_t lookup;
+    uint32_t i;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&capture, 0, sizeof(capture));
+    ASSERT_STATUS(lt_world_set_trace_hook(world, test_trace_hook, &capture), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+
+    position.x = 1.0f;
+    position.y = 2.0f;
+    position.z = 3.0f;
+    velocity.x = 0.25f;
+    velocity.y = 0.5f;
+    velocity.z = 0.75f;
+
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, &velocity), LT_STATUS_OK);
+
+    memset(terms, 0, sizeof(terms));
+    terms[0].component_id = position_id;
+    terms[0].access = LT_ACCESS_WRITE;
+    terms[1].component_id = velocity_id;
+    terms[1].access = LT_ACCESS_READ;
+
+    memset(&query_desc, 0, sizeof(query_desc));
+    query_desc.with_terms = terms;
+    query_desc.with_count = 2u;
+
+    ASSERT_STATUS(lt_query_create(world, &query_desc, &query), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_iter_begin(query, &iter), LT_STATUS_OK);
+
+    while (1) {
+        ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+        if (has_value == 0u) {
+            break;
+        }
+        ASSERT_TRUE(view.count > 0u);
+    }
+
+    ASSERT_STATUS(lt_query_iter_next(&iter, &view, &has_value), LT_STATUS_OK);
+    ASSERT_TRUE(has_value == 0u);
+
+    ASSERT_TRUE(capture.query_begin_count == 1u);
+    ASSERT_TRUE(capture.query_chunk_count >= 1u);
+    ASSERT_TRUE(capture.query_end_count == 1u);
+    ASSERT_TRUE(capture.last_kind == LT_TRACE_EVENT_QUERY_ITER_END);
+    ASSERT_TRUE(capture.last_status == LT_STATUS_OK);
+
+    for (i = 0u; i < 4000u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, velocity_id, &velocity), LT_STATUS_OK);
+    }
+    lookup.world = world;
+    lookup.component_id = velocity_id;
+    capture.total = 0u;
+    ASSERT_STATUS(lt_query_for_each_chunk_parallel(query, 4u, test_trace_lookup_chunk, &lookup), LT_STATUS_OK);
+    ASSERT_TRUE(capture.component_get_count == 4001u && capture.total == 4002u);
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_parallel_query_for_each_chunk_validation(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entity;
+    test_vec3_t position;
+    test_vec3_t velocity;
+    lt_query_term_t terms[2];
+    lt_query_desc_t query_desc;
+    lt_query_t* query;
+    test_parallel_step_ctx_t step_ctx;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+
+    position.x = 0.0f;
+    position.y = 1.0f;
+    position.z = 2.0f;
+    velocity.x = 1.0f;
+    velocity.y = 1.0f;
+    velocity.z = 1.0f;
+    ASSERT_STATUS(lt_add_component(world, entity, position_id, &position), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entity, velocity_id, &velocity), LT_STATUS_OK);
+
+    memset(terms, 0, sizeof(terms));
+    terms[0].component_id = position_id;
+    terms[0].access = LT_ACCESS_WRITE;
+    terms[1].component_id = velocity_id;
+    terms[1].access = LT_ACCESS_READ;
+
+    memset(&query_desc, 0, sizeof(query_desc));
+    query_desc.with_terms = terms;
+    query_desc.with_count = 2u;
+    ASSERT_STATUS(lt_query_create(world, &query_desc, &query), LT_STATUS_OK);
+
+    step_ctx.dt = 1.0f / 60.0f;
+    ASSERT_STATUS(
+        lt_query_for_each_chunk_parallel(query, 0u, test_parallel_integrate_chunk, &step_ctx),
+        LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(
+        lt_query_for_each_chunk_parallel(query, 1u, NULL, &step_ctx),
+        LT_STATUS_INVALID_ARGUMENT);
+
+    ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_query_for_each_chunk_parallel(query, 2u, test_parallel_integrate_chunk, &step_ctx),
+        LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_subset_ctx_s {
+    uint32_t views[4];
+    uint32_t rows[4];
+    uint32_t unordered;
+} test_subset_ctx_t;
+
+static void test_subset_bump_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_subset_ctx_t* ctx;
+    test_vec3_t* position_col;
+    uint32_t k;
+
+    ctx = (test_subset_ctx_t*)user_data;
+    position_col = (test_vec3_t*)view->columns[0];
+    for (k = 0u; k < view->row_count; ++k) {
+        if ((k > 0u && view->rows[k - 1u] >= view->rows[k]) || view->rows[k] >= view->count) {
+            ctx->unordered = 1u;
+        }
+        position_col[view->rows[k]].y += 1000.0f;
+    }
+    ctx->views[worker_index] += 1u;
+    ctx->rows[worker_index] += view->row_count;
+}
+
+static int test_parallel_query_for_each_chunk_deterministic(void)
+{
+    test_determinism_snapshot_t serial_run;
+    test_determinism_snapshot_t parallel_run_a;
+    test_determinism_snapshot_t parallel_run_b;
+
+    ASSERT_TRUE(run_parallel_query_simulation(0x0BADF00Du, 1u, &serial_run) == 0);
+    ASSERT_TRUE(run_parallel_query_simulation(0x0BADF00Du, 4u, &parallel_run_a) == 0);
+    ASSERT_TRUE(run_parallel_query_simulation(0x0BADF00Du, 4u, &parallel_run_b) == 0);
+
+    ASSERT_TRUE(serial_run.checksum == parallel_run_a.checksum);
+    ASSERT_TRUE(parallel_run_a.checksum == parallel_run_b.checksum);
+    ASSERT_TRUE(serial_run.stats.live_entities == parallel_run_a.stats.live_entities);
+    ASSERT_TRUE(serial_run.stats.chunk_count == parallel_run_a.stats.chunk_count);
+    ASSERT_TRUE(serial_run.stats.structural_moves == parallel_run_a.stats.structural_moves);
+    ASSERT_TRUE(parallel_run_a.stats.structural_moves == parallel_run_b.stats.structural_moves);
+    return 0;
+}
+
+static int test_query_for_each_subset_chunk_bins_rows(void)
+{
+    enum { ENTITY_COUNT = 200 };
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_query_term_t terms[2];
+    lt_query_desc_t desc;
+    lt_query_t* query;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_entity_t subset[ENTITY_COUNT];
+    lt_entity_t stale;
+    test_subset_ctx_t ctx;
+    test_vec3_t position;
+    uint32_t subset_count;
+    uint32_t chunk_count;
+    uint32_t views;
+    uint32_t rows;
+    uint32_t worker;
+    uint32_t i;
+    void* ptr;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 512u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        position.x = (float)i;
+        position.y = 0.0f;
+        position.z = 0.0f;
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &position), LT_STATUS_OK);
+        if ((i % 5u) != 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, NULL), LT_STATUS_OK);
+        }
+    }
+
+    memset(terms, 0, sizeof(terms));
+    terms[0].component_id = position_id;
+    terms[0].access = LT_ACCESS_WRITE;
+    terms[1].component_id = velocity_id;
+    terms[1].access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = terms;
+    desc.with_count = 2u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_count(query, &rows, &chunk_count), LT_STATUS_OK);
+    ASSERT_TRUE(chunk_count > 2u);
+
+    subset_count = 0u;
+    for (i = ENTITY_COUNT; i > 0u; --i) {
+        if (((i - 1u) % 3u) == 0u) {
+            subset[subset_count] = entities[i - 1u];
+            subset_count += 1u;
+        }
+    }
+    subset[subset_count] = entities[3];
+    subset_count += 1u;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ASSERT_STATUS(
+        lt_query_for_each_subset_chunk(query, subset, subset_count, 4u, test_subset_bump_chunk, &ctx),
+        LT_STATUS_OK);
+    ASSERT_TRUE(ctx.unordered == 0u);
+
+    views = 0u;
+    rows = 0u;
+    for (worker = 0u; worker < 4u; ++worker) {
+        views += ctx.views[worker];
+        rows += ctx.rows[worker];
+    }
+    ASSERT_TRUE(views <= chunk_count);
+    ASSERT_TRUE(views > 1u);
+
+    subset_count = 0u;
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        uint8_t selected;
+
+        selected = (uint8_t)((i % 3u) == 0u && (i % 5u) != 0u);
+        subset_count += selected;
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x == (float)i);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->y == (selected ? 1000.0f : 0.0f));
+    }
+    ASSERT_TRUE(rows == subset_count);
+
+    ASSERT_STATUS(lt_query_for_each_subset_chunk(query, NULL, 0u, 1u, test_subset_bump_chunk, &ctx), LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_query_for_each_subset_chunk(query, NULL, 1u, 1u, test_subset_bump_chunk, &ctx),
+        LT_STATUS_INVALID_ARGUMENT);
+
+    stale = entities[1];
+    ASSERT_STATUS(lt_entity_destroy(world, stale), LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_query_for_each_subset_chunk(query, &stale, 1u, 1u, test_subset_bump_chunk, &ctx),
+        LT_STATUS_STALE_ENTITY);
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_query_schedule_validation(void)
+{
+    lt_world_t* world_a;
+    lt_world_t* world_b;
+    lt_component_id_t position_a;
+    lt_component_id_t velocity_a;
+    lt_component_id_t position_b;
+    lt_component_id_t velocity_b;
+    lt_query_term_t term;
+    lt_query_desc_t desc;
+    lt_query_t* query_a;
+    lt_query_t* query_b;
+    lt_schedule_t* schedule;
+    lt_schedule_t* invalid_schedule;
+    lt_query_schedule_entry_t entry_a;
+    lt_query_schedule_entry_t mixed_entries[2];
+
+    ASSERT_STATUS(lt_world_create(NULL, &world_a), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_create(NULL, &world_b), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world_a, &position_a, &velocity_a) == 0);
+    ASSERT_TRUE(register_vec3_components(world_b, &position_b, &velocity_b) == 0);
+
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_a;
+    term.access = LT_ACCESS_WRITE;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world_a, &desc, &query_a), LT_STATUS_OK);
+
+    term.component_id = position_b;
+    term.access = LT_ACCESS_WRITE;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world_b, &desc, &query_b), LT_STATUS_OK);
+    schedule = NULL;
+    invalid_schedule = NULL;
+
+    entry_a.query = query_a;
+    entry_a.callback = test_parallel_integrate_chunk;
+    entry_a.user_data = NULL;
+
+    ASSERT_STATUS(lt_schedule_create(NULL, 0u, &schedule), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_create(&entry_a, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_execute(NULL, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+
+    ASSERT_STATUS(lt_query_schedule_execute(NULL, 0u, 1u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_query_schedule_execute(NULL, 1u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_query_schedule_execute(&entry_a, 1u, 0u, NULL), LT_STATUS_INVALID_ARGUMENT);
+
+    entry_a.callback = NULL;
+    ASSERT_STATUS(lt_query_schedule_execute(&entry_a, 1u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_create(&entry_a, 1u, &schedule), LT_STATUS_INVALID_ARGUMENT);
+    entry_a.callback = test_parallel_integrate_chunk;
+    ASSERT_STATUS(lt_schedule_create(&entry_a, 1u, &schedule), LT_STATUS_OK);
+    ASSERT_TRUE(schedule != NULL);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 0u, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 1u, NULL), LT_STATUS_OK);
+
+    mixed_entries[0].query = query_a;
+    mixed_entries[0].callback = test_parallel_integrate_chunk;
+    mixed_entries[0].user_data = NULL;
+    mixed_entries[1].query = query_b;
+    mixed_entries[1].callback = test_parallel_integrate_chunk;
+    mixed_entries[1].user_data = NULL;
+    ASSERT_STATUS(lt_query_schedule_execute(mixed_entries, 2u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_create(mixed_entries, 2u, &invalid_schedule), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_TRUE(invalid_schedule == NULL);
+
+    ASSERT_STATUS(lt_world_begin_defer(world_a), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 2u, NULL), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_query_schedule_execute(&mixed_entries[0], 1u, 2u, NULL), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_world_end_defer(world_a), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world_a), LT_STATUS_OK);
+
+    lt_schedule_destroy(schedule);
+    lt_query_destroy(query_b);
+    lt_query_destroy(query_a);
+    lt_world_destroy(world_b);
+    lt_world_destroy(world_a);
+    return 0;
+}
+
+static int test_query_schedule_batches_and_deterministic(void)
+{
+    test_determinism_snapshot_t serial_run;
+    test_determinism_snapshot_t parallel_run_a;
+    test_determinism_snapshot_t parallel_run_b;
+    test_determinism_snapshot_t one_shot_parallel_run;
+    lt_query_schedule_stats_t serial_stats;
+    lt_query_schedule_stats_t parallel_stats;
+    lt_query_schedule_stats_t one_shot_parallel_stats;
+
+    ASSERT_TRUE(run_schedule_simulation(0x00A11CEAu, 1u, 1u, &serial_run, &serial_stats) == 0);
+    ASSERT_TRUE(run_schedule_simulation(0x00A11CEAu, 4u, 1u, &parallel_run_a, &parallel_stats) == 0);
+    ASSERT_TRUE(run_schedule_simulation(0x00A11CEAu, 4u, 1u, &parallel_run_b, NULL) == 0);
+    ASSERT_TRUE(
+        run_schedule_simulation(
+            0x00A11CEAu,
+            4u,
+            0u,
+            &one_shot_parallel_run,
+            &one_shot_parallel_stats)
+        == 0);
+
+    ASSERT_TRUE(parallel_stats.batch_count == 2u);
+    ASSERT_TRUE(parallel_stats.edge_count == 1u);
+    ASSERT_TRUE(parallel_stats.max_batch_size == 2u);
+    ASSERT_TRUE(serial_stats.batch_count == parallel_stats.batch_count);
+    ASSERT_TRUE(serial_stats.edge_count == parallel_stats.edge_count);
+    ASSERT_TRUE(serial_stats.max_batch_size == parallel_stats.max_batch_size);
+    ASSERT_TRUE(one_shot_parallel_stats.batch_count == parallel_stats.batch_count);
+    ASSERT_TRUE(one_shot_parallel_stats.edge_count == parallel_stats.edge_count);
+    ASSERT_TRUE(one_shot_parallel_stats.max_batch_size == parallel_stats.max_batch_size);
+
+    ASSERT_TRUE(serial_run.checksum == parallel_run_a.checksum);
+    ASSERT_TRUE(parallel_run_a.checksum == parallel_run_b.checksum);
+    ASSERT_TRUE(one_shot_parallel_run.checksum == parallel_run_a.checksum);
+    ASSERT_TRUE(serial_run.stats.live_entities == parallel_run_a.stats.live_entities);
+    ASSERT_TRUE(serial_run.stats.chunk_count == parallel_run_a.stats.chunk_count);
+    ASSERT_TRUE(serial_run.stats.structural_moves == parallel_run_a.stats.structural_moves);
+    ASSERT_TRUE(parallel_run_a.stats.structural_moves == parallel_run_b.stats.structural_moves);
+    ASSERT_TRUE(one_shot_parallel_run.stats.structural_moves == parallel_run_a.stats.structural_moves);
+    return 0;
+}
+
+typedef struct test_schedule_log_s {
+    uint32_t order[64];
+    uint32_t count;
+} test_schedule_log_t;
+
+typedef struct test_schedule_log_entry_s {
+    test_schedule_log_t* log;
+    uint32_t index;
+} test_schedule_log_entry_t;
+
+static void test_schedule_log_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_schedule_log_entry_t* entry;
+
+    (void)view;
+    (void)worker_index;
+    entry = (test_schedule_log_entry_t*)user_data;
+    entry->log->order[entry->log->count] = entry->index;
+    entry->log->count += 1u;
+}
+
+static int test_schedule_compile_matches_pairwise_layering(void)
+{
+    enum { COMPONENT_COUNT = 8, ENTRY_COUNT = 48, MAX_TERMS = 3 };
+    lt_world_t* world;
+    lt_component_desc_t component_desc;
+    lt_component_id_t components[COMPONENT_COUNT];
+    lt_query_term_t terms[ENTRY_COUNT][MAX_TERMS];
+    uint32_t term_counts[ENTRY_COUNT];
+    lt_query_t* queries[ENTRY_COUNT];
+    lt_query_schedule_entry_t entries[ENTRY_COUNT];
+    test_schedule_log_entry_t log_entries[ENTRY_COUNT];
+    test_schedule_log_t log;
+    uint32_t levels[ENTRY_COUNT];
+    uint32_t expected[ENTRY_COUNT];
+    lt_query_schedule_stats_t stats;
+    lt_query_desc_t desc;
+    lt_entity_t entity;
+    char name[8];
+    uint32_t rng;
+    uint32_t max_level;
+    uint32_t expected_count;
+    uint32_t level;
+    uint32_t i;
+    uint32_t j;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.size = (uint32_t)sizeof(float);
+    component_desc.align = (uint32_t)_Alignof(float);
+    for (i = 0u; i < COMPONENT_COUNT; ++i) {
+        name[0] = 'C';
+        name[1] = (char)('0' + (char)i);
+        name[2] = '\0';
+        component_desc.name = name;
+        ASSERT_STATUS(lt_register_component(world, &component_desc, &components[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, components[i], NULL), LT_STATUS_OK);
+    }
+
+    rng = 0x5EEDu;
+    memset(&log, 0, sizeof(log));
+    memset(entries, 0, sizeof(entries));
+    for (i = 0u; i < ENTRY_COUNT; ++i) {
+        uint32_t first;
+
+        term_counts[i] = 1u + test_rand_u32(&rng) % MAX_TERMS;
+        first = test_rand_u32(&rng) % COMPONENT_COUNT;
+        for (j = 0u; j < term_counts[i]; ++j) {
+            terms[i][j].component_id = components[(first + j * 3u) % COMPONENT_COUNT];
+            terms[i][j].access = (test_rand_u32(&rng) % 3u) == 0u ? LT_ACCESS_WRITE : LT_ACCESS_READ;
+        }
+        memset(&desc, 0, sizeof(desc));
+        desc.with_terms = terms[i];
+        desc.with_count = term_counts[i];
+        ASSERT_STATUS(lt_query_create(world, &desc, &queries[i]), LT_STATUS_OK);
+
+        log_entries[i].log = &log;
+        log_entries[i].index = i;
+        entries[i].query = queries[i];
+        entries[i].callback = test_schedule_log_chunk;
+        entries[i].user_data = &log_entries[i];
+    }
+
+    max_level = 0u;
+    for (j = 0u; j < ENTRY_COUNT; ++j) {
+        levels[j] = 0u;
+        for (i = 0u; i < j; ++i) {
+            uint32_t a;
+            uint32_t b;
+            uint8_t conflict;
+
+            conflict = 0u;
+            for (a = 0u; a < term_counts[i]; ++a) {
+                for (b = 0u; b < term_counts[j]; ++b) {
+                    if (terms[i][a].component_id == terms[j][b].component_id
+                        && (terms[i][a].access == LT_ACCESS_WRITE || terms[j][b].access == LT_ACCESS_WRITE)) {
+                        conflict = 1u;
+                    }
+                }
+            }
+            if (conflict != 0u && levels[i] + 1u > levels[j]) {
+                levels[j] = levels[i] + 1u;
+            }
+        }
+        if (levels[j] > max_level) {
+            max_level = levels[j];
+        }
+    }
+
+    expected_count = 0u;
+    for (level = 0u; level <= max_level; ++level) {
+        for (i = 0u; i < ENTRY_COUNT; ++i) {
+            if (levels[i] == level) {
+                expected[expected_count] = i;
+                expected_count += 1u;
+            }
+        }
+    }
+
+    ASSERT_STATUS(lt_query_schedule_execute(entries, ENTRY_COUNT, 1u, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.batch_count == max_level + 1u);
+    ASSERT_TRUE(log.count == ENTRY_COUNT);
+    for (i = 0u; i < ENTRY_COUNT; ++i) {
+        ASSERT_TRUE(log.order[i] == expected[i]);
+    }
+
+    for (i = 0u; i < ENTRY_COUNT; ++i) {
+        lt_query_destroy(queries[i]);
+    }
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_schedule_run_log(lt_schedule_t* schedule, test_schedule_log_t* log)
+{
+    memset(log, 0, sizeof(*log));
+    ASSERT_STATUS(lt_schedule_execute(schedule, 1u, NULL), LT_STATUS_OK);
+    return 0;
+}
+
+static int test_schedule_incremental_edits_match_rebuild(void)
+{
+    enum { COMPONENT_COUNT = 8, POOL_COUNT = 40, MAX_ENTRIES = 48, MAX_TERMS = 3, EDIT_COUNT = 300 };
+    lt_world_t* world;
+    lt_component_desc_t component_desc;
+    lt_component_id_t components[COMPONENT_COUNT];
+    lt_query_term_t terms[POOL_COUNT][MAX_TERMS];
+    lt_query_t* queries[POOL_COUNT];
+    lt_event_access_t pool_events[POOL_COUNT];
+    lt_query_schedule_entry_t pool[POOL_COUNT];
+    lt_schedule_entry_decl_t pool_decls[POOL_COUNT];
+    lt_query_schedule_entry_t fresh_entries[MAX_ENTRIES];
+    lt_schedule_entry_decl_t fresh_decls[MAX_ENTRIES];
+    test_schedule_log_entry_t log_entries[POOL_COUNT];
+    test_schedule_log_t log;
+    test_schedule_log_t fresh_log;
+    uint32_t model_ids[MAX_ENTRIES];
+    uint8_t model_enabled[MAX_ENTRIES];
+    uint32_t model_count;
+    lt_schedule_t* schedule;
+    lt_schedule_t* fresh;
+    lt_query_schedule_stats_t stats;
+    lt_query_schedule_stats_t fresh_stats;
+    lt_event_channel_desc_t channel_desc;
+    lt_event_channel_id_t channel_a;
+    lt_event_channel_id_t channel_b;
+    lt_event_channel_id_t channel_pool;
+    lt_event_access_t cycle_access[2][2];
+    lt_schedule_entry_decl_t cycle_decl;
+    lt_query_desc_t desc;
+    lt_entity_t entity;
+    char name[8];
+    uint32_t rng;
+    uint32_t edit;
+    uint32_t conflicts;
+    uint32_t fresh_count;
+    uint32_t i;
+    uint32_t j;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+    memset(&component_desc, 0, sizeof(component_desc));
+    component_desc.size = (uint32_t)sizeof(float);
+    component_desc.align = (uint32_t)_Alignof(float);
+    for (i = 0u; i < COMPONENT_COUNT; ++i) {
+        name[0] = 'C';
+        name[1] = (char)('0' + (char)i);
+        name[2] = '\0';
+        component_desc.name = name;
+        ASSERT_STATUS(lt_register_component(world, &component_desc, &components[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, components[i], NULL), LT_STATUS_OK);
+    }
+
+    memset(&channel_desc, 0, sizeof(channel_desc));
+    channel_desc.event_size = (uint32_t)sizeof(uint32_t);
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &channel_a), LT_STATUS_OK);
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &channel_b), LT_STATUS_OK);
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &channel_pool), LT_STATUS_OK);
+
+    rng = 0xED17u;
+    memset(pool_decls, 0, sizeof(pool_decls));
+    for (i = 0u; i < POOL_COUNT; ++i) {
+        uint32_t term_count;
+        uint32_t first;
+
+        term_count = 1u + test_rand_u32(&rng) % MAX_TERMS;
+        first = test_rand_u32(&rng) % COMPONENT_COUNT;
+        for (j = 0u; j < term_count; ++j) {
+            terms[i][j].component_id = components[(first + j * 3u) % COMPONENT_COUNT];
+            terms[i][j].access = (test_rand_u32(&rng) % 3u) == 0u ? LT_ACCESS_WRITE : LT_ACCESS_READ;
+        }
+        memset(&desc, 0, sizeof(desc));
+        desc.with_terms = terms[i];
+        desc.with_count = term_count;
+        ASSERT_STATUS(lt_query_create(world, &desc, &queries[i]), LT_STATUS_OK);
+
+        log_entries[i].log = &log;
+        log_entries[i].index = i;
+        pool[i].query = queries[i];
+        pool[i].callback = test_schedule_log_chunk;
+        pool[i].user_data = &log_entries[i];
+        pool_decls[i].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+        if ((test_rand_u32(&rng) % 4u) == 0u) {
+            pool_events[i].channel = channel_pool;
+            pool_events[i].access = (test_rand_u32(&rng) & 1u) == 0u ? LT_ACCESS_WRITE : LT_ACCESS_READ;
+            pool_decls[i].events = &pool_events[i];
+            pool_decls[i].event_count = 1u;
+        }
+    }
+
+    model_count = 24u;
+    for (i = 0u; i < model_count; ++i) {
+        model_ids[i] = i;
+        model_enabled[i] = 1u;
+    }
+    while (lt_schedule_create_with_decls(pool, pool_decls, model_count, &schedule) == LT_STATUS_CONFLICT) {
+        model_count -= 1u;
+    }
+
+    conflicts = 0u;
+    for (edit = 0u; edit < EDIT_COUNT; ++edit) {
+        uint32_t op;
+        uint32_t position;
+
+        op = test_rand_u32(&rng) % 3u;
+        if (op == 1u && model_count == MAX_ENTRIES) {
+            op = 0u;
+        }
+        if (op == 2u && model_count == 1u) {
+            op = 1u;
+        }
+
+        if (op == 0u) {
+            lt_status_t status;
+
+            position = test_rand_u32(&rng) % model_count;
+            status = lt_schedule_set_entry_enabled(schedule, position, (uint8_t)(model_enabled[position] == 0u));
+            ASSERT_TRUE(status == LT_STATUS_OK || (status == LT_STATUS_CONFLICT && model_enabled[position] == 0u));
+            if (status == LT_STATUS_OK) {
+                model_enabled[position] = (uint8_t)(model_enabled[position] == 0u ? 1u : 0u);
+            } else {
+                conflicts += 1u;
+            }
+        } else if (op == 1u) {
+            uint32_t pool_index;
+            lt_status_t status;
+
+            position = test_rand_u32(&rng) % (model_count + 1u);
+            pool_index = test_rand_u32(&rng) % POOL_COUNT;
+            status = lt_schedule_insert_entry(schedule, position, &pool[pool_index], &pool_decls[pool_index]);
+            ASSERT_TRUE(status == LT_STATUS_OK || status == LT_STATUS_CONFLICT);
+            if (status == LT_STATUS_CONFLICT) {
+                conflicts += 1u;
+                continue;
+            }
+            memmove(&model_ids[position + 1u], &model_ids[position], sizeof(model_ids[0]) * (model_count - position));
+            memmove(
+                &model_enabled[position + 1u],
+                &model_enabled[position],
+                sizeof(model_enabled[0]) * (model_count - position));
+            model_ids[position] = pool_index;
+            model_enabled[position] = 1u;
+            model_count += 1u;
+        } else {
+            position = test_rand_u32(&rng) % model_count;
+            ASSERT_STATUS(lt_schedule_remove_entry(schedule, position), LT_STATUS_OK);
+            memmove(
+                &model_ids[position],
+                &model_ids[position + 1u],
+                sizeof(model_ids[0]) * (model_count - position - 1u));
+            memmove(
+                &model_enabled[position],
+                &model_enabled[position + 1u],
+                sizeof(model_enabled[0]) * (model_count - position - 1u));
+            model_count -= 1u;
+        }
+
+        fresh_count = 0u;
+        for (i = 0u; i < model_count; ++i) {
+            if (model_enabled[i] != 0u) {
+                fresh_entries[fresh_count] = pool[model_ids[i]];
+                fresh_decls[fresh_count] = pool_decls[model_ids[i]];
+                fresh_count += 1u;
+            }
+        }
+
+        ASSERT_STATUS(lt_schedule_get_stats(schedule, &stats), LT_STATUS_OK);
+        ASSERT_TRUE(test_schedule_run_log(schedule, &log) == 0);
+        if (fresh_count == 0u) {
+            ASSERT_TRUE(stats.batch_count == 0u && stats.edge_count == 0u);
+            ASSERT_TRUE(log.count == 0u);
+            continue;
+        }
+
+        ASSERT_STATUS(
+            lt_schedule_create_with_decls(fresh_entries, fresh_decls, fresh_count, &fresh),
+            LT_STATUS_OK);
+        ASSERT_STATUS(lt_schedule_get_stats(fresh, &fresh_stats), LT_STATUS_OK);
+        ASSERT_TRUE(stats.batch_count == fresh_stats.batch_count);
+        ASSERT_TRUE(stats.edge_count == fresh_stats.edge_count);
+        ASSERT_TRUE(stats.max_batch_size == fresh_stats.max_batch_size);
+        fresh_log = log;
+        ASSERT_TRUE(test_schedule_run_log(fresh, &log) == 0);
+        ASSERT_TRUE(log.count == fresh_count && fresh_log.count == fresh_count);
+        ASSERT_TRUE(memcmp(log.order, fresh_log.order, sizeof(log.order[0]) * fresh_count) == 0);
+        lt_schedule_destroy(fresh);
+    }
+
+    (void)conflicts;
+    cycle_access[0][0].channel = channel_a;
+    cycle_access[0][0].access = LT_ACCESS_WRITE;
+    cycle_access[0][1].channel = channel_b;
+    cycle_access[0][1].access = LT_ACCESS_READ;
+    cycle_access[1][0].channel = channel_b;
+    cycle_access[1][0].access = LT_ACCESS_WRITE;
+    cycle_access[1][1].channel = channel_a;
+    cycle_access[1][1].access = LT_ACCESS_READ;
+
+    ASSERT_STATUS(lt_schedule_get_stats(schedule, &fresh_stats), LT_STATUS_OK);
+    cycle_decl = pool_decls[0];
+    cycle_decl.events = cycle_access[0];
+    cycle_decl.event_count = 2u;
+    ASSERT_STATUS(lt_schedule_insert_entry(schedule, 0u, &pool[0], &cycle_decl), LT_STATUS_OK);
+    cycle_decl.events = cycle_access[1];
+    ASSERT_STATUS(lt_schedule_insert_entry(schedule, model_count + 1u, &pool[0], &cycle_decl), LT_STATUS_CONFLICT);
+    ASSERT_STATUS(lt_schedule_remove_entry(schedule, 0u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_get_stats(schedule, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.batch_count == fresh_stats.batch_count);
+    ASSERT_TRUE(stats.edge_count == fresh_stats.edge_count);
+
+    ASSERT_STATUS(lt_schedule_insert_entry(schedule, model_count + 1u, NULL, NULL), LT_STATUS_INVALID_ARGUMENT);
+    cycle_decl.version = LT_SCHEDULE_ENTRY_DECL_VERSION + 1u;
+    ASSERT_STATUS(lt_schedule_insert_entry(schedule, 0u, &pool[0], &cycle_decl), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_remove_entry(schedule, model_count), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_schedule_set_entry_enabled(schedule, model_count, 1u), LT_STATUS_INVALID_ARGUMENT);
+
+    lt_schedule_destroy(schedule);
+    for (i = 0u; i < POOL_COUNT; ++i) {
+        lt_query_destroy(queries[i]);
+    }
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_task_ctx_s {
+    float base;
+    float values[1000];
+    uint32_t rows_per_worker[4];
+    uint32_t base_misses;
+    uint32_t rows_seen_at_finish;
+} test_task_ctx_t;
+
+static void test_task_set_base(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    ((test_task_ctx_t*)user_data)->base = 3.0f;
+}
+
+static void test_task_fill_values(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_task_ctx_t* ctx;
+    uint32_t i;
+
+    (void)worker_index;
+    ctx = (test_task_ctx_t*)user_data;
+    for (i = begin; i < end; ++i) {
+        if (ctx->base != 3.0f) {
+            ctx->base_misses += 1u;
+        }
+        ctx->values[i] = ctx->base + (float)i;
+    }
+}
+
+static void test_task_apply_values(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_task_ctx_t* ctx;
+    test_vec3_t* position_col;
+    uint32_t row;
+
+    ctx = (test_task_ctx_t*)user_data;
+    position_col = (test_vec3_t*)view->columns[0];
+    for (row = 0u; row < view->count; ++row) {
+        position_col[row].x += ctx->values[row % 1000u];
+    }
+    ctx->rows_per_worker[worker_index] += view->count;
+}
+
+static void test_task_bump_y(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_vec3_t* position_col;
+    uint32_t row;
+
+    (void)worker_index;
+    (void)user_data;
+    position_col = (test_vec3_t*)view->columns[0];
+    for (row = 0u; row < view->count; ++row) {
+        position_col[row].y = position_col[row].y * 2.0f + 1.0f;
+    }
+}
+
+static void test_task_finish(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_task_ctx_t* ctx;
+    uint32_t i;
+
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    ctx = (test_task_ctx_t*)user_data;
+    ctx->rows_seen_at_finish = 0u;
+    for (i = 0u; i < 4u; ++i) {
+        ctx->rows_seen_at_finish += ctx->rows_per_worker[i];
+    }
+}
+
+static int run_task_graph_case(uint32_t worker_count)
+{
+    enum { ENTITY_COUNT = 1500 };
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_query_term_t term;
+    lt_query_desc_t desc;
+    lt_query_t* query;
+    lt_schedule_t* schedule;
+    lt_query_schedule_entry_t entries[2];
+    lt_task_graph_t* graph;
+    lt_task_id_t base_id;
+    lt_task_id_t fill_id;
+    lt_task_id_t apply_id;
+    lt_task_id_t schedule_id;
+    lt_task_id_t finish_id;
+    lt_task_id_t bad_dep;
+    test_task_ctx_t ctx;
+    lt_entity_t entities[ENTITY_COUNT];
+    test_vec3_t position;
+    uint32_t i;
+    void* ptr;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        position.x = 0.0f;
+        position.y = 0.0f;
+        position.z = 0.0f;
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &position), LT_STATUS_OK);
+    }
+
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_WRITE;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
+
+    memset(&ctx, 0, sizeof(ctx));
+    memset(entries, 0, sizeof(entries));
+    entries[0].query = query;
+    entries[0].callback = test_task_bump_y;
+    entries[0].user_data = NULL;
+    entries[1] = entries[0];
+    ASSERT_STATUS(lt_schedule_create(entries, 2u, &schedule), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_task(graph, test_task_set_base, &ctx, NULL, 0u, &base_id), LT_STATUS_OK);
+    bad_dep = 42u;
+    ASSERT_STATUS(
+        lt_task_graph_add_task(graph, test_task_set_base, &ctx, &bad_dep, 1u, NULL),
+        LT_STATUS_NOT_FOUND);
+    ASSERT_STATUS(
+        lt_task_graph_add_parallel_for(graph, test_task_fill_values, &ctx, 1000u, 0u, NULL, 0u, NULL),
+        LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(
+        lt_task_graph_add_parallel_for(graph, test_task_fill_values, &ctx, 1000u, 64u, &base_id, 1u, &fill_id),
+        LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_task_graph_add_query(graph, query, test_task_apply_values, &ctx, &fill_id, 1u, &apply_id),
+        LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_schedule(graph, schedule, NULL, 0u, &schedule_id), LT_STATUS_OK);
+    ASSERT_STATUS(
+        lt_task_graph_add_task(graph, test_task_finish, &ctx, &schedule_id, 1u, &finish_id),
+        LT_STATUS_OK);
+    ASSERT_TRUE(finish_id == schedule_id + 1u);
+
+    ASSERT_STATUS(lt_task_graph_execute(graph, worker_count), LT_STATUS_OK);
+    ASSERT_TRUE(ctx.base_misses == 0u);
+    ASSERT_TRUE(ctx.rows_seen_at_finish == ENTITY_COUNT);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_get_component(world, entities[i], position_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->y == 3.0f);
+        ASSERT_TRUE(((const test_vec3_t*)ptr)->x >= 3.0f);
+    }
+
+    if (worker_count > 1u) {
+        ASSERT_STATUS(lt_world_begin_defer(world), LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_execute(graph, worker_count), LT_STATUS_CONFLICT);
+        ASSERT_STATUS(lt_world_end_defer(world), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_task_graph_execute(graph, 0u), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_task_graph_execute(NULL, 1u), LT_STATUS_INVALID_ARGUMENT);
+
+    lt_task_graph_destroy(graph);
+    lt_schedule_destroy(schedule);
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_task_graph_orders_tasks_queries_and_schedules(void)
+{
+    ASSERT_TRUE(run_task_graph_case(1u) == 0);
+    ASSERT_TRUE(run_task_graph_case(4u) == 0);
+    return 0;
+}
+
+static void test_task_count_rows(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    ((uint32_t*)user_data)[worker_index] += view->count;
+}
+
+static int test_task_graph_query_sees_rows_spawned_by_dependencies(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_query_term_t term;
+    lt_query_desc_t desc;
+    lt_query_t* query;
+    lt_task_graph_t* graph;
+    lt_task_id_t ids[2];
+    test_task_spawn_t spawn;
+    uint32_t rows[4];
+    uint32_t workers;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+
+    memset(&term, 0, sizeof(term));
+    term.component_id = position_id;
+    term.access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &query), LT_STATUS_OK);
+
+    for (workers = 1u; workers <= 4u; workers *= 4u) {
+        memset(&spawn, 0, sizeof(spawn));
+        spawn.world = world;
+        spawn.component_id = position_id;
+        memset(rows, 0, sizeof(rows));
+        ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_add_task(graph, test_task_spawn_entities, &spawn, NULL, 0u, &ids[0]),
+                      LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_add_task(graph, test_task_add_components, &spawn, &ids[0], 1u, &ids[1]),
+                      LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_add_query(graph, query, test_task_count_rows, rows, &ids[1], 1u, NULL),
+                      LT_STATUS_OK);
+        ASSERT_STATUS(lt_task_graph_execute(graph, workers), LT_STATUS_OK);
+        ASSERT_TRUE(spawn.failures == 0u);
+        ASSERT_TRUE(rows[0] + rows[1] + rows[2] + rows[3] == (workers == 1u ? 100u : 200u));
+        lt_task_graph_destroy(graph);
+    }
+
+    lt_query_destroy(query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_event_ctx_s {
+    lt_world_t* world;
+    lt_event_channel_id_t channel;
+    uint32_t produced_per_worker[4];
+    uint32_t min_produced_per_worker[4];
+    uint32_t consume_calls_per_worker[4];
+    lt_status_t status;
+} test_event_ctx_t;
+
+static void test_event_produce_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_event_ctx_t* ctx;
+    uint32_t i;
+
+    ctx = (test_event_ctx_t*)user_data;
+    for (i = 0u; i < view->count; ++i) {
+        if (lt_event_write(ctx->world, ctx->channel, worker_index, &view->entities[i]) != LT_STATUS_OK) {
+            ctx->status = LT_STATUS_CONFLICT;
+        }
+    }
+    ctx->produced_per_worker[worker_index] += view->count;
+}
+
+static void test_event_consume_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_event_ctx_t* ctx;
+    uint32_t produced;
+    uint32_t i;
+
+    (void)view;
+    ctx = (test_event_ctx_t*)user_data;
+    produced = 0u;
+    for (i = 0u; i < 4u; ++i) {
+        produced += ctx->produced_per_worker[i];
+    }
+    if (ctx->consume_calls_per_worker[worker_index] == 0u
+        || produced < ctx->min_produced_per_worker[worker_index]) {
+        ctx->min_produced_per_worker[worker_index] = produced;
+    }
+    ctx->consume_calls_per_worker[worker_index] += 1u;
+}
+
+static int test_event_writers_bypass_world_allocator(void)
+{
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_event_channel_desc_t channel_desc;
+    lt_event_channel_id_t channel;
+    const void* events;
+    uint32_t event_count;
+    uint32_t alloc_calls;
+    uint32_t before;
+    uint32_t i;
+
+    alloc_calls = 0u;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.allocator.alloc = test_counting_alloc;
+    cfg.allocator.free = test_counting_free;
+    cfg.allocator.user = &alloc_calls;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+
+    memset(&channel_desc, 0, sizeof(channel_desc));
+    channel_desc.event_size = (uint32_t)sizeof(uint32_t);
+    channel_desc.worker_count = 4u;
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &channel), LT_STATUS_OK);
+
+    before = alloc_calls;
+    for (i = 0u; i < 1000u; ++i) {
+        ASSERT_STATUS(lt_event_write(world, channel, i % 4u, &i), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_world_swap_events(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_event_read(world, channel, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == 1000u);
+    ASSERT_TRUE(alloc_calls == before);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static int test_event_channels_swap_and_order_schedules(void)
+{
+    enum { ENTITY_COUNT = 600 };
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_event_channel_desc_t channel_desc;
+    lt_event_channel_id_t hits;
+    lt_event_channel_id_t notes;
+    lt_event_access_t produce_access[2];
+    lt_event_access_t consume_access[2];
+    lt_query_term_t produce_term;
+    lt_query_term_t consume_term;
+    lt_query_desc_t desc;
+    lt_query_t* produce_query;
+    lt_query_t* consume_query;
+    lt_query_schedule_entry_t entries[2];
+    lt_schedule_entry_decl_t decls[2];
+    lt_query_schedule_stats_t stats;
+    lt_schedule_t* schedule;
+    test_event_ctx_t ctx;
+    lt_entity_t entities[ENTITY_COUNT];
+    uint8_t seen[ENTITY_COUNT];
+    const void* events;
+    const lt_entity_t* hit_events;
+    const uint32_t* note_events;
+    uint32_t event_count;
+    uint32_t consume_calls;
+    uint32_t note;
+    uint32_t i;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, NULL), LT_STATUS_OK);
+        if ((i % 3u) == 0u) {
+            ASSERT_STATUS(lt_add_component(world, entities[i], velocity_id, NULL), LT_STATUS_OK);
+        }
+    }
+
+    memset(&channel_desc, 0, sizeof(channel_desc));
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &hits), LT_STATUS_INVALID_ARGUMENT);
+    channel_desc.event_size = (uint32_t)sizeof(lt_entity_t);
+    channel_desc.align = 3u;
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &hits), LT_STATUS_INVALID_ARGUMENT);
+    channel_desc.align = (uint32_t)_Alignof(lt_entity_t);
+    channel_desc.worker_count = 4u;
+    channel_desc.initial_capacity = 16u;
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &hits), LT_STATUS_OK);
+    memset(&channel_desc, 0, sizeof(channel_desc));
+    channel_desc.event_size = (uint32_t)sizeof(uint32_t);
+    ASSERT_STATUS(lt_event_channel_create(world, &channel_desc, &notes), LT_STATUS_OK);
+    ASSERT_TRUE(hits != notes);
+
+    note = 7u;
+    ASSERT_STATUS(lt_event_write(world, notes, 1u, &note), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_event_write(world, 99u, 0u, &note), LT_STATUS_INVALID_ARGUMENT);
+    for (i = 0u; i < 3u; ++i) {
+        note = 10u + i;
+        ASSERT_STATUS(lt_event_write(world, notes, 0u, &note), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_event_read(world, notes, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == 0u);
+    ASSERT_STATUS(lt_world_swap_events(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_event_read(world, notes, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == 3u);
+    note_events = (const uint32_t*)events;
+    ASSERT_TRUE(note_events[0] == 10u && note_events[1] == 11u && note_events[2] == 12u);
+
+    memset(&produce_term, 0, sizeof(produce_term));
+    produce_term.component_id = position_id;
+    produce_term.access = LT_ACCESS_WRITE;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &produce_term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &produce_query), LT_STATUS_OK);
+    memset(&consume_term, 0, sizeof(consume_term));
+    consume_term.component_id = velocity_id;
+    consume_term.access = LT_ACCESS_READ;
+    desc.with_terms = &consume_term;
+    ASSERT_STATUS(lt_query_create(world, &desc, &consume_query), LT_STATUS_OK);
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.world = world;
+    ctx.channel = hits;
+    ctx.status = LT_STATUS_OK;
+    memset(produce_access, 0, sizeof(produce_access));
+    produce_access[0].channel = hits;
+    produce_access[0].access = LT_ACCESS_WRITE;
+    memset(consume_access, 0, sizeof(consume_access));
+    consume_access[0].channel = hits;
+    consume_access[0].access = LT_ACCESS_READ;
+
+    memset(entries, 0, sizeof(entries));
+    memset(decls, 0, sizeof(decls));
+    entries[0].query = consume_query;
+    entries[0].callback = test_event_consume_chunk;
+    entries[0].user_data = &ctx;
+    decls[0].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+    decls[0].events = consume_access;
+    decls[0].event_count = 1u;
+    entries[1].query = produce_query;
+    entries[1].callback = test_event_produce_chunk;
+    entries[1].user_data = &ctx;
+    decls[1].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+    decls[1].events = produce_access;
+    decls[1].event_count = 1u;
+
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 4u, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.batch_count == 2u);
+    ASSERT_TRUE(stats.edge_count == 1u);
+    ASSERT_TRUE(ctx.status == LT_STATUS_OK);
+    consume_calls = 0u;
+    for (i = 0u; i < 4u; ++i) {
+        consume_calls += ctx.consume_calls_per_worker[i];
+        if (ctx.consume_calls_per_worker[i] > 0u) {
+            ASSERT_TRUE(ctx.min_produced_per_worker[i] == ENTITY_COUNT);
+        }
+    }
+    ASSERT_TRUE(consume_calls > 0u);
+    lt_schedule_destroy(schedule);
+
+    ASSERT_STATUS(lt_event_read(world, hits, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == 0u);
+    ASSERT_STATUS(lt_world_swap_events(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_event_read(world, hits, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == ENTITY_COUNT);
+    hit_events = (const lt_entity_t*)events;
+    memset(seen, 0, sizeof(seen));
+    for (i = 0u; i < event_count; ++i) {
+        uint32_t index;
+
+        index = (uint32_t)(hit_events[i] & 0xFFFFFFFFu);
+        ASSERT_TRUE(index < ENTITY_COUNT);
+        ASSERT_TRUE(seen[index] == 0u);
+        seen[index] = 1u;
+    }
+    ASSERT_STATUS(lt_event_read(world, notes, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == 0u);
+
+    ASSERT_STATUS(lt_world_swap_events(world), LT_STATUS_OK);
+    ASSERT_STATUS(lt_event_read(world, hits, &events, &event_count), LT_STATUS_OK);
+    ASSERT_TRUE(event_count == 0u);
+
+    produce_access[1].channel = notes;
+    produce_access[1].access = LT_ACCESS_READ;
+    consume_access[1].channel = notes;
+    consume_access[1].access = LT_ACCESS_WRITE;
+    decls[0].event_count = 2u;
+    decls[1].event_count = 2u;
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_CONFLICT);
+    consume_access[1].channel = 99u;
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_INVALID_ARGUMENT);
+    decls[0].events = NULL;
+    ASSERT_STATUS(lt_query_schedule_execute_with_decls(entries, decls, 2u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+
+    lt_query_destroy(consume_query);
+    lt_query_destroy(produce_query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_random_access_ctx_s {
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_id_t health_id;
+    const lt_entity_t* targets;
+    uint32_t hits_per_worker[4];
+    uint32_t denied_per_worker[4];
+} test_random_access_ctx_t;
+
+static void test_random_access_attack_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_random_access_ctx_t* ctx;
+    uint32_t i;
+
+    ctx = (test_random_access_ctx_t*)user_data;
+    for (i = 0u; i < view->count; ++i) {
+        lt_entity_t target;
+        void* ptr;
+
+        target = ctx->targets[(uint32_t)(view->entities[i] & 0xFFFFFFFFu)];
+        if (lt_get_component(ctx->world, target, ctx->health_id, &ptr) == LT_STATUS_OK) {
+            *(uint32_t*)ptr += 1u;
+            ctx->hits_per_worker[worker_index] += 1u;
+        }
+        if (lt_get_component(ctx->world, target, ctx->velocity_id, &ptr) == LT_STATUS_CONFLICT) {
+            ctx->denied_per_worker[worker_index] += 1u;
+        }
+        if (lt_get_component(ctx->world, target, ctx->position_id, &ptr) == LT_STATUS_OK
+            && lt_set_component(ctx->world, target, ctx->position_id, ptr) == LT_STATUS_CONFLICT) {
+            ctx->denied_per_worker[worker_index] += 1u;
+        }
+    }
+}
+
+static void test_random_access_heal_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    uint32_t* health_col;
+    uint32_t i;
+
+    (void)worker_index;
+    (void)user_data;
+    health_col = (uint32_t*)view->columns[0];
+    for (i = 0u; i < view->count; ++i) {
+        health_col[i] *= 2u;
+    }
+}
+
+static int test_random_access_totals(
+    test_random_access_ctx_t* ctx,
+    uint32_t expected_hits,
+    uint32_t expected_denied)
+{
+    uint32_t hits;
+    uint32_t denied;
+    uint32_t i;
+
+    hits = 0u;
+    denied = 0u;
+    for (i = 0u; i < 4u; ++i) {
+        hits += ctx->hits_per_worker[i];
+        denied += ctx->denied_per_worker[i];
+    }
+    memset(ctx->hits_per_worker, 0, sizeof(ctx->hits_per_worker));
+    memset(ctx->denied_per_worker, 0, sizeof(ctx->denied_per_worker));
+    ASSERT_TRUE(hits == expected_hits);
+    ASSERT_TRUE(denied == expected_denied);
+    return 0;
+}
+
+static int test_schedule_random_access_sets(void)
+{
+    enum { ENTITY_COUNT = 400 };
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_desc_t health_desc;
+    lt_query_term_t attack_term;
+    lt_query_term_t heal_term;
+    lt_query_term_t random_access;
+    lt_query_desc_t desc;
+    lt_query_t* attack_query;
+    lt_query_t* heal_query;
+    lt_query_schedule_entry_t entries[2];
+    lt_schedule_entry_decl_t decls[2];
+    lt_query_schedule_stats_t stats;
+    lt_schedule_t* schedule;
+    lt_task_graph_t* graph;
+    test_random_access_ctx_t ctx;
+    lt_entity_t entities[ENTITY_COUNT];
+    lt_entity_t targets[ENTITY_COUNT];
+    uint32_t health;
+    uint32_t expected_denied;
+    uint32_t i;
+    void* ptr;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    memset(&ctx, 0, sizeof(ctx));
+    ASSERT_TRUE(register_vec3_components(world, &ctx.position_id, &ctx.velocity_id) == 0);
+    memset(&health_desc, 0, sizeof(health_desc));
+    health_desc.name = "Health";
+    health_desc.size = (uint32_t)sizeof(uint32_t);
+    health_desc.align = (uint32_t)_Alignof(uint32_t);
+    ASSERT_STATUS(lt_register_component(world, &health_desc, &ctx.health_id), LT_STATUS_OK);
+
+    health = 0u;
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], ctx.position_id, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], ctx.health_id, &health), LT_STATUS_OK);
+    }
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        targets[(uint32_t)(entities[i] & 0xFFFFFFFFu)] = entities[(i + 1u) % ENTITY_COUNT];
+    }
+    ctx.world = world;
+    ctx.targets = targets;
+
+    memset(&attack_term, 0, sizeof(attack_term));
+    attack_term.component_id = ctx.position_id;
+    attack_term.access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = &attack_term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &attack_query), LT_STATUS_OK);
+    memset(&heal_term, 0, sizeof(heal_term));
+    heal_term.component_id = ctx.health_id;
+    heal_term.access = LT_ACCESS_WRITE;
+    desc.with_terms = &heal_term;
+    ASSERT_STATUS(lt_query_create(world, &desc, &heal_query), LT_STATUS_OK);
+
+    memset(&random_access, 0, sizeof(random_access));
+    random_access.component_id = ctx.health_id;
+    random_access.access = LT_ACCESS_WRITE;
+    memset(entries, 0, sizeof(entries));
+    memset(decls, 0, sizeof(decls));
+    entries[0].query = attack_query;
+    entries[0].callback = test_random_access_attack_chunk;
+    entries[0].user_data = &ctx;
+    entries[1].query = heal_query;
+    entries[1].callback = test_random_access_heal_chunk;
+    decls[0].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+    decls[1].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+
+    ASSERT_STATUS(lt_schedule_create(entries, 2u, &schedule), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_get_stats(schedule, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.batch_count == 1u);
+    lt_schedule_destroy(schedule);
+
+    decls[0].random_access = &random_access;
+    decls[0].random_access_count = 1u;
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_get_stats(schedule, &stats), LT_STATUS_OK);
+    ASSERT_TRUE(stats.batch_count == 2u);
+    ASSERT_TRUE(stats.edge_count == 1u);
+
+#if !LT_NO_VALIDATION
+    expected_denied = ENTITY_COUNT * 2u;
+#else
+    expected_denied = 0u;
+#endif
+    ASSERT_STATUS(lt_world_set_access_checks(NULL, 1u), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_world_set_access_checks(world, 1u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, entities[0], ctx.velocity_id, &ptr), LT_STATUS_NOT_FOUND);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 4u, NULL), LT_STATUS_OK);
+    ASSERT_TRUE(test_random_access_totals(&ctx, ENTITY_COUNT, expected_denied) == 0);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_get_component(world, entities[i], ctx.health_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(*(const uint32_t*)ptr == 2u);
+    }
+
+    ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_schedule(graph, schedule, NULL, 0u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_execute(graph, 4u), LT_STATUS_OK);
+    ASSERT_TRUE(test_random_access_totals(&ctx, ENTITY_COUNT, expected_denied) == 0);
+
+    ASSERT_STATUS(lt_world_set_access_checks(world, 0u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 4u, NULL), LT_STATUS_OK);
+    ASSERT_TRUE(test_random_access_totals(&ctx, ENTITY_COUNT, 0u) == 0);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_get_component(world, entities[i], ctx.health_id, &ptr), LT_STATUS_OK);
+        ASSERT_TRUE(*(const uint32_t*)ptr == 14u);
+    }
+    lt_task_graph_destroy(graph);
+    lt_schedule_destroy(schedule);
+
+    random_access.component_id = LT_COMPONENT_INVALID;
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_INVALID_ARGUMENT);
+    random_access.component_id = ctx.health_id;
+    random_access.access = (lt_access_t)7;
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_INVALID_ARGUMENT);
+    decls[0].random_access = NULL;
+    ASSERT_STATUS(lt_query_schedule_execute_with_decls(entries, decls, 2u, 1u, NULL), LT_STATUS_INVALID_ARGUMENT);
+
+    lt_query_destroy(heal_query);
+    lt_query_destroy(attack_query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_validator_ctx_s {
+    lt_world_t* world;
+    lt_component_id_t health_id;
+    uint32_t chunks_per_worker[4];
+    uint32_t probes_per_worker[4];
+    uint32_t column_violations_per_worker[4];
+    uint32_t read_violations_per_worker[4];
+    uint32_t bad_reports_per_worker[4];
+} test_validator_ctx_t;
+
+static void test_validator_hook(const lt_access_violation_t* violation, void* user_data)
+{
+    test_validator_ctx_t* ctx;
+    uint32_t worker;
+
+    ctx = (test_validator_ctx_t*)user_data;
+    worker = violation->worker_index;
+    if (violation->kind == LT_ACCESS_VIOLATION_READ_COLUMN_WRITE
+        && violation->system_name != NULL
+        && strcmp(violation->system_name, "integrate") == 0
+        && strcmp(violation->component_name, "Velocity") == 0
+        && violation->entity == LT_ENTITY_NULL) {
+        ctx->column_violations_per_worker[worker] += 1u;
+    } else if (violation->kind == LT_ACCESS_VIOLATION_UNDECLARED_READ
+        && violation->system_name != NULL
+        && strcmp(violation->system_name, "probe") == 0
+        && strcmp(violation->component_name, "Health") == 0
+        && violation->entity != LT_ENTITY_NULL) {
+        ctx->read_violations_per_worker[worker] += 1u;
+    } else {
+        ctx->bad_reports_per_worker[worker] += 1u;
+    }
+}
+
+static void test_validator_integrate_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_validator_ctx_t* ctx;
+    test_vec3_t* position_col;
+    test_vec3_t* velocity_col;
+    uint32_t i;
+
+    ctx = (test_validator_ctx_t*)user_data;
+    position_col = (test_vec3_t*)view->columns[0];
+    velocity_col = (test_vec3_t*)view->columns[1];
+    for (i = 0u; i < view->count; ++i) {
+        position_col[i].x += velocity_col[i].x;
+    }
+    velocity_col[0].x += 1.0f;
+    ctx->chunks_per_worker[worker_index] += 1u;
+}
+
+static void test_validator_probe_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_validator_ctx_t* ctx;
+    uint32_t i;
+    void* ptr;
+
+    ctx = (test_validator_ctx_t*)user_data;
+    for (i = 0u; i < view->count; ++i) {
+        if (lt_get_component(ctx->world, view->entities[i], ctx->health_id, &ptr) == LT_STATUS_CONFLICT) {
+            ctx->probes_per_worker[worker_index] += 1u;
+        }
+    }
+}
+
+static int test_validator_expect(test_validator_ctx_t* ctx, uint32_t expected_probes, int expect_reports)
+{
+    uint32_t chunks;
+    uint32_t probes;
+    uint32_t column_violations;
+    uint32_t read_violations;
+    uint32_t bad_reports;
+    uint32_t i;
+
+    chunks = 0u;
+    probes = 0u;
+    column_violations = 0u;
+    read_violations = 0u;
+    bad_reports = 0u;
+    for (i = 0u; i < 4u; ++i) {
+        chunks += ctx->chunks_per_worker[i];
+        probes += ctx->probes_per_worker[i];
+        column_violations += ctx->column_violations_per_worker[i];
+        read_violations += ctx->read_violations_per_worker[i];
+        bad_reports += ctx->bad_reports_per_worker[i];
+    }
+    memset(ctx->chunks_per_worker, 0, sizeof(ctx->chunks_per_worker));
+    memset(ctx->probes_per_worker, 0, sizeof(ctx->probes_per_worker));
+    memset(ctx->column_violations_per_worker, 0, sizeof(ctx->column_violations_per_worker));
+    memset(ctx->read_violations_per_worker, 0, sizeof(ctx->read_violations_per_worker));
+    memset(ctx->bad_reports_per_worker, 0, sizeof(ctx->bad_reports_per_worker));
+
+    ASSERT_TRUE(chunks > 1u);
+    ASSERT_TRUE(probes == expected_probes);
+    ASSERT_TRUE(bad_reports == 0u);
+    ASSERT_TRUE(column_violations == (expect_reports ? chunks : 0u));
+    ASSERT_TRUE(read_violations == (expect_reports ? expected_probes : 0u));
+    return 0;
+}
+
+static int test_access_validator_reports_violations(void)
+{
+    enum { ENTITY_COUNT = 300 };
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_component_desc_t health_desc;
+    lt_query_term_t integrate_terms[2];
+    lt_query_term_t probe_term;
+    lt_query_desc_t desc;
+    lt_query_t* integrate_query;
+    lt_query_t* probe_query;
+    lt_query_schedule_entry_t entries[2];
+    lt_schedule_entry_decl_t decls[2];
+    lt_schedule_t* schedule;
+    lt_task_graph_t* graph;
+    test_validator_ctx_t ctx;
+    lt_entity_t entity;
+    uint32_t expected_probes;
+    int expect_reports;
+    uint32_t i;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&health_desc, 0, sizeof(health_desc));
+    health_desc.name = "Health";
+    health_desc.size = (uint32_t)sizeof(uint32_t);
+    health_desc.align = (uint32_t)_Alignof(uint32_t);
+    ASSERT_STATUS(lt_register_component(world, &health_desc, &ctx.health_id), LT_STATUS_OK);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, velocity_id, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, ctx.health_id, NULL), LT_STATUS_OK);
+    }
+    ctx.world = world;
+
+    memset(integrate_terms, 0, sizeof(integrate_terms));
+    integrate_terms[0].component_id = position_id;
+    integrate_terms[0].access = LT_ACCESS_WRITE;
+    integrate_terms[1].component_id = velocity_id;
+    integrate_terms[1].access = LT_ACCESS_READ;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_terms = integrate_terms;
+    desc.with_count = 2u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &integrate_query), LT_STATUS_OK);
+    memset(&probe_term, 0, sizeof(probe_term));
+    probe_term.component_id = position_id;
+    probe_term.access = LT_ACCESS_READ;
+    desc.with_terms = &probe_term;
+    desc.with_count = 1u;
+    ASSERT_STATUS(lt_query_create(world, &desc, &probe_query), LT_STATUS_OK);
+
+    memset(entries, 0, sizeof(entries));
+    memset(decls, 0, sizeof(decls));
+    entries[0].query = integrate_query;
+    entries[0].callback = test_validator_integrate_chunk;
+    entries[0].user_data = &ctx;
+    decls[0].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+    decls[0].name = "integrate";
+    entries[1].query = probe_query;
+    entries[1].callback = test_validator_probe_chunk;
+    entries[1].user_data = &ctx;
+    decls[1].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+    decls[1].name = "probe";
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_OK);
+
+#if !LT_NO_VALIDATION
+    expected_probes = ENTITY_COUNT;
+    expect_reports = 1;
+#else
+    expected_probes = 0u;
+    expect_reports = 0;
+#endif
+    ASSERT_STATUS(lt_world_set_access_violation_hook(NULL, test_validator_hook, &ctx), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_world_set_access_violation_hook(world, test_validator_hook, &ctx), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 4u, NULL), LT_STATUS_OK);
+    ASSERT_TRUE(test_validator_expect(&ctx, 0u, 0) == 0);
+
+    ASSERT_STATUS(lt_world_set_access_checks(world, 1u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_execute(schedule, 4u, NULL), LT_STATUS_OK);
+    ASSERT_TRUE(test_validator_expect(&ctx, expected_probes, expect_reports) == 0);
+
+    ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_schedule(graph, schedule, NULL, 0u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_execute(graph, 4u), LT_STATUS_OK);
+    ASSERT_TRUE(test_validator_expect(&ctx, expected_probes, expect_reports) == 0);
+
+    ASSERT_STATUS(lt_world_set_access_violation_hook(world, NULL, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_execute(graph, 1u), LT_STATUS_OK);
+    ASSERT_TRUE(test_validator_expect(&ctx, expected_probes, 0) == 0);
+
+    lt_task_graph_destroy(graph);
+    lt_schedule_destroy(schedule);
+    lt_query_destroy(probe_query);
+    lt_query_destroy(integrate_query);
+    lt_world_destroy(world);
+    return 0;
+}
+
+typedef struct test_epoch_scan_s {
+    uint32_t rows;
+    float first_x;
+    uint32_t mismatches;
+} test_epoch_scan_t;
+
+static void test_epoch_scan_chunk(const lt_chunk_view_t* view, void* user_data)
+{
+    test_epoch_scan_t* scan;
+    const test_vec3_t* position_col;
+    uint32_t i;
+
+    scan = (test_epoch_scan_t*)user_data;
+    position_col = (const test_vec3_t*)view->columns[0];
+    for (i = 0u; i < view->count; ++i) {
+        if (scan->rows == 0u) {
+            scan->first_x = position_col[i].x;
+        }
+        if (position_col[i].x != scan->first_x || position_col[i].y != position_col[i].x) {
+            scan->mismatches += 1u;
+        }
+        scan->rows += 1u;
+    }
+}
+
+typedef struct test_epoch_threads_s {
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    const lt_entity_t* entities;
+    uint32_t entity_count;
+    uint32_t writer_failures;
+    uint32_t reader_failures;
+    uint32_t reader_pins;
+} test_epoch_threads_t;
+
+static void test_epoch_writer_task(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_epoch_threads_t* ctx;
+    uint32_t round;
+    uint32_t i;
+
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    ctx = (test_epoch_threads_t*)user_data;
+    for (round = 1u; round <= 60u; ++round) {
+        test_vec3_t position;
+
+        position.x = (float)round;
+        position.y = (float)round;
+        position.z = 0.0f;
+        for (i = 0u; i < ctx->entity_count; ++i) {
+            if (lt_set_component(ctx->world, ctx->entities[i], ctx->position_id, &position) != LT_STATUS_OK) {
+                ctx->writer_failures += 1u;
+            }
+        }
+        for (i = round % 7u; i < ctx->entity_count; i += 7u) {
+            uint8_t has;
+
+            (void)lt_has_component(ctx->world, ctx->entities[i], ctx->velocity_id, &has);
+            if (has != 0u) {
+                (void)lt_remove_component(ctx->world, ctx->entities[i], ctx->velocity_id);
+            } else {
+                (void)lt_add_component(ctx->world, ctx->entities[i], ctx->velocity_id, NULL);
+            }
+        }
+        if (lt_world_publish_epoch(ctx->world, NULL) != LT_STATUS_OK) {
+            ctx->writer_failures += 1u;
+        }
+    }
+}
+
+static void test_epoch_reader_task(uint32_t begin, uint32_t end, uint32_t worker_index, void* user_data)
+{
+    test_epoch_threads_t* ctx;
+    uint64_t last_id;
+    uint32_t i;
+
+    (void)begin;
+    (void)end;
+    (void)worker_index;
+    ctx = (test_epoch_threads_t*)user_data;
+    last_id = 0u;
+    for (i = 0u; i < 200u; ++i) {
+        const lt_epoch_t* epoch;
+        lt_epoch_info_t info;
+        test_epoch_scan_t scan;
+
+        if (lt_epoch_pin(ctx->world, &epoch) != LT_STATUS_OK) {
+            ctx->reader_failures += 1u;
+            continue;
+        }
+        memset(&scan, 0, sizeof(scan));
+        (void)lt_epoch_get_info(epoch, &info);
+        (void)lt_epoch_for_each_chunk(epoch, &ctx->position_id, 1u, test_epoch_scan_chunk, &scan);
+        if (info.id < last_id || scan.rows != ctx->entity_count || scan.mismatches != 0u) {
+            ctx->reader_failures += 1u;
+        }
+        last_id = info.id;
+        ctx->reader_pins += 1u;
+        (void)lt_epoch_release(ctx->world, epoch);
+    }
+}
+
+static int test_epoch_snapshots_isolate_readers(void)
+{
+    enum { ENTITY_COUNT = 256 };
+    lt_world_config_t cfg;
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_entity_t entities[ENTITY_COUNT];
+    const lt_epoch_t* first;
+    const lt_epoch_t* second;
+    lt_epoch_info_t info;
+    test_epoch_scan_t scan;
+    test_epoch_threads_t threads;
+    test_vec3_t position;
+    lt_task_graph_t* graph;
+    const void* ptr;
+    void* mut;
+    uint64_t epoch_id;
+    uint32_t i;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.target_chunk_bytes = 1024u;
+    ASSERT_STATUS(lt_world_create(&cfg, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    ASSERT_STATUS(lt_epoch_pin(world, &first), LT_STATUS_NOT_FOUND);
+    position.x = 1.0f;
+    position.y = 1.0f;
+    position.z = 0.0f;
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entities[i]), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entities[i], position_id, &position), LT_STATUS_OK);
+    }
+
+    ASSERT_STATUS(lt_world_publish_epoch(NULL, NULL), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_world_publish_epoch(world, &epoch_id), LT_STATUS_OK);
+    ASSERT_TRUE(epoch_id == 1u);
+    ASSERT_STATUS(lt_epoch_pin(world, &first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_info(first, &info), LT_STATUS_OK);
+    ASSERT_TRUE(info.id == 1u && info.live_entity_count == ENTITY_COUNT);
+    ASSERT_TRUE(info.chunk_count > 2u && info.shared_chunk_count == 0u);
+
+    position.x = 5.0f;
+    position.y = 5.0f;
+    ASSERT_STATUS(lt_set_component(world, entities[0], position_id, &position), LT_STATUS_OK);
+    ASSERT_STATUS(lt_entity_destroy(world, entities[1]), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entities[2], velocity_id, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_world_flush(world), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_epoch_get_component(first, entities[0], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 1.0f);
+    ASSERT_STATUS(lt_epoch_get_component(first, entities[1], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_component(first, entities[2], velocity_id, &ptr), LT_STATUS_NOT_FOUND);
+    memset(&scan, 0, sizeof(scan));
+    ASSERT_STATUS(lt_epoch_for_each_chunk(first, &position_id, 1u, test_epoch_scan_chunk, &scan), LT_STATUS_OK);
+    ASSERT_TRUE(scan.rows == ENTITY_COUNT && scan.mismatches == 0u);
+
+    ASSERT_STATUS(lt_world_publish_epoch(world, &epoch_id), LT_STATUS_OK);
+    ASSERT_TRUE(epoch_id == 2u);
+    ASSERT_STATUS(lt_epoch_pin(world, &second), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_info(second, &info), LT_STATUS_OK);
+    ASSERT_TRUE(info.live_entity_count == ENTITY_COUNT - 1u);
+    ASSERT_TRUE(info.shared_chunk_count > 0u && info.shared_chunk_count < info.chunk_count);
+    ASSERT_STATUS(lt_epoch_get_component(second, entities[0], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 5.0f);
+    ASSERT_STATUS(lt_epoch_get_component(second, entities[1], position_id, &ptr), LT_STATUS_STALE_ENTITY);
+    ASSERT_STATUS(lt_epoch_get_component(second, entities[2], velocity_id, &ptr), LT_STATUS_OK);
+    memset(&scan, 0, sizeof(scan));
+    ASSERT_STATUS(lt_epoch_for_each_chunk(second, &velocity_id, 1u, test_epoch_scan_chunk, &scan), LT_STATUS_OK);
+    ASSERT_TRUE(scan.rows == 1u);
+
+    ASSERT_STATUS(lt_epoch_release(world, first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_release(world, first), LT_STATUS_INVALID_ARGUMENT);
+    ASSERT_STATUS(lt_world_publish_epoch(world, &epoch_id), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_component(second, entities[0], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 5.0f);
+    ASSERT_STATUS(lt_epoch_release(world, second), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_pin(world, &first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_info(first, &info), LT_STATUS_OK);
+    ASSERT_TRUE(info.id == 3u && info.shared_chunk_count == info.chunk_count);
+    ASSERT_STATUS(lt_epoch_release(world, first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_get_component(world, entities[3], position_id, &mut), LT_STATUS_OK);
+    ((test_vec3_t*)mut)->x = 7.0f;
+    ASSERT_STATUS(lt_world_publish_epoch(world, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_pin(world, &first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_info(first, &info), LT_STATUS_OK);
+    ASSERT_TRUE(info.shared_chunk_count + 1u == info.chunk_count);
+    ASSERT_STATUS(lt_epoch_get_component(first, entities[3], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 7.0f);
+    ASSERT_STATUS(lt_epoch_release(world, first), LT_STATUS_OK);
+    ((test_vec3_t*)mut)->x = 9.0f;
+    ASSERT_STATUS(lt_world_publish_epoch(world, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_pin(world, &first), LT_STATUS_OK);
+    ASSERT_STATUS(lt_epoch_get_component(first, entities[3], position_id, &ptr), LT_STATUS_OK);
+    ASSERT_TRUE(((const test_vec3_t*)ptr)->x == 9.0f);
+    ASSERT_STATUS(lt_epoch_release(world, first), LT_STATUS_OK);
+
+    position.x = 0.0f;
+    position.y = 0.0f;
+    ASSERT_STATUS(lt_entity_create(world, &entities[1]), LT_STATUS_OK);
+    ASSERT_STATUS(lt_add_component(world, entities[1], position_id, &position), LT_STATUS_OK);
+    for (i = 0u; i < ENTITY_COUNT; ++i) {
+        ASSERT_STATUS(lt_set_component(world, entities[i], position_id, &position), LT_STATUS_OK);
+    }
+    ASSERT_STATUS(lt_world_publish_epoch(world, NULL), LT_STATUS_OK);
+
+    memset(&threads, 0, sizeof(threads));
+    threads.world = world;
+    threads.position_id = position_id;
+    threads.velocity_id = velocity_id;
+    threads.entities = entities;
+    threads.entity_count = ENTITY_COUNT;
+    ASSERT_STATUS(lt_task_graph_create(&graph), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_task(graph, test_epoch_writer_task, &threads, NULL, 0u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_add_task(graph, test_epoch_reader_task, &threads, NULL, 0u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_task_graph_execute(graph, 2u), LT_STATUS_OK);
+    ASSERT_TRUE(threads.writer_failures == 0u);
+    ASSERT_TRUE(threads.reader_failures == 0u);
+    ASSERT_TRUE(threads.reader_pins == 200u);
+    lt_task_graph_destroy(graph);
+
+    lt_world_destroy(world);
+    return 0;
+}
+
+static void test_profiled_chunk(const lt_chunk_view_t* view, uint32_t worker_index, void* user_data)
+{
+    test_vec3_t* column;
+    uint32_t i;
+
+    (void)worker_index;
+    (void)user_data;
+    column = (test_vec3_t*)view->columns[0];
+    for (i = 0u; i < view->count; ++i) {
+        column[i].x += 1.0f;
+    }
+}
+
+static int test_schedule_profiling_and_shm_export(void)
+{
+    lt_world_t* world;
+    lt_component_id_t position_id;
+    lt_component_id_t velocity_id;
+    lt_query_term_t terms[2];
+    lt_query_desc_t desc;
+    lt_query_t* queries[2];
+    lt_query_schedule_entry_t entries[2];
+    lt_schedule_entry_decl_t decls[2];
+    lt_schedule_t* schedule;
+    const lt_schedule_t* schedules[1];
+    lt_schedule_entry_timing_t timing;
+    lt_shm_export_t* exporter;
+    lt_entity_t entity;
+    const char* name;
+    uint32_t count;
+    uint32_t i;
+
+    ASSERT_STATUS(lt_world_create(NULL, &world), LT_STATUS_OK);
+    ASSERT_TRUE(register_vec3_components(world, &position_id, &velocity_id) == 0);
+    for (i = 0u; i < 500u; ++i) {
+        ASSERT_STATUS(lt_entity_create(world, &entity), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, position_id, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_add_component(world, entity, velocity_id, NULL), LT_STATUS_OK);
+    }
+
+    memset(terms, 0, sizeof(terms));
+    terms[0].component_id = position_id;
+    terms[0].access = LT_ACCESS_WRITE;
+    terms[1].component_id = velocity_id;
+    terms[1].access = LT_ACCESS_WRITE;
+    memset(&desc, 0, sizeof(desc));
+    desc.with_count = 1u;
+    desc.with_terms = &terms[0];
+    ASSERT_STATUS(lt_query_create(world, &desc, &queries[0]), LT_STATUS_OK);
+    desc.with_terms = &terms[1];
+    ASSERT_STATUS(lt_query_create(world, &desc, &queries[1]), LT_STATUS_OK);
+    memset(entries, 0, sizeof(entries));
+    memset(decls, 0, sizeof(decls));
+    for (i = 0u; i < 2u; ++i) {
+        entries[i].query = queries[i];
+        entries[i].callback = test_profiled_chunk;
+        decls[i].version = LT_SCHEDULE_ENTRY_DECL_VERSION;
+    }
+    decls[0].name = "advance_position";
+    decls[1].name = "advance_velocity";
+    ASSERT_STATUS(lt_schedule_create_with_decls(entries, decls, 2u, &schedule), LT_STATUS_OK);
+
+    ASSERT_STATUS(lt_schedule_execute(schedule, 2u, NULL), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_get_entry_timing(schedule, 0u, &timing), LT_STATUS_OK);
+    ASSERT_TRUE(timing.run_count == 0u);
+    ASSERT_STATUS(lt_schedule_set_profiling(schedule, 1u), LT_STATUS_OK);
+    for (i = 0u; i < 3u; ++i) {
+        ASSERT_STATUS(lt_schedule_execute(schedule, i == 0u ? 1u : 2u, NULL), LT_STATUS_OK);
+    }
+    for (i = 0u; i < 2u; ++i) {
+        ASSERT_STATUS(lt_schedule_get_entry_timing(schedule, i, &timing), LT_STATUS_OK);
+        ASSERT_TRUE(timing.run_count == 3u);
+        ASSERT_TRUE(timing.total_ns >= timing.max_ns && timing.max_ns >= timing.last_ns);
+    }
+    ASSERT_STATUS(lt_schedule_get_entry_count(schedule, &count), LT_STATUS_OK);
+    ASSERT_TRUE(count == 2u);
+    ASSERT_STATUS(lt_schedule_get_entry_name(schedule, 1u, &name), LT_STATUS_OK);
+    ASSERT_TRUE(strcmp(name, "advance_velocity") == 0);
+    ASSERT_STATUS(lt_schedule_get_entry_timing(schedule, 2u, &timing), LT_STATUS_INVALID_ARGUMENT);
+
+    ASSERT_STATUS(lt_schedule_remove_entry(schedule, 0u), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_get_entry_timing(schedule, 0u, &timing), LT_STATUS_OK);
+    ASSERT_TRUE(timing.run_count == 3u);
+    ASSERT_STATUS(lt_schedule_insert_entry(schedule, 0u, &entries[0], &decls[0]), LT_STATUS_OK);
+    ASSERT_STATUS(lt_schedule_get_entry_timing(schedule, 0u, &timing), LT_STATUS_OK);
+    ASSERT_TRUE(timing.run_count == 0u);
+
+    schedules[0] = schedule;
+#if defined(LT_HAS_SHM_EXPORT) && LT_HAS_SHM_EXPORT
+    {
+        char segment_name[64];
+        lt_shm_header_t header;
+        lt_shm_entry_t shm_entries[4];
+        lt_shm_export_t* stale;
+        lt_shm_header_t* stale_header;
+        const void* segment;
+        size_t segment_bytes;
+        pid_t dead;
+        int fd;
+
+        (void)snprintf(segment_name, sizeof(segment_name), "/lattice-test-%ld", (long)getpid());
+        ASSERT_STATUS(lt_shm_export_create("no-slash", 4u, &exporter), LT_STATUS_INVALID_ARGUMENT);
+        ASSERT_STATUS(lt_shm_export_create(segment_name, 4u, &stale), LT_STATUS_OK);
+        ASSERT_STATUS(lt_shm_export_create(segment_name, 1u, &exporter), LT_STATUS_ALREADY_EXISTS);
+
+        dead = fork();
+        ASSERT_TRUE(dead >= 0);
+        if (dead == 0) {
+            _exit(0);
+        }
+        ASSERT_TRUE(waitpid(dead, NULL, 0) == dead);
+        fd = shm_open(segment_name, O_RDWR, 0);
+        ASSERT_TRUE(fd >= 0);
+        stale_header = (lt_shm_header_t*)mmap(NULL, sizeof(*stale_header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        (void)close(fd);
+        ASSERT_TRUE((void*)stale_header != MAP_FAILED);
+        stale_header->owner_pid = (uint64_t)dead;
+        (void)munmap(stale_header, sizeof(*stale_header));
+        ASSERT_STATUS(lt_shm_export_create(segment_name, 1u, &exporter), LT_STATUS_OK);
+        lt_shm_export_destroy(stale);
+        fd = shm_open(segment_name, O_RDONLY, 0);
+        ASSERT_TRUE(fd >= 0);
+        (void)close(fd);
+        ASSERT_STATUS(lt_schedule_execute(schedule, 1u, NULL), LT_STATUS_OK);
+        ASSERT_STATUS(lt_shm_export_publish(exporter, world, schedules, 1u), LT_STATUS_OK);
+        ASSERT_STATUS(lt_shm_export_publish(exporter, world, schedules, 1u), LT_STATUS_OK);
+
+        fd = shm_open(segment_name, O_RDONLY, 0);
+        ASSERT_TRUE(fd >= 0);
+        segment_bytes = lt_shm_segment_bytes(1u);
+        segment = mmap(NULL, segment_bytes, PROT_READ, MAP_SHARED, fd, 0);
+        (void)close(fd);
+        ASSERT_TRUE(segment != MAP_FAILED);
+        ASSERT_STATUS(lt_shm_read(segment, segment_bytes, &header, shm_entries, 4u, &count), LT_STATUS_OK);
+        ASSERT_TRUE(header.frame == 2u && (header.sequence & 1u) == 0u && header.owner_pid == (uint64_t)getpid());
+        ASSERT_TRUE(header.world.live_entities == 500u && header.world.chunk_bytes > 0u);
+        ASSERT_TRUE(header.entry_count == 1u && header.dropped_entries == 1u && count == 1u);
+        ASSERT_TRUE(strcmp(shm_entries[0].name, "advance_position") == 0);
+        ASSERT_TRUE(shm_entries[0].run_count == 1u);
+        ASSERT_STATUS(lt_shm_read(segment, sizeof(header) - 1u, &header, shm_entries, 4u, &count),
+                      LT_STATUS_INVALID_ARGUMENT);
+        (void)munmap((void*)segment, segment_bytes);
+        lt_shm_export_destroy(exporter);
+        ASSERT_TRUE(shm_open(segment_name, O_RDONLY, 0) < 0);
+
+        fd = shm_open(segment_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        ASSERT_TRUE(fd >= 0);
+        ASSERT_TRUE(ftruncate(fd, (off_t)segment_bytes) == 0);
+        (void)close(fd);
+        ASSERT_STATUS(lt_shm_export_create(segment_name, 1u, &exporter), LT_STATUS_ALREADY_EXISTS);
+        ASSERT_TRUE(shm_unlink(segment_name) == 0);
+    }
+#else
+    ASSERT_STATUS(lt_shm_export_create("/lattice-test", 4u, &exporter), LT_STATUS_NOT_IMPLEMENTED);
+    ASSERT_STATUS(lt_shm_export_publish(NULL, world, schedules, 1u), LT_STATUS_NOT_IMPLEMENTED);
+#endif
+
+    lt_schedule_destroy(schedule);
+    lt_query_destroy(queries[1]);
+    lt_query_destroy(queries[0]);
+    lt_world_destroy(world);
     return 0;
 }
 
@@ -2020,21 +5532,49 @@ int main(void)
     RUN_TEST(test_component_validation);
     RUN_TEST(test_world_introspection_snapshots);
     RUN_TEST(test_add_remove_components_preserve_data);
+    RUN_TEST(test_add_remove_components_single_move);
+    RUN_TEST(test_component_batch_add_remove_moves_runs);
+    RUN_TEST(test_unchecked_accessors_match_checked);
+    RUN_TEST(test_component_ref_revalidates_after_moves);
     RUN_TEST(test_swap_remove_updates_entity_locations);
     RUN_TEST(test_world_stats_structural_moves);
+    RUN_TEST(test_world_stats_sampled_from_monitor_thread);
+    RUN_TEST(test_transition_heatmap_records_moves);
+    RUN_TEST(test_component_access_stats_count_rows_and_lookups);
+    RUN_TEST(test_recorder_captures_world_operations);
+    RUN_TEST(test_recorder_captures_task_graph_operations);
     RUN_TEST(test_destructors_called_on_remove_destroy_and_world_destroy);
     RUN_TEST(test_tag_component_behavior);
     RUN_TEST(test_query_iteration_and_filters);
+    RUN_TEST(test_query_count_tracks_rows_without_iteration);
+    RUN_TEST(test_empty_archetypes_skipped_and_reclaimed);
+    RUN_TEST(test_query_ranges_skip_chunks_by_key_summary);
+    RUN_TEST(test_query_group_by_clusters_archetypes);
+    RUN_TEST(test_query_sort_orders_rows_across_chunks);
+    RUN_TEST(test_query_retag_relinks_chunks_without_moves);
     RUN_TEST(test_query_validation_conflicts);
     RUN_TEST(test_deferred_component_visibility_and_payload_copy);
     RUN_TEST(test_deferred_flush_conflict_and_destroy);
     RUN_TEST(test_deferred_command_ordering);
+    RUN_TEST(test_deferred_set_component_coalesces);
+    RUN_TEST(test_query_auto_defer_structural_changes);
     RUN_TEST(test_trace_hook_reports_core_events);
     RUN_TEST(test_trace_hook_reports_query_events);
     RUN_TEST(test_parallel_query_for_each_chunk_validation);
     RUN_TEST(test_parallel_query_for_each_chunk_deterministic);
+    RUN_TEST(test_query_for_each_subset_chunk_bins_rows);
     RUN_TEST(test_query_schedule_validation);
     RUN_TEST(test_query_schedule_batches_and_deterministic);
+    RUN_TEST(test_schedule_compile_matches_pairwise_layering);
+    RUN_TEST(test_schedule_incremental_edits_match_rebuild);
+    RUN_TEST(test_task_graph_orders_tasks_queries_and_schedules);
+    RUN_TEST(test_task_graph_query_sees_rows_spawned_by_dependencies);
+    RUN_TEST(test_event_channels_swap_and_order_schedules);
+    RUN_TEST(test_event_writers_bypass_world_allocator);
+    RUN_TEST(test_schedule_random_access_sets);
+    RUN_TEST(test_access_validator_reports_violations);
+    RUN_TEST(test_epoch_snapshots_isolate_readers);
+    RUN_TEST(test_schedule_profiling_and_shm_export);
     RUN_TEST(test_determinism_seeded_mixed_sequence);
     return 0;
 }